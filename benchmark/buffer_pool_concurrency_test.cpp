@@ -0,0 +1,127 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+struct Stat
+{
+  int64_t hit_count   = 0;
+  int64_t other_count = 0;
+};
+
+/**
+ * @brief 测试buffer pool命中时的吞吐量
+ * @details 所有的页面都会缓存在内存中，每次访问都会命中。
+ * 第一个参数是页帧表的分片个数，可以对比不同分片个数、不同线程数时的吞吐量。
+ */
+class BufferPoolHitBenchmark : public Fixture
+{
+public:
+  static constexpr int PAGE_NUM = 1000;
+
+  string Name() const { return "buffer_pool_hit"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    string log_name = this->Name() + ".log";
+    string filename = this->Name() + ".bp";
+    LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_INFO);
+
+    const int memory_size = (PAGE_NUM + DEFAULT_ITEM_NUM_PER_POOL) * BP_PAGE_SIZE;
+    BufferPoolOptions options;
+    options.memory_size     = memory_size;
+    options.frame_shard_num = static_cast<int>(state.range(0));
+    bpm_ = make_unique<BufferPoolManager>(options);
+
+    ::remove(filename.c_str());
+    RC rc = bpm_->create_file(filename.c_str());
+    if (rc != RC::SUCCESS) {
+      throw runtime_error("failed to create buffer pool file");
+    }
+
+    rc = bpm_->open_file(filename.c_str(), buffer_pool_);
+    if (rc != RC::SUCCESS) {
+      throw runtime_error("failed to open buffer pool file");
+    }
+
+    for (int i = 0; i < PAGE_NUM; i++) {
+      Frame *frame = nullptr;
+      rc = buffer_pool_->allocate_page(&frame);
+      if (rc != RC::SUCCESS) {
+        throw runtime_error("failed to allocate page");
+      }
+      buffer_pool_->unpin_page(frame);
+    }
+    LOG_INFO("test %s setup done. threads=%d, shard num=%ld", this->Name().c_str(), state.threads(), state.range(0));
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    string filename = this->Name() + ".bp";
+    bpm_->close_file(filename.c_str());
+    bpm_.reset();
+    buffer_pool_ = nullptr;
+    ::remove(filename.c_str());
+  }
+
+protected:
+  unique_ptr<BufferPoolManager> bpm_;
+  DiskBufferPool               *buffer_pool_ = nullptr;
+};
+
+BENCHMARK_DEFINE_F(BufferPoolHitBenchmark, Hit)(State &state)
+{
+  // 不使用 IntegerGenerator，因为 random_device 每次都会有系统调用，开销比命中一次buffer pool还要大
+  mt19937                    generator(state.thread_index());
+  uniform_int_distribution<> distrib(1, PAGE_NUM);
+  Stat                       stat;
+
+  for (auto _ : state) {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool_->get_this_page(static_cast<PageNum>(distrib(generator)), &frame);
+    if (rc == RC::SUCCESS) {
+      buffer_pool_->unpin_page(frame);
+      stat.hit_count++;
+    } else {
+      stat.other_count++;
+    }
+  }
+
+  state.counters["hit"]   = Counter(stat.hit_count, Counter::kIsRate);
+  state.counters["other"] = Counter(stat.other_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(BufferPoolHitBenchmark, Hit)->Arg(1)->Arg(16)->ThreadRange(1, 16)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
+BENCHMARK_MAIN();
@@ -0,0 +1,155 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <benchmark/benchmark.h>
+
+#include "common/lang/hybrid_latch.h"
+#include "storage/buffer/page.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 多个线程同时读取少数几个热点页面，比如B+树的根节点和上层的内部节点，对比几种读取方式的扩展性
+ * @details 页帧只有在 CONCURRENCY 编译模式下才会真正加锁，这里直接测试页帧使用的 HybridLatch。
+ * SharedLatch: 加读锁，每次加锁解锁都要修改锁的状态
+ * OptimisticRead: 乐观读，只读取版本号，不写共享的缓存行
+ * StdSharedMutex: 使用 std::shared_mutex，作为原来读写锁的参考
+ * 每次读取页面上的几个字节，模拟在内部节点上查找子节点
+ */
+static constexpr int HOT_PAGE_NUM = 4;
+static constexpr int READ_BYTES   = 64;
+static constexpr int MAX_THREADS  = 64;
+
+struct HotPages
+{
+  HotPages()
+  {
+    pages.reset(new Page[HOT_PAGE_NUM]);
+    memset(pages.get(), 0, sizeof(Page) * HOT_PAGE_NUM);
+  }
+
+  unique_ptr<Page[]> pages;
+  HybridLatch        latches[HOT_PAGE_NUM];
+  shared_mutex       mutexes[HOT_PAGE_NUM];
+};
+
+static HotPages &hot_pages()
+{
+  static HotPages instance;
+  return instance;
+}
+
+static int read_page(const char *data)
+{
+  int sum = 0;
+  for (int i = 0; i < READ_BYTES; i++) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+static void SharedLatch(State &state)
+{
+  HotPages &hot   = hot_pages();
+  int       index = state.thread_index();
+  for (auto _ : state) {
+    const int i = index++ % HOT_PAGE_NUM;
+    hot.latches[i].lock_shared();
+    DoNotOptimize(read_page(hot.pages[i].data));
+    hot.latches[i].unlock_shared();
+  }
+  state.counters["reads"] = Counter(state.iterations(), Counter::kIsRate);
+}
+
+static void OptimisticRead(State &state)
+{
+  HotPages &hot       = hot_pages();
+  int       index     = state.thread_index();
+  int64_t   conflicts = 0;
+  for (auto _ : state) {
+    const int i       = index++ % HOT_PAGE_NUM;
+    uint64_t  version = 0;
+    while (true) {
+      if (hot.latches[i].try_optimistic_read(version)) {
+        DoNotOptimize(read_page(hot.pages[i].data));
+        if (hot.latches[i].validate(version)) {
+          break;
+        }
+      }
+      conflicts++;
+    }
+  }
+  state.counters["reads"]     = Counter(state.iterations(), Counter::kIsRate);
+  state.counters["conflicts"] = Counter(conflicts);
+}
+
+static void StdSharedMutex(State &state)
+{
+  HotPages &hot   = hot_pages();
+  int       index = state.thread_index();
+  for (auto _ : state) {
+    const int i = index++ % HOT_PAGE_NUM;
+    hot.mutexes[i].lock_shared();
+    DoNotOptimize(read_page(hot.pages[i].data));
+    hot.mutexes[i].unlock_shared();
+  }
+  state.counters["reads"] = Counter(state.iterations(), Counter::kIsRate);
+}
+
+/**
+ * @brief 第一个线程不停地修改页面，其它线程乐观读，观察写者对读者的影响
+ */
+static void OptimisticReadWithWriter(State &state)
+{
+  HotPages &hot       = hot_pages();
+  int       index     = state.thread_index();
+  int64_t   conflicts = 0;
+  for (auto _ : state) {
+    const int i = index++ % HOT_PAGE_NUM;
+    if (state.thread_index() == 0) {
+      hot.latches[i].lock();
+      hot.pages[i].data[0]++;
+      hot.latches[i].unlock();
+      continue;
+    }
+
+    uint64_t version = 0;
+    while (true) {
+      if (hot.latches[i].try_optimistic_read(version)) {
+        DoNotOptimize(read_page(hot.pages[i].data));
+        if (hot.latches[i].validate(version)) {
+          break;
+        }
+      }
+      conflicts++;
+    }
+  }
+  state.counters["reads"]     = Counter(state.iterations(), Counter::kIsRate);
+  state.counters["conflicts"] = Counter(conflicts);
+}
+
+BENCHMARK(SharedLatch)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+BENCHMARK(OptimisticRead)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+BENCHMARK(StdSharedMutex)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+BENCHMARK(OptimisticReadWithWriter)->ThreadRange(2, MAX_THREADS)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
+BENCHMARK_MAIN();
@@ -0,0 +1,196 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/page_io.h"
+#include "common/io/io.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 对比几种页面读写方式的吞吐量
+ * @details 每次迭代顺序读写 BATCH_PAGES 个页面，整个文件读写完后再从头开始。
+ * 参数表示读写方式：
+ * 0: lseek + read/write，每个页面两次系统调用
+ * 1: pread/pwrite，每个页面一次系统调用
+ * 2: preadv/pwritev，BATCH_PAGES 个页面一次系统调用
+ * 3: 和 2 一样合并页面，使用 io_uring 引擎提交
+ */
+class PageIOBenchmark : public Fixture
+{
+public:
+  static constexpr int FILE_PAGES  = 4096;
+  static constexpr int BATCH_PAGES = 32;
+
+  string Name() const { return "page_io"; }
+
+  void SetUp(const State &state) override
+  {
+    string log_name  = this->Name() + ".log";
+    string file_name = this->Name() + ".data";
+    LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_INFO);
+
+    ::remove(file_name.c_str());
+    fd_ = ::open(file_name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    if (fd_ < 0) {
+      throw runtime_error("failed to create data file");
+    }
+
+    pages_.reset(new Page[BATCH_PAGES]);
+    memset(pages_.get(), 0, sizeof(Page) * BATCH_PAGES);
+    for (int i = 0; i < FILE_PAGES; i += BATCH_PAGES) {
+      if (writen(fd_, pages_.get(), sizeof(Page) * BATCH_PAGES) != 0) {
+        throw runtime_error("failed to init data file");
+      }
+    }
+    next_page_ = 0;
+
+    if (page_io_.init(state.range(0) == 3 ? "io_uring" : "sync") != RC::SUCCESS) {
+      throw runtime_error("failed to init page io");
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    string file_name = this->Name() + ".data";
+    ::close(fd_);
+    fd_ = -1;
+    pages_.reset();
+    ::remove(file_name.c_str());
+  }
+
+  /**
+   * @brief 下一批要读写的页面
+   */
+  PageNum next_batch()
+  {
+    PageNum start_page = next_page_;
+    next_page_         = (next_page_ + BATCH_PAGES) % FILE_PAGES;
+    for (int i = 0; i < BATCH_PAGES; i++) {
+      pages_[i].page_num = start_page + i;
+    }
+    return start_page;
+  }
+
+  RC read_batch(int method, PageNum start_page)
+  {
+    switch (method) {
+      case 0: {
+        for (int i = 0; i < BATCH_PAGES; i++) {
+          if (lseek(fd_, static_cast<off_t>(start_page + i) * BP_PAGE_SIZE, SEEK_SET) == -1 ||
+              readn(fd_, &pages_[i], BP_PAGE_SIZE) != 0) {
+            return RC::IOERR_READ;
+          }
+        }
+      } break;
+      case 1: {
+        for (int i = 0; i < BATCH_PAGES; i++) {
+          RC rc = page_io_.read_page(fd_, start_page + i, pages_[i]);
+          if (rc != RC::SUCCESS) {
+            return rc;
+          }
+        }
+      } break;
+      default: {
+        Page *pages[BATCH_PAGES];
+        for (int i = 0; i < BATCH_PAGES; i++) {
+          pages[i] = &pages_[i];
+        }
+        return page_io_.read_pages(fd_, start_page, pages, BATCH_PAGES);
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  RC write_batch(int method)
+  {
+    switch (method) {
+      case 0: {
+        for (int i = 0; i < BATCH_PAGES; i++) {
+          if (lseek(fd_, static_cast<off_t>(pages_[i].page_num) * BP_PAGE_SIZE, SEEK_SET) == -1 ||
+              writen(fd_, &pages_[i], BP_PAGE_SIZE) != 0) {
+            return RC::IOERR_WRITE;
+          }
+        }
+      } break;
+      case 1: {
+        for (int i = 0; i < BATCH_PAGES; i++) {
+          RC rc = page_io_.write_page(fd_, pages_[i]);
+          if (rc != RC::SUCCESS) {
+            return rc;
+          }
+        }
+      } break;
+      default: {
+        const Page *pages[BATCH_PAGES];
+        for (int i = 0; i < BATCH_PAGES; i++) {
+          pages[i] = &pages_[i];
+        }
+        return page_io_.write_pages(fd_, pages, BATCH_PAGES);
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+protected:
+  int                fd_ = -1;
+  unique_ptr<Page[]> pages_;
+  PageNum            next_page_ = 0;
+  BPPageIO           page_io_;
+};
+
+BENCHMARK_DEFINE_F(PageIOBenchmark, Read)(State &state)
+{
+  const int method = static_cast<int>(state.range(0));
+  int64_t   pages  = 0;
+  for (auto _ : state) {
+    if (read_batch(method, next_batch()) != RC::SUCCESS) {
+      state.SkipWithError("failed to read pages");
+      break;
+    }
+    pages += BATCH_PAGES;
+  }
+  state.counters["pages"] = Counter(pages, Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(PageIOBenchmark, Write)(State &state)
+{
+  const int method = static_cast<int>(state.range(0));
+  int64_t   pages  = 0;
+  for (auto _ : state) {
+    next_batch();
+    if (write_batch(method) != RC::SUCCESS) {
+      state.SkipWithError("failed to write pages");
+      break;
+    }
+    pages += BATCH_PAGES;
+  }
+  state.counters["pages"] = Counter(pages, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(PageIOBenchmark, Read)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+BENCHMARK_REGISTER_F(PageIOBenchmark, Write)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+////////////////////////////////////////////////////////////////////////////////
+
+BENCHMARK_MAIN();
@@ -254,6 +254,42 @@ BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * 插入吞吐随线程数的变化。每个线程有自己的插入目标页面，线程数增加时吞吐应该跟着增加，
+ * 而不是都竞争同一个页面的写锁。pages 是插入结束时文件的页面数，每个线程最多多占用一个没有填满的页面
+ */
+struct InsertionScalingBenchmark : public BenchmarkBase
+{
+  string Name() const override { return "insertion_scaling"; }
+};
+
+BENCHMARK_DEFINE_F(InsertionScalingBenchmark, InsertionScaling)(State &state)
+{
+  IntegerGenerator generator(1, 1 << 31);
+  Stat             stat;
+
+  RID rid;
+  for (auto _ : state) {
+    Insert(generator.next(), stat, rid);
+  }
+
+  state.counters["success"] = Counter(stat.insert_success_count, Counter::kIsRate);
+  state.counters["other"]   = Counter(stat.insert_other_count, Counter::kIsRate);
+  if (0 == state.thread_index()) {
+    state.counters["pages"] = Counter(buffer_pool_->page_count());
+  }
+}
+
+BENCHMARK_REGISTER_F(InsertionScalingBenchmark, InsertionScaling)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
 class DeletionBenchmark : public BenchmarkBase
 {
 public:
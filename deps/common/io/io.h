@@ -67,6 +67,18 @@ int getFileSize(const char *filePath, uint64_t &fileLen);
  */
 int writen(int fd, const void *buf, int size);
 
+/**
+ * @brief 在文件指定的位置一次性写入指定长度的数据
+ * @details 不会修改文件的读写位置，多个线程可以同时在同一个文件描述符上写不同的位置
+ *
+ * @param fd  写入的描述符
+ * @param buf 写入的数据
+ * @param size 写入多少数据
+ * @param offset 写入的位置
+ * @return int 0 表示成功，否则返回errno
+ */
+int pwriten(int fd, const void *buf, int size, int64_t offset);
+
 /**
  * @brief 一次性读取指定长度的数据
  * 
@@ -77,4 +89,16 @@ int writen(int fd, const void *buf, int size);
  */
 int readn(int fd, void *buf, int size);
 
+/**
+ * @brief 从文件指定的位置一次性读取指定长度的数据
+ * @details 不会修改文件的读写位置
+ *
+ * @param fd  读取的描述符
+ * @param buf 读取到这里
+ * @param size 读取的数据长度
+ * @param offset 读取的位置
+ * @return int 返回0表示成功。-1 表示读取到文件尾，并且没有读到size大小数据，其它表示errno
+ */
+int preadn(int fd, void *buf, int size, int64_t offset);
+
 }  // namespace common
@@ -12,33 +12,71 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2021/5/7.
 //
 
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
 #include "common/lang/bitmap.h"
 
 namespace common {
 
-int find_first_zero(char byte, int start)
+int bytes(int size)
 {
-  for (int i = start; i < 8; i++) {
-    if ((byte & (1 << i)) == 0) {
-      return i;
-    }
-  }
-  return -1;
+  return size % 8 == 0 ? size / 8 : size / 8 + 1;
+}
+
+static int words(int size)
+{
+  return (size + 63) / 64;
 }
 
-int find_first_setted(char byte, int start)
+/**
+ * @brief 读取位图中的第 word_index 个64位字，超出位图的部分是0
+ * @details 第i位在第i/8个字节的第i%8位，按照小端拼接以后正好是字中的第i%64位。位图不一定按照8字节对齐，使用memcpy读取
+ */
+static uint64_t load_word(const char *bitmap, int size, int word_index)
 {
-  for (int i = start; i < 8; i++) {
-    if ((byte & (1 << i)) != 0) {
-      return i;
+  const int begin_byte = word_index * 8;
+  const int byte_num   = std::min(8, bytes(size) - begin_byte);
+  uint64_t  word       = 0;
+  if (byte_num == 8) {
+    memcpy(&word, bitmap + begin_byte, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+  } else {
+    for (int i = 0; i < byte_num; i++) {
+      word |= static_cast<uint64_t>(static_cast<uint8_t>(bitmap[begin_byte + i])) << (i * 8);
     }
   }
-  return -1;
+  return word;
 }
 
-int bytes(int size)
+/**
+ * @brief 从start开始查找第一个是1的位。invert为true时查找是0的位
+ */
+static int find_next_bit(const char *bitmap, int size, int start, bool invert)
 {
-  return size % 8 == 0 ? size / 8 : size / 8 + 1;
+  if (start < 0) {
+    start = 0;
+  }
+  if (start >= size) {
+    return -1;
+  }
+
+  const uint64_t flip       = invert ? ~0ULL : 0ULL;
+  const int      word_count = words(size);
+  int            word_index = start / 64;
+  uint64_t       word       = (load_word(bitmap, size, word_index) ^ flip) & (~0ULL << (start % 64));
+  while (word == 0) {
+    if (++word_index >= word_count) {
+      return -1;
+    }
+    word = load_word(bitmap, size, word_index) ^ flip;
+  }
+
+  const int index = word_index * 64 + __builtin_ctzll(word);
+  return index < size ? index : -1;
 }
 
 Bitmap::Bitmap() : bitmap_(nullptr), size_(0)
@@ -70,50 +108,22 @@ void Bitmap::clear_bit(int index)
   bits &= ~(1 << (index % 8));
 }
 
-int Bitmap::next_unsetted_bit(int start)
-{
-  int ret = -1;
-  int start_in_byte = start % 8;
-  for (int iter = start / 8, end = bytes(size_); iter < end; iter++) {
-    char byte = bitmap_[iter];
-    if (byte != -1) {
-      int index_in_byte = find_first_zero(byte, start_in_byte);
-      if (index_in_byte >= 0) {
-        ret = iter * 8 + index_in_byte;
-        break;
-      }
-
-      start_in_byte = 0;
-    }
-  }
+int Bitmap::next_unsetted_bit(int start) { return find_next_bit(bitmap_, size_, start, true /*invert*/); }
 
-  if (ret >= size_) {
-    ret = -1;
-  }
-  return ret;
-}
+int Bitmap::next_setted_bit(int start) { return find_next_bit(bitmap_, size_, start, false /*invert*/); }
 
-int Bitmap::next_setted_bit(int start)
+int Bitmap::count_setted_bits()
 {
-  int ret = -1;
-  int start_in_byte = start % 8;
-  for (int iter = start / 8, end = bytes(size_); iter < end; iter++) {
-    char byte = bitmap_[iter];
-    if (byte != 0x00) {
-      int index_in_byte = find_first_setted(byte, start_in_byte);
-      if (index_in_byte >= 0) {
-        ret = iter * 8 + index_in_byte;
-        break;
-      }
-
-      start_in_byte = 0;
+  const int word_count = words(size_);
+  int       count      = 0;
+  for (int i = 0; i < word_count; i++) {
+    uint64_t word = load_word(bitmap_, size_, i);
+    if (i == word_count - 1 && size_ % 64 != 0) {
+      word &= (1ULL << (size_ % 64)) - 1;
     }
+    count += __builtin_popcountll(word);
   }
-
-  if (ret >= size_) {
-    ret = -1;
-  }
-  return ret;
+  return count;
 }
 
 }  // namespace common
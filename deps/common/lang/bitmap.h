@@ -27,11 +27,18 @@ public:
   void clear_bit(int index);
 
   /**
+   * @brief 查找下一个是0或1的位，每次比较64位
    * @param start 从哪个位开始查找，start是包含在内的
+   * @return 找不到时返回-1
    */
   int next_unsetted_bit(int start);
   int next_setted_bit(int start);
 
+  /**
+   * @brief 是1的位的个数
+   */
+  int count_setted_bits();
+
 private:
   char *bitmap_;
   int size_;
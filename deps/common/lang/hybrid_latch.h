@@ -0,0 +1,184 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief 支持乐观读的读写锁
+ * @details 一个64位的状态同时记录版本号、写锁和读锁个数：
+ * - 低31位是持有读锁的个数
+ * - 第31位表示有人持有(或者正在等待)写锁
+ * - 高32位是版本号，每次释放写锁时加一
+ *
+ * 乐观读不修改状态，只记下开始时的版本号，读完以后校验版本号没有变化、期间也没有人加写锁，
+ * 校验通过说明读到的数据是一致的，否则需要重试。乐观读的时候数据可能正在被修改，读到的内容
+ * 只能在校验通过以后使用，读取过程中也不能信任里面的指针、长度等信息。
+ * 读多写少的页面上，乐观读不会写共享的缓存行，多核并发读取时没有缓存行的争抢。
+ *
+ * 需要长时间持有页面时使用读锁(共享)或写锁(排他)。写锁优先：设置写锁标记以后，其它线程新的读锁和
+ * 乐观读都会失败或者等待，写者再等已经持有读锁的线程释放。等待时先自旋，再让出CPU。
+ *
+ * 读锁可以在同一个线程上重入(比如自连接时两个扫描读同一个页面)：每个线程记录自己持有的读锁和次数，
+ * 只有第一次加锁和最后一次释放时修改状态，重入时不会被等待中的写者挡住。因此读锁必须在加锁的线程上释放。
+ * 写锁不可重入，持有读锁时也不能再加写锁。
+ */
+class HybridLatch final
+{
+public:
+  HybridLatch() = default;
+  ~HybridLatch() = default;
+
+  HybridLatch(const HybridLatch &) = delete;
+  HybridLatch &operator=(const HybridLatch &) = delete;
+
+  /**
+   * @brief 开始乐观读
+   * @param[out] version 当前的版本号，读完以后交给 validate 校验
+   * @return 有人持有写锁时返回 false，这时不能乐观读
+   */
+  bool try_optimistic_read(uint64_t &version) const
+  {
+    const uint64_t state = state_.load(std::memory_order_acquire);
+    if (state & EXCLUSIVE_BIT) {
+      return false;
+    }
+    version = state >> VERSION_SHIFT;
+    return true;
+  }
+
+  /**
+   * @brief 校验乐观读期间没有发生过修改
+   */
+  bool validate(uint64_t version) const
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t state = state_.load(std::memory_order_relaxed);
+    return (state & EXCLUSIVE_BIT) == 0 && (state >> VERSION_SHIFT) == version;
+  }
+
+  void lock_shared()
+  {
+    for (int spin = 0; !try_lock_shared(); spin++) {
+      backoff(spin);
+    }
+  }
+
+  bool try_lock_shared()
+  {
+    // 当前线程已经持有读锁，写者不可能拿到锁，直接重入
+    for (auto &held : held_shared_latches_) {
+      if (held.first == this) {
+        held.second++;
+        return true;
+      }
+    }
+
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    while ((state & EXCLUSIVE_BIT) == 0) {
+      if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        held_shared_latches_.emplace_back(this, 1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void unlock_shared()
+  {
+    for (auto iter = held_shared_latches_.begin(); iter != held_shared_latches_.end(); ++iter) {
+      if (iter->first == this) {
+        if (--iter->second > 0) {
+          return;
+        }
+        held_shared_latches_.erase(iter);
+        break;
+      }
+    }
+    state_.fetch_sub(1, std::memory_order_release);
+  }
+
+  void lock()
+  {
+    // 先抢到写锁标记，挡住新来的读者，再等已有的读者退出
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    for (int spin = 0;; spin++) {
+      if ((state & EXCLUSIVE_BIT) == 0 &&
+          state_.compare_exchange_weak(
+              state, state | EXCLUSIVE_BIT, std::memory_order_acquire, std::memory_order_relaxed)) {
+        break;
+      }
+      backoff(spin);
+      state = state_.load(std::memory_order_relaxed);
+    }
+
+    for (int spin = 0; (state_.load(std::memory_order_acquire) & SHARED_MASK) != 0; spin++) {
+      backoff(spin);
+    }
+  }
+
+  bool try_lock()
+  {
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    if ((state & (EXCLUSIVE_BIT | SHARED_MASK)) != 0) {
+      return false;
+    }
+    return state_.compare_exchange_strong(
+        state, state | EXCLUSIVE_BIT, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 释放写锁，同时增加版本号，让期间开始的乐观读校验失败
+   */
+  void unlock() { state_.fetch_add(VERSION_UNIT - EXCLUSIVE_BIT, std::memory_order_release); }
+
+  uint64_t version() const { return state_.load(std::memory_order_relaxed) >> VERSION_SHIFT; }
+  bool     is_locked() const { return (state_.load(std::memory_order_relaxed) & EXCLUSIVE_BIT) != 0; }
+  int      shared_count() const { return static_cast<int>(state_.load(std::memory_order_relaxed) & SHARED_MASK); }
+
+private:
+  static void backoff(int spin)
+  {
+    if (spin < SPIN_COUNT) {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#elif defined(__aarch64__)
+      asm volatile("yield");
+#endif
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  static constexpr int      SPIN_COUNT    = 64;
+  static constexpr int      VERSION_SHIFT = 32;
+  static constexpr uint64_t SHARED_MASK   = (1UL << 31) - 1;
+  static constexpr uint64_t EXCLUSIVE_BIT = 1UL << 31;
+  static constexpr uint64_t VERSION_UNIT  = 1UL << VERSION_SHIFT;
+
+  std::atomic<uint64_t> state_{0};
+
+  /// 当前线程持有的读锁和重入的次数。一个线程同时持有的读锁很少，直接遍历
+  static inline thread_local std::vector<std::pair<const HybridLatch *, int>> held_shared_latches_;
+};
+
+}  // namespace common
@@ -29,7 +29,7 @@ public:
   }
 
 protected:
-  Snapshot *snapshot_value_;
+  Snapshot *snapshot_value_ = nullptr;
 };
 
 }  // namespace common
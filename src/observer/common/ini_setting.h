@@ -25,3 +25,25 @@ See the Mulan PSL v2 for more details. */
 #define SOCKET_BUFFER_SIZE 8192
 
 #define SESSION_STAGE_NAME "SessionStage"
+
+//! buffer pool
+#define BUFFER_POOL "BUFFER_POOL"
+#define FRAME_SHARD_NUM "FRAME_SHARD_NUM"
+#define FRAME_SHARD_NUM_DEFAULT 0
+#define FRAME_REPLACER "REPLACER"
+#define FRAME_REPLACER_DEFAULT "lru"
+#define SCAN_RING_SIZE "SCAN_RING_SIZE"
+#define SCAN_RING_SIZE_DEFAULT 32
+#define READ_AHEAD_MAX_PAGES "READ_AHEAD_MAX_PAGES"
+#define READ_AHEAD_MAX_PAGES_DEFAULT 64
+#define CLEAN_FRAME_TARGET "CLEAN_FRAME_TARGET"
+#define PAGE_CLEANER_BATCH_SIZE "PAGE_CLEANER_BATCH_SIZE"
+#define PAGE_CLEANER_INTERVAL_MS "PAGE_CLEANER_INTERVAL_MS"
+#define IO_ENGINE "IO_ENGINE"
+#define TABLE_PAGE_SIZE "TABLE_PAGE_SIZE"
+#define INDEX_PAGE_SIZE "INDEX_PAGE_SIZE"
+#define WARM_UP_FILE "WARM_UP_FILE"
+#define WARM_UP_THREADS "WARM_UP_THREADS"
+#define WARM_UP_DUMP_INTERVAL_SEC "WARM_UP_DUMP_INTERVAL_SEC"
+#define USE_HUGE_PAGES "USE_HUGE_PAGES"
+#define DIRECT_IO "DIRECT_IO"
@@ -151,9 +151,107 @@ int prepare_init_seda()
   return 0;
 }
 
+void init_buffer_pool_options(Ini &properties, BufferPoolOptions &options)
+{
+  options.frame_shard_num = FRAME_SHARD_NUM_DEFAULT;
+  options.replacer        = FRAME_REPLACER_DEFAULT;
+  options.scan_ring_size  = SCAN_RING_SIZE_DEFAULT;
+  options.read_ahead_max_pages = READ_AHEAD_MAX_PAGES_DEFAULT;
+
+  std::map<std::string, std::string> bp_section = properties.get(BUFFER_POOL);
+  std::map<std::string, std::string>::iterator it = bp_section.find(FRAME_SHARD_NUM);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.frame_shard_num);
+  }
+
+  it = bp_section.find(FRAME_REPLACER);
+  if (it != bp_section.end()) {
+    options.replacer = it->second;
+  }
+
+  it = bp_section.find(SCAN_RING_SIZE);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.scan_ring_size);
+  }
+
+  it = bp_section.find(READ_AHEAD_MAX_PAGES);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.read_ahead_max_pages);
+  }
+
+  it = bp_section.find(CLEAN_FRAME_TARGET);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.clean_frame_target);
+  }
+
+  it = bp_section.find(PAGE_CLEANER_BATCH_SIZE);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.page_cleaner_batch_size);
+  }
+
+  it = bp_section.find(PAGE_CLEANER_INTERVAL_MS);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.page_cleaner_interval_ms);
+  }
+
+  it = bp_section.find(IO_ENGINE);
+  if (it != bp_section.end()) {
+    options.io_engine = it->second;
+  }
+
+  it = bp_section.find(TABLE_PAGE_SIZE);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.table_page_size);
+  }
+
+  it = bp_section.find(INDEX_PAGE_SIZE);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.index_page_size);
+  }
+
+  it = bp_section.find(WARM_UP_FILE);
+  if (it != bp_section.end()) {
+    options.warm_up_file = it->second;
+  }
+
+  it = bp_section.find(WARM_UP_THREADS);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.warm_up_threads);
+  }
+
+  it = bp_section.find(WARM_UP_DUMP_INTERVAL_SEC);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.warm_up_dump_interval_s);
+  }
+
+  it = bp_section.find(USE_HUGE_PAGES);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.use_huge_pages);
+  }
+
+  it = bp_section.find(DIRECT_IO);
+  if (it != bp_section.end()) {
+    str_to_val(it->second, options.direct_io);
+  }
+
+  LOG_INFO("buffer pool options: frame shard num=%d, replacer=%s, scan ring size=%d, read ahead max pages=%d, "
+      "clean frame target=%d, page cleaner batch size=%d, page cleaner interval=%dms, io engine=%s, "
+      "table page size=%d, index page size=%d, warm up file=%s, warm up threads=%d, warm up dump interval=%ds, "
+      "use huge pages=%d, direct io=%d",
+      options.frame_shard_num, options.replacer.c_str(), options.scan_ring_size, options.read_ahead_max_pages,
+      options.clean_frame_target,
+      options.page_cleaner_batch_size, options.page_cleaner_interval_ms, options.io_engine.c_str(),
+      options.table_page_size, options.index_page_size,
+      options.warm_up_file.c_str(), options.warm_up_threads, options.warm_up_dump_interval_s,
+      options.use_huge_pages, options.direct_io);
+}
+
 int init_global_objects(ProcessParam *process_param, Ini &properties)
 {
-  GCTX.buffer_pool_manager_ = new BufferPoolManager();
+  BufferPoolOptions bp_options;
+  init_buffer_pool_options(properties, bp_options);
+
+  GCTX.buffer_pool_manager_ = new BufferPoolManager(bp_options);
   BufferPoolManager::set_instance(GCTX.buffer_pool_manager_);
 
   GCTX.handler_ = new DefaultHandler();
@@ -173,11 +271,23 @@ int init_global_objects(ProcessParam *process_param, Ini &properties)
     LOG_ERROR("failed to init handler. rc=%s", strrc(rc));
     return -1;
   }
+
+  // 所有的表都已经打开，在后台预热，不影响接受连接
+  rc = GCTX.buffer_pool_manager_->start_warm_up();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start buffer pool warm up. rc=%s", strrc(rc));
+  }
   return ret;
 }
 
 int uninit_global_objects()
 {
+  // 关闭表之前保存内存中的页面列表，下次启动时预热
+  BufferPoolManager *bpm = &BufferPoolManager::instance();
+  if (bpm != nullptr) {
+    bpm->stop_warm_up();
+  }
+
   // TODO use global context
   DefaultHandler *default_handler = &DefaultHandler::get_default();
   if (default_handler != nullptr) {
@@ -185,7 +295,6 @@ int uninit_global_objects()
     delete default_handler;
   }
 
-  BufferPoolManager *bpm = &BufferPoolManager::instance();
   if (bpm != nullptr) {
     BufferPoolManager::set_instance(nullptr);
     delete bpm;
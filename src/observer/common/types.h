@@ -25,3 +25,14 @@ using SlotNum = int32_t;
 
 /// LSN for log sequence number
 using LSN = int32_t;
+
+/**
+ * @brief 数据文件中记录的存放格式，每张表在创建时确定，记录在表的元数据中
+ * @details 参考 RecordPageHandler 和 RecordLayout
+ */
+enum class StorageFormat
+{
+  FIXED_FORMAT,    ///< 定长格式，页面上用位图管理定长的槽位，记录按照内存中的格式存放
+  SLOTTED_FORMAT,  ///< 变长格式，页面上有槽位目录，记录编码以后按照实际长度存放
+  PAX_FORMAT,      ///< 列分组格式，页面内每个字段的值连续存放在一个小页中，参考 PaxPage
+};
@@ -236,6 +236,21 @@ RC PlainCommunicator::write_result_internal(SessionEvent *event, bool &need_disc
         }
       }
 
+      OverflowReader reader;
+      rc = tuple->cell_reader_at(i, reader);
+      if (rc == RC::SUCCESS) {
+        rc = write_cell_stream(reader);
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to send data to client. rc=%s, err=%s", strrc(rc), strerror(errno));
+          sql_result->close();
+          return rc;
+        }
+        continue;
+      } else if (rc != RC::UNIMPLENMENT) {
+        sql_result->close();
+        return rc;
+      }
+
       Value value;
       rc = tuple->cell_at(i, value);
       if (rc != RC::SUCCESS) {
@@ -293,4 +308,25 @@ RC PlainCommunicator::write_result_internal(SessionEvent *event, bool &need_disc
   }
 
   return rc;
-}
\ No newline at end of file
+}
+
+RC PlainCommunicator::write_cell_stream(OverflowReader &reader)
+{
+  char buf[4096];
+  while (reader.remain() > 0) {
+    int read_len = 0;
+    RC  rc       = reader.read(buf, sizeof(buf), read_len);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (read_len == 0) {
+      break;
+    }
+
+    rc = writer_->writen(buf, read_len);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -18,6 +18,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "net/communicator.h"
 
+class OverflowReader;
+
 /**
  * @brief 与客户端进行通讯
  * @ingroup Communicator
@@ -37,6 +39,11 @@ private:
   RC write_debug(SessionEvent *event, bool &need_disconnect);
   RC write_result_internal(SessionEvent *event, bool &need_disconnect);
 
+  /**
+   * @brief 把一个大字段的值一段一段地发送出去，不需要把整个值都读到内存中
+   */
+  RC write_cell_stream(OverflowReader &reader);
+
 protected:
   std::vector<char> send_message_delimiter_; ///< 发送消息分隔符
   std::vector<char> debug_message_prefix_; ///< 调试信息前缀
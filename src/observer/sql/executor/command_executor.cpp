@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/executor/desc_table_executor.h"
 #include "sql/executor/help_executor.h"
 #include "sql/executor/show_tables_executor.h"
+#include "sql/executor/show_buffer_pool_status_executor.h"
 #include "sql/executor/trx_begin_executor.h"
 #include "sql/executor/trx_end_executor.h"
 #include "sql/executor/set_variable_executor.h"
@@ -56,6 +57,11 @@ RC CommandExecutor::execute(SQLStageEvent *sql_event)
       return executor.execute(sql_event);
     }
 
+    case StmtType::SHOW_BUFFER_POOL_STATUS: {
+      ShowBufferPoolStatusExecutor executor;
+      return executor.execute(sql_event);
+    }
+
     case StmtType::BEGIN: {
       TrxBeginExecutor executor;
       return executor.execute(sql_event);
@@ -21,6 +21,11 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+/**
+ * 导入数据时每一批插入多少条记录
+ */
+static constexpr int LOAD_BATCH_SIZE = 1000;
+
 RC LoadDataExecutor::execute(SQLStageEvent *sql_event)
 {
   RC rc = RC::SUCCESS;
@@ -33,17 +38,19 @@ RC LoadDataExecutor::execute(SQLStageEvent *sql_event)
 }
 
 /**
- * 从文件中导入数据时使用。尝试向表中插入解析后的一行数据。
+ * 从文件中导入数据时使用。把解析后的一行数据组装成一条记录。
  * @param table  要导入的表
  * @param file_values 从文件中读取到的一行数据，使用分隔符拆分后的几个字段值
- * @param record_values Table::insert_record使用的参数，为了防止频繁的申请内存
+ * @param record_values Table::make_record使用的参数，为了防止频繁的申请内存
+ * @param record 生成的记录
  * @param errmsg 如果出现错误，通过这个参数返回错误信息
  * @return 成功返回RC::SUCCESS
  */
-RC insert_record_from_file(Table *table, 
-                           std::vector<std::string> &file_values, 
-                           std::vector<Value> &record_values, 
-                           std::stringstream &errmsg)
+RC make_record_from_file(Table *table, 
+                         std::vector<std::string> &file_values, 
+                         std::vector<Value> &record_values, 
+                         Record &record,
+                         std::stringstream &errmsg)
 {
 
   const int field_num = record_values.size();
@@ -60,7 +67,7 @@ RC insert_record_from_file(Table *table,
     const FieldMeta *field = table->table_meta().field(i + sys_field_num);
 
     std::string &file_value = file_values[i];
-    if (field->type() != CHARS) {
+    if (attr_value_type(field->type()) != CHARS) {
       common::strip(file_value);
     }
 
@@ -94,7 +101,9 @@ RC insert_record_from_file(Table *table,
           record_values[i].set_float(float_value);
         }
       } break;
-      case CHARS: {
+      case CHARS:
+      case VARCHARS:
+      case TEXTS: {
         record_values[i].set_string(file_value.c_str());
       } break;
       default: {
@@ -105,17 +114,35 @@ RC insert_record_from_file(Table *table,
   }
 
   if (RC::SUCCESS == rc) {
-    Record record;
     rc = table->make_record(field_num, record_values.data(), record);
     if (rc != RC::SUCCESS) {
       errmsg << "insert failed.";
-    } else if (RC::SUCCESS != (rc = table->insert_record(record))) {
-      errmsg << "insert failed.";
     }
   }
   return rc;
 }
 
+/**
+ * 从文件中导入数据时使用。尝试向表中插入解析后的一行数据。
+ * @param table  要导入的表
+ * @param file_values 从文件中读取到的一行数据，使用分隔符拆分后的几个字段值
+ * @param record_values Table::make_record使用的参数，为了防止频繁的申请内存
+ * @param errmsg 如果出现错误，通过这个参数返回错误信息
+ * @return 成功返回RC::SUCCESS
+ */
+RC insert_record_from_file(Table *table, 
+                           std::vector<std::string> &file_values, 
+                           std::vector<Value> &record_values, 
+                           std::stringstream &errmsg)
+{
+  Record record;
+  RC rc = make_record_from_file(table, file_values, record_values, record, errmsg);
+  if (RC::SUCCESS == rc && RC::SUCCESS != (rc = table->insert_record(record))) {
+    errmsg << "insert failed.";
+  }
+  return rc;
+}
+
 void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult *sql_result)
 {
   std::stringstream result_string;
@@ -140,6 +167,42 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
   const std::string delim("|");
   int line_num = 0;
   int insertion_count = 0;
+
+  // 解析出来的记录先攒成一批再插入。Record 没有移动构造函数，提前预留空间，防止扩容时拷贝
+  std::vector<Record> records;
+  std::vector<std::vector<std::string>> batch_values;
+  std::vector<int> batch_lines;
+  records.reserve(LOAD_BATCH_SIZE);
+  batch_values.reserve(LOAD_BATCH_SIZE);
+  batch_lines.reserve(LOAD_BATCH_SIZE);
+
+  auto flush_batch = [&]() {
+    if (records.empty()) {
+      return RC::SUCCESS;
+    }
+
+    RC rc = table->insert_records(records);
+    if (RC::SUCCESS == rc) {
+      insertion_count += static_cast<int>(records.size());
+    } else {
+      // 整批都没有插入，逐行重新插入，找到出错的那一行
+      for (size_t i = 0; i < batch_values.size(); i++) {
+        std::stringstream errmsg;
+        rc = insert_record_from_file(table, batch_values[i], record_values, errmsg);
+        if (rc != RC::SUCCESS) {
+          result_string << "Line:" << batch_lines[i] << " insert record failed:" << errmsg.str()
+                        << ". error:" << strrc(rc) << std::endl;
+          break;
+        }
+        insertion_count++;
+      }
+    }
+    records.clear();
+    batch_values.clear();
+    batch_lines.clear();
+    return rc;
+  };
+
   RC rc = RC::SUCCESS;
   while (!fs.eof() && RC::SUCCESS == rc) {
     std::getline(fs, line);
@@ -151,14 +214,27 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
     file_values.clear();
     common::split_string(line, delim, file_values);
     std::stringstream errmsg;
-    rc = insert_record_from_file(table, file_values, record_values, errmsg);
+    records.emplace_back();
+    rc = make_record_from_file(table, file_values, record_values, records.back(), errmsg);
     if (rc != RC::SUCCESS) {
-      result_string << "Line:" << line_num << " insert record failed:" << errmsg.str() << ". error:" << strrc(rc)
-                    << std::endl;
-    } else {
-      insertion_count++;
+      records.pop_back();
+      // 出错之前的行仍然要导入
+      if (RC::SUCCESS == flush_batch()) {
+        result_string << "Line:" << line_num << " insert record failed:" << errmsg.str() << ". error:" << strrc(rc)
+                      << std::endl;
+      }
+      break;
+    }
+
+    batch_values.push_back(file_values);
+    batch_lines.push_back(line_num);
+    if (static_cast<int>(records.size()) >= LOAD_BATCH_SIZE) {
+      rc = flush_batch();
     }
   }
+  if (RC::SUCCESS == rc) {
+    rc = flush_batch();
+  }
   fs.close();
 
   struct timespec end_time;
@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/executor/sql_result.h"
 #include "session/session.h"
 #include "sql/stmt/set_variable_stmt.h"
+#include "storage/buffer/disk_buffer_pool.h"
 
 /**
  * @brief SetVariable语句执行器
@@ -49,14 +50,56 @@ public:
 
       session->set_sql_debug(bool_value);
       LOG_TRACE("set sql_debug to %d", bool_value);
+    } else if (strcasecmp(var_name, "buffer_pool_memory_size") == 0) {
+      // 全局变量，对所有会话生效
+      int64_t memory_size = 0;
+      rc = var_value_to_size(var_value, memory_size);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      rc = BufferPoolManager::instance().resize(memory_size);
+      if (rc != RC::SUCCESS) {
+        return RC::VARIABLE_NOT_VALID;
+      }
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
 
-    return RC::SUCCESS;
+    return rc;
   }
 
 private:
+  /**
+   * @brief 把变量值转换成字节数，字符串可以带单位 K、M 或 G，比如 '256M'
+   */
+  RC var_value_to_size(const Value &var_value, int64_t &size) const
+  {
+    if (var_value.attr_type() == AttrType::INTS) {
+      size = var_value.get_int();
+      return RC::SUCCESS;
+    }
+
+    if (var_value.attr_type() != AttrType::CHARS) {
+      return RC::VARIABLE_NOT_VALID;
+    }
+
+    const std::string str = var_value.get_string();
+    char *end = nullptr;
+    size = strtoll(str.c_str(), &end, 10);
+    if (end == str.c_str()) {
+      return RC::VARIABLE_NOT_VALID;
+    }
+
+    switch (*end) {
+      case 'g': case 'G': size <<= 10; [[fallthrough]];
+      case 'm': case 'M': size <<= 10; [[fallthrough]];
+      case 'k': case 'K': size <<= 10; end++; break;
+      default: break;
+    }
+    return *end == '\0' ? RC::SUCCESS : RC::VARIABLE_NOT_VALID;
+  }
+
   RC var_value_to_boolean(const Value &var_value, bool &bool_value) const
   {
     RC rc = RC::SUCCESS;
@@ -0,0 +1,48 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "sql/expr/tuple.h"
+#include "storage/table/table.h"
+
+RC RowTuple::cell_at(int index, Value &cell) const
+{
+  if (index < 0 || index >= static_cast<int>(speces_.size())) {
+    LOG_WARN("invalid argument. index=%d", index);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  FieldExpr *field_expr = speces_[index];
+  const FieldMeta *field_meta = field_expr->field().meta();
+  if (field_meta->type() == TEXTS) {
+    return table_->read_overflow_value(*field_meta, this->record_->data(), cell);
+  }
+
+  cell.set_type(field_meta->type());
+  cell.set_data(this->record_->data() + field_meta->offset(), field_meta->len());
+  return RC::SUCCESS;
+}
+
+RC RowTuple::cell_reader_at(int index, OverflowReader &reader) const
+{
+  if (index < 0 || index >= static_cast<int>(speces_.size())) {
+    LOG_WARN("invalid argument. index=%d", index);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const FieldMeta *field_meta = speces_[index]->field().meta();
+  if (field_meta->type() != TEXTS) {
+    return RC::UNIMPLENMENT;
+  }
+  return table_->open_overflow_reader(*field_meta, this->record_->data(), reader);
+}
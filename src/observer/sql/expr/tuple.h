@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/value.h"
 #include "sql/expr/expression.h"
 #include "storage/record/record.h"
+#include "storage/record/overflow_page.h"
 
 class Table;
 
@@ -108,6 +109,28 @@ public:
    */
   virtual RC find_cell(const TupleCellSpec &spec, Value &cell) const = 0;
 
+  /**
+   * @brief 以流的方式读取指定位置的Cell
+   * @details 大字段(TEXTS)的值可能很长，返回给客户端时可以一段一段地从溢出页面中读取，不用放到一个Value中。
+   * 只有大字段支持流式读取，其它的Cell返回 RC::UNIMPLENMENT，调用者再使用 cell_at 获取
+   *
+   * @param index 位置
+   * @param[out] reader 返回的读取器
+   */
+  virtual RC cell_reader_at(int index, OverflowReader &reader) const
+  {
+    return RC::UNIMPLENMENT;
+  }
+
+  /**
+   * @brief 根据cell的描述，获取cell的流式读取器
+   * @details 找不到cell时返回 RC::NOTFOUND，不支持流式读取时返回 RC::UNIMPLENMENT
+   */
+  virtual RC find_cell_reader(const TupleCellSpec &spec, OverflowReader &reader) const
+  {
+    return RC::UNIMPLENMENT;
+  }
+
   virtual std::string to_string() const
   {
     std::string str;
@@ -164,36 +187,29 @@ public:
     return speces_.size();
   }
 
-  RC cell_at(int index, Value &cell) const override
-  {
-    if (index < 0 || index >= static_cast<int>(speces_.size())) {
-      LOG_WARN("invalid argument. index=%d", index);
-      return RC::INVALID_ARGUMENT;
-    }
-
-    FieldExpr *field_expr = speces_[index];
-    const FieldMeta *field_meta = field_expr->field().meta();
-    cell.set_type(field_meta->type());
-    cell.set_data(this->record_->data() + field_meta->offset(), field_meta->len());
-    return RC::SUCCESS;
-  }
+  /**
+   * @details 大字段(TEXTS)的值在这里才从溢出页面中读取出来
+   */
+  RC cell_at(int index, Value &cell) const override;
 
   RC find_cell(const TupleCellSpec &spec, Value &cell) const override
   {
-    const char *table_name = spec.table_name();
-    const char *field_name = spec.field_name();
-    if (0 != strcmp(table_name, table_->name())) {
+    const int index = find_index(spec);
+    if (index < 0) {
       return RC::NOTFOUND;
     }
+    return cell_at(index, cell);
+  }
 
-    for (size_t i = 0; i < speces_.size(); ++i) {
-      const FieldExpr *field_expr = speces_[i];
-      const Field &field = field_expr->field();
-      if (0 == strcmp(field_name, field.field_name())) {
-        return cell_at(i, cell);
-      }
+  RC cell_reader_at(int index, OverflowReader &reader) const override;
+
+  RC find_cell_reader(const TupleCellSpec &spec, OverflowReader &reader) const override
+  {
+    const int index = find_index(spec);
+    if (index < 0) {
+      return RC::NOTFOUND;
     }
-    return RC::NOTFOUND;
+    return cell_reader_at(index, reader);
   }
 
 #if 0
@@ -218,6 +234,25 @@ public:
     return *record_;
   }
 
+private:
+  int find_index(const TupleCellSpec &spec) const
+  {
+    const char *table_name = spec.table_name();
+    const char *field_name = spec.field_name();
+    if (0 != strcmp(table_name, table_->name())) {
+      return -1;
+    }
+
+    for (size_t i = 0; i < speces_.size(); ++i) {
+      const FieldExpr *field_expr = speces_[i];
+      const Field &field = field_expr->field();
+      if (0 == strcmp(field_name, field.field_name())) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
 private:
   Record *record_ = nullptr;
   const Table *table_ = nullptr;
@@ -275,6 +310,24 @@ public:
     return tuple_->find_cell(spec, cell);
   }
 
+  RC cell_reader_at(int index, OverflowReader &reader) const override
+  {
+    if (index < 0 || index >= static_cast<int>(speces_.size())) {
+      return RC::INTERNAL;
+    }
+    if (tuple_ == nullptr) {
+      return RC::INTERNAL;
+    }
+
+    const TupleCellSpec *spec = speces_[index];
+    return tuple_->find_cell_reader(*spec, reader);
+  }
+
+  RC find_cell_reader(const TupleCellSpec &spec, OverflowReader &reader) const override
+  {
+    return tuple_->find_cell_reader(spec, reader);
+  }
+
 #if 0
   RC cell_spec_at(int index, const TupleCellSpec *&spec) const override
   {
@@ -420,6 +473,16 @@ public:
     return right_->find_cell(spec, value);
   }
 
+  RC find_cell_reader(const TupleCellSpec &spec, OverflowReader &reader) const override
+  {
+    RC rc = left_->find_cell_reader(spec, reader);
+    if (rc != RC::NOTFOUND) {
+      return rc;
+    }
+
+    return right_->find_cell_reader(spec, reader);
+  }
+
 private:
   Tuple *left_ = nullptr;
   Tuple *right_ = nullptr;
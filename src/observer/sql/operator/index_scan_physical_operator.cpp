@@ -70,10 +70,10 @@ RC IndexScanPhysicalOperator::next()
   RID rid;
   RC rc = RC::SUCCESS;
 
-  record_page_handler_.cleanup();
-
   bool filter_result = false;
   while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
+    // 过滤掉的记录也要释放页面，才能读取下一条
+    record_page_handler_.cleanup();
     rc = record_handler_->get_record(record_page_handler_, &rid, readonly_, &current_record_);
     if (rc != RC::SUCCESS) {
       return rc;
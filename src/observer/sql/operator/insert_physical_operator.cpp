@@ -19,22 +19,45 @@ See the Mulan PSL v2 for more details. */
 
 using namespace std;
 
-InsertPhysicalOperator::InsertPhysicalOperator(Table *table, vector<Value> &&values)
-    : table_(table), values_(std::move(values))
+InsertPhysicalOperator::InsertPhysicalOperator(Table *table, vector<vector<Value>> &&values_list)
+    : table_(table), values_list_(std::move(values_list))
 {}
 
 RC InsertPhysicalOperator::open(Trx *trx)
 {
-  Record record;
-  RC rc = table_->make_record(static_cast<int>(values_.size()), values_.data(), record);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to make record. rc=%s", strrc(rc));
+  if (values_list_.size() == 1) {
+    vector<Value> &values = values_list_.front();
+    Record record;
+    RC rc = table_->make_record(static_cast<int>(values.size()), values.data(), record);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to make record. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = trx->insert_record(table_, record);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to insert record by transaction. rc=%s", strrc(rc));
+    }
     return rc;
   }
 
-  rc = trx->insert_record(table_, record);
+  // Record 没有移动构造函数，一次构造出所有的记录，不要逐个添加
+  vector<Record> records(values_list_.size());
+  for (size_t i = 0; i < values_list_.size(); i++) {
+    vector<Value> &values = values_list_[i];
+    RC rc = table_->make_record(static_cast<int>(values.size()), values.data(), records[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to make record. row=%d, rc=%s", static_cast<int>(i), strrc(rc));
+      for (size_t j = 0; j < i; j++) {
+        table_->free_overflow_values(records[j].data());
+      }
+      return rc;
+    }
+  }
+
+  RC rc = trx->insert_records(table_, records);
   if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to insert record by transaction. rc=%s", strrc(rc));
+    LOG_WARN("failed to insert records by transaction. rc=%s", strrc(rc));
   }
   return rc;
 }
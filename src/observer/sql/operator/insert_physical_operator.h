@@ -23,11 +23,12 @@ class InsertStmt;
 /**
  * @brief 插入物理算子
  * @ingroup PhysicalOperator
+ * @details 一次插入多行时使用事务的批量插入接口
  */
 class InsertPhysicalOperator : public PhysicalOperator
 {
 public:
-  InsertPhysicalOperator(Table *table, std::vector<Value> &&values);
+  InsertPhysicalOperator(Table *table, std::vector<std::vector<Value>> &&values_list);
 
   virtual ~InsertPhysicalOperator() = default;
 
@@ -44,5 +45,5 @@ public:
 
 private:
   Table *table_ = nullptr;
-  std::vector<Value> values_;
+  std::vector<std::vector<Value>> values_list_;
 };
@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by WangYunlai on 2021/6/9.
 //
 
+#include <algorithm>
+
 #include "sql/operator/table_scan_physical_operator.h"
 #include "storage/table/table.h"
 #include "event/sql_debug.h"
@@ -20,7 +22,9 @@ using namespace std;
 
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
-  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_);
+  RC rc = table_->column_store() != nullptr
+              ? table_->get_column_scanner(column_scanner_, trx, readonly_, column_conditions_, columns_)
+              : table_->get_record_scanner(record_scanner_, trx, readonly_, zone_map_conditions_, columns_);
   if (rc == RC::SUCCESS) {
     tuple_.set_schema(table_, table_->table_meta().field_metas());
   }
@@ -28,16 +32,26 @@ RC TableScanPhysicalOperator::open(Trx *trx)
   return rc;
 }
 
+bool TableScanPhysicalOperator::scanner_has_next()
+{
+  return table_->column_store() != nullptr ? column_scanner_.has_next() : record_scanner_.has_next();
+}
+
+RC TableScanPhysicalOperator::scanner_next(Record &record)
+{
+  return table_->column_store() != nullptr ? column_scanner_.next(record) : record_scanner_.next(record);
+}
+
 RC TableScanPhysicalOperator::next()
 {
-  if (!record_scanner_.has_next()) {
+  if (!scanner_has_next()) {
     return RC::RECORD_EOF;
   }
 
   RC rc = RC::SUCCESS;
   bool filter_result = false;
-  while (record_scanner_.has_next()) {
-    rc = record_scanner_.next(current_record_);
+  while (scanner_has_next()) {
+    rc = scanner_next(current_record_);
     if (rc != RC::SUCCESS) {
       return rc;
     }
@@ -61,6 +75,15 @@ RC TableScanPhysicalOperator::next()
 
 RC TableScanPhysicalOperator::close()
 {
+  if (table_->column_store() != nullptr) {
+    sql_debug("column filter selected %ld of %ld rows of table %s",
+              column_scanner_.rows_selected(), column_scanner_.rows_scanned(), table_->name());
+    return column_scanner_.close_scan();
+  }
+
+  if (!zone_map_conditions_.empty()) {
+    sql_debug("zone map skipped %d pages of table %s", record_scanner_.pages_skipped(), table_->name());
+  }
   return record_scanner_.close_scan();
 }
 
@@ -72,12 +95,150 @@ Tuple *TableScanPhysicalOperator::current_tuple()
 
 string TableScanPhysicalOperator::param() const
 {
-  return table_->name();
+  ColumnStore *column_store = table_->column_store();
+  if (column_store != nullptr) {
+    // 过滤条件和读取的字段在每个行组中使用的编码
+    string result = string(table_->name()) + ", column store";
+    if (!column_conditions_.empty()) {
+      result += ", filter: ";
+      for (size_t i = 0; i < column_conditions_.size(); i++) {
+        result += (i == 0 ? "" : " AND ") + column_store->condition_to_string(column_conditions_[i]);
+      }
+    }
+
+    const TableMeta &table_meta = table_->table_meta();
+    result += ", encodings:";
+    for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+      if (columns_.empty() || find(columns_.begin(), columns_.end(), i) != columns_.end()) {
+        result += string(" ") + table_meta.field(i)->name() + "(" + column_store->encoding_summary(i) + ")";
+      }
+    }
+    return result;
+  }
+
+  if (zone_map_conditions_.empty()) {
+    return table_->name();
+  }
+
+  // EXPLAIN 不执行查询，这里给出的是按照当前的摘要可以跳过的页面数
+  ZoneMap &zone_map   = table_->zone_map();
+  int      skippable  = 0;
+  int      summarized = 0;
+  zone_map.count_skippable(zone_map_conditions_, skippable, summarized);
+
+  string result = string(table_->name()) + ", zone map: ";
+  for (size_t i = 0; i < zone_map_conditions_.size(); i++) {
+    result += (i == 0 ? "" : " AND ") + zone_map.condition_to_string(zone_map_conditions_[i]);
+  }
+  result += ", skip " + to_string(skippable) + "/" + to_string(summarized) + " summarized pages";
+  return result;
 }
 
 void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
 {
   predicates_ = std::move(exprs);
+
+  zone_map_conditions_.clear();
+  column_conditions_.clear();
+  if (table_->column_store() != nullptr || table_->zone_map().enabled()) {
+    for (unique_ptr<Expression> &expr : predicates_) {
+      collect_scan_conditions(expr.get());
+    }
+  }
+}
+
+void TableScanPhysicalOperator::set_fields(const vector<Field> &fields)
+{
+  const FieldMeta *first_field = table_->table_meta().field(0);
+  columns_.clear();
+  for (const Field &field : fields) {
+    const int column = static_cast<int>(field.meta() - first_field);
+    if (find(columns_.begin(), columns_.end(), column) == columns_.end()) {
+      columns_.push_back(column);
+    }
+  }
+  if (columns_.empty()) {
+    // 至少要读取一列，否则会被当成读取所有的列
+    columns_.push_back(table_->table_meta().sys_field_num());
+  }
+}
+
+/**
+ * @brief 字段的值与常量比较时，能否按照字段的取值范围判断比较结果
+ * @details 字段与常量的类型不同时，Value::compare 的结果不一定与取值范围的顺序一致
+ */
+static bool zone_map_comparable(AttrType field_type, AttrType value_type)
+{
+  auto is_number = [](AttrType type) { return type == INTS || type == FLOATS; };
+  auto is_string = [](AttrType type) { return type == CHARS || type == VARCHARS; };
+  return field_type == value_type || (is_number(field_type) && is_number(value_type)) ||
+         (is_string(field_type) && is_string(value_type));
+}
+
+/**
+ * @brief 交换比较运算两边的表达式以后的运算
+ */
+static CompOp swap_comp_op(CompOp comp)
+{
+  switch (comp) {
+    case LESS_THAN: return GREAT_THAN;
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    default: return comp;
+  }
+}
+
+void TableScanPhysicalOperator::collect_scan_conditions(Expression *expr)
+{
+  if (expr->type() == ExprType::CONJUNCTION) {
+    ConjunctionExpr *conjunction_expr = static_cast<ConjunctionExpr *>(expr);
+    if (conjunction_expr->conjunction_type() == ConjunctionExpr::Type::AND) {
+      for (unique_ptr<Expression> &child : conjunction_expr->children()) {
+        collect_scan_conditions(child.get());
+      }
+    }
+    return;
+  }
+
+  if (expr->type() != ExprType::COMPARISON) {
+    return;
+  }
+
+  ComparisonExpr *comparison_expr = static_cast<ComparisonExpr *>(expr);
+  Expression     *left            = comparison_expr->left().get();
+  Expression     *right           = comparison_expr->right().get();
+  CompOp          comp            = comparison_expr->comp();
+  if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    std::swap(left, right);
+    comp = swap_comp_op(comp);
+  }
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return;
+  }
+
+  const Field &field = static_cast<FieldExpr *>(left)->field();
+  const Value &value = static_cast<ValueExpr *>(right)->get_value();
+  if (field.table() != table_ || !zone_map_comparable(field.attr_type(), value.attr_type())) {
+    return;
+  }
+
+  if (table_->column_store() != nullptr) {
+    ColumnCondition condition;
+    condition.column = static_cast<int>(field.meta() - table_->table_meta().field(0));
+    condition.comp   = comp;
+    condition.value  = value;
+    column_conditions_.push_back(condition);
+    return;
+  }
+
+  ZoneMapCondition condition;
+  condition.field_index = table_->zone_map().field_index(field.field_name());
+  condition.comp        = comp;
+  condition.value       = value;
+  if (condition.field_index >= 0) {
+    zone_map_conditions_.push_back(condition);
+  }
 }
 
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
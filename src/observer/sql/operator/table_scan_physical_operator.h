@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/operator/physical_operator.h"
 #include "storage/record/record_manager.h"
+#include "storage/column/column_store.h"
 #include "common/rc.h"
 
 class Table;
@@ -48,15 +49,35 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 设置上层算子用到的字段，列分组格式和列存储的表扫描时只读取这些字段，其它字段的值都是0
+   * @details 只能用于只读的扫描，不设置时读取所有的字段
+   */
+  void set_fields(const std::vector<Field> &fields);
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
+  /**
+   * @brief 从谓词中找出字段与常量比较的条件
+   * @details 行存储的表用这些条件按照区域映射跳过页面，参考 ZoneMap；
+   * 列存储的表在编码以后的列数据上计算这些条件，参考 ColumnSegment::filter
+   */
+  void collect_scan_conditions(Expression *expr);
+
+  bool scanner_has_next();
+  RC   scanner_next(Record &record);
+
 private:
   Table *                                  table_ = nullptr;
   Trx *                                    trx_ = nullptr;
   bool                                     readonly_ = false;
   RecordFileScanner                        record_scanner_;
+  ColumnScanner                            column_scanner_;  ///< 列存储的表使用
   Record                                   current_record_;
   RowTuple                                 tuple_;
   std::vector<std::unique_ptr<Expression>> predicates_; // TODO chang predicate to table tuple filter
+  std::vector<ZoneMapCondition>            zone_map_conditions_;
+  std::vector<ColumnCondition>             column_conditions_;
+  std::vector<int>                         columns_;  ///< 需要读取的字段编号
 };
@@ -83,9 +83,20 @@ RC LogicalPlanGenerator::create_plan(
 
   const std::vector<Table *> &tables = select_stmt->tables();
   const std::vector<Field> &all_fields = select_stmt->query_fields();
+
+  // 查询和过滤条件中用到的所有字段
+  std::vector<Field> used_fields = all_fields;
+  for (const FilterUnit *filter_unit : select_stmt->filter_stmt()->filter_units()) {
+    for (const FilterObj *filter_obj : {&filter_unit->left(), &filter_unit->right()}) {
+      if (filter_obj->is_attr) {
+        used_fields.push_back(filter_obj->field);
+      }
+    }
+  }
+
   for (Table *table : tables) {
     std::vector<Field> fields;
-    for (const Field &field : all_fields) {
+    for (const Field &field : used_fields) {
       if (0 == strcmp(field.table_name(), table->name())) {
         fields.push_back(field);
       }
@@ -160,9 +171,7 @@ RC LogicalPlanGenerator::create_plan(
     InsertStmt *insert_stmt, unique_ptr<LogicalOperator> &logical_operator)
 {
   Table *table = insert_stmt->table();
-  vector<Value> values(insert_stmt->values(), insert_stmt->values() + insert_stmt->value_amount());
-
-  InsertLogicalOperator *insert_operator = new InsertLogicalOperator(table, values);
+  InsertLogicalOperator *insert_operator = new InsertLogicalOperator(table, insert_stmt->values_list());
   logical_operator.reset(insert_operator);
   return RC::SUCCESS;
 }
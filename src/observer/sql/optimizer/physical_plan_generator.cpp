@@ -142,6 +142,9 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
   } else {
     auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.readonly());
     table_scan_oper->set_predicates(std::move(predicates));
+    if (table_get_oper.readonly()) {
+      table_scan_oper->set_fields(table_get_oper.fields());
+    }
     oper = unique_ptr<PhysicalOperator>(table_scan_oper);
     LOG_TRACE("use table scan");
   }
@@ -207,8 +210,8 @@ RC PhysicalPlanGenerator::create_plan(ProjectLogicalOperator &project_oper, uniq
 RC PhysicalPlanGenerator::create_plan(InsertLogicalOperator &insert_oper, unique_ptr<PhysicalOperator> &oper)
 {
   Table *table = insert_oper.table();
-  vector<Value> &values = insert_oper.values();
-  InsertPhysicalOperator *insert_phy_oper = new InsertPhysicalOperator(table, std::move(values));
+  vector<vector<Value>> &values_list = insert_oper.values_list();
+  InsertPhysicalOperator *insert_phy_oper = new InsertPhysicalOperator(table, std::move(values_list));
   oper.reset(insert_phy_oper);
   return RC::SUCCESS;
 }
@@ -112,8 +112,8 @@ struct CalcSqlNode
  */
 struct InsertSqlNode
 {
-  std::string        relation_name;  ///< Relation to insert into
-  std::vector<Value> values;         ///< 要插入的值
+  std::string                     relation_name;  ///< Relation to insert into
+  std::vector<std::vector<Value>> values_list;    ///< 要插入的每一行的值
 };
 
 /**
@@ -152,6 +152,16 @@ struct AttrInfoSqlNode
   size_t      length;     ///< Length of attribute
 };
 
+/**
+ * @brief 建表语句中的一个选项，比如 zone_map=(id, ts)
+ * @ingroup SQLParser
+ */
+struct TableOptionSqlNode
+{
+  std::string              name;    ///< 选项名
+  std::vector<std::string> values;  ///< 选项的值
+};
+
 /**
  * @brief 描述一个create table语句
  * @ingroup SQLParser
@@ -161,6 +171,9 @@ struct CreateTableSqlNode
 {
   std::string                  relation_name;         ///< Relation name
   std::vector<AttrInfoSqlNode> attr_infos;            ///< attributes
+  std::vector<std::string>     zone_map_fields;       ///< 维护区域映射的字段，参考 ZoneMap
+  std::string                  storage_format;        ///< 记录的存放格式，row 或者 pax，为空时是 row
+  std::string                  engine;                ///< 存储引擎，row 或者 column，为空时是 row
 };
 
 /**
@@ -271,6 +284,7 @@ enum SqlCommandFlag
   SCF_DROP_INDEX,
   SCF_SYNC,
   SCF_SHOW_TABLES,
+  SCF_SHOW_BUFFER_POOL_STATUS,  ///< 查看缓冲池的统计信息
   SCF_DESC_TABLE,
   SCF_BEGIN,        ///< 事务开始语句，可以在这里扩展只读事务
   SCF_COMMIT,
@@ -19,11 +19,11 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/comparator.h"
 #include "common/lang/string.h"
 
-const char *ATTR_TYPE_NAME[] = {"undefined", "chars", "ints", "floats", "booleans"};
+const char *ATTR_TYPE_NAME[] = {"undefined", "chars", "ints", "floats", "booleans", "varchars", "texts"};
 
 const char *attr_type_to_string(AttrType type)
 {
-  if (type >= UNDEFINED && type <= FLOATS) {
+  if (type >= UNDEFINED && type <= TEXTS) {
     return ATTR_TYPE_NAME[type];
   }
   return "unknown";
@@ -38,6 +38,14 @@ AttrType attr_type_from_string(const char *s)
   return UNDEFINED;
 }
 
+AttrType attr_value_type(AttrType field_type)
+{
+  if (field_type == VARCHARS || field_type == TEXTS) {
+    return CHARS;
+  }
+  return field_type;
+}
+
 Value::Value(int val)
 {
   set_int(val);
@@ -61,7 +69,8 @@ Value::Value(const char *s, int len /*= 0*/)
 void Value::set_data(char *data, int length)
 {
   switch (attr_type_) {
-    case CHARS: {
+    case CHARS:
+    case VARCHARS: {
       set_string(data, length);
     } break;
     case INTS: {
@@ -121,7 +130,9 @@ void Value::set_value(const Value &value)
     case FLOATS: {
       set_float(value.get_float());
     } break;
-    case CHARS: {
+    case CHARS:
+    case VARCHARS:
+    case TEXTS: {
       set_string(value.get_string().c_str());
     } break;
     case BOOLEANS: {
@@ -27,11 +27,20 @@ enum AttrType
   INTS,           ///< 整数类型(4字节)
   FLOATS,         ///< 浮点数类型(4字节)
   BOOLEANS,       ///< boolean类型，当前不是由parser解析出来的，是程序内部使用的
+  VARCHARS,       ///< 变长字符串类型，只用作字段的类型，从记录中取出来的值是CHARS
+  TEXTS,          ///< 大文本类型，只用作字段的类型，值存放在溢出页面中，读取出来的值是CHARS
 };
 
 const char *attr_type_to_string(AttrType type);
 AttrType attr_type_from_string(const char *s);
 
+/**
+ * @brief 字段类型为 field_type 时，字段中取出来的值是什么类型
+ * @details VARCHARS 只是在页面上的存放方式不同，在内存记录中与 CHARS 一样，取出来的值也是 CHARS。
+ * TEXTS 在记录中只保存溢出页面的引用，读取时从溢出页面中取出完整的值，也是 CHARS
+ */
+AttrType attr_value_type(AttrType field_type);
+
 /**
  * @brief 属性的值
  * 
@@ -110,9 +110,12 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   Expression *                      expression;
   std::vector<Expression *> *       expression_list;
   std::vector<Value> *              value_list;
+  std::vector<std::vector<Value>> * row_list;
   std::vector<ConditionSqlNode> *   condition_list;
   std::vector<RelAttrSqlNode> *     rel_attr_list;
   std::vector<std::string> *        relation_list;
+  TableOptionSqlNode *              table_option;
+  std::vector<TableOptionSqlNode> * table_option_list;
   char *                            string;
   int                               number;
   float                             floats;
@@ -133,7 +136,11 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <rel_attr>            rel_attr
 %type <attr_infos>          attr_def_list
 %type <attr_info>           attr_def
+%type <table_option>        table_option
+%type <table_option_list>   table_option_list
 %type <value_list>          value_list
+%type <value_list>          insert_row
+%type <row_list>            insert_row_list
 %type <condition_list>      where
 %type <condition_list>      condition_list
 %type <rel_attr_list>       select_attr
@@ -149,6 +156,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <sql_node>            create_table_stmt
 %type <sql_node>            drop_table_stmt
 %type <sql_node>            show_tables_stmt
+%type <sql_node>            show_buffer_pool_status_stmt
 %type <sql_node>            desc_table_stmt
 %type <sql_node>            create_index_stmt
 %type <sql_node>            drop_index_stmt
@@ -186,6 +194,7 @@ command_wrapper:
   | create_table_stmt
   | drop_table_stmt
   | show_tables_stmt
+  | show_buffer_pool_status_stmt
   | desc_table_stmt
   | create_index_stmt
   | drop_index_stmt
@@ -248,6 +257,21 @@ show_tables_stmt:
     }
     ;
 
+/* BUFFER、POOL、STATUS 不作为关键字，以免和同名的表、字段冲突 */
+show_buffer_pool_status_stmt:
+    SHOW ID ID ID {
+      const bool matched = 0 == strcasecmp($2, "BUFFER") && 0 == strcasecmp($3, "POOL") && 0 == strcasecmp($4, "STATUS");
+      free($2);
+      free($3);
+      free($4);
+      if (!matched) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      $$ = new ParsedSqlNode(SCF_SHOW_BUFFER_POOL_STATUS);
+    }
+    ;
+
 desc_table_stmt:
     DESC ID  {
       $$ = new ParsedSqlNode(SCF_DESC_TABLE);
@@ -281,8 +305,28 @@ drop_index_stmt:      /*drop index 语句的语法解析树*/
     }
     ;
 create_table_stmt:    /*create table 语句的语法解析树*/
-    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE
+    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE table_option_list
     {
+      std::vector<TableOptionSqlNode> *options = $8;
+      bool valid_options = true;
+      if (options != nullptr) {
+        for (const TableOptionSqlNode &option : *options) {
+          if (0 == strcasecmp(option.name.c_str(), "format") || 0 == strcasecmp(option.name.c_str(), "engine")) {
+            valid_options = valid_options && option.values.size() == 1;
+          } else if (0 != strcasecmp(option.name.c_str(), "zone_map")) {
+            valid_options = false;
+          }
+        }
+      }
+      if (!valid_options) {
+        free($3);
+        delete $5;
+        delete $6;
+        delete options;
+        yyerror(&@$, sql_string, sql_result, scanner, "unknown table option");
+        YYERROR;
+      }
+
       $$ = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = $$->create_table;
       create_table.relation_name = $3;
@@ -296,6 +340,61 @@ create_table_stmt:    /*create table 语句的语法解析树*/
       create_table.attr_infos.emplace_back(*$5);
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
       delete $5;
+
+      if (options != nullptr) {
+        for (TableOptionSqlNode &option : *options) {
+          if (0 == strcasecmp(option.name.c_str(), "format")) {
+            create_table.storage_format = option.values.front();
+          } else if (0 == strcasecmp(option.name.c_str(), "engine")) {
+            create_table.engine = option.values.front();
+          } else {
+            create_table.zone_map_fields.swap(option.values);
+          }
+        }
+        delete options;
+      }
+    }
+    ;
+
+/* 表选项的名字不作为关键字，由 create_table_stmt 检查 */
+table_option_list:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | table_option table_option_list
+    {
+      if ($2 != nullptr) {
+        $$ = $2;
+      } else {
+        $$ = new std::vector<TableOptionSqlNode>;
+      }
+      $$->emplace($$->begin(), std::move(*$1));
+      delete $1;
+    }
+    ;
+
+table_option:
+    ID EQ ID
+    {
+      $$ = new TableOptionSqlNode;
+      $$->name = $1;
+      $$->values.push_back($3);
+      free($1);
+      free($3);
+    }
+    | ID EQ LBRACE ID rel_list RBRACE
+    {
+      $$ = new TableOptionSqlNode;
+      $$->name = $1;
+      if ($5 != nullptr) {
+        $$->values.swap(*$5);
+        delete $5;
+      }
+      $$->values.push_back($4);
+      std::reverse($$->values.begin(), $$->values.end());
+      free($1);
+      free($4);
     }
     ;
 attr_def_list:
@@ -340,22 +439,67 @@ type:
     INT_T      { $$=INTS; }
     | STRING_T { $$=CHARS; }
     | FLOAT_T  { $$=FLOATS; }
+    | ID {
+      int attr_type = UNDEFINED;
+      if (0 == strcasecmp($1, "VARCHAR")) {
+        attr_type = VARCHARS;
+      } else if (0 == strcasecmp($1, "TEXT")) {
+        attr_type = TEXTS;
+      }
+      free($1);
+      if (attr_type == UNDEFINED) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      $$=attr_type;
+    }
     ;
 insert_stmt:        /*insert   语句的语法解析树*/
-    INSERT INTO ID VALUES LBRACE value value_list RBRACE 
+    INSERT INTO ID VALUES insert_row insert_row_list
     {
       $$ = new ParsedSqlNode(SCF_INSERT);
       $$->insertion.relation_name = $3;
-      if ($7 != nullptr) {
-        $$->insertion.values.swap(*$7);
+      if ($6 != nullptr) {
+        $$->insertion.values_list.swap(*$6);
+        delete $6;
       }
-      $$->insertion.values.emplace_back(*$6);
-      std::reverse($$->insertion.values.begin(), $$->insertion.values.end());
-      delete $6;
+      $$->insertion.values_list.emplace_back(std::move(*$5));
+      std::reverse($$->insertion.values_list.begin(), $$->insertion.values_list.end());
+      delete $5;
       free($3);
     }
     ;
 
+insert_row:
+    LBRACE value value_list RBRACE
+    {
+      if ($3 != nullptr) {
+        $$ = $3;
+      } else {
+        $$ = new std::vector<Value>;
+      }
+      $$->emplace_back(*$2);
+      std::reverse($$->begin(), $$->end());
+      delete $2;
+    }
+    ;
+
+insert_row_list:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | COMMA insert_row insert_row_list {
+      if ($3 != nullptr) {
+        $$ = $3;
+      } else {
+        $$ = new std::vector<std::vector<Value>>;
+      }
+      $$->emplace_back(std::move(*$2));
+      delete $2;
+    }
+    ;
+
 value_list:
     /* empty */
     {
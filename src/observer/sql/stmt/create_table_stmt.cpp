@@ -12,12 +12,34 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/6/13.
 //
 
+#include <strings.h>
+
 #include "sql/stmt/create_table_stmt.h"
+#include "common/log/log.h"
 #include "event/sql_debug.h"
 
 RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt)
 {
-  stmt = new CreateTableStmt(create_table.relation_name, create_table.attr_infos);
+  TableOptions options;
+  options.zone_map_fields = create_table.zone_map_fields;
+
+  const std::string &format = create_table.storage_format;
+  if (0 == strcasecmp(format.c_str(), "pax")) {
+    options.pax = true;
+  } else if (!format.empty() && 0 != strcasecmp(format.c_str(), "row")) {
+    LOG_WARN("unknown storage format. table=%s, format=%s", create_table.relation_name.c_str(), format.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const std::string &engine = create_table.engine;
+  if (0 == strcasecmp(engine.c_str(), "column")) {
+    options.column_store = true;
+  } else if (!engine.empty() && 0 != strcasecmp(engine.c_str(), "row")) {
+    LOG_WARN("unknown storage engine. table=%s, engine=%s", create_table.relation_name.c_str(), engine.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  stmt = new CreateTableStmt(create_table.relation_name, create_table.attr_infos, options);
   sql_debug("create table statement: table name %s", create_table.relation_name.c_str());
   return RC::SUCCESS;
 }
@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <vector>
+
 #include "common/rc.h"
 #include "sql/stmt/stmt.h"
 
@@ -28,7 +30,7 @@ class InsertStmt : public Stmt
 {
 public:
   InsertStmt() = default;
-  InsertStmt(Table *table, const Value *values, int value_amount);
+  InsertStmt(Table *table, const std::vector<std::vector<Value>> *values_list);
 
   StmtType type() const override
   {
@@ -43,17 +45,15 @@ public:
   {
     return table_;
   }
-  const Value *values() const
-  {
-    return values_;
-  }
-  int value_amount() const
+  /**
+   * @brief 要插入的每一行的值，一条语句可以插入多行
+   */
+  const std::vector<std::vector<Value>> &values_list() const
   {
-    return value_amount_;
+    return *values_list_;
   }
 
 private:
   Table *table_ = nullptr;
-  const Value *values_ = nullptr;
-  int value_amount_ = 0;
+  const std::vector<std::vector<Value>> *values_list_ = nullptr;
 };
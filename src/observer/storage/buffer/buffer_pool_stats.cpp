@@ -0,0 +1,214 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "storage/buffer/buffer_pool_stats.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+
+using namespace std;
+using namespace common;
+
+int64_t BPShardedCounter::value() const
+{
+  int64_t value = 0;
+  for (const Shard &shard : shards_) {
+    value += shard.value.load(memory_order_relaxed);
+  }
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int BPLatencyHistogram::bucket_of(int64_t latency_us)
+{
+  if (latency_us <= 0) {
+    return 0;
+  }
+  const int bucket = 64 - __builtin_clzll(static_cast<uint64_t>(latency_us));
+  return min(bucket, BUCKET_NUM - 1);
+}
+
+int64_t BPLatencyHistogram::bucket_upper_us(int bucket)
+{
+  return int64_t(1) << bucket;
+}
+
+void BPLatencyHistogram::record(int64_t latency_us)
+{
+  latency_us = max(latency_us, int64_t(0));
+
+  Shard &shard = shards_[bp_stats_shard_index()];
+  shard.count.fetch_add(1, memory_order_relaxed);
+  shard.sum_us.fetch_add(latency_us, memory_order_relaxed);
+  shard.buckets[bucket_of(latency_us)].fetch_add(1, memory_order_relaxed);
+}
+
+void BPLatencyHistogram::summary(Summary &summary) const
+{
+  summary = Summary();
+  for (const Shard &shard : shards_) {
+    summary.count += shard.count.load(memory_order_relaxed);
+    summary.sum_us += shard.sum_us.load(memory_order_relaxed);
+    for (int i = 0; i < BUCKET_NUM; i++) {
+      summary.buckets[i] += shard.buckets[i].load(memory_order_relaxed);
+    }
+  }
+}
+
+int64_t BPLatencyHistogram::Summary::percentile_us(double percent) const
+{
+  // 各个分片不是同时读取的，桶的总数可能和 count 稍有差别，以桶为准
+  int64_t total = 0;
+  for (int64_t bucket_count : buckets) {
+    total += bucket_count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  const int64_t target = max(static_cast<int64_t>(total * percent / 100.0 + 0.5), int64_t(1));
+  int64_t       seen   = 0;
+  for (int i = 0; i < BUCKET_NUM; i++) {
+    seen += buckets[i];
+    if (seen >= target) {
+      return bucket_upper_us(i);
+    }
+  }
+  return bucket_upper_us(BUCKET_NUM - 1);
+}
+
+string BPLatencyHistogram::Summary::to_string() const
+{
+  if (count == 0) {
+    return "count=0";
+  }
+
+  char buf[128];
+  snprintf(buf, sizeof(buf), "count=%ld avg=%.1fus p50<%ldus p99<%ldus",
+           count, mean_us(), percentile_us(50), percentile_us(99));
+  return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolStats::record_read(int pages, int64_t latency_us)
+{
+  page_reads_.add(pages);
+  read_latency_.record(latency_us);
+  if (parent_ != nullptr) {
+    parent_->record_read(pages, latency_us);
+  }
+}
+
+void BufferPoolStats::record_write(int pages, int64_t latency_us)
+{
+  page_writes_.add(pages);
+  write_latency_.record(latency_us);
+  if (parent_ != nullptr) {
+    parent_->record_write(pages, latency_us);
+  }
+}
+
+void BufferPoolStats::record_pin_wait(int64_t latency_us)
+{
+  pin_waits_.add();
+  pin_wait_latency_.record(latency_us);
+  if (parent_ != nullptr) {
+    parent_->record_pin_wait(latency_us);
+  }
+}
+
+double BufferPoolStats::hit_ratio() const
+{
+  const int64_t hit_count = hits();
+  const int64_t total     = hit_count + misses();
+  return total == 0 ? 0.0 : static_cast<double>(hit_count) / total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief 注册到 MetricsRegistry 中的一个统计项，快照时取一次值
+ */
+class BPMetricGroup::Gauge : public common::Gauge
+{
+public:
+  explicit Gauge(function<string()> getter) : getter_(std::move(getter)) {}
+  ~Gauge() { delete snapshot_value_; }
+
+  void snapshot() override
+  {
+    if (snapshot_value_ == nullptr) {
+      snapshot_value_ = new SnapshotBasic<string>();
+    }
+    string value = getter_();
+    static_cast<SnapshotBasic<string> *>(snapshot_value_)->setValue(value);
+  }
+
+  string value() const { return getter_(); }
+
+private:
+  function<string()> getter_;
+};
+
+BPMetricGroup::BPMetricGroup(const string &scope, const string &tag_prefix) : scope_(scope), tag_prefix_(tag_prefix)
+{}
+
+BPMetricGroup::~BPMetricGroup()
+{
+  MetricsRegistry &registry = get_metrics_registry();
+  for (size_t i = 0; i < gauges_.size(); i++) {
+    registry.unregister(tag_prefix_ + names_[i]);
+  }
+}
+
+void BPMetricGroup::add(const string &name, function<string()> getter)
+{
+  gauges_.emplace_back(new Gauge(std::move(getter)));
+  names_.push_back(name);
+  get_metrics_registry().register_metric(tag_prefix_ + name, gauges_.back().get());
+}
+
+void BPMetricGroup::add_stats(const BufferPoolStats &stats)
+{
+  const BufferPoolStats *s = &stats;
+  add("hits", [s]() { return std::to_string(s->hits()); });
+  add("misses", [s]() { return std::to_string(s->misses()); });
+  add("hit_ratio", [s]() {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.4f", s->hit_ratio());
+    return string(buf);
+  });
+  add("page_reads", [s]() { return std::to_string(s->page_reads()); });
+  add("page_writes", [s]() { return std::to_string(s->page_writes()); });
+  add("pin_waits", [s]() { return std::to_string(s->pin_waits()); });
+
+  auto latency = [](const BPLatencyHistogram &histogram) {
+    return [&histogram]() {
+      BPLatencyHistogram::Summary summary;
+      histogram.summary(summary);
+      return summary.to_string();
+    };
+  };
+  add("read_latency", latency(stats.read_latency()));
+  add("flush_latency", latency(stats.write_latency()));
+  add("pin_wait_latency", latency(stats.pin_wait_latency()));
+}
+
+void BPMetricGroup::collect(vector<BPStatusItem> &items) const
+{
+  for (size_t i = 0; i < gauges_.size(); i++) {
+    items.push_back(BPStatusItem{scope_, names_[i], gauges_[i]->value()});
+  }
+}
@@ -0,0 +1,241 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 统计信息的分片个数
+ * @details 每个线程固定使用其中一个分片，线程数不超过分片数时，不同线程更新的是不同的缓存行
+ */
+static constexpr int BP_STATS_SHARD_NUM = 16;
+
+/**
+ * @brief 当前线程使用的统计分片
+ */
+inline int bp_stats_shard_index()
+{
+  static std::atomic<int> next_index{0};
+  thread_local const int  index = next_index.fetch_add(1, std::memory_order_relaxed) % BP_STATS_SHARD_NUM;
+  return index;
+}
+
+/**
+ * @brief 按线程分片的计数器
+ * @ingroup BufferPool
+ * @details 增加计数只修改当前线程的分片，读取时把所有分片加起来。
+ * 命中页面这样的热点路径上，多个线程同时计数也不会争抢同一个缓存行
+ */
+class BPShardedCounter
+{
+public:
+  void add(int64_t value = 1) { shards_[bp_stats_shard_index()].value.fetch_add(value, std::memory_order_relaxed); }
+
+  int64_t value() const;
+
+private:
+  struct alignas(64) Shard
+  {
+    std::atomic<int64_t> value{0};
+  };
+
+  Shard shards_[BP_STATS_SHARD_NUM];
+};
+
+/**
+ * @brief 延迟直方图，单位是微秒
+ * @ingroup BufferPool
+ * @details 按照2的幂划分桶，第0个桶记录小于1微秒的次数，第i个桶记录 [2^(i-1), 2^i) 微秒的次数，
+ * 超出范围的记录在最后一个桶中。同样按照线程分片，分位数按照所在桶的上界估算
+ */
+class BPLatencyHistogram
+{
+public:
+  static constexpr int BUCKET_NUM = 28;  ///< 最后一个桶从 2^26 微秒(约67秒)开始
+
+  /**
+   * @brief 直方图在某个时刻的汇总
+   */
+  struct Summary
+  {
+    int64_t count  = 0;
+    int64_t sum_us = 0;
+    int64_t buckets[BUCKET_NUM] = {0};
+
+    double  mean_us() const { return count == 0 ? 0.0 : static_cast<double>(sum_us) / count; }
+    int64_t percentile_us(double percent) const;
+    std::string to_string() const;
+  };
+
+public:
+  void record(int64_t latency_us);
+  void summary(Summary &summary) const;
+
+  static int bucket_of(int64_t latency_us);
+
+  /**
+   * @brief 桶的上界，即落在这个桶中的延迟都小于这个值
+   */
+  static int64_t bucket_upper_us(int bucket);
+
+private:
+  struct alignas(64) Shard
+  {
+    std::atomic<int64_t> count{0};
+    std::atomic<int64_t> sum_us{0};
+    std::atomic<int64_t> buckets[BUCKET_NUM] = {};
+  };
+
+  Shard shards_[BP_STATS_SHARD_NUM];
+};
+
+/**
+ * @brief 计时，只在读写磁盘、等待页帧这些本身就比较慢的地方使用
+ */
+class BPStopwatch
+{
+public:
+  BPStopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+  int64_t elapsed_us() const
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief 缓冲池的访问统计
+ * @ingroup BufferPool
+ * @details 每个 DiskBufferPool 有一份自己文件的统计，BufferPoolManager 有一份全局的统计。
+ * 文件的统计把 parent 设置为全局统计，记录时同时更新两份。
+ *
+ * - 命中：要访问的页面已经在页帧中(包括其它线程正在加载的页面)
+ * - 未命中：需要当前线程从磁盘读取页面
+ * - 等待页帧(pin wait)：等待其它线程加载页面，或者没有干净的页帧可以淘汰，等待刷脏线程
+ */
+class BufferPoolStats
+{
+public:
+  explicit BufferPoolStats(BufferPoolStats *parent = nullptr) : parent_(parent) {}
+
+  void record_hit()
+  {
+    hits_.add();
+    if (parent_ != nullptr) {
+      parent_->record_hit();
+    }
+  }
+
+  void record_miss()
+  {
+    misses_.add();
+    if (parent_ != nullptr) {
+      parent_->record_miss();
+    }
+  }
+
+  /**
+   * @brief 从磁盘读取了一批页面
+   * @param latency_us 这次读取用了多长时间
+   */
+  void record_read(int pages, int64_t latency_us);
+
+  /**
+   * @brief 向磁盘写了一批页面
+   */
+  void record_write(int pages, int64_t latency_us);
+
+  void record_pin_wait(int64_t latency_us);
+
+  int64_t hits() const { return hits_.value(); }
+  int64_t misses() const { return misses_.value(); }
+  int64_t page_reads() const { return page_reads_.value(); }
+  int64_t page_writes() const { return page_writes_.value(); }
+  int64_t pin_waits() const { return pin_waits_.value(); }
+
+  /**
+   * @brief 命中率，还没有访问过页面时返回0
+   */
+  double hit_ratio() const;
+
+  const BPLatencyHistogram &read_latency() const { return read_latency_; }
+  const BPLatencyHistogram &write_latency() const { return write_latency_; }
+  const BPLatencyHistogram &pin_wait_latency() const { return pin_wait_latency_; }
+
+private:
+  BufferPoolStats *parent_ = nullptr;
+
+  BPShardedCounter hits_;
+  BPShardedCounter misses_;
+  BPShardedCounter page_reads_;
+  BPShardedCounter page_writes_;
+  BPShardedCounter pin_waits_;
+
+  BPLatencyHistogram read_latency_;
+  BPLatencyHistogram write_latency_;
+  BPLatencyHistogram pin_wait_latency_;
+};
+
+/**
+ * @brief SHOW BUFFER POOL STATUS 的一行
+ */
+struct BPStatusItem
+{
+  std::string scope;  ///< global 或者文件名
+  std::string name;
+  std::string value;
+};
+
+/**
+ * @brief 一组缓冲池的统计项
+ * @ingroup BufferPool
+ * @details 每一项都注册到 common::MetricsRegistry 中，名字是 tag_prefix + name，
+ * 同时也可以通过 collect 一次取出来给 SHOW BUFFER POOL STATUS 使用。析构时取消注册。
+ * 统计项的值在取的时候才计算，比如脏页个数需要遍历页帧表
+ */
+class BPMetricGroup
+{
+public:
+  BPMetricGroup(const std::string &scope, const std::string &tag_prefix);
+  ~BPMetricGroup();
+
+  void add(const std::string &name, std::function<std::string()> getter);
+
+  /**
+   * @brief 添加一组常用的访问统计：命中、读写、等待页帧和对应的延迟
+   */
+  void add_stats(const BufferPoolStats &stats);
+
+  void collect(std::vector<BPStatusItem> &items) const;
+
+  const std::string &scope() const { return scope_; }
+
+private:
+  class Gauge;
+
+  std::string                         scope_;
+  std::string                         tag_prefix_;
+  std::vector<std::string>            names_;
+  std::vector<std::unique_ptr<Gauge>> gauges_;
+};
@@ -13,6 +13,9 @@ See the Mulan PSL v2 for more details. */
 //
 #include <errno.h>
 #include <string.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
 
 #include "storage/buffer/disk_buffer_pool.h"
 #include "common/lang/mutex.h"
@@ -31,7 +34,8 @@ string BPFileHeader::to_string() const
 {
   stringstream ss;
   ss << "pageCount:" << page_count
-     << ", allocatedCount:" << allocated_pages;
+     << ", allocatedCount:" << allocated_pages
+     << ", pageSize:" << file_page_size();
   return ss.str();
 }
 
@@ -40,37 +44,91 @@ string BPFileHeader::to_string() const
 BPFrameManager::BPFrameManager(const char *name) : allocator_(name)
 {}
 
-RC BPFrameManager::init(int pool_num)
+RC BPFrameManager::init(int pool_num, int shard_num /* = 1 */, const char *replacer /* = nullptr */,
+    bool use_huge_pages /* = false */)
 {
-  int ret = allocator_.init(false, pool_num);
-  if (ret == 0) {
-    return RC::SUCCESS;
+  if (shard_num <= 0) {
+    shard_num = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  }
+
+  // 页帧个数实际上由页面内存限制，运行时调大内存时需要扩展页帧，参考 resize
+  int ret = allocator_.init(true, pool_num);
+  if (ret != 0) {
+    return RC::NOMEM;
   }
-  return RC::NOMEM;
+  page_allocator_.init(static_cast<int64_t>(allocator_.get_size()) * BP_PAGE_SIZE, use_huge_pages);
+
+  shards_.clear();
+  shards_.reserve(shard_num);
+  for (int i = 0; i < shard_num; i++) {
+    FrameShard *shard = new FrameShard;
+    shard->replacer.reset(FrameReplacer::create(replacer));
+    if (shard->replacer == nullptr) {
+      LOG_WARN("failed to create frame replacer, use lru instead. name=%s", replacer);
+      shard->replacer.reset(new LruFrameReplacer());
+    }
+    shards_.emplace_back(shard);
+  }
+  LOG_INFO("frame manager init done. pool num=%d, shard num=%d, replacer=%s, use huge pages=%d",
+           pool_num, shard_num, replacer == nullptr ? "" : replacer, use_huge_pages);
+  return RC::SUCCESS;
 }
 
 RC BPFrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    shard->frames.clear();
+  }
   return RC::SUCCESS;
 }
 
-int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purger)
+BPFrameManager::FrameShard &BPFrameManager::shard_of(const FrameId &frame_id)
 {
-  std::lock_guard<std::mutex> lock_guard(lock_);
+  return *shards_[frame_id.hash() % shards_.size()];
+}
 
-  std::vector<Frame *> frames_can_purge;
+size_t BPFrameManager::frame_num() const
+{
+  size_t count = 0;
+  for (const std::unique_ptr<FrameShard> &shard : shards_) {
+    std::lock_guard<std::mutex> lock_guard(shard->lock);
+    count += shard->frames.size();
+  }
+  return count;
+}
+
+int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purger)
+{
   if (count <= 0) {
     count = 1;
   }
+
+  const size_t shard_num = shards_.size();
+  const size_t start = purge_cursor_.fetch_add(1) % shard_num;
+
+  int freed_count = 0;
+  for (size_t i = 0; i < shard_num && freed_count < count; i++) {
+    FrameShard &shard = *shards_[(start + i) % shard_num];
+    freed_count += purge_shard_frames(shard, count - freed_count, purger);
+  }
+  LOG_INFO("purge frame done. number=%d", freed_count);
+  return freed_count;
+}
+
+int BPFrameManager::purge_shard_frames(FrameShard &shard, int count, std::function<RC(Frame *frame)> &purger)
+{
+  std::lock_guard<std::mutex> lock_guard(shard.lock);
+
+  std::vector<Frame *> frames_can_purge;
   frames_can_purge.reserve(count);
 
-  auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
-    if (frame->can_purge()) {
+  // 只淘汰干净的页面，写脏页的工作交给后台刷脏线程
+  auto purge_finder = [&frames_can_purge, count](Frame *frame) {
+    if (frame->can_purge() && !frame->dirty()) {
       frame->pin();
       frames_can_purge.push_back(frame);
       if (frames_can_purge.size() >= static_cast<size_t>(count)) {
@@ -80,16 +138,14 @@ int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purg
     return true;  // true continue to look up
   };
 
-  frames_.foreach_reverse(purge_finder);
-  LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
+  shard.replacer->foreach_victim(purge_finder);
+  LOG_DEBUG("purge frames find %ld pages in shard", frames_can_purge.size());
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
   int freed_count = 0;
   for (Frame *frame : frames_can_purge) {
     RC rc = purger(frame);
     if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+      free_internal(shard, frame->frame_id(), frame);
       freed_count++;
     } else {
       frame->unpin();
@@ -97,83 +153,260 @@ int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purg
                to_string(frame->frame_id()).c_str(), strrc(rc));
     }
   }
-  LOG_INFO("purge frame done. number=%d", freed_count);
+  evictions_.add(freed_count);
   return freed_count;
 }
 
-Frame *BPFrameManager::get(int file_desc, PageNum page_num)
+void BPFrameManager::sync_references()
 {
-  FrameId frame_id(file_desc, page_num);
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::lock_guard<std::mutex> lock_guard(shard->lock);
+    shard->replacer->sync_references();
+  }
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id)
+int BPFrameManager::find_dirty_victims(int clean_target, int max_count, std::vector<Frame *> &frames)
 {
+  // 空闲的页帧也可以直接使用，够用的时候就不需要检查了
+  const int free_num = static_cast<int>(free_frame_num());
+  if (free_num >= clean_target) {
+    return 0;
+  }
+
+  const int shard_num    = static_cast<int>(shards_.size());
+  const int shard_target = (clean_target - free_num + shard_num - 1) / shard_num;
+
+  int backlog = 0;
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::lock_guard<std::mutex> lock_guard(shard->lock);
+
+    int checked = 0;
+    shard->replacer->foreach_victim([&](Frame *frame) {
+      if (!frame->can_purge()) {
+        return true;
+      }
+
+      if (frame->dirty()) {
+        backlog++;
+        if (static_cast<int>(frames.size()) < max_count) {
+          frame->pin();
+          frames.push_back(frame);
+        }
+      }
+      return ++checked < shard_target;
+    });
+  }
+  return backlog;
+}
+
+size_t BPFrameManager::free_frame_num()
+{
+  const size_t free_frames = allocator_.get_size() - allocator_.get_used_num();
+  const size_t free_pages  = static_cast<size_t>(std::max(page_allocator_.free_memory(), int64_t(0)) / BP_PAGE_SIZE);
+  return std::min(free_frames, free_pages);
+}
+
+RC BPFrameManager::resize(int64_t memory_size)
+{
+  const int64_t frame_num = memory_size / BP_PAGE_SIZE;
+  while (static_cast<int64_t>(allocator_.get_size()) < frame_num) {
+    if (allocator_.extend() != 0) {
+      LOG_WARN("failed to extend frames. frames=%d, target=%ld", allocator_.get_size(), frame_num);
+      return RC::NOMEM;
+    }
+  }
+
+  page_allocator_.set_memory_limit(memory_size);
+  LOG_INFO("frame manager resized. memory size=%ld, frames=%d, used memory=%ld, allocated memory=%ld, "
+           "hugetlb memory=%ld, thp memory=%ld",
+           memory_size, allocator_.get_size(), page_allocator_.used_memory(), page_allocator_.allocated_memory(),
+           page_allocator_.hugetlb_memory(), page_allocator_.thp_memory());
+  return RC::SUCCESS;
+}
+
+int BPFrameManager::release_frames(int max_count)
+{
+  const int64_t exceeded = page_allocator_.exceeded_memory();
+  if (exceeded <= 0 || max_count <= 0) {
+    return 0;
+  }
+
+  // 淘汰的都是干净的页面，脏页由刷脏线程先写到磁盘
+  auto purger = [](Frame *frame) { return RC::SUCCESS; };
+  const int count = static_cast<int>(std::min<int64_t>((exceeded + BP_PAGE_SIZE - 1) / BP_PAGE_SIZE, max_count));
+  return purge_frames(count, purger);
+}
+
+Frame *BPFrameManager::get(int file_desc, PageNum page_num, bool touch /* = true */)
+{
+  FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = shard_of(frame_id);
   Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
+  {
+    std::lock_guard<std::mutex> lock_guard(shard.lock);
+    frame = get_internal(shard, frame_id, touch);
+  }
+
+  // 刷脏线程正在写这个页面，等它写完才能使用
   if (frame != nullptr) {
-    frame->pin();
+    frame->wait_flushing();
   }
   return frame;
 }
 
-Frame *BPFrameManager::alloc(int file_desc, PageNum page_num)
+Frame *BPFrameManager::get_internal(FrameShard &shard, const FrameId &frame_id, bool touch)
+{
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
+  }
+
+  Frame *frame = iter->second;
+  frame->pin();
+  if (touch) {
+    frame->access();
+  }
+  return frame;
+}
+
+Frame *BPFrameManager::alloc(int file_desc, PageNum page_num, bool cold /* = false */,
+    int page_size /* = BP_PAGE_SIZE */, bool *created /* = nullptr */)
 {
   FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  Frame *frame = get_internal(frame_id);
-  if (frame != nullptr) {
-    return frame;
+  Frame *frame = nullptr;
+  {
+    std::lock_guard<std::mutex> lock_guard(shard.lock);
+    frame = get_internal(shard, frame_id, !cold);
+    if (frame == nullptr) {
+      Page *page = page_allocator_.alloc(page_size);
+      if (page == nullptr) {
+        return nullptr;
+      }
+
+      frame = allocator_.alloc();
+      if (frame == nullptr) {
+        page_allocator_.free(page, page_size);
+      } else {
+        ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s", 
+               to_string(*frame).c_str());
+        frame->set_page(page, page_size);
+        frame->set_page_num(page_num);
+        frame->set_file_desc(file_desc);
+        frame->set_loading();
+        frame->pin();
+        shard.frames.emplace(frame_id, frame);
+        shard.replacer->insert(frame, cold);
+        if (created != nullptr) {
+          *created = true;
+        }
+      }
+      return frame;
+    }
   }
 
-  frame = allocator_.alloc();
-  if (frame != nullptr) {
-    ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s", 
-           to_string(*frame).c_str());
-    frame->set_page_num(page_num);
-    frame->pin();
-    frames_.put(frame_id, frame);
+  if (created != nullptr) {
+    *created = false;
   }
+  frame->wait_flushing();
   return frame;
 }
 
+bool BPFrameManager::begin_flush(Frame *frame)
+{
+  FrameShard &shard = shard_of(frame->frame_id());
+
+  std::lock_guard<std::mutex> lock_guard(shard.lock);
+  // pin 页帧都要拿着分片的锁，这里检查通过以后，其它线程再 pin 住也会等待写完
+  if (frame->pin_count() > 1) {
+    return false;
+  }
+  frame->set_flushing();
+  return true;
+}
+
+void BPFrameManager::end_flush(Frame *frame)
+{
+  frame->finish_flushing();
+}
+
 RC BPFrameManager::free(int file_desc, PageNum page_num, Frame *frame)
 {
   FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  std::lock_guard<std::mutex> lock_guard(shard.lock);
+  return free_internal(shard, frame_id, frame);
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC BPFrameManager::free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame)
 {
-  Frame *frame_source = nullptr;
-  [[maybe_unused]] bool found = frames_.get(frame_id, frame_source);
+  auto iter = shard.frames.find(frame_id);
+  [[maybe_unused]] bool found = iter != shard.frames.end();
+  [[maybe_unused]] Frame *frame_source = found ? iter->second : nullptr;
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
          "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
          found, to_string(frame_id).c_str(), frame_source, frame, frame->pin_count(), lbt());
 
   frame->unpin();
-  frames_.remove(frame_id);
+  shard.replacer->remove(frame);
+  shard.frames.erase(iter);
+  page_allocator_.free(&frame->page(), frame->page_size());
+  frame->set_page(nullptr, BP_PAGE_SIZE);
   allocator_.free(frame);
   return RC::SUCCESS;
 }
 
-std::list<Frame *> BPFrameManager::find_list(int file_desc)
+RC BPFrameManager::recycle(int file_desc, PageNum page_num)
+{
+  FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = shard_of(frame_id);
+
+  std::lock_guard<std::mutex> lock_guard(shard.lock);
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return RC::NOTFOUND;
+  }
+
+  Frame *frame = iter->second;
+  if (!frame->can_purge() || frame->dirty()) {
+    return RC::LOCKED_UNLOCK;
+  }
+
+  frame->pin();
+  return free_internal(shard, frame_id, frame);
+}
+
+void BPFrameManager::count_frames(int file_desc, int &frames, int &dirty_frames)
 {
-  std::lock_guard<std::mutex> lock_guard(lock_);
+  frames       = 0;
+  dirty_frames = 0;
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::lock_guard<std::mutex> lock_guard(shard->lock);
+    for (auto &item : shard->frames) {
+      if (file_desc < 0 || file_desc == item.first.file_desc()) {
+        frames++;
+        if (item.second->dirty()) {
+          dirty_frames++;
+        }
+      }
+    }
+  }
+}
 
+std::list<Frame *> BPFrameManager::find_list(int file_desc)
+{
   std::list<Frame *> frames;
-  auto fetcher = [&frames, file_desc](const FrameId &frame_id, Frame *const frame) -> bool {
-    if (file_desc == frame_id.file_desc()) {
-      frame->pin();
-      frames.push_back(frame);
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::lock_guard<std::mutex> lock_guard(shard->lock);
+    for (auto &item : shard->frames) {
+      if (file_desc == item.first.file_desc()) {
+        item.second->pin();
+        frames.push_back(item.second);
+      }
     }
-    return true;
-  };
-  frames_.foreach (fetcher);
+  }
   return frames;
 }
 
@@ -184,38 +417,102 @@ BufferPoolIterator::~BufferPoolIterator()
 {}
 RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
 {
-  bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
+  buffer_pool_  = &bp;
+  end_page_num_ = bp.page_count();
   if (start_page <= 0) {
     current_page_num_ = 0;
   } else {
     current_page_num_ = start_page;
   }
+  next_page_num_ = BP_INVALID_PAGE_NUM;
+  reset_read_ahead();
   return RC::SUCCESS;
 }
 
 bool BufferPoolIterator::has_next()
 {
-  return bitmap_.next_setted_bit(current_page_num_ + 1) != -1;
+  if (next_page_num_ == BP_INVALID_PAGE_NUM) {
+    next_page_num_ = buffer_pool_->next_allocated_page(current_page_num_ + 1, end_page_num_);
+  }
+  return next_page_num_ != BP_INVALID_PAGE_NUM;
 }
 
 PageNum BufferPoolIterator::next()
 {
-  PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
-  if (next_page != -1) {
-    current_page_num_ = next_page;
+  if (!has_next()) {
+    return BP_INVALID_PAGE_NUM;
   }
+
+  PageNum next_page = next_page_num_;
+  next_page_num_    = BP_INVALID_PAGE_NUM;
+  current_page_num_ = next_page;
+  read_ahead(next_page);
   return next_page;
 }
 
 RC BufferPoolIterator::reset()
 {
   current_page_num_ = 0;
+  next_page_num_    = BP_INVALID_PAGE_NUM;
+  reset_read_ahead();
   return RC::SUCCESS;
 }
 
+void BufferPoolIterator::enable_read_ahead(int max_pages, BPScanRing *ring /* = nullptr */)
+{
+  read_ahead_max_ = std::max(max_pages, 0);
+  scan_ring_      = ring;
+  reset_read_ahead();
+}
+
+void BufferPoolIterator::reset_read_ahead()
+{
+  read_ahead_size_  = 0;
+  sequential_count_ = 0;
+  loaded_end_page_  = 0;
+  advised_end_page_ = 0;
+}
+
+PageNum BufferPoolIterator::window_end(PageNum start_page, int count)
+{
+  PageNum end_page = start_page;
+  for (int i = 0; i < count; i++) {
+    PageNum page_num = buffer_pool_->next_allocated_page(end_page, end_page_num_);
+    if (page_num == BP_INVALID_PAGE_NUM) {
+      break;
+    }
+    end_page = page_num + 1;
+  }
+  return end_page;
+}
+
+void BufferPoolIterator::read_ahead(PageNum page_num)
+{
+  // 只遍历一两个页面的时候不预读，比如只访问开头几个页面就结束的扫描
+  if (read_ahead_max_ <= 0 || ++sequential_count_ < 2 || page_num < loaded_end_page_) {
+    return;
+  }
+
+  // 上一个窗口已经用完了，说明还在顺序遍历，扩大窗口
+  read_ahead_size_ = read_ahead_size_ == 0 ? std::min(READ_AHEAD_INIT_PAGES, read_ahead_max_)
+                                           : std::min(read_ahead_size_ * 2, read_ahead_max_);
+
+  const PageNum load_end_page = window_end(page_num, read_ahead_size_);
+  buffer_pool_->read_ahead(page_num, load_end_page - page_num, scan_ring_);
+  loaded_end_page_ = load_end_page;
+
+  // 下一个窗口让操作系统在后台读取
+  const PageNum advise_start_page = std::max(load_end_page, advised_end_page_);
+  const PageNum advise_end_page   = window_end(load_end_page, std::min(read_ahead_size_ * 2, read_ahead_max_));
+  if (advise_end_page > advise_start_page) {
+    buffer_pool_->advise_read_ahead(advise_start_page, advise_end_page - advise_start_page);
+    advised_end_page_ = advise_end_page;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 DiskBufferPool::DiskBufferPool(BufferPoolManager &bp_manager, BPFrameManager &frame_manager)
-    : bp_manager_(bp_manager), frame_manager_(frame_manager)
+    : bp_manager_(bp_manager), frame_manager_(frame_manager), stats_(&bp_manager.stats())
 {}
 
 DiskBufferPool::~DiskBufferPool()
@@ -226,17 +523,44 @@ DiskBufferPool::~DiskBufferPool()
 
 RC DiskBufferPool::open_file(const char *file_name)
 {
-  int fd = open(file_name, O_RDWR);
+  int fd = -1;
+  direct_io_ = false;
+#ifdef O_DIRECT
+  if (bp_manager_.options().direct_io) {
+    fd = open(file_name, O_RDWR | O_DIRECT);
+    if (fd >= 0) {
+      direct_io_ = true;
+    } else if (errno == EINVAL) {
+      LOG_WARN("file system does not support O_DIRECT, use buffered io instead. file=%s", file_name);
+    }
+  }
+#endif
+  if (fd < 0) {
+    fd = open(file_name, O_RDWR);
+  }
   if (fd < 0) {
     LOG_ERROR("Failed to open file %s, because %s.", file_name, strerror(errno));
     return RC::IOERR_ACCESS;
   }
-  LOG_INFO("Successfully open buffer pool file %s.", file_name);
+  LOG_INFO("Successfully open buffer pool file %s. direct io=%d", file_name, direct_io_);
 
   file_name_ = file_name;
   file_desc_ = fd;
 
-  RC rc = RC::SUCCESS;
+  // 先按照最小的页面大小读出文件头，得到文件的页面大小。O_DIRECT 要求内存是对齐的
+  unique_ptr<Page, decltype(&::free)> header_page(
+      static_cast<Page *>(::aligned_alloc(BPPageAllocator::PAGE_ALIGNMENT, BP_PAGE_SIZE)), &::free);
+  RC rc = header_page == nullptr ? RC::NOMEM : bp_manager_.page_io().read_page(fd, BP_HEADER_PAGE, *header_page);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to read header of %s. rc=%s", file_name, strrc(rc));
+    close(fd);
+    file_desc_ = -1;
+    return rc;
+  }
+  const BPFileHeader *header = reinterpret_cast<const BPFileHeader *>(header_page->data);
+  page_size_       = header->file_page_size();
+  pages_per_group_ = header->pages_per_group();
+
   rc = allocate_frame(BP_HEADER_PAGE, &hdr_frame_);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to allocate frame for header. file name %s", file_name_.c_str());
@@ -246,7 +570,6 @@ RC DiskBufferPool::open_file(const char *file_name)
   }
 
   hdr_frame_->set_file_desc(fd);
-  hdr_frame_->access();
 
   if ((rc = load_page(BP_HEADER_PAGE, hdr_frame_)) != RC::SUCCESS) {
     LOG_ERROR("Failed to load first page of %s, due to %s.", file_name, strerror(errno));
@@ -255,14 +578,41 @@ RC DiskBufferPool::open_file(const char *file_name)
     file_desc_ = -1;
     return rc;
   }
+  hdr_frame_->finish_loading(true);
 
   file_header_ = (BPFileHeader *)hdr_frame_->data();
 
+  if ((rc = load_group_stats()) != RC::SUCCESS) {
+    LOG_ERROR("Failed to load page groups of %s. rc=%s", file_name, strrc(rc));
+    close_file();
+    return rc;
+  }
+
+  init_metrics();
+
   LOG_INFO("Successfully open %s. file_desc=%d, hdr_frame=%p, file header=%s",
            file_name, file_desc_, hdr_frame_, file_header_->to_string().c_str());
   return RC::SUCCESS;
 }
 
+void DiskBufferPool::init_metrics()
+{
+  metrics_.reset(new BPMetricGroup(file_name_, "buffer_pool.file." + file_name_ + "."));
+
+  // 文件关闭以后，描述符可能已经给了别的文件
+  auto count_frames = [this](bool dirty) {
+    int frames       = 0;
+    int dirty_frames = 0;
+    if (file_desc_ >= 0) {
+      frame_manager_.count_frames(file_desc_, frames, dirty_frames);
+    }
+    return std::to_string(dirty ? dirty_frames : frames);
+  };
+  metrics_->add("cached_pages", [count_frames]() { return count_frames(false); });
+  metrics_->add("dirty_pages", [count_frames]() { return count_frames(true); });
+  metrics_->add_stats(stats_);
+}
+
 RC DiskBufferPool::close_file()
 {
   RC rc = RC::SUCCESS;
@@ -270,8 +620,6 @@ RC DiskBufferPool::close_file()
     return rc;
   }
 
-  hdr_frame_->unpin();
-
   // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
   rc = purge_all_pages();
   if (rc != RC::SUCCESS) {
@@ -279,7 +627,22 @@ RC DiskBufferPool::close_file()
     return rc;
   }
 
+  // 文件头页面最后释放。前面失败时文件头页面还pin着，可以再次关闭文件
+  if (hdr_frame_ != nullptr) {
+    std::scoped_lock lock_guard(lock_);
+    std::scoped_lock cleaner_guard(bp_manager_.page_cleaner().batch_lock());
+    rc = purge_frame(BP_HEADER_PAGE, hdr_frame_);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("failed to close %s, due to failed to purge header page. rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
+    }
+    hdr_frame_   = nullptr;
+    file_header_ = nullptr;
+  }
+
   disposed_pages_.clear();
+  group_allocated_.clear();
+  free_group_hint_ = 0;
 
   if (close(file_desc_) < 0) {
     LOG_ERROR("Failed to close fileId:%d, fileName:%s, error:%s", file_desc_, file_name_.c_str(), strerror(errno));
@@ -292,96 +655,208 @@ RC DiskBufferPool::close_file()
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
+RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame, BPScanRing *ring /* = nullptr */)
+{
+  // 读取页面不需要文件的锁，同一个页面的并发读取由页帧的加载状态协调
+  return get_page_internal(page_num, frame, ring);
+}
+
+RC DiskBufferPool::get_page_internal(PageNum page_num, Frame **frame, BPScanRing *ring /* = nullptr */)
 {
   RC rc = RC::SUCCESS;
   *frame = nullptr;
 
-  Frame *used_match_frame = frame_manager_.get(file_desc_, page_num);
+  // 顺序扫描命中的页面不算作一次访问，否则扫描过的页面都会变成热点页面
+  Frame *used_match_frame = frame_manager_.get(file_desc_, page_num, ring == nullptr /*touch*/);
   if (used_match_frame != nullptr) {
-    used_match_frame->access();
+    stats_.record_hit();
+    if ((rc = wait_for_loaded(page_num, used_match_frame)) != RC::SUCCESS) {
+      return rc;
+    }
     *frame = used_match_frame;
     return RC::SUCCESS;
   }
 
-  std::scoped_lock lock_guard(lock_); // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
+  if (ring != nullptr) {
+    // 先回收扫描环中最早加载的页面，这样加载新页面时就不需要淘汰公共的页帧
+    PageNum recycle_page_num = ring->pop_if_full();
+    if (recycle_page_num != BP_INVALID_PAGE_NUM) {
+      (void)frame_manager_.recycle(file_desc_, recycle_page_num);
+    }
+  }
 
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
-  rc = allocate_frame(page_num, &allocated_frame);
+  bool   created         = false;
+  rc = allocate_frame(page_num, &allocated_frame, ring != nullptr /*cold*/, &created);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to alloc frame %s:%d, due to failed to alloc page.", file_name_.c_str(), page_num);
     return rc;
   }
 
-  allocated_frame->set_file_desc(file_desc_);
+  if (!created) {
+    // 其它线程先放进来了，由它负责加载
+    stats_.record_hit();
+    if ((rc = wait_for_loaded(page_num, allocated_frame)) != RC::SUCCESS) {
+      return rc;
+    }
+    *frame = allocated_frame;
+    return RC::SUCCESS;
+  }
+
   // allocated_frame->pin(); // pined in manager::get
-  allocated_frame->access();
+  stats_.record_miss();
 
   if ((rc = load_page(page_num, allocated_frame)) != RC::SUCCESS) {
     LOG_ERROR("Failed to load page %s:%d", file_name_.c_str(), page_num);
-    purge_frame(page_num, allocated_frame);
+    abort_loading(page_num, allocated_frame);
     return rc;
   }
+  allocated_frame->finish_loading(true);
+
+  if (ring != nullptr) {
+    ring->push(page_num);
+  }
 
   *frame = allocated_frame;
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::wait_for_loaded(PageNum page_num, Frame *frame)
+{
+  while (true) {
+    switch (frame->load_state()) {
+      case Frame::LOADED: {
+        return RC::SUCCESS;
+      }
+      case Frame::LOADING: {
+        BPStopwatch stopwatch;
+        frame->wait_loading();
+        stats_.record_pin_wait(stopwatch.elapsed_us());
+      } break;
+      case Frame::LOAD_FAILED: {
+        if (!frame->try_start_loading()) {
+          break;  // 其它线程抢先开始重新加载了
+        }
+
+        RC rc = load_page(page_num, frame);
+        if (rc != RC::SUCCESS) {
+          LOG_ERROR("Failed to reload page %s:%d", file_name_.c_str(), page_num);
+          abort_loading(page_num, frame);
+          return rc;
+        }
+        frame->finish_loading(true);
+        return RC::SUCCESS;
+      }
+    }
+  }
+}
+
+void DiskBufferPool::abort_loading(PageNum page_num, Frame *frame)
+{
+  // 等待的线程会看到加载失败，由其中一个重新加载。没有人使用这个页帧时直接释放
+  frame->finish_loading(false);
+  frame->unpin();
+  (void)frame_manager_.recycle(file_desc_, page_num);
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
 
   lock_.lock();
-  
-  int byte = 0, bit = 0;
-  if ((file_header_->allocated_pages) < (file_header_->page_count)) {
-    // There is one free page
-    for (int i = 0; i < file_header_->page_count; i++) {
-      byte = i / 8;
-      bit = i % 8;
-      if (((file_header_->bitmap[byte]) & (1 << bit)) == 0) {
-        (file_header_->allocated_pages)++;
-        file_header_->bitmap[byte] |= (1 << bit);
-        // TODO,  do we need clean the loaded page's data?
-        hdr_frame_->mark_dirty();
-
-        lock_.unlock();
-        return get_this_page(i, frame);
-      }
+
+  // 先从有空闲页面的组中分配。free_group_hint_ 之前的组都是满的，不需要再检查
+  const int group_count = static_cast<int>(group_allocated_.size());
+  for (; free_group_hint_ < group_count; free_group_hint_++) {
+    const int group = free_group_hint_;
+    if (group_allocated_[group] >= group_page_count(group)) {
+      continue;
     }
+
+    Frame *bitmap_frame = nullptr;
+    char  *bitmap_data  = nullptr;
+    if ((rc = get_group_bitmap(group, &bitmap_frame, &bitmap_data)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to get bitmap of group %d. file=%s, rc=%s", group, file_name_.c_str(), strrc(rc));
+      lock_.unlock();
+      return rc;
+    }
+
+    Bitmap bitmap(bitmap_data, group_page_count(group));
+    const int index = bitmap.next_unsetted_bit(0);
+    if (index < 0) {
+      LOG_WARN("group has no free page but its count says it has. file=%s, group=%d, allocated=%d",
+               file_name_.c_str(), group, group_allocated_[group]);
+      bitmap_frame->unpin();
+      group_allocated_[group] = group_page_count(group);
+      continue;
+    }
+
+    bitmap.set_bit(index);
+    bitmap_frame->mark_dirty();
+    bitmap_frame->unpin();
+    group_allocated_[group]++;
+    file_header_->allocated_pages++;
+    // TODO,  do we need clean the loaded page's data?
+    hdr_frame_->mark_dirty();
+
+    lock_.unlock();
+    return get_this_page(group * pages_per_group_ + index, frame);
   }
 
-  if (file_header_->page_count >= BPFileHeader::MAX_PAGE_NUM) {
-    LOG_WARN("file buffer pool is full. page count %d, max page count %d",
-        file_header_->page_count, BPFileHeader::MAX_PAGE_NUM);
+  // 所有的组都满了，扩展文件。如果下一个页面是新组的位图页，就先创建这个组
+  PageNum page_num = file_header_->page_count;
+  if (is_bitmap_page(page_num)) {
+    page_num++;
+  }
+  if (page_num < 0 || page_num == std::numeric_limits<PageNum>::max()) {
+    LOG_WARN("file buffer pool is full. page count %d", file_header_->page_count);
     lock_.unlock();
     return RC::BUFFERPOOL_NOBUF;
   }
 
-  PageNum page_num = file_header_->page_count;
+  if ((rc = extend_to(page_num)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to extend file %s to page %d. rc=%s", file_name_.c_str(), page_num, strrc(rc));
+    lock_.unlock();
+    return rc;
+  }
+
   Frame *allocated_frame = nullptr;
-  if ((rc = allocate_frame(page_num, &allocated_frame)) != RC::SUCCESS) {
+  bool   created         = false;
+  if ((rc = allocate_frame(page_num, &allocated_frame, false /*cold*/, &created)) != RC::SUCCESS) {
     LOG_ERROR("Failed to allocate frame %s, due to no free page.", file_name_.c_str());
     lock_.unlock();
     return rc;
   }
+  if (!created) {
+    // 可能有线程在读取文件尾之后的页面，等它结束，再用新页面覆盖
+    allocated_frame->wait_loading();
+  }
 
   LOG_INFO("allocate new page. file=%s, pageNum=%d, pin=%d",
            file_name_.c_str(), page_num, allocated_frame->pin_count());
 
-  file_header_->allocated_pages++;
-  file_header_->page_count++;
+  const int group        = page_num / pages_per_group_;
+  Frame    *bitmap_frame = nullptr;
+  char     *bitmap_data  = nullptr;
+  if ((rc = get_group_bitmap(group, &bitmap_frame, &bitmap_data)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to get bitmap of group %d. file=%s, rc=%s", group, file_name_.c_str(), strrc(rc));
+    abort_loading(page_num, allocated_frame);
+    lock_.unlock();
+    return rc;
+  }
+  Bitmap(bitmap_data, group_page_count(group)).set_bit(page_num - group * pages_per_group_);
+  bitmap_frame->mark_dirty();
+  bitmap_frame->unpin();
 
-  byte = page_num / 8;
-  bit = page_num % 8;
-  file_header_->bitmap[byte] |= (1 << bit);
+  group_allocated_[group]++;
+  file_header_->allocated_pages++;
   hdr_frame_->mark_dirty();
 
   allocated_frame->set_file_desc(file_desc_);
-  allocated_frame->access();
   allocated_frame->clear_page();
-  allocated_frame->set_page_num(file_header_->page_count - 1);
+  allocated_frame->set_page_num(page_num);
+  allocated_frame->finish_loading(true);
 
   // Use flush operation to extension file
   if ((rc = flush_page_internal(*allocated_frame)) != RC::SUCCESS) {
@@ -399,19 +874,53 @@ RC DiskBufferPool::allocate_page(Frame **frame)
 RC DiskBufferPool::dispose_page(PageNum page_num)
 {
   std::scoped_lock lock_guard(lock_);
-  Frame *used_frame = frame_manager_.get(file_desc_, page_num);
-  if (used_frame != nullptr) {
-    ASSERT("the page try to dispose is in use. frame:%s", to_string(*used_frame).c_str());
-    frame_manager_.free(file_desc_, page_num, used_frame);
-  } else {
-    LOG_WARN("failed to fetch the page while disposing it. pageNum=%d", page_num);
-    return RC::NOTFOUND;
+  if (page_num >= file_header_->page_count || is_bitmap_page(page_num)) {
+    LOG_WARN("try to dispose an invalid page. file=%s, page num=%d", file_name_.c_str(), page_num);
+    return RC::BUFFERPOOL_INVALID_PAGE_NUM;
   }
 
-  hdr_frame_->mark_dirty();
-  file_header_->allocated_pages--;
-  char tmp = 1 << (page_num % 8);
-  file_header_->bitmap[page_num / 8] &= ~tmp;
+  // 加载位图页可能需要等待刷脏线程，所以要在 batch_lock 之前拿到
+  const int group        = page_num / pages_per_group_;
+  Frame    *bitmap_frame = nullptr;
+  char     *bitmap_data  = nullptr;
+  RC        rc           = get_group_bitmap(group, &bitmap_frame, &bitmap_data);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to get bitmap of group %d. file=%s, rc=%s", group, file_name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  {
+    std::scoped_lock cleaner_guard(bp_manager_.page_cleaner().batch_lock());
+    Frame *used_frame = frame_manager_.get(file_desc_, page_num);
+    if (used_frame != nullptr && used_frame->pin_count() > 1) {
+      // 乐观读的线程可能还pin着这个页面，它校验版本时会发现页面已经变了。
+      // 页帧不能释放，页面也就不再回收，留在文件中
+      LOG_INFO("the page to dispose is in use, keep it. file=%s, frame=%s",
+               file_name_.c_str(), to_string(*used_frame).c_str());
+      used_frame->unpin();
+      bitmap_frame->unpin();
+      return RC::LOCKED_UNLOCK;
+    }
+    if (used_frame != nullptr) {
+      frame_manager_.free(file_desc_, page_num, used_frame);
+    } else {
+      LOG_WARN("failed to fetch the page while disposing it. pageNum=%d", page_num);
+      bitmap_frame->unpin();
+      return RC::NOTFOUND;
+    }
+  }
+
+  Bitmap bitmap(bitmap_data, group_page_count(group));
+  const int index = page_num - group * pages_per_group_;
+  if (bitmap.get_bit(index)) {
+    bitmap.clear_bit(index);
+    bitmap_frame->mark_dirty();
+    group_allocated_[group]--;
+    file_header_->allocated_pages--;
+    hdr_frame_->mark_dirty();
+    free_group_hint_ = std::min(free_group_hint_, group);
+  }
+  bitmap_frame->unpin();
   return RC::SUCCESS;
 }
 
@@ -445,6 +954,7 @@ RC DiskBufferPool::purge_frame(PageNum page_num, Frame *buf)
 RC DiskBufferPool::purge_page(PageNum page_num)
 {
   std::scoped_lock lock_guard(lock_);
+  std::scoped_lock cleaner_guard(bp_manager_.page_cleaner().batch_lock());
   Frame *used_frame = frame_manager_.get(file_desc_, page_num);
   if (used_frame != nullptr) {
     return purge_frame(page_num, used_frame);
@@ -455,15 +965,43 @@ RC DiskBufferPool::purge_page(PageNum page_num)
 
 RC DiskBufferPool::purge_all_pages()
 {
+  // 刷脏线程可能正拿着这个文件的页帧，等它处理完再释放
+  std::scoped_lock lock_guard(lock_);
+  std::scoped_lock cleaner_guard(bp_manager_.page_cleaner().batch_lock());
+
   std::list<Frame *> used = frame_manager_.find_list(file_desc_);
+  std::vector<Frame *> frames;
+  frames.reserve(used.size());
+  for (Frame *frame : used) {
+    // 文件头页面由 close_file 在最后释放
+    if (frame == hdr_frame_) {
+      frame->unpin();
+      continue;
+    }
 
-  std::scoped_lock lock_guard(lock_);
-  for (std::list<Frame *>::iterator it = used.begin(); it != used.end(); ++it) {
-    Frame *frame = *it;
+    if (frame->pin_count() != 1) {
+      LOG_INFO("Begin to free page %d of %d(file id), but it's pin count > 1:%d.",
+          frame->page_num(), frame->file_desc(), frame->pin_count());
+      frame->unpin();
+      continue;
+    }
+    frames.push_back(frame);
+  }
+
+  RC rc = flush_frames_internal(frames);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to flush pages of %d(file desc) during purge all pages. rc=%s", file_desc_, strrc(rc));
+  }
 
-    purge_frame(frame->page_num(), frame);
+  // 没有写成功的脏页留在内存中，关闭文件时可以再试
+  for (Frame *frame : frames) {
+    if (frame->dirty()) {
+      frame->unpin();
+      continue;
+    }
+    frame_manager_.free(file_desc_, frame->page_num(), frame);
   }
-  return RC::SUCCESS;
+  return rc;
 }
 
 RC DiskBufferPool::check_all_pages_unpinned()
@@ -497,91 +1035,413 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   // so it is easier to flush data to file.
 
   Page &page = frame.page();
-  int64_t offset = ((int64_t)page.page_num) * sizeof(Page);
-  if (lseek(file_desc_, offset, SEEK_SET) == offset - 1) {
-    LOG_ERROR("Failed to flush page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, &page, sizeof(Page)) != 0) {
-    LOG_ERROR("Failed to flush page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_WRITE;
+  BPStopwatch stopwatch;
+  RC rc = bp_manager_.page_io().write_page(file_desc_, page, page_size_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page %d of %d. rc=%s", page.page_num, file_desc_, strrc(rc));
+    return rc;
   }
+  stats_.record_write(1, stopwatch.elapsed_us());
   frame.clear_dirty();
   LOG_DEBUG("Flush block. file desc=%d, pageNum=%d, pin count=%d", file_desc_, page.page_num, frame.pin_count());
 
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::flush_frames_internal(const std::vector<Frame *> &frames)
+{
+  std::vector<Frame *> dirty_frames;
+  for (Frame *frame : frames) {
+    if (frame->dirty()) {
+      dirty_frames.push_back(frame);
+    }
+  }
+  if (dirty_frames.empty()) {
+    return RC::SUCCESS;
+  }
+
+  std::sort(dirty_frames.begin(), dirty_frames.end(), [](const Frame *left, const Frame *right) {
+    return left->page_num() < right->page_num();
+  });
+
+  // 先清除脏标识再写，如果写的过程中页面又被修改了，脏标识会被重新设置上
+  std::vector<const Page *> pages;
+  pages.reserve(dirty_frames.size());
+  for (Frame *frame : dirty_frames) {
+    frame->clear_dirty();
+    pages.push_back(&frame->page());
+  }
+
+  BPStopwatch stopwatch;
+  RC rc = bp_manager_.page_io().write_pages(file_desc_, pages.data(), static_cast<int>(pages.size()), page_size_);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to flush pages of %d(file desc). count=%d, rc=%s", file_desc_, (int)pages.size(), strrc(rc));
+    for (Frame *frame : dirty_frames) {
+      frame->mark_dirty();
+    }
+    return rc;
+  }
+  stats_.record_write(static_cast<int>(pages.size()), stopwatch.elapsed_us());
+
+  LOG_DEBUG("Flush blocks. file desc=%d, count=%d", file_desc_, (int)pages.size());
+  return RC::SUCCESS;
+}
+
 RC DiskBufferPool::flush_all_pages()
 {
   std::list<Frame *> used = frame_manager_.find_list(file_desc_);
-  for (Frame *frame : used) {
-    RC rc = flush_page(*frame);
+  std::vector<Frame *> frames(used.begin(), used.end());
+
+  RC rc = RC::SUCCESS;
+  {
+    std::scoped_lock lock_guard(lock_);
+    rc = flush_frames_internal(frames);
+  }
+
+  for (Frame *frame : frames) {
+    frame->unpin();  // pinned in find_list
+  }
+
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to flush all pages");
+  }
+  return rc;
+}
+
+int DiskBufferPool::read_ahead(PageNum start_page, int count, BPScanRing *ring /* = nullptr */)
+{
+  // 只在查找需要读取的页面时持有文件的锁，读取时这些页帧都处于 LOADING 状态，访问它们的线程会等待读取完成
+  std::unique_lock lock_guard(lock_);
+
+  const PageNum end_page = std::min(start_page + count, file_header_->page_count);
+
+  // 每一段页号连续的页面作为一个读请求，所有的请求一次提交
+  std::vector<PageIORequest> requests;
+  std::vector<Frame *>       frames;
+  PageNum                    last_page    = BP_INVALID_PAGE_NUM;
+  Frame                     *bitmap_frame = nullptr;
+  int                        bitmap_group = -1;
+  common::Bitmap             bitmap;
+  for (PageNum page_num = std::max(start_page, BP_HEADER_PAGE + 1); page_num < end_page; page_num++) {
+    if (is_bitmap_page(page_num)) {
+      continue;
+    }
+
+    const int group = page_num / pages_per_group_;
+    if (group != bitmap_group) {
+      if (bitmap_frame != nullptr) {
+        bitmap_frame->unpin();
+        bitmap_frame = nullptr;
+      }
+
+      char *bitmap_data = nullptr;
+      if (get_group_bitmap(group, &bitmap_frame, &bitmap_data) != RC::SUCCESS) {
+        LOG_WARN("failed to get bitmap of group %d for read ahead. file=%s", group, file_name_.c_str());
+        break;
+      }
+      bitmap.init(bitmap_data, group_page_count(group));
+      bitmap_group = group;
+    }
+
+    if (!bitmap.get_bit(page_num - group * pages_per_group_)) {
+      continue;
+    }
+
+    Frame *frame = frame_manager_.get(file_desc_, page_num, false /*touch*/);
+    if (frame != nullptr) {
+      frame->unpin();
+      continue;
+    }
+
+    if (ring != nullptr) {
+      PageNum recycle_page_num = ring->pop_if_full();
+      if (recycle_page_num != BP_INVALID_PAGE_NUM) {
+        (void)frame_manager_.recycle(file_desc_, recycle_page_num);
+      }
+    }
+
+    bool created = false;
+    RC   rc      = allocate_frame(page_num, &frame, true /*cold*/, &created);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to flush all pages");
-      return rc;
+      LOG_WARN("failed to allocate frame for read ahead. file=%s, page num=%d, rc=%s",
+               file_name_.c_str(), page_num, strrc(rc));
+      break;
+    }
+    if (!created) {
+      frame->unpin();  // 其它线程刚刚开始加载这个页面
+      continue;
     }
+    frames.push_back(frame);
+    if (ring != nullptr) {
+      ring->push(page_num);  // 读取失败的页面会被释放，回收时找不到就跳过了
+    }
+
+    if (requests.empty() || last_page + 1 != page_num ||
+        static_cast<int>(requests.back().pages.size()) >= BPPageIO::MAX_REQUEST_PAGES) {
+      PageIORequest &request = requests.emplace_back();
+      request.file_desc      = file_desc_;
+      request.start_page     = page_num;
+      request.is_write       = false;
+      request.page_size      = page_size_;
+    }
+    requests.back().pages.push_back(&frame->page());
+    last_page = page_num;
   }
-  return RC::SUCCESS;
+
+  if (bitmap_frame != nullptr) {
+    bitmap_frame->unpin();
+  }
+  lock_guard.unlock();
+
+  BPStopwatch stopwatch;
+  (void)bp_manager_.page_io().execute(requests);
+  const int64_t latency_us = stopwatch.elapsed_us();
+
+  // 读取成功的页面留在内存中，失败的释放掉
+  int    loaded      = 0;
+  size_t frame_index = 0;
+  for (const PageIORequest &request : requests) {
+    if (request.rc != RC::SUCCESS) {
+      LOG_WARN("Failed to read ahead pages %s:%d, count=%d. rc=%s",
+               file_name_.c_str(), request.start_page, (int)request.pages.size(), strrc(request.rc));
+    }
+
+    for (size_t i = 0; i < request.pages.size(); i++, frame_index++) {
+      Frame *frame = frames[frame_index];
+      const PageNum page_num = request.start_page + static_cast<PageNum>(i);
+      if (request.rc == RC::SUCCESS) {
+        frame->set_page_num(page_num);
+        frame->finish_loading(true);
+        frame->unpin();
+        loaded++;
+      } else {
+        abort_loading(page_num, frame);
+      }
+    }
+  }
+
+  if (!requests.empty()) {
+    stats_.record_read(loaded, latency_us);
+  }
+
+  LOG_DEBUG("read ahead done. file=%s, start page=%d, count=%d, loaded=%d",
+            file_name_.c_str(), start_page, count, loaded);
+  return loaded;
 }
 
 RC DiskBufferPool::recover_page(PageNum page_num)
 {
-  int byte = 0, bit = 0;
-  byte = page_num / 8;
-  bit = page_num % 8;
-
   std::scoped_lock lock_guard(lock_);
-  if (!(file_header_->bitmap[byte] & (1 << bit))) {
-    file_header_->bitmap[byte] |= (1 << bit);
+  if (is_bitmap_page(page_num)) {
+    LOG_WARN("try to recover a bitmap page. file=%s, page num=%d", file_name_.c_str(), page_num);
+    return RC::BUFFERPOOL_INVALID_PAGE_NUM;
+  }
+
+  RC rc = extend_to(page_num);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to extend file %s to page %d. rc=%s", file_name_.c_str(), page_num, strrc(rc));
+    return rc;
+  }
+
+  const int group        = page_num / pages_per_group_;
+  Frame    *bitmap_frame = nullptr;
+  char     *bitmap_data  = nullptr;
+  if ((rc = get_group_bitmap(group, &bitmap_frame, &bitmap_data)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to get bitmap of group %d. file=%s, rc=%s", group, file_name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  Bitmap bitmap(bitmap_data, group_page_count(group));
+  const int index = page_num - group * pages_per_group_;
+  if (!bitmap.get_bit(index)) {
+    bitmap.set_bit(index);
+    bitmap_frame->mark_dirty();
+    group_allocated_[group]++;
     file_header_->allocated_pages++;
-    file_header_->page_count++;
     hdr_frame_->mark_dirty();
   }
+  bitmap_frame->unpin();
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+PageNum DiskBufferPool::next_allocated_page(PageNum start_page, PageNum end_page)
 {
-  auto purger = [this](Frame *frame) {
-    if (!frame->dirty()) {
-      return RC::SUCCESS;
+  std::scoped_lock lock_guard(lock_);
+
+  end_page         = std::min(end_page, file_header_->page_count);
+  PageNum page_num = std::max(start_page, BP_HEADER_PAGE + 1);
+  while (page_num < end_page) {
+    const int     group       = page_num / pages_per_group_;
+    const PageNum group_start = group * pages_per_group_;
+
+    // 只分配了位图页的组直接跳过，不需要读取位图
+    if (group_allocated_[group] > 1) {
+      Frame *bitmap_frame = nullptr;
+      char  *bitmap_data  = nullptr;
+      RC     rc           = get_group_bitmap(group, &bitmap_frame, &bitmap_data);
+      if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to get bitmap of group %d. file=%s, rc=%s", group, file_name_.c_str(), strrc(rc));
+        return BP_INVALID_PAGE_NUM;
+      }
+
+      Bitmap    bitmap(bitmap_data, group_page_count(group));
+      const int index = bitmap.next_setted_bit(std::max(page_num - group_start, 1));
+      bitmap_frame->unpin();
+      if (index >= 0) {
+        return group_start + index < end_page ? group_start + index : BP_INVALID_PAGE_NUM;
+      }
     }
 
-    RC rc = RC::SUCCESS;
-    if (frame->file_desc() == file_desc_) {
-      rc = this->flush_page_internal(*frame);
-    } else {
-      rc = bp_manager_.flush_page(*frame);
+    page_num = group_start + pages_per_group_;
+  }
+  return BP_INVALID_PAGE_NUM;
+}
+
+int DiskBufferPool::group_page_count(int group) const
+{
+  return std::min(file_header_->page_count - group * pages_per_group_, pages_per_group_);
+}
+
+RC DiskBufferPool::get_group_bitmap(int group, Frame **frame, char **bitmap)
+{
+  RC rc = get_page_internal(group * pages_per_group_, frame);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  if (group == 0) {
+    *bitmap = reinterpret_cast<BPFileHeader *>((*frame)->data())->group_bitmap();
+  } else {
+    *bitmap = (*frame)->data();
+  }
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::extend_to(PageNum page_num)
+{
+  while (file_header_->page_count <= page_num) {
+    const PageNum new_page = file_header_->page_count;
+    if (is_bitmap_page(new_page)) {
+      // 创建一个新的组，位图页中只有自己对应的位是1
+      Frame *frame   = nullptr;
+      bool   created = false;
+      RC     rc      = allocate_frame(new_page, &frame, false /*cold*/, &created);
+      if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to allocate frame for bitmap page %d of %s", new_page, file_name_.c_str());
+        return rc;
+      }
+      if (!created) {
+        frame->wait_loading();
+      }
+
+      frame->set_file_desc(file_desc_);
+      frame->clear_page();
+      frame->set_page_num(new_page);
+      frame->finish_loading(true);
+      Bitmap(frame->data(), pages_per_group_).set_bit(0);
+      if ((rc = flush_page_internal(*frame)) != RC::SUCCESS) {
+        LOG_ERROR("Failed to write bitmap page %d of %s", new_page, file_name_.c_str());
+        purge_frame(new_page, frame);
+        return rc;
+      }
+      frame->unpin();
+
+      group_allocated_.push_back(1);
+      file_header_->allocated_pages++;
+      LOG_INFO("create new page group. file=%s, group=%d", file_name_.c_str(), (int)group_allocated_.size() - 1);
     }
 
+    file_header_->page_count++;
+    hdr_frame_->mark_dirty();
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 统计位图中有多少个1
+ */
+static int count_bits(const char *bitmap, int bits)
+{
+  int count = 0;
+  for (int i = 0; i < bits / 8; i++) {
+    count += __builtin_popcount(static_cast<unsigned char>(bitmap[i]));
+  }
+  for (int i = bits / 8 * 8; i < bits; i++) {
+    count += (bitmap[i / 8] >> (i % 8)) & 1;
+  }
+  return count;
+}
+
+RC DiskBufferPool::load_group_stats()
+{
+  const int group_count = (file_header_->page_count + pages_per_group_ - 1) / pages_per_group_;
+  group_allocated_.assign(group_count, 0);
+  free_group_hint_ = 0;
+
+  int64_t allocated_pages = 0;
+  for (int group = 0; group < group_count; group++) {
+    Frame *bitmap_frame = nullptr;
+    char  *bitmap_data  = nullptr;
+    RC     rc           = get_group_bitmap(group, &bitmap_frame, &bitmap_data);
     if (rc != RC::SUCCESS) {
-      LOG_ERROR("Failed to aclloc block due to failed to flush old block. rc=%s", strrc(rc));
+      LOG_ERROR("Failed to get bitmap of group %d. file=%s, rc=%s", group, file_name_.c_str(), strrc(rc));
+      return rc;
     }
-    return rc;
-  };
+
+    group_allocated_[group] = count_bits(bitmap_data, group_page_count(group));
+    allocated_pages += group_allocated_[group];
+    bitmap_frame->unpin();
+  }
+
+  if (allocated_pages != file_header_->allocated_pages) {
+    LOG_WARN("allocated pages in file header does not match the bitmaps. file=%s, header=%d, bitmaps=%ld",
+             file_name_.c_str(), file_header_->allocated_pages, allocated_pages);
+    file_header_->allocated_pages = static_cast<int32_t>(allocated_pages);
+    hdr_frame_->mark_dirty();
+  }
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer, bool cold /* = false */, bool *created /* = nullptr */)
+{
+  // 淘汰的都是干净的页面，不需要写磁盘
+  auto purger = [](Frame *frame) { return RC::SUCCESS; };
 
   while (true) {
-    Frame *frame = frame_manager_.alloc(file_desc_, page_num);
+    Frame *frame = frame_manager_.alloc(file_desc_, page_num, cold, page_size_, created);
     if (frame != nullptr) {
       *buffer = frame;
       return RC::SUCCESS;
     }
 
     LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
-    (void)frame_manager_.purge_frames(1/*count*/, purger);
+    if (frame_manager_.purge_frames(1/*count*/, purger) == 0) {
+      BPStopwatch stopwatch;
+      bp_manager_.page_cleaner().wait_for_clean_frames();
+      stats_.record_pin_wait(stopwatch.elapsed_us());
+    }
   }
   return RC::BUFFERPOOL_NOBUF;
 }
 
 RC DiskBufferPool::check_page_num(PageNum page_num)
 {
-  if (page_num >= file_header_->page_count) {
+  if (page_num >= file_header_->page_count || is_bitmap_page(page_num)) {
     LOG_ERROR("Invalid pageNum:%d, file's name:%s", page_num, file_name_.c_str());
     return RC::BUFFERPOOL_INVALID_PAGE_NUM;
   }
-  if ((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0) {
+
+  const int group        = page_num / pages_per_group_;
+  Frame    *bitmap_frame = nullptr;
+  char     *bitmap_data  = nullptr;
+  RC        rc           = get_group_bitmap(group, &bitmap_frame, &bitmap_data);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  const bool allocated =
+      Bitmap(bitmap_data, group_page_count(group)).get_bit(page_num - group * pages_per_group_);
+  bitmap_frame->unpin();
+  if (!allocated) {
     LOG_ERROR("Invalid pageNum:%d, file's name:%s", page_num, file_name_.c_str());
     return RC::BUFFERPOOL_INVALID_PAGE_NUM;
   }
@@ -590,20 +1450,17 @@ RC DiskBufferPool::check_page_num(PageNum page_num)
 
 RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
 {
-  int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
+  BPStopwatch stopwatch;
+  RC rc = bp_manager_.page_io().read_page(file_desc_, page_num, frame->page(), page_size_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, rc=%s",
+              file_name_.c_str(), file_desc_, page_num, strrc(rc));
+    return rc;
   }
+  stats_.record_read(1, stopwatch.elapsed_us());
 
-  Page &page = frame->page();
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
-  if (ret != 0) {
-    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
-              file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
-    return RC::IOERR_READ;
-  }
+  // 回放日志恢复的页面可能从来没有写过，读到的页号是0，以实际的位置为准
+  frame->set_page_num(page_num);
   return RC::SUCCESS;
 }
 
@@ -611,20 +1468,113 @@ int DiskBufferPool::file_desc() const
 {
   return file_desc_;
 }
+
+int DiskBufferPool::scan_ring_size() const
+{
+  return bp_manager_.options().scan_ring_size;
+}
+
+int DiskBufferPool::read_ahead_max_pages() const
+{
+  return bp_manager_.options().read_ahead_max_pages;
+}
+
+void DiskBufferPool::advise_read_ahead(PageNum start_page, int count)
+{
+  // O_DIRECT 不经过页缓存，让操作系统预读只会把页面再缓存一份
+  if (direct_io_) {
+    return;
+  }
+  bp_manager_.page_io().will_need(file_desc_, start_page, count, page_size_);
+}
 ////////////////////////////////////////////////////////////////////////////////
 BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
+    : BufferPoolManager(BufferPoolOptions{.memory_size = memory_size})
+{}
+
+BufferPoolManager::BufferPoolManager(const BufferPoolOptions &options) : options_(options)
 {
+  int memory_size = options_.memory_size;
   if (memory_size <= 0) {
     memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
   }
   const int pool_num = std::max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
-  frame_manager_.init(pool_num);
-  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d",
-           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num);
+  RC rc = frame_manager_.init(pool_num, options_.frame_shard_num, options_.replacer.c_str(), options_.use_huge_pages);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("failed to init frame manager. rc=%s", strrc(rc));
+  }
+  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d, frame shard num: %d, "
+           "replacer: %s, scan ring size: %d",
+           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num, (int)frame_manager_.shard_num(),
+           options_.replacer.c_str(), options_.scan_ring_size);
+
+  rc = page_io_.init(options_.io_engine.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("failed to init page io. rc=%s", strrc(rc));
+  }
+  LOG_INFO("buffer pool page io engine: %s", page_io_.engine_name());
+
+  int clean_frame_target = options_.clean_frame_target;
+  if (clean_frame_target <= 0) {
+    clean_frame_target = pool_num * DEFAULT_ITEM_NUM_PER_POOL / 8;
+  }
+  init_metrics();
+
+  rc = page_cleaner_.start(clean_frame_target, options_.page_cleaner_batch_size, options_.page_cleaner_interval_ms);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("failed to start page cleaner. rc=%s", strrc(rc));
+  }
+}
+
+void BufferPoolManager::init_metrics()
+{
+  metrics_.reset(new BPMetricGroup("global", "buffer_pool."));
+
+  BPPageAllocator &allocator = frame_manager_.page_allocator();
+  metrics_->add("memory_size", [&allocator]() { return std::to_string(allocator.memory_limit()); });
+  metrics_->add("used_memory", [&allocator]() { return std::to_string(allocator.used_memory()); });
+  metrics_->add("allocated_memory", [&allocator]() { return std::to_string(allocator.allocated_memory()); });
+  metrics_->add("hugetlb_memory", [&allocator]() { return std::to_string(allocator.hugetlb_memory()); });
+  metrics_->add("thp_memory", [&allocator]() { return std::to_string(allocator.thp_memory()); });
+  // 内存调小以后还没有释放的部分，为0说明调整已经完成
+  metrics_->add("exceeded_memory", [&allocator]() { return std::to_string(allocator.exceeded_memory()); });
+
+  auto count_frames = [this](bool dirty) {
+    int frames       = 0;
+    int dirty_frames = 0;
+    frame_manager_.count_frames(-1, frames, dirty_frames);
+    return std::to_string(dirty ? dirty_frames : frames);
+  };
+  metrics_->add("cached_pages", [count_frames]() { return count_frames(false); });
+  metrics_->add("dirty_pages", [count_frames]() { return count_frames(true); });
+  metrics_->add("free_frames", [this]() { return std::to_string(frame_manager_.free_frame_num()); });
+  metrics_->add("evictions", [this]() { return std::to_string(frame_manager_.evictions()); });
+
+  metrics_->add_stats(stats_);
+
+  metrics_->add("cleaner_flushed_pages", [this]() { return std::to_string(page_cleaner_.flushed_pages()); });
+  metrics_->add("cleaner_backlog", [this]() { return std::to_string(page_cleaner_.backlog()); });
+  metrics_->add("cleaner_foreground_waits", [this]() { return std::to_string(page_cleaner_.foreground_waits()); });
+}
+
+void BufferPoolManager::status(std::vector<BPStatusItem> &items)
+{
+  std::scoped_lock lock_guard(lock_);
+  metrics_->collect(items);
+
+  std::map<std::string, DiskBufferPool *> sorted_pools(buffer_pools_.begin(), buffer_pools_.end());
+  for (auto &[file_name, bp] : sorted_pools) {
+    if (bp->metrics() != nullptr) {
+      bp->metrics()->collect(items);
+    }
+  }
 }
 
 BufferPoolManager::~BufferPoolManager()
 {
+  page_warmer_.stop();
+  page_cleaner_.stop();
+
   std::unordered_map<std::string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
@@ -633,8 +1583,16 @@ BufferPoolManager::~BufferPoolManager()
   }
 }
 
-RC BufferPoolManager::create_file(const char *file_name)
+RC BufferPoolManager::create_file(const char *file_name, int page_size /* = 0 */)
 {
+  if (page_size <= 0) {
+    page_size = BP_PAGE_SIZE;
+  }
+  if (!bp_valid_page_size(page_size)) {
+    LOG_WARN("invalid page size %d. file=%s", page_size, file_name);
+    return RC::INVALID_ARGUMENT;
+  }
+
   int fd = open(file_name, O_RDWR | O_CREAT | O_EXCL, S_IREAD | S_IWRITE);
   if (fd < 0) {
     LOG_ERROR("Failed to create %s, due to %s.", file_name, strerror(errno));
@@ -652,12 +1610,14 @@ RC BufferPoolManager::create_file(const char *file_name)
     return RC::IOERR_ACCESS;
   }
 
-  Page page;
-  memset(&page, 0, BP_PAGE_SIZE);
+  unique_ptr<char[]> page_buffer(new char[page_size]);
+  memset(page_buffer.get(), 0, page_size);
 
-  BPFileHeader *file_header = (BPFileHeader *)page.data;
+  Page         *page        = reinterpret_cast<Page *>(page_buffer.get());
+  BPFileHeader *file_header = (BPFileHeader *)page->data;
   file_header->allocated_pages = 1;
   file_header->page_count = 1;
+  file_header->page_size = page_size;
 
   char *bitmap = file_header->bitmap;
   bitmap[0] |= 0x01;
@@ -667,14 +1627,14 @@ RC BufferPoolManager::create_file(const char *file_name)
     return RC::IOERR_SEEK;
   }
 
-  if (writen(fd, (char *)&page, BP_PAGE_SIZE) != 0) {
+  if (writen(fd, page_buffer.get(), page_size) != 0) {
     LOG_ERROR("Failed to write header to file %s, due to %s.", file_name, strerror(errno));
     close(fd);
     return RC::IOERR_WRITE;
   }
 
   close(fd);
-  LOG_INFO("Successfully create %s.", file_name);
+  LOG_INFO("Successfully create %s. page size=%d", file_name, page_size);
   return RC::SUCCESS;
 }
 
@@ -752,7 +1712,79 @@ RC BufferPoolManager::flush_page(Frame &frame)
   return bp->flush_page(frame);
 }
 
+RC BufferPoolManager::start_warm_up()
+{
+  return page_warmer_.start(
+      options_.warm_up_file.c_str(), options_.warm_up_threads, options_.warm_up_dump_interval_s);
+}
+
+void BufferPoolManager::stop_warm_up()
+{
+  page_warmer_.stop();
+  if (!options_.warm_up_file.empty()) {
+    (void)page_warmer_.dump(options_.warm_up_file.c_str());
+  }
+}
+
+void BufferPoolManager::resident_pages(std::map<std::string, std::vector<PageNum>> &pages)
+{
+  std::scoped_lock lock_guard(lock_);
+  for (auto &[file_name, bp] : buffer_pools_) {
+    std::vector<PageNum> &file_pages = pages[file_name];
+    for (Frame *frame : frame_manager_.find_list(bp->file_desc())) {
+      if (frame->load_state() == Frame::LOADED) {
+        file_pages.push_back(frame->page_num());
+      }
+      frame->unpin();  // pinned in find_list
+    }
+    std::sort(file_pages.begin(), file_pages.end());
+  }
+}
+
+RC BufferPoolManager::prefetch_pages(const char *file_name, PageNum start_page, int count, int &loaded)
+{
+  loaded = 0;
+
+  // 拿着锁读取，防止读取过程中文件被关闭
+  std::scoped_lock lock_guard(lock_);
+  auto iter = buffer_pools_.find(file_name);
+  if (iter == buffer_pools_.end()) {
+    return RC::NOTFOUND;
+  }
+
+  if (frame_manager_.free_frame_num() == 0) {
+    return RC::BUFFERPOOL_NOBUF;
+  }
+
+  loaded = iter->second->read_ahead(start_page, count);
+  return RC::SUCCESS;
+}
+
 static BufferPoolManager *default_bpm = nullptr;
+RC BufferPoolManager::resize(int64_t memory_size)
+{
+  const int64_t min_memory_size = static_cast<int64_t>(DEFAULT_ITEM_NUM_PER_POOL) * BP_PAGE_SIZE;
+  if (memory_size < min_memory_size) {
+    LOG_WARN("buffer pool memory size is too small. memory size=%ld, min=%ld", memory_size, min_memory_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int64_t old_memory_size = frame_manager_.memory_size();
+  RC rc = frame_manager_.resize(memory_size);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to resize buffer pool. memory size=%ld, rc=%s", memory_size, strrc(rc));
+    return rc;
+  }
+
+  if (options_.clean_frame_target <= 0) {
+    page_cleaner_.set_clean_target(static_cast<int>(memory_size / BP_PAGE_SIZE / 8));
+  }
+  page_cleaner_.wake_up();
+  LOG_INFO("buffer pool resized. memory size: %ld -> %ld, clean target=%d",
+           old_memory_size, memory_size, page_cleaner_.clean_target());
+  return RC::SUCCESS;
+}
+
 void BufferPoolManager::set_instance(BufferPoolManager *bpm)
 {
   if (default_bpm != nullptr && bpm != nullptr) {
@@ -22,20 +22,31 @@ See the Mulan PSL v2 for more details. */
 #include <time.h>
 #include <string>
 #include <mutex>
+#include <map>
 #include <unordered_map>
 #include <functional>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <atomic>
 
 #include "common/rc.h"
 #include "common/types.h"
 #include "common/lang/mutex.h"
 #include "common/mm/mem_pool.h"
-#include "common/lang/lru_cache.h"
 #include "common/lang/bitmap.h"
 #include "storage/buffer/page.h"
+#include "storage/buffer/buffer_pool_stats.h"
 #include "storage/buffer/frame.h"
+#include "storage/buffer/frame_replacer.h"
+#include "storage/buffer/page_allocator.h"
+#include "storage/buffer/page_cleaner.h"
+#include "storage/buffer/page_io.h"
+#include "storage/buffer/page_warmer.h"
 
 class BufferPoolManager;
 class DiskBufferPool;
+class BPScanRing;
 
 /**
  * @brief BufferPool 的实现
@@ -47,24 +58,57 @@ class DiskBufferPool;
 /**
  * @brief BufferPool的文件第一个页面，存放一些元数据信息，包括了后面每页的分配信息。
  * @ingroup BufferPool
- * @details
+ * @details 参考 Linux ext2，文件中的页面按照 pages_per_group 个一组划分，每组的第一个页面是这一组的位图页，
+ * 记录组内每个页面是否已经分配。第0组的位图放在文件头中，也就是当前页面。
  * @code
- * TODO 1. 当前的做法，只能分配比较少的页面，你可以扩展一下，支持更多的页面或无限多的页面吗？
- *         可以参考Linux ext(n)和Windows NTFS等文件系统
- *      2. 当前使用bitmap存放页面分配情况，但是这种方法在页面非常多的时候，查找空闲页面的
- *         效率非常低，你有办法优化吗？
+ * group 0: | header(bitmap of group 0) | page 1 | ... | page pages_per_group - 1 |
+ * group 1: | bitmap of group 1 | page pages_per_group + 1 | ... |
+ * ...
  * @endcode
+ * 位图页自己对应的位总是1，但是它们不会被当作数据页面返回。
+ *
+ * 每个文件在创建时选择自己的页面大小，记录在 page_size 中，文件中所有的页面(包括文件头)都是这个大小。
+ * 以前的文件没有 page_size，这个位置是第0组位图的开始，位图的第0位总是1，不会是一个合法的页面大小，
+ * 这样的文件按照 BP_PAGE_SIZE 和以前的格式访问。
  */
 struct BPFileHeader 
 {
-  int32_t page_count;       //! 当前文件一共有多少个页面
-  int32_t allocated_pages;  //! 已经分配了多少个页面
-  char bitmap[0];           //! 页面分配位图, 第0个页面(就是当前页面)，总是1
+  int32_t page_count;       //! 当前文件一共有多少个页面，包括位图页
+  int32_t allocated_pages;  //! 已经分配了多少个页面，包括位图页
+  int32_t page_size;        //! 页面大小
+  char bitmap[0];           //! 第0组的页面分配位图, 第0个页面(就是当前页面)，总是1
 
   /**
-   * 能够分配的最大的页面个数，即bitmap的字节数 乘以8
+   * 以前的文件格式每组的页面个数，即文件头中bitmap的字节数 乘以8
    */
-  static const int MAX_PAGE_NUM = (BP_PAGE_DATA_SIZE - sizeof(page_count) - sizeof(allocated_pages)) * 8;
+  static constexpr int LEGACY_PAGES_PER_GROUP = (BP_PAGE_DATA_SIZE - sizeof(int32_t) * 2) * 8;
+
+  /**
+   * @brief 是否是没有记录页面大小的文件
+   */
+  bool is_legacy() const { return !bp_valid_page_size(page_size); }
+
+  /**
+   * @brief 文件的页面大小
+   */
+  int file_page_size() const { return is_legacy() ? BP_PAGE_SIZE : page_size; }
+
+  /**
+   * @brief 第0组的位图
+   */
+  char *group_bitmap() { return is_legacy() ? reinterpret_cast<char *>(&page_size) : bitmap; }
+
+  /**
+   * @brief 每组的页面个数
+   */
+  int pages_per_group() const
+  {
+    return is_legacy() ? LEGACY_PAGES_PER_GROUP : pages_per_group(page_size);
+  }
+  static int pages_per_group(int page_size)
+  {
+    return (bp_page_data_size(page_size) - static_cast<int>(sizeof(int32_t) * 3)) * 8;
+  }
 
   std::string to_string() const;
 };
@@ -82,7 +126,15 @@ class BPFrameManager
 public:
   BPFrameManager(const char *tag);
 
-  RC init(int pool_num);
+  /**
+   * @brief 初始化页帧管理器
+   * 
+   * @param pool_num  内存池个数，每个内存池有 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+   * @param shard_num 页帧表的分片个数。<=0 时使用CPU核数
+   * @param replacer  页帧淘汰策略的名字，参考 FrameReplacer::create
+   * @param use_huge_pages 页面内存是否使用大页，参考 BPPageAllocator
+   */
+  RC init(int pool_num, int shard_num = 1, const char *replacer = nullptr, bool use_huge_pages = false);
   RC cleanup();
 
   /**
@@ -90,9 +142,11 @@ public:
    * 
    * @param file_desc 文件描述符，也可以当做buffer pool文件的标识
    * @param page_num  页面号
+   * @param touch     是否记录这次访问。顺序扫描时不记录，以免把扫描的页面当成热点页面
+   *                  记录访问只设置页帧的访问标识，参考 Frame::access
    * @return Frame* 页帧指针
    */
-  Frame *get(int file_desc, PageNum page_num);
+  Frame *get(int file_desc, PageNum page_num, bool touch = true);
 
   /**
    * @brief 列出所有指定文件的页面
@@ -107,9 +161,14 @@ public:
    * 
    * @param file_desc 文件描述符
    * @param page_num 页面编号
-   * @return Frame* 页帧指针
+   * @param cold     是否是冷页面，冷页面会优先被淘汰
+   * @param page_size 页面大小，参考 BPPageAllocator
+   * @param created  返回是否是新分配的页帧。新分配的页帧处于 LOADING 状态，调用者需要加载数据以后
+   *                 调用 Frame::finish_loading；否则返回的是已经在页帧表中的页帧
+   * @return Frame* 页帧指针。没有空闲的页帧或者页面内存不够时返回 nullptr
    */
-  Frame *alloc(int file_desc, PageNum page_num);
+  Frame *alloc(int file_desc, PageNum page_num, bool cold = false, int page_size = BP_PAGE_SIZE,
+      bool *created = nullptr);
 
   /**
    * 尽管frame中已经包含了file_desc和page_num，但是依然要求
@@ -119,16 +178,92 @@ public:
 
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
-   * 尝试从pin count=0的页面中淘汰一些
+   * 尝试从pin count=0的干净页面中淘汰一些。脏页由后台刷脏线程写到磁盘，参考 BPPageCleaner
    * @param count 想要purge多少个页面
-   * @param purger 需要在释放frame之前，对页面做些什么操作。当前是刷新脏数据到磁盘
+   * @param purger 需要在释放frame之前，对页面做些什么操作
    * @return 返回本次清理了多少个页面
+   * @details 从某个分片开始依次在各个分片上查找可以淘汰的页面，每次调用的起始分片都不同，
+   * 避免总是淘汰同一个分片上的页面
    */
   int purge_frames(int count, std::function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const
+  /**
+   * @brief 查找即将被淘汰的脏页，给后台刷脏线程使用
+   * @details 每个分片按照淘汰的顺序检查最前面的若干个可以淘汰的页帧，使得空闲页帧加上这些页帧
+   * 不少于 clean_target 个。其中的脏页就是需要刷到磁盘的页面
+   * @param clean_target 需要保持干净的页帧个数
+   * @param max_count    最多返回多少个脏页
+   * @param frames       返回的脏页，都已经pin住，使用完需要unpin
+   * @return 检查的页帧中一共有多少个脏页
+   */
+  int find_dirty_victims(int clean_target, int max_count, std::vector<Frame *> &frames);
+
+  /**
+   * @brief 刷脏线程写页面之前调用，确认没有其它线程在使用这个页帧
+   * @details 调用者需要已经pin住这个页帧。成功以后，其它线程通过 get/alloc 拿到这个页帧时，
+   * 会等到 end_flush 以后才返回，所以刷脏线程写的是一个完整的页面。
+   * @return 除了调用者，还有其它线程pin着这个页帧时返回false
+   */
+  bool begin_flush(Frame *frame);
+  void end_flush(Frame *frame);
+
+  /**
+   * @brief 把页帧上的访问标识同步到各个分片的淘汰策略中
+   * @details 命中页面时只设置访问标识，由后台刷脏线程每一轮调用一次，参考 FrameReplacer
+   */
+  void sync_references();
+
+  /**
+   * @brief 如果指定的页面没有被使用并且不是脏页，就直接释放它的页帧
+   * @details 顺序扫描使用私有页帧环时，用来回收扫描过的页面
+   * @return RC::SUCCESS 表示回收成功
+   */
+  RC recycle(int file_desc, PageNum page_num);
+
+  /**
+   * @brief 当前已经映射了页面的页帧个数，即所有分片上页帧的总和
+   */
+  size_t frame_num() const;
+
+  /**
+   * @brief 还没有映射页面的空闲页帧个数
+   * @details 按照 BP_PAGE_SIZE 计算，同时受页帧个数和页面内存的限制
+   */
+  size_t free_frame_num();
+
+  /**
+   * @brief 调整所有页帧占用的内存大小
+   * @details 调大时先补充页帧，再调大页面内存的上限，不影响正在进行的访问。
+   * 调小时只调整页面内存的上限，多出来的页面由 release_frames 逐步淘汰，不会阻塞前台请求
+   */
+  RC resize(int64_t memory_size);
+
+  /**
+   * @brief 内存上限调小以后，淘汰一些干净的页帧并把页面内存还给系统
+   * @param max_count 最多淘汰多少个页帧
+   * @return 淘汰的页帧个数，没有超出上限时返回0
+   */
+  int release_frames(int max_count);
+
+  int64_t memory_size() { return page_allocator_.memory_limit(); }
+  int64_t used_memory() { return page_allocator_.used_memory(); }
+
+  BPPageAllocator &page_allocator() { return page_allocator_; }
+
+  /**
+   * @brief 统计已经映射的页帧个数和其中的脏页个数
+   * @param file_desc 只统计这个文件的页帧，小于0时统计所有的页帧
+   */
+  void count_frames(int file_desc, int &frames, int &dirty_frames);
+
+  /**
+   * @brief 一共淘汰了多少个页帧，包括内存调小以后释放的页帧
+   */
+  int64_t evictions() const { return evictions_.value(); }
+
+  size_t shard_num() const
   {
-    return frames_.count();
+    return shards_.size();
   }
 
   /**
@@ -139,10 +274,6 @@ public:
     return allocator_.get_size();
   }
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC     free_internal(const FrameId &frame_id, Frame *frame);
-
 private:
   class BPFrameIdHasher {
   public:
@@ -152,17 +283,42 @@ private:
     }
   };
 
-  using FrameLruCache = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
+  using FrameMap = std::unordered_map<FrameId, Frame *, BPFrameIdHasher>;
   using FrameAllocator = common::MemPoolSimple<Frame>;
 
-  std::mutex lock_;
-  FrameLruCache  frames_;
+  /**
+   * @brief 页帧表的一个分片
+   * @details 每个分片有自己的锁、页面映射表和淘汰策略。页面根据 FrameId::hash 映射到某个分片上，
+   * 访问不同分片上的页面时不会竞争同一把锁。按照缓存行对齐，防止不同分片的锁出现伪共享。
+   */
+  struct alignas(64) FrameShard
+  {
+    std::mutex                     lock;
+    FrameMap                       frames;
+    std::unique_ptr<FrameReplacer> replacer;
+  };
+
+  FrameShard &shard_of(const FrameId &frame_id);
+
+  Frame *get_internal(FrameShard &shard, const FrameId &frame_id, bool touch);
+  RC     free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame);
+  int    purge_shard_frames(FrameShard &shard, int count, std::function<RC(Frame *frame)> &purger);
+
+private:
+  std::vector<std::unique_ptr<FrameShard>> shards_;
+  std::atomic<size_t> purge_cursor_{0};  ///< 下次淘汰页面时从哪个分片开始找
+  BPShardedCounter    evictions_;
   FrameAllocator allocator_;
+  BPPageAllocator page_allocator_;  ///< 页帧使用的页面内存，所有页面大小共用一个上限，参考 resize
 };
 
 /**
  * @brief 用于遍历BufferPool中的所有页面
  * @ingroup BufferPool
+ * @details 开启预读以后，连续遍历时会提前把后面的页面读到内存中。
+ * 预读窗口从 READ_AHEAD_INIT_PAGES 个页面开始，每用完一个窗口就扩大一倍，直到最大值。
+ * 当前窗口中的页面一次批量读到页帧中，同时通知操作系统在后台读取下一个窗口，
+ * 等遍历到下一个窗口时，数据通常已经在页缓存中了。
  */
 class BufferPoolIterator
 {
@@ -175,9 +331,74 @@ public:
   PageNum next();
   RC reset();
 
+  /**
+   * @brief 开启顺序预读
+   * @param max_pages 预读窗口最多包含多少个已分配的页面，<=0 表示不预读
+   * @param ring      预读的页面也放到这个扫描环中，参考 BPScanRing
+   */
+  void enable_read_ahead(int max_pages, BPScanRing *ring = nullptr);
+
+  /// 预读窗口的初始大小
+  static constexpr int READ_AHEAD_INIT_PAGES = 4;
+
+private:
+  void read_ahead(PageNum page_num);
+  void reset_read_ahead();
+
+  /**
+   * @brief 从 start_page 开始数 count 个已分配的页面，返回最后一个页面的下一个页号
+   */
+  PageNum window_end(PageNum start_page, int count);
+
 private:
-  common::Bitmap bitmap_;
+  DiskBufferPool *buffer_pool_ = nullptr;
   PageNum current_page_num_ = -1;
+  PageNum next_page_num_    = BP_INVALID_PAGE_NUM;  ///< has_next 找到的下一个页面
+  PageNum end_page_num_     = 0;                    ///< 只遍历开始时已经在文件中的页面
+
+  BPScanRing *scan_ring_          = nullptr;
+  int         read_ahead_max_     = 0;
+  int         read_ahead_size_    = 0;   ///< 当前预读窗口的大小
+  int         sequential_count_   = 0;   ///< 连续遍历了多少个页面
+  PageNum     loaded_end_page_    = 0;   ///< 这个页号之前的页面已经预读到页帧中了
+  PageNum     advised_end_page_   = 0;   ///< 这个页号之前的页面已经通知操作系统读取了
+};
+
+/**
+ * @brief 顺序扫描使用的私有页帧环
+ * @ingroup BufferPool
+ * @details 全表扫描会访问大量的页面，并且这些页面通常只访问一次。如果扫描加载的页面都放在公共的
+ * 页帧中，就会把热点页面挤出内存。扫描时使用一个大小固定的环记录自己加载的页面，环满了以后，先回收
+ * 环中最早加载的页面，再加载新的页面，这样一次扫描最多只占用环大小个页帧。
+ * 在扫描过程中其它线程正在使用或者已经修改的页面不会被回收。
+ */
+class BPScanRing
+{
+public:
+  explicit BPScanRing(int size) : size_(size) {}
+
+  /**
+   * @brief 记录一个由当前扫描加载的页面
+   */
+  void push(PageNum page_num) { pages_.push_back(page_num); }
+
+  /**
+   * @brief 如果环已经满了，就弹出最早加载的页面，需要回收它
+   * @return 环没有满时返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum pop_if_full()
+  {
+    if (static_cast<int>(pages_.size()) < size_) {
+      return BP_INVALID_PAGE_NUM;
+    }
+    PageNum page_num = pages_.front();
+    pages_.pop_front();
+    return page_num;
+  }
+
+private:
+  const int           size_;
+  std::deque<PageNum> pages_;
 };
 
 /**
@@ -197,6 +418,8 @@ public:
 
   /**
    * 根据文件名打开一个分页文件
+   * @details 配置了 DIRECT_IO 时使用 O_DIRECT 打开，页面不会在操作系统的页缓存中再缓存一份。
+   * 文件系统不支持 O_DIRECT 时退化成普通的读写
    */
   RC open_file(const char *file_name);
 
@@ -207,8 +430,11 @@ public:
 
   /**
    * 根据文件ID和页号获取指定页面到缓冲区，返回页面句柄指针。
+   * @param ring 顺序扫描时使用的私有页帧环，参考 BPScanRing。为空时使用公共的页帧
+   * @details 不持有文件的锁读取磁盘，不同页面的读取可以同时进行。同一个页面同时只有一个线程读取，
+   * 其它线程等待读取完成，参考 Frame::LoadState
    */
-  RC get_this_page(PageNum page_num, Frame **frame);
+  RC get_this_page(PageNum page_num, Frame **frame, BPScanRing *ring = nullptr);
 
   /**
    * 在指定文件中分配一个新的页面，并将其放入缓冲区，返回页面句柄指针。
@@ -248,6 +474,29 @@ public:
 
   int file_desc() const;
 
+  /**
+   * @brief 文件是否使用 O_DIRECT 打开
+   */
+  bool direct_io() const { return direct_io_; }
+
+  /**
+   * @brief 顺序扫描时私有页帧环的大小，0表示不使用
+   */
+  int scan_ring_size() const;
+
+  const std::string &file_name() const { return file_name_; }
+
+  /**
+   * @brief 这个文件的访问统计，参考 BufferPoolStats
+   * @details 刷脏线程写的页面只记录在全局统计中
+   */
+  const BufferPoolStats &stats() const { return stats_; }
+
+  /**
+   * @brief 这个文件的统计项，打开文件以后才有
+   */
+  const BPMetricGroup *metrics() const { return metrics_.get(); }
+
   /**
    * 如果页面是脏的，就将数据刷新到磁盘
    */
@@ -255,21 +504,75 @@ public:
 
   /**
    * 刷新所有页面到磁盘，即使pin count不是0
+   * 页号连续的脏页会合并成一次系统调用
    */
   RC flush_all_pages();
 
+  /**
+   * @brief 预读，把从 start_page 开始的 count 个页面读到内存中
+   * @details 已经在内存中的页面和没有分配的页面会跳过，页号连续的页面一次读取。
+   * 预读的页面作为冷页面放在淘汰顺序的前面，被访问以后才会变成普通的页面。
+   * @param ring 预读的页面也放到扫描环中，环满时先回收环中最早加载的页面
+   * @return 读取了多少个页面
+   */
+  int read_ahead(PageNum start_page, int count, BPScanRing *ring = nullptr);
+
+  /**
+   * @brief 通知操作系统在后台读取这些页面，不会读到页帧中，也不会等待读取完成
+   */
+  void advise_read_ahead(PageNum start_page, int count);
+
+  /**
+   * @brief 顺序遍历时预读窗口的最大页面数，0表示不预读
+   */
+  int read_ahead_max_pages() const;
+
   /**
    * 回放日志时处理page0中已被认定为不存在的page
    */
   RC recover_page(PageNum page_num);
 
+  /**
+   * @brief 找到 [start_page, end_page) 中第一个已经分配的数据页面，位图页不算
+   * @return 没有时返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum next_allocated_page(PageNum start_page, PageNum end_page);
+
+  /**
+   * @brief 当前文件一共有多少个页面，包括没有分配的页面和位图页
+   */
+  PageNum page_count() const { return file_header_->page_count; }
+
+  /**
+   * @brief 是否是某个组的位图页，第0组的位图页就是文件头
+   */
+  bool is_bitmap_page(PageNum page_num) const { return page_num % pages_per_group_ == 0; }
+
+  /**
+   * @brief 每组的页面个数，参考 BPFileHeader
+   */
+  int pages_per_group() const { return pages_per_group_; }
+
+  /**
+   * @brief 文件的页面大小，以及每个页面可以存放数据的大小
+   */
+  int page_size() const { return page_size_; }
+  int page_data_size() const { return bp_page_data_size(page_size_); }
+
 protected:
-  RC allocate_frame(PageNum page_num, Frame **buf);
+  /**
+   * @brief 分配一个页帧，页帧不够时淘汰一些页面
+   * @param created 是否是新分配的页帧，参考 BPFrameManager::alloc
+   */
+  RC allocate_frame(PageNum page_num, Frame **buf, bool cold = false, bool *created = nullptr);
 
   /**
    * 刷新指定页面到磁盘(flush)，并且释放关联的Frame
    */
   RC purge_frame(PageNum page_num, Frame *used_frame);
+  /**
+   * @brief 检查页面是否已经分配，调用者需要持有 lock_
+   */
   RC check_page_num(PageNum page_num);
 
   /**
@@ -282,21 +585,110 @@ protected:
    */
   RC flush_page_internal(Frame &frame);
 
+  /**
+   * @brief 把这些页帧中的脏页写到磁盘
+   * @details 按照页号排序后再写，页号连续的页面合并成一次系统调用
+   */
+  RC flush_frames_internal(const std::vector<Frame *> &frames);
+
+  /**
+   * @brief get_this_page 的实现，不需要持有 lock_
+   */
+  RC get_page_internal(PageNum page_num, Frame **frame, BPScanRing *ring = nullptr);
+
+  /**
+   * @brief 确保已经pin住的页帧中的数据可以使用
+   * @details 其它线程正在加载时等待它完成；上次加载失败时由当前线程重新加载
+   */
+  RC wait_for_loaded(PageNum page_num, Frame *frame);
+
+  /**
+   * @brief 当前线程加载页面失败，唤醒等待的线程，没有人使用时释放页帧
+   */
+  void abort_loading(PageNum page_num, Frame *frame);
+
+  /**
+   * @brief 获取某个组的位图，调用者需要持有 lock_
+   * @param frame 位图所在的页帧，使用完以后需要 unpin
+   * @param bitmap 位图的数据，有效的位数参考 group_page_count
+   */
+  RC get_group_bitmap(int group, Frame **frame, char **bitmap);
+
+  /**
+   * @brief 把文件扩展到包含 page_num，需要的时候创建新的组，调用者需要持有 lock_
+   * @details 新扩展的页面都是未分配的
+   */
+  RC extend_to(PageNum page_num);
+
+  /**
+   * @brief 统计每个组已经分配的页面个数，打开文件时调用
+   */
+  RC load_group_stats();
+
+  /**
+   * @brief 组内已经在文件中的页面个数
+   */
+  int group_page_count(int group) const;
+
+  /**
+   * @brief 注册这个文件的统计项，参考 BPMetricGroup
+   */
+  void init_metrics();
+
 private:
   BufferPoolManager &  bp_manager_;
   BPFrameManager &     frame_manager_;
 
   std::string          file_name_;
   int                  file_desc_ = -1;
+  bool                 direct_io_ = false;
   Frame *              hdr_frame_ = nullptr;
   BPFileHeader *       file_header_ = nullptr;
   std::set<PageNum>    disposed_pages_;
+  int                  page_size_       = BP_PAGE_SIZE;
+  int                  pages_per_group_ = BPFileHeader::LEGACY_PAGES_PER_GROUP;
+
+  std::vector<int32_t> group_allocated_;      ///< 每个组已经分配的页面个数，包括位图页
+  int                  free_group_hint_ = 0;  ///< 这个组之前的组都没有空闲页面
+
+  BufferPoolStats                stats_;
+  std::unique_ptr<BPMetricGroup> metrics_;  ///< 在 BufferPoolManager 中删除这个对象时才取消注册
 
   common::Mutex        lock_;
 private:
   friend class BufferPoolIterator;
 };
 
+/**
+ * @brief BufferPool的配置项
+ * @ingroup BufferPool
+ * @details 进程启动时从配置文件的 [BUFFER_POOL] 中读取
+ */
+struct BufferPoolOptions
+{
+  int         memory_size     = 0;  ///< 所有页帧占用的内存大小，<=0 时使用默认值
+  int         frame_shard_num = 1;  ///< 页帧表的分片个数，<=0 时使用CPU核数
+  std::string replacer;             ///< 页帧淘汰策略，参考 FrameReplacer::create
+  int         scan_ring_size  = 0;  ///< 顺序扫描时私有页帧环的大小，0表示不使用
+  int         read_ahead_max_pages = 0;  ///< 顺序遍历时预读窗口的最大页面数，0表示不预读
+
+  int clean_frame_target       = 0;    ///< 刷脏线程需要保持的干净页帧个数，<=0 时使用页帧总数的1/8
+  int page_cleaner_batch_size  = 64;   ///< 刷脏线程每批最多写多少个页面
+  int page_cleaner_interval_ms = 100;  ///< 刷脏线程多久检查一次
+
+  std::string io_engine;  ///< 批量读写页面使用的引擎，sync 或者 io_uring，参考 BPPageIO::init
+
+  int table_page_size = BP_PAGE_SIZE;  ///< 新建的数据文件的页面大小
+  int index_page_size = BP_PAGE_SIZE;  ///< 新建的索引文件的页面大小
+
+  std::string warm_up_file;                ///< 保存内存中页面列表的文件，用于重启后预热，为空表示不预热
+  int         warm_up_threads         = 4;  ///< 预热使用的线程个数
+  int         warm_up_dump_interval_s = 0;  ///< 定期保存页面列表的间隔，<=0 表示只在退出时保存
+
+  bool use_huge_pages = false;  ///< 页面内存是否使用大页，参考 BPPageAllocator
+  bool direct_io      = false;  ///< 是否使用 O_DIRECT 读写文件，参考 DiskBufferPool::open_file
+};
+
 /**
  * @brief BufferPool的管理类
  * @ingroup BufferPool
@@ -304,21 +696,94 @@ private:
 class BufferPoolManager 
 {
 public:
+  /**
+   * @param memory_size 所有页帧占用的内存大小，<=0 时使用默认值
+   */
   BufferPoolManager(int memory_size = 0);
+  BufferPoolManager(const BufferPoolOptions &options);
   ~BufferPoolManager();
 
-  RC create_file(const char *file_name);
+  /**
+   * @brief 创建一个分页文件
+   * @param page_size 文件的页面大小，只支持 8KB、16KB、32KB 和 64KB。<=0 时使用 BP_PAGE_SIZE
+   */
+  RC create_file(const char *file_name, int page_size = 0);
   RC open_file(const char *file_name, DiskBufferPool *&bp);
   RC close_file(const char *file_name);
 
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 开始在后台预热，参考 BPPageWarmer
+   * @details 需要在打开所有的文件以后调用
+   */
+  RC start_warm_up();
+
+  /**
+   * @brief 停止预热和定期保存，并保存当前内存中的页面列表
+   * @details 需要在关闭文件之前调用，关闭文件时页面都会被释放
+   */
+  void stop_warm_up();
+
+  /**
+   * @brief 所有打开的文件在内存中的页面，按照页号排序
+   */
+  void resident_pages(std::map<std::string, std::vector<PageNum>> &pages);
+
+  /**
+   * @brief 把文件中的一段页面读到内存中，预热使用
+   * @param loaded 返回实际读取了多少个页面
+   * @return 文件没有打开时返回 RC::NOTFOUND，没有空闲页帧时返回 RC::BUFFERPOOL_NOBUF
+   */
+  RC prefetch_pages(const char *file_name, PageNum start_page, int count, int &loaded);
+
+  /**
+   * @brief 在运行时调整所有页帧占用的内存大小
+   * @details 调大立即生效。调小以后由刷脏线程在后台逐步淘汰多出来的页面，不会阻塞正在执行的请求。
+   * 没有配置 CLEAN_FRAME_TARGET 时，刷脏线程的目标也按照新的页帧个数调整
+   * @param memory_size 新的内存大小，不能小于一个内存池的页面(DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE)
+   */
+  RC resize(int64_t memory_size);
+
+  int64_t memory_size() { return frame_manager_.memory_size(); }
+  int64_t used_memory() { return frame_manager_.used_memory(); }
+
+  /**
+   * @brief 页面内存，可以查看有多少内存在大页上
+   */
+  BPPageAllocator &page_allocator() { return frame_manager_.page_allocator(); }
+
+  /**
+   * @brief 全局的访问统计，包括所有文件和刷脏线程
+   */
+  BufferPoolStats &stats() { return stats_; }
+
+  /**
+   * @brief 缓冲池当前的状态，SHOW BUFFER POOL STATUS 使用
+   * @details 先是全局的统计和内存使用情况，然后是每个打开的文件的统计
+   */
+  void status(std::vector<BPStatusItem> &items);
+
+  const BufferPoolOptions &options() const { return options_; }
+  BPPageCleaner &page_cleaner() { return page_cleaner_; }
+  BPPageIO &page_io() { return page_io_; }
+  BPPageWarmer &page_warmer() { return page_warmer_; }
+
 public:
   static void set_instance(BufferPoolManager *bpm); // TODO 优化全局变量的表示方法
   static BufferPoolManager &instance();
 
 private:
+  void init_metrics();
+
+private:
+  BufferPoolOptions options_;
+  BufferPoolStats   stats_;
   BPFrameManager frame_manager_{"BufPool"};
+  BPPageIO       page_io_;
+  BPPageCleaner  page_cleaner_{frame_manager_, page_io_, stats_};
+  BPPageWarmer   page_warmer_{*this};
+  std::unique_ptr<BPMetricGroup> metrics_;
 
   common::Mutex  lock_;
   std::unordered_map<std::string, DiskBufferPool *> buffer_pools_;
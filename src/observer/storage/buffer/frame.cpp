@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by lianyu on 2022/10/29.
 //
 
+#include <sstream>
+
 #include "storage/buffer/frame.h"
 #include "session/thread_data.h"
 #include "session/session.h"
@@ -79,26 +81,55 @@ void Frame::write_latch()
 
 void Frame::write_latch(intptr_t xid)
 {
-  {
-    scoped_lock debug_lock(debug_lock_);
-    ASSERT(pin_count_.load() > 0,
-           "frame lock. write lock failed while pin count is invalid. "
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-
-    ASSERT(read_lockers_.find(xid) == read_lockers_.end(),
-           "frame lock write while holding the read lock."
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+  ASSERT(pin_count_.load() > 0,
+         "frame lock. write lock failed while pin count is invalid. "
+         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
+         this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
+
+  // 只有持有写锁的线程才可能看到自己的xid
+  if (write_locker_.load(std::memory_order_relaxed) == xid) {
+    write_recursive_count_++;
+    return;
   }
 
-  lock_.lock();
-  write_locker_ = xid;
-  write_recursive_count_++;
+#ifdef CONCURRENCY
+  latch_.lock();
+#endif
+  write_locker_.store(xid, std::memory_order_relaxed);
+  write_recursive_count_ = 1;
 
   LOG_DEBUG("frame write lock success."
-            "this=%p, pin=%d, pageNum=%d, write locker=%lx(recursive=%d), fd=%d, xid=%lx, lbt=%s",
-            this, pin_count_.load(), page_.page_num, write_locker_, write_recursive_count_, file_desc_, xid, lbt());
+            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
+            this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
+}
+
+bool Frame::try_write_latch()
+{
+  const intptr_t xid = get_default_debug_xid();
+  ASSERT(pin_count_.load() > 0,
+         "frame lock. try write lock failed while pin count is invalid. "
+         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx",
+         this, pin_count_.load(), page_->page_num, file_desc_, xid);
+
+  const intptr_t write_locker = write_locker_.load(std::memory_order_relaxed);
+  if (write_locker == xid) {
+    write_recursive_count_++;
+    return true;
+  }
+
+  // 不支持并发的编译模式下没有真正加锁，只能根据 write_locker_ 判断其它线程是否正在写这个页面
+  if (write_locker != 0) {
+    return false;
+  }
+
+#ifdef CONCURRENCY
+  if (!latch_.try_lock()) {
+    return false;
+  }
+#endif
+  write_locker_.store(xid, std::memory_order_relaxed);
+  write_recursive_count_ = 1;
+  return true;
 }
 
 void Frame::write_unlatch()
@@ -108,28 +139,27 @@ void Frame::write_unlatch()
 
 void Frame::write_unlatch(intptr_t xid)
 {
-  // 因为当前已经加着写锁，而且写锁只有一个，所以不再加debug_lock来做校验
-  debug_lock_.lock();
-
   ASSERT(pin_count_.load() > 0, 
         "frame lock. write unlock failed while pin count is invalid."
         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-         this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+         this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
 
-  ASSERT(write_locker_ == xid,
+  ASSERT(write_locker_.load() == xid,
          "frame unlock write while not the owner."
          "write_locker=%lx, this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-         write_locker_, this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+         write_locker_.load(), this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
 
-  LOG_DEBUG("frame write unlock success. this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-            this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-
-  if (--write_recursive_count_ == 0) {
-    write_locker_ = 0;
+  if (--write_recursive_count_ > 0) {
+    return;
   }
-  debug_lock_.unlock();
-  
-  lock_.unlock();
+
+  write_locker_.store(0, std::memory_order_relaxed);
+#ifdef CONCURRENCY
+  latch_.unlock();
+#endif
+
+  LOG_DEBUG("frame write unlock success. this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
+            this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
 }
 
 void Frame::read_latch()
@@ -139,55 +169,31 @@ void Frame::read_latch()
 
 void Frame::read_latch(intptr_t xid) 
 {
-  {
-    std::scoped_lock debug_lock(debug_lock_);
-    ASSERT(pin_count_ > 0, "frame lock. read lock failed while pin count is invalid."
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-
-    ASSERT(xid != write_locker_,
-           "frame lock read while holding the write lock."
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-  }
+  ASSERT(pin_count_ > 0, "frame lock. read lock failed while pin count is invalid."
+         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
+         this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
 
-  lock_.lock_shared();
+  ASSERT(xid != write_locker_.load(),
+         "frame lock read while holding the write lock."
+         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
+         this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
 
-  {
-    scoped_lock debug_lock(debug_lock_);
-    int recursive_count = ++read_lockers_[xid];
-    LOG_DEBUG("frame read lock success."
-              "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, recursive=%d, lbt=%s",
-              this, pin_count_.load(), page_.page_num, file_desc_, xid, recursive_count, lbt());
-  }
+#ifdef CONCURRENCY
+  latch_.lock_shared();
+#endif
 }
 
 bool Frame::try_read_latch()
 {
-  intptr_t xid = get_default_debug_xid();
-  {
-    std::scoped_lock debug_lock(debug_lock_);
-    ASSERT(pin_count_ > 0, "frame try lock. read lock failed while pin count is invalid."
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-
-    ASSERT(xid != write_locker_,
-           "frame try to lock read while holding the write lock."
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-  }
-
-  bool ret = lock_.try_lock_shared();
-  if (ret) {
-    debug_lock_.lock();
-    int recursive_count = ++read_lockers_[xid];
-    LOG_DEBUG("frame read lock success."
-              "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, recursive=%d, lbt=%s",
-              this, pin_count_.load(), page_.page_num, file_desc_, xid, recursive_count, lbt());
-    debug_lock_.unlock();
-  }
+  ASSERT(pin_count_ > 0, "frame try lock. read lock failed while pin count is invalid."
+         "this=%p, pin=%d, pageNum=%d, fd=%d",
+         this, pin_count_.load(), page_->page_num, file_desc_);
 
-  return ret;
+#ifdef CONCURRENCY
+  return latch_.try_lock_shared();
+#else
+  return true;
+#endif
 }
 
 void Frame::read_unlatch()
@@ -197,91 +203,44 @@ void Frame::read_unlatch()
 
 void Frame::read_unlatch(intptr_t xid)
 {
-  {
-    std::scoped_lock debug_lock(debug_lock_);
-    ASSERT(pin_count_.load() > 0,
-            "frame lock. read unlock failed while pin count is invalid."
-            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-
-#if DEBUG
-    auto read_lock_iter = read_lockers_.find(xid);
-    int recursive_count = read_lock_iter != read_lockers_.end() ? read_lock_iter->second : 0;
-    ASSERT(recursive_count > 0,
-           "frame unlock while not holding read lock."
-           "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, recursive=%d, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, recursive_count, lbt());
-
-    if (1 == recursive_count) {
-      read_lockers_.erase(xid);
-    }
-
-#endif // DEBUG
-
-  }
-
-  LOG_DEBUG("frame read unlock success."
-            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-            this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+  ASSERT(pin_count_.load() > 0,
+         "frame lock. read unlock failed while pin count is invalid."
+         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
+         this, pin_count_.load(), page_->page_num, file_desc_, xid, lbt());
 
-  lock_.unlock_shared();
+#ifdef CONCURRENCY
+  latch_.unlock_shared();
+#endif
 }
 
 void Frame::pin()
 {
-  std::scoped_lock debug_lock(debug_lock_);
-
-  intptr_t xid = get_default_debug_xid();
   int pin_count = ++pin_count_;
 
-  LOG_DEBUG("after frame pin. "
-            "this=%p, write locker=%lx, read locker has xid %d? pin=%d, fd=%d, pageNum=%d, xid=%lx, lbt=%s",
-            this, write_locker_, read_lockers_.find(xid) != read_lockers_.end(), 
-            pin_count, file_desc_, page_.page_num, xid, lbt());
+  LOG_DEBUG("after frame pin. this=%p, pin=%d, fd=%d, pageNum=%d, lbt=%s",
+            this, pin_count, file_desc_, page_->page_num, lbt());
 }
 
 int Frame::unpin()
 {
-  intptr_t xid = get_default_debug_xid();
-
   ASSERT(pin_count_.load() > 0,
          "try to unpin a frame that pin count <= 0."
-         "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-         this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
-  
-  std::scoped_lock debug_lock(debug_lock_);
+         "this=%p, pin=%d, pageNum=%d, fd=%d, lbt=%s",
+         this, pin_count_.load(), page_->page_num, file_desc_, lbt());
 
   int pin_count = --pin_count_;
 
-  LOG_DEBUG("after frame unpin. "
-            "this=%p, write locker=%lx, read locker has xid? %d, pin=%d, fd=%d, pageNum=%d, xid=%lx, lbt=%s",
-            this, write_locker_, read_lockers_.find(xid) != read_lockers_.end(), 
-            pin_count, file_desc_, page_.page_num, xid, lbt());
-  
+  LOG_DEBUG("after frame unpin. this=%p, pin=%d, fd=%d, pageNum=%d, lbt=%s",
+            this, pin_count, file_desc_, page_->page_num, lbt());
+
   if (0 == pin_count) {
-    ASSERT(write_locker_ == 0,
-           "frame unpin to 0 failed while someone hold the write lock. write locker=%lx, pageNum=%d, fd=%d, xid=%lx",
-           write_locker_, page_.page_num, file_desc_, xid);
-    ASSERT(read_lockers_.empty(),
-           "frame unpin to 0 failed while someone hold the read locks. reader num=%d, pageNum=%d, fd=%d, xid=%lx",
-           read_lockers_.size(), page_.page_num, file_desc_, xid);
+    ASSERT(write_locker_.load() == 0 && !latch_.is_locked() && latch_.shared_count() == 0,
+           "frame unpin to 0 failed while someone hold the latch. write locker=%lx, readers=%d, pageNum=%d, fd=%d",
+           write_locker_.load(), latch_.shared_count(), page_->page_num, file_desc_);
   }
   return pin_count;
 }
 
-
-unsigned long current_time()
-{
-  struct timespec tp;
-  clock_gettime(CLOCK_MONOTONIC, &tp);
-  return tp.tv_sec * 1000 * 1000 * 1000UL + tp.tv_nsec;
-}
-
-void Frame::access()
-{
-  acc_time_ = current_time();
-}
-
 string to_string(const Frame &frame)
 {
   stringstream ss;
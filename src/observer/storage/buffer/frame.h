@@ -23,7 +23,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/buffer/page.h"
 #include "common/log/log.h"
-#include "common/lang/mutex.h"
+#include "common/lang/hybrid_latch.h"
 #include "common/types.h"
 
 /**
@@ -57,6 +57,10 @@ private:
  * 
  * 为了防止在使用过程中页面被淘汰，这里使用了pin count，当页面被使用时，pin count会增加，
  * 当页面不再使用时，pin count会减少。当pin count为0时，页面可以被淘汰。
+ *
+ * 页帧放到页帧表中时，页面数据还没有从磁盘读上来，处于 LOADING 状态。负责读取的线程不需要持有
+ * 文件的锁，其它线程找到这个页帧以后等待读取完成，不会重复读取同一个页面。读取失败时页帧变成
+ * LOAD_FAILED 状态，之后第一个拿到它的线程会重新读取。
  */
 class Frame
 {
@@ -72,36 +76,143 @@ public:
    * 而是调用reinit和reset。
    */
   void reinit()
-  {}
+  {
+    referenced_.store(false, std::memory_order_relaxed);
+  }
   void reset()
   {}
   
   void clear_page()
   {
-    memset(&page_, 0, sizeof(page_));
+    memset(page_, 0, page_size_);
+  }
+
+  /**
+   * @brief 设置页帧使用的页面内存
+   * @details 页面内存由 BPFrameManager 按照文件的页面大小分配，页帧本身不管理这块内存
+   */
+  void set_page(Page *page, int page_size)
+  {
+    page_      = page;
+    page_size_ = page_size;
   }
 
   int     file_desc() const { return file_desc_; }
   void    set_file_desc(int fd) { file_desc_ = fd; }
-  Page &  page() { return page_; }
-  PageNum page_num() const { return page_.page_num; }
-  void    set_page_num(PageNum page_num) { page_.page_num = page_num; }
-  FrameId frame_id() const { return FrameId(file_desc_, page_.page_num); }
-  LSN     lsn() const { return page_.lsn; }
-  void    set_lsn(LSN lsn) { page_.lsn = lsn; }
+  Page &  page() { return *page_; }
+  int     page_size() const { return page_size_; }
+  PageNum page_num() const { return page_->page_num; }
+  void    set_page_num(PageNum page_num) { page_->page_num = page_num; }
+  FrameId frame_id() const { return FrameId(file_desc_, page_->page_num); }
+  LSN     lsn() const { return page_->lsn; }
+  void    set_lsn(LSN lsn) { page_->lsn = lsn; }
+
+  /**
+   * @brief 记录页帧被访问了一次
+   * @details 命中页面是最热的路径，这里只设置一个访问标识，不读时钟，也不修改淘汰策略的数据结构。
+   * 访问标识由淘汰策略在淘汰时或者后台线程定期收集，参考 FrameReplacer::sync_references。
+   * 已经设置过就不再写，频繁访问的热点页面不会反复写同一个缓存行
+   */
+  void access()
+  {
+    if (!referenced_.load(std::memory_order_relaxed)) {
+      referenced_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  bool referenced() const { return referenced_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 清除访问标识
+   * @return 清除之前是否有访问标识。和 access 之间不是原子的，并发时可能丢掉一次访问，对淘汰没有影响
+   */
+  bool clear_referenced()
+  {
+    if (!referenced_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    referenced_.store(false, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief 页面数据的加载状态
+   */
+  enum LoadState
+  {
+    LOADED,       ///< 页面数据可以使用
+    LOADING,      ///< 有一个线程正在读取页面数据
+    LOAD_FAILED,  ///< 上次读取失败了，需要重新读取
+  };
+
+  LoadState load_state() const { return load_state_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 新分配的页帧在放到页帧表之前设置成 LOADING，分配它的线程负责加载数据
+   */
+  void set_loading() { load_state_.store(LOADING, std::memory_order_relaxed); }
+
+  /**
+   * @brief 上次读取失败时，由当前线程重新读取
+   * @return 当前线程负责读取时返回 true
+   */
+  bool try_start_loading()
+  {
+    LoadState expected = LOAD_FAILED;
+    return load_state_.compare_exchange_strong(expected, LOADING, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief 加载结束，唤醒等待的线程
+   */
+  void finish_loading(bool success)
+  {
+    load_state_.store(success ? LOADED : LOAD_FAILED, std::memory_order_release);
+    load_state_.notify_all();
+  }
 
-  /// 刷新访问时间 TODO touch is better?
-  void access();
+  /**
+   * @brief 等待其它线程加载结束，调用者需要已经pin住当前页帧
+   */
+  void wait_loading()
+  {
+    load_state_.wait(LOADING, std::memory_order_acquire);
+  }
 
   /**
    * @brief 标记指定页面为“脏”页。如果修改了页面的内容，则应调用此函数，
    * 以便该页面被淘汰出缓冲区时系统将新的页面数据写入磁盘文件
    */
-  void mark_dirty() { dirty_ = true; }
-  void clear_dirty() { dirty_ = false; }
-  bool dirty() const { return dirty_; }
+  void mark_dirty() { dirty_.store(true); }
+  bool dirty() const { return dirty_.load(); }
+
+  /**
+   * @brief 清除脏标识
+   * @return 清除之前是不是脏页。刷脏线程用它判断是否需要写，不会和其它线程设置脏标识冲突
+   */
+  bool clear_dirty() { return dirty_.exchange(false); }
+
+  /**
+   * @brief 刷脏线程开始写这个页面。调用者需要拿着页帧所在分片的锁，并且只有自己pin住了这个页帧
+   * @details 写完之前，其它线程pin住这个页帧以后需要调用 wait_flushing 等待，不能修改页面
+   */
+  void set_flushing() { flushing_.store(true, std::memory_order_release); }
+
+  /**
+   * @brief 写页面结束，唤醒等待的线程
+   */
+  void finish_flushing()
+  {
+    flushing_.store(false, std::memory_order_release);
+    flushing_.notify_all();
+  }
+
+  /**
+   * @brief 等待刷脏线程写完这个页面，调用者需要已经pin住当前页帧
+   */
+  void wait_flushing() { flushing_.wait(true, std::memory_order_acquire); }
 
-  char *data() { return page_.data; }
+  char *data() { return page_->data; }
 
   bool can_purge() { return pin_count_.load() == 0; }
 
@@ -118,12 +229,27 @@ public:
   int  unpin();
   int  pin_count() const { return pin_count_.load(); }
 
+  /**
+   * @brief 加写锁
+   * @details 同一个 xid 可以重复加写锁，加了几次就要释放几次。持有读锁时不能再加写锁
+   */
   void write_latch();
   void write_latch(intptr_t xid);
 
+  /**
+   * @brief 尝试加写锁，其它线程持有锁时马上返回false
+   */
+  bool try_write_latch();
+
   void write_unlatch();
   void write_unlatch(intptr_t xid);
-  
+
+  /**
+   * @brief 加读锁
+   * @details 读锁需要修改锁的状态，适合需要长时间访问页面的场景，比如遍历页面上的记录。
+   * 只是短暂地读取一下页面内容，可以使用乐观读。
+   * 同一个线程可以重复加读锁(比如自连接的两个扫描读同一个页面)，读锁要在加锁的线程上释放
+   */
   void read_latch();
   void read_latch(intptr_t xid);
   bool try_read_latch();
@@ -131,25 +257,37 @@ public:
   void read_unlatch();
   void read_unlatch(intptr_t xid);
 
+  /**
+   * @brief 开始乐观读
+   * @details 乐观读不加锁，也不修改页帧上的任何状态。读完以后调用 optimistic_read_validate
+   * 校验期间页面没有被修改，校验失败就重试或者改成加读锁。乐观读期间页面可能正在被修改，
+   * 校验通过之前读到的数据都不可信，访问页面上的偏移量、长度等信息时要检查边界。
+   * 调用者需要已经pin住当前页帧。
+   * @param[out] version 开始读时的版本号
+   * @return 有人持有写锁时返回 false
+   */
+  bool optimistic_read_latch(uint64_t &version) const { return latch_.try_optimistic_read(version); }
+  bool optimistic_read_validate(uint64_t version) const { return latch_.validate(version); }
+
   friend std::string to_string(const Frame &frame);
 
 private:
   friend class  BufferPool;
 
-  bool              dirty_     = false;
+  std::atomic<bool> dirty_{false};
+  std::atomic<bool> flushing_{false};
   std::atomic<int>  pin_count_{0};
-  unsigned long     acc_time_  = 0;
+  std::atomic<LoadState> load_state_{LOADED};
+  std::atomic<bool> referenced_{false};  ///< 上次收集以后是否被访问过
   int               file_desc_ = -1;
-  Page              page_;
-
-  /// 在非并发编译时，加锁解锁动作将什么都不做
-  common::RecursiveSharedMutex     lock_;
+  Page             *page_      = nullptr;
+  int               page_size_ = BP_PAGE_SIZE;
 
-  /// 使用一些手段来做测试，提前检测出头疼的死锁问题
-  /// 如果编译时没有增加调试选项，这些代码什么都不做
-  common::DebugMutex  debug_lock_;
-  intptr_t            write_locker_ = 0;
-  int                 write_recursive_count_ = 0;
-  std::unordered_map<intptr_t, int>  read_lockers_;
+  /// 页面锁，写锁释放时增加版本号，读者可以通过版本号做乐观读。
+  /// 与其它锁一样，只有在CONCURRENCY编译模式下才会真正加锁，否则版本号不会变化，乐观读总是成功
+  common::HybridLatch    latch_;
+  /// 写锁可以重入，这两个字段只有持有写锁的线程才会修改
+  std::atomic<intptr_t>  write_locker_{0};
+  int                    write_recursive_count_ = 0;
 };
 
@@ -0,0 +1,297 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <strings.h>
+#include <algorithm>
+#include <vector>
+
+#include "storage/buffer/frame_replacer.h"
+#include "storage/buffer/frame.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+FrameReplacer *FrameReplacer::create(const char *name)
+{
+  if (common::is_blank(name) || 0 == strcasecmp(name, "lru")) {
+    return new LruFrameReplacer();
+  }
+
+  if (0 == strcasecmp(name, "clock")) {
+    return new ClockFrameReplacer();
+  }
+
+  if (0 == strcasecmp(name, "lru-k") || 0 == strcasecmp(name, "lru-2")) {
+    return new LruKFrameReplacer(2);
+  }
+
+  LOG_ERROR("unknown frame replacer name. name=%s", name);
+  return nullptr;
+}
+
+/**
+ * @brief 按照淘汰顺序遍历候选页帧，有访问标识的页帧清除标识后先跳过，放到 referenced 中
+ * @param get_frame 从迭代器取出页帧
+ * @return func 要求停止遍历时返回 false
+ */
+template <typename Iter, typename GetFrame>
+static bool visit_unreferenced(
+    Iter begin, Iter end, GetFrame get_frame, function<bool(Frame *)> &func, vector<Frame *> &referenced)
+{
+  for (Iter iter = begin; iter != end; ++iter) {
+    Frame *frame = get_frame(*iter);
+    if (frame->clear_referenced()) {
+      referenced.push_back(frame);
+      continue;
+    }
+
+    if (!func(frame)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LruFrameReplacer::insert(Frame *frame, bool cold)
+{
+  ASSERT(nodes_.find(frame) == nodes_.end(), "frame has been inserted into replacer. frame=%p", frame);
+  if (cold) {
+    nodes_.emplace(frame, lru_list_.insert(lru_list_.end(), frame));
+  } else {
+    nodes_.emplace(frame, lru_list_.insert(lru_list_.begin(), frame));
+  }
+}
+
+void LruFrameReplacer::access(Frame *frame)
+{
+  auto iter = nodes_.find(frame);
+  if (iter != nodes_.end()) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+  }
+}
+
+void LruFrameReplacer::sync_references()
+{
+  // 从尾部向头部依次移到头部，访问过的页帧之间保持原来的先后顺序
+  vector<Frame *> referenced;
+  for (auto iter = lru_list_.rbegin(); iter != lru_list_.rend(); ++iter) {
+    if ((*iter)->clear_referenced()) {
+      referenced.push_back(*iter);
+    }
+  }
+  for (Frame *frame : referenced) {
+    access(frame);
+  }
+}
+
+void LruFrameReplacer::remove(Frame *frame)
+{
+  auto iter = nodes_.find(frame);
+  if (iter != nodes_.end()) {
+    lru_list_.erase(iter->second);
+    nodes_.erase(iter);
+  }
+}
+
+void LruFrameReplacer::foreach_victim(function<bool(Frame *)> func)
+{
+  vector<Frame *> referenced;
+  const bool finished =
+      visit_unreferenced(lru_list_.rbegin(), lru_list_.rend(), [](Frame *frame) { return frame; }, func, referenced);
+
+  // 遍历时访问过的页帧移到头部，如果还需要更多的候选，再按照原来的顺序给出它们
+  for (Frame *frame : referenced) {
+    access(frame);
+  }
+  if (finished) {
+    for (Frame *frame : referenced) {
+      if (!func(frame)) {
+        break;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ClockFrameReplacer::insert(Frame *frame, bool cold)
+{
+  ASSERT(nodes_.find(frame) == nodes_.end(), "frame has been inserted into replacer. frame=%p", frame);
+  // 放在指针的前面，这样新的页帧会在指针转动一圈之后才会被检查
+  auto iter = ring_.insert(hand_, Node{frame, !cold});
+  nodes_.emplace(frame, iter);
+}
+
+void ClockFrameReplacer::access(Frame *frame)
+{
+  auto iter = nodes_.find(frame);
+  if (iter != nodes_.end()) {
+    iter->second->referenced = true;
+  }
+}
+
+void ClockFrameReplacer::sync_references()
+{
+  // 转动指针时直接检查页帧上的访问标识
+}
+
+void ClockFrameReplacer::remove(Frame *frame)
+{
+  auto iter = nodes_.find(frame);
+  if (iter == nodes_.end()) {
+    return;
+  }
+
+  if (hand_ == iter->second) {
+    ++hand_;
+  }
+  ring_.erase(iter->second);
+  nodes_.erase(iter);
+}
+
+void ClockFrameReplacer::foreach_victim(function<bool(Frame *)> func)
+{
+  // 指针转动一圈，没有访问标识的页帧直接作为候选；有访问标识的清除标识，
+  // 放到最后再作为候选，这样每个页帧最多只会被检查一次
+  vector<Frame *> second_chance;
+  const size_t    ring_size = ring_.size();
+  for (size_t step = 0; step < ring_size; step++) {
+    if (hand_ == ring_.end()) {
+      hand_ = ring_.begin();
+    }
+
+    Node &node = *hand_;
+    ++hand_;
+    if (node.frame->clear_referenced() || node.referenced) {
+      node.referenced = false;
+      second_chance.push_back(node.frame);
+      continue;
+    }
+
+    if (!func(node.frame)) {
+      return;
+    }
+  }
+
+  for (Frame *frame : second_chance) {
+    if (!func(frame)) {
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LruKFrameReplacer::LruKFrameReplacer(int k /* = 2 */) : k_(std::max(k, 1))
+{}
+
+void LruKFrameReplacer::insert(Frame *frame, bool cold)
+{
+  ASSERT(entries_.find(frame) == entries_.end(), "frame has been inserted into replacer. frame=%p", frame);
+  Entry &entry = entries_[frame];
+  entry.history.push_back(++current_ts_);
+  if (cold) {
+    entry.history_iter = history_list_.insert(history_list_.begin(), frame);
+  } else {
+    entry.history_iter = history_list_.insert(history_list_.end(), frame);
+  }
+  entry.in_history = true;
+
+  if (k_ == 1) {
+    record_access(frame, entry);
+  }
+}
+
+void LruKFrameReplacer::access(Frame *frame)
+{
+  auto iter = entries_.find(frame);
+  if (iter == entries_.end()) {
+    return;
+  }
+
+  Entry &entry = iter->second;
+  entry.history.push_back(++current_ts_);
+  if (entry.history.size() > static_cast<size_t>(k_)) {
+    if (!entry.in_history) {
+      cache_set_.erase(make_pair(entry.history.front(), frame));
+    }
+    entry.history.pop_front();
+  }
+  record_access(frame, entry);
+}
+
+void LruKFrameReplacer::sync_references()
+{
+  vector<Frame *> referenced;
+  for (auto &[frame, entry] : entries_) {
+    if (frame->clear_referenced()) {
+      referenced.push_back(frame);
+    }
+  }
+  for (Frame *frame : referenced) {
+    access(frame);
+  }
+}
+
+void LruKFrameReplacer::record_access(Frame *frame, Entry &entry)
+{
+  if (entry.history.size() < static_cast<size_t>(k_)) {
+    // 访问次数还不够，按照LRU的顺序放到最后面
+    history_list_.splice(history_list_.end(), history_list_, entry.history_iter);
+    return;
+  }
+
+  if (entry.in_history) {
+    history_list_.erase(entry.history_iter);
+    entry.in_history = false;
+  }
+  cache_set_.emplace(entry.history.front(), frame);
+}
+
+void LruKFrameReplacer::remove(Frame *frame)
+{
+  auto iter = entries_.find(frame);
+  if (iter == entries_.end()) {
+    return;
+  }
+
+  Entry &entry = iter->second;
+  if (entry.in_history) {
+    history_list_.erase(entry.history_iter);
+  } else {
+    cache_set_.erase(make_pair(entry.history.front(), frame));
+  }
+  entries_.erase(iter);
+}
+
+void LruKFrameReplacer::foreach_victim(function<bool(Frame *)> func)
+{
+  vector<Frame *> referenced;
+  const bool finished =
+      visit_unreferenced(history_list_.begin(), history_list_.end(), [](Frame *frame) { return frame; }, func,
+          referenced) &&
+      visit_unreferenced(cache_set_.begin(), cache_set_.end(),
+          [](const pair<uint64_t, Frame *> &item) { return item.second; }, func, referenced);
+
+  for (Frame *frame : referenced) {
+    access(frame);
+  }
+  if (finished) {
+    for (Frame *frame : referenced) {
+      if (!func(frame)) {
+        break;
+      }
+    }
+  }
+}
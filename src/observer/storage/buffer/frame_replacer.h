@@ -0,0 +1,176 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <functional>
+#include <list>
+#include <set>
+#include <unordered_map>
+
+class Frame;
+
+/**
+ * @brief 页帧淘汰策略
+ * @ingroup BufferPool
+ * @details 页帧管理器的每个分片都有一个淘汰策略对象，记录页帧的访问情况，在内存不足时给出
+ * 应该优先淘汰哪些页帧。淘汰策略本身不做并发控制，由页帧管理器分片的锁来保护。
+ * 进程启动时根据配置的名字创建具体的对象，参考 FrameReplacer::create。
+ *
+ * 命中页面时页帧管理器不调用 access，只设置页帧上的访问标识(Frame::access)。淘汰策略在两个地方
+ * 收集访问标识：遍历淘汰候选时，有访问标识的页帧先按照一次访问处理，再放到最后作为候选；
+ * 后台刷脏线程每一轮调用 sync_references，把这段时间访问过的页帧都按照一次访问记录下来。
+ * 所以访问顺序的精度是后台线程的一轮，同一轮中的多次访问只算一次。
+ */
+class FrameReplacer
+{
+public:
+  FrameReplacer() = default;
+  virtual ~FrameReplacer() = default;
+
+  /**
+   * @brief 新的页帧加入到页帧管理器中
+   *
+   * @param frame 页帧
+   * @param cold  是否是冷页面。比如顺序扫描加载的页面，大概率不会再被访问，应该尽快淘汰
+   */
+  virtual void insert(Frame *frame, bool cold) = 0;
+
+  /**
+   * @brief 页帧被访问了一次，立即更新淘汰顺序
+   */
+  virtual void access(Frame *frame) = 0;
+
+  /**
+   * @brief 收集页帧上的访问标识，每个有标识的页帧按照一次访问处理并清除标识
+   * @details 需要遍历所有的页帧，由后台线程定期调用，参考 BPFrameManager::sync_references
+   */
+  virtual void sync_references() = 0;
+
+  /**
+   * @brief 页帧从页帧管理器中删除
+   */
+  virtual void remove(Frame *frame) = 0;
+
+  /**
+   * @brief 按照淘汰的优先级，从高到低遍历页帧
+   * @details 遍历时不能修改当前淘汰策略对象，比如调用 insert/remove。
+   * 有些淘汰策略，比如CLOCK，遍历本身也会修改淘汰信息。
+   * @param func 返回false时停止遍历
+   */
+  virtual void foreach_victim(std::function<bool(Frame *)> func) = 0;
+
+  virtual size_t size() const = 0;
+
+public:
+  /**
+   * @brief 根据名字创建淘汰策略
+   * @details 当前支持 lru、clock 和 lru-k(lru-2)。名字为空时使用lru
+   */
+  static FrameReplacer *create(const char *name);
+};
+
+/**
+ * @brief LRU 淘汰策略
+ * @ingroup BufferPool
+ * @details 淘汰最久没有访问过的页帧。一次全表扫描就会把热点页面都挤出去
+ */
+class LruFrameReplacer : public FrameReplacer
+{
+public:
+  void insert(Frame *frame, bool cold) override;
+  void access(Frame *frame) override;
+  void sync_references() override;
+  void remove(Frame *frame) override;
+  void foreach_victim(std::function<bool(Frame *)> func) override;
+
+  size_t size() const override { return nodes_.size(); }
+
+private:
+  std::list<Frame *> lru_list_;  ///< 头部是最近访问过的页帧
+  std::unordered_map<Frame *, std::list<Frame *>::iterator> nodes_;
+};
+
+/**
+ * @brief CLOCK 淘汰策略
+ * @ingroup BufferPool
+ * @details 所有页帧组成一个环，每个页帧有一个访问标识。访问页帧时仅设置访问标识，不需要移动页帧。
+ * 淘汰时从指针位置开始转动，如果页帧有访问标识，就清除标识给它“第二次机会”，否则就淘汰它。
+ * 页帧上的访问标识在转动时直接检查，不需要定期收集
+ */
+class ClockFrameReplacer : public FrameReplacer
+{
+public:
+  void insert(Frame *frame, bool cold) override;
+  void access(Frame *frame) override;
+  void sync_references() override;
+  void remove(Frame *frame) override;
+  void foreach_victim(std::function<bool(Frame *)> func) override;
+
+  size_t size() const override { return nodes_.size(); }
+
+private:
+  struct Node
+  {
+    Frame *frame;
+    bool   referenced;
+  };
+
+  using NodeList = std::list<Node>;
+
+  NodeList                                           ring_;
+  NodeList::iterator                                 hand_ = ring_.end();  ///< 时钟指针，指向下一个要检查的页帧
+  std::unordered_map<Frame *, NodeList::iterator>    nodes_;
+};
+
+/**
+ * @brief LRU-K 淘汰策略
+ * @ingroup BufferPool
+ * @details 记录每个页帧最近K次的访问时间，淘汰第K次访问时间最早的页帧。访问次数不足K次的页帧，
+ * 优先被淘汰，它们之间按照LRU的顺序。
+ * 顺序扫描的页面通常只会访问一次，所以在淘汰时排在前面，不会将多次访问的热点页面挤出去。
+ */
+class LruKFrameReplacer : public FrameReplacer
+{
+public:
+  explicit LruKFrameReplacer(int k = 2);
+
+  void insert(Frame *frame, bool cold) override;
+  void access(Frame *frame) override;
+  void sync_references() override;
+  void remove(Frame *frame) override;
+  void foreach_victim(std::function<bool(Frame *)> func) override;
+
+  size_t size() const override { return entries_.size(); }
+
+private:
+  struct Entry
+  {
+    std::deque<uint64_t>         history;  ///< 最近K次访问的时间，头部是最早的
+    std::list<Frame *>::iterator history_iter;
+    bool                         in_history = true;  ///< 在 history_list_ 还是 cache_set_ 中
+  };
+
+  void record_access(Frame *frame, Entry &entry);
+
+private:
+  const int k_;
+  uint64_t  current_ts_ = 0;  ///< 逻辑时钟，每次访问加一
+
+  std::list<Frame *>                       history_list_;  ///< 访问次数不足K次的页帧，头部是最久没有访问过的
+  std::set<std::pair<uint64_t, Frame *>>   cache_set_;     ///< 访问次数达到K次的页帧，按照第K次访问时间排序
+  std::unordered_map<Frame *, Entry>       entries_;
+};
@@ -23,12 +23,17 @@ static constexpr int BP_INVALID_PAGE_NUM = -1;
 
 static constexpr PageNum BP_HEADER_PAGE   = 0;
 
+/// 默认的页面大小，也是最小的页面大小。每个文件可以在创建时选择自己的页面大小，参考 BPFileHeader
 static constexpr const int BP_PAGE_SIZE = (1 << 13);
 static constexpr const int BP_PAGE_DATA_SIZE = (BP_PAGE_SIZE - sizeof(PageNum) - sizeof(LSN));
 
+/// 最大的页面大小
+static constexpr const int BP_MAX_PAGE_SIZE = (1 << 16);
+
 /**
  * @brief 表示一个页面，可能放在内存或磁盘上
  * @ingroup BufferPool
+ * @details 页面大于 BP_PAGE_SIZE 时，data 会超出这里声明的大小，页面的实际大小由文件决定。
  */
 struct Page
 {
@@ -36,3 +41,19 @@ struct Page
   LSN     lsn;
   char data[BP_PAGE_DATA_SIZE];
 };
+
+/**
+ * @brief 页面大小是否合法，只支持 8KB、16KB、32KB 和 64KB
+ */
+inline bool bp_valid_page_size(int page_size)
+{
+  return page_size >= BP_PAGE_SIZE && page_size <= BP_MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+}
+
+/**
+ * @brief 页面中可以存放数据的大小
+ */
+inline int bp_page_data_size(int page_size)
+{
+  return page_size - static_cast<int>(sizeof(PageNum) + sizeof(LSN));
+}
@@ -0,0 +1,315 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <algorithm>
+
+#include "storage/buffer/page_allocator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+BPPageAllocator::~BPPageAllocator()
+{
+  for (auto &[base, chunk] : chunks_) {
+    ::munmap(chunk->base, chunk->size);
+  }
+  chunks_.clear();
+}
+
+void BPPageAllocator::init(int64_t memory_limit, bool use_huge_pages /* = false */)
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    use_huge_pages_ = use_huge_pages;
+  }
+  set_memory_limit(memory_limit);
+}
+
+void BPPageAllocator::set_memory_limit(int64_t memory_limit)
+{
+  lock_guard<mutex> guard(lock_);
+  memory_limit_ = memory_limit;
+  (void)release_free_chunks(0);
+}
+
+int BPPageAllocator::size_class(int page_size)
+{
+  int index = 0;
+  for (int size = BP_PAGE_SIZE; size < page_size; size <<= 1) {
+    index++;
+  }
+  return index;
+}
+
+Page *BPPageAllocator::alloc(int page_size)
+{
+  ASSERT(bp_valid_page_size(page_size), "invalid page size %d", page_size);
+
+  lock_guard<mutex> guard(lock_);
+  if (used_memory_ + page_size > memory_limit_) {
+    return nullptr;
+  }
+
+  Chunk *chunk = prepare_chunk(page_size);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+
+  Page *page = chunk->free_pages.back();
+  chunk->free_pages.pop_back();
+  chunk->used++;
+  if (chunk->free_pages.empty()) {
+    free_chunks_[size_class(page_size)].erase(chunk);
+  }
+  used_memory_ += page_size;
+  return page;
+}
+
+void BPPageAllocator::free(Page *page, int page_size)
+{
+  lock_guard<mutex> guard(lock_);
+  Chunk *chunk = find_chunk(page);
+  ASSERT(chunk != nullptr && chunk->page_size == page_size,
+         "free a page not allocated by this allocator. page=%p, page size=%d", page, page_size);
+
+  used_memory_ -= page_size;
+  chunk->used--;
+  chunk->free_pages.push_back(page);
+
+  std::set<Chunk *> &free_chunks = free_chunks_[size_class(page_size)];
+  if (chunk->used > 0) {
+    free_chunks.insert(chunk);
+    return;
+  }
+
+  free_chunks.erase(chunk);
+  if (allocated_memory_ > memory_limit_) {
+    // 上限调小了，直接还给系统
+    unmap_chunk(chunk);
+  } else if (chunk->size == CHUNK_SIZE) {
+    // 整块都空闲了，可以重新切分给其它大小的页面使用
+    chunk->page_size = 0;
+    chunk->free_pages.clear();
+    empty_chunks_.push_back(chunk);
+  } else {
+    free_chunks.insert(chunk);
+  }
+}
+
+BPPageAllocator::Chunk *BPPageAllocator::prepare_chunk(int page_size)
+{
+  std::set<Chunk *> &free_chunks = free_chunks_[size_class(page_size)];
+  if (!free_chunks.empty()) {
+    return *free_chunks.begin();
+  }
+
+  Chunk *chunk = nullptr;
+  if (!empty_chunks_.empty()) {
+    chunk = empty_chunks_.back();
+    empty_chunks_.pop_back();
+  } else {
+    // 剩余的内存不够一整块时，只映射一个页面。其它大小的块中可能有一些空闲页面，但是还有页面正在使用，
+    // 没有办法还给系统，这时候占用的内存会稍微超出上限。调用者已经保证正在使用的内存不会超出上限
+    int64_t chunk_size = CHUNK_SIZE;
+    if (allocated_memory_ + CHUNK_SIZE > memory_limit_) {
+      chunk_size = page_size;
+      (void)release_free_chunks(page_size);
+    }
+
+    chunk = map_chunk(chunk_size);
+    if (chunk == nullptr) {
+      return nullptr;
+    }
+  }
+
+  carve(chunk, page_size);
+  return chunk;
+}
+
+bool BPPageAllocator::release_free_chunks(int64_t size)
+{
+  while (!empty_chunks_.empty() && allocated_memory_ + size > memory_limit_) {
+    Chunk *chunk = empty_chunks_.back();
+    empty_chunks_.pop_back();
+    unmap_chunk(chunk);
+  }
+
+  for (int i = 0; i < SIZE_CLASS_NUM && allocated_memory_ + size > memory_limit_; i++) {
+    std::set<Chunk *> &free_chunks = free_chunks_[i];
+    for (auto iter = free_chunks.begin(); iter != free_chunks.end() && allocated_memory_ + size > memory_limit_; ) {
+      Chunk *chunk = *iter;
+      if (chunk->used > 0) {
+        ++iter;
+        continue;
+      }
+
+      iter = free_chunks.erase(iter);
+      unmap_chunk(chunk);
+    }
+  }
+  return allocated_memory_ + size <= memory_limit_;
+}
+
+BPPageAllocator::Chunk *BPPageAllocator::map_chunk(int64_t size)
+{
+  const int prot  = PROT_READ | PROT_WRITE;
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+  char     *base = nullptr;
+  ChunkType type = ChunkType::NORMAL;
+  if (use_huge_pages_ && size == CHUNK_SIZE) {
+#ifdef MAP_HUGETLB
+    if (!hugetlb_failed_) {
+      void *addr = ::mmap(nullptr, size, prot, flags | MAP_HUGETLB, -1, 0);
+      if (addr != MAP_FAILED) {
+        base = static_cast<char *>(addr);
+        type = ChunkType::HUGETLB;
+      } else {
+        hugetlb_failed_ = true;
+        LOG_INFO("no reserved huge pages, use transparent huge pages instead. error=%s", strerror(errno));
+      }
+    }
+#endif
+
+#ifdef MADV_HUGEPAGE
+    if (base == nullptr) {
+      // 透明大页要求地址按照大页对齐，多映射一块再把两头多余的部分去掉
+      void *addr = ::mmap(nullptr, size + CHUNK_SIZE, prot, flags, -1, 0);
+      if (addr != MAP_FAILED) {
+        char *raw     = static_cast<char *>(addr);
+        char *raw_end = raw + size + CHUNK_SIZE;
+        base = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(raw) + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1));
+        if (base > raw) {
+          ::munmap(raw, base - raw);
+        }
+        if (raw_end > base + size) {
+          ::munmap(base + size, raw_end - (base + size));
+        }
+        if (::madvise(base, size, MADV_HUGEPAGE) == 0) {
+          type = ChunkType::THP;
+        }
+      }
+    }
+#endif
+  }
+
+  if (base == nullptr) {
+    void *addr = ::mmap(nullptr, size, prot, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+      LOG_WARN("failed to map page memory. size=%ld, error=%s", size, strerror(errno));
+      return nullptr;
+    }
+    base = static_cast<char *>(addr);
+  }
+
+  Chunk *chunk = new Chunk;
+  chunk->base  = base;
+  chunk->size  = size;
+  chunk->type  = type;
+  chunks_.emplace(base, chunk);
+
+  allocated_memory_ += size;
+  if (type == ChunkType::HUGETLB) {
+    hugetlb_memory_ += size;
+  } else if (type == ChunkType::THP) {
+    thp_memory_ += size;
+  }
+  return chunk;
+}
+
+void BPPageAllocator::unmap_chunk(Chunk *chunk)
+{
+  allocated_memory_ -= chunk->size;
+  if (chunk->type == ChunkType::HUGETLB) {
+    hugetlb_memory_ -= chunk->size;
+  } else if (chunk->type == ChunkType::THP) {
+    thp_memory_ -= chunk->size;
+  }
+
+  const char *base = chunk->base;
+  ::munmap(chunk->base, chunk->size);
+  chunks_.erase(base);  // chunk 在这里被释放
+}
+
+BPPageAllocator::Chunk *BPPageAllocator::find_chunk(Page *page)
+{
+  const char *addr = reinterpret_cast<const char *>(page);
+  auto        iter = chunks_.upper_bound(addr);
+  if (iter == chunks_.begin()) {
+    return nullptr;
+  }
+
+  --iter;
+  Chunk *chunk = iter->second.get();
+  return addr < chunk->base + chunk->size ? chunk : nullptr;
+}
+
+void BPPageAllocator::carve(Chunk *chunk, int page_size)
+{
+  const int page_num = static_cast<int>(chunk->size / page_size);
+  chunk->page_size   = page_size;
+  chunk->used        = 0;
+  chunk->free_pages.clear();
+  chunk->free_pages.reserve(page_num);
+  // 倒序放入，按照地址从小到大分配
+  for (int i = page_num - 1; i >= 0; i--) {
+    chunk->free_pages.push_back(reinterpret_cast<Page *>(chunk->base + static_cast<int64_t>(i) * page_size));
+  }
+  free_chunks_[size_class(page_size)].insert(chunk);
+}
+
+int64_t BPPageAllocator::memory_limit()
+{
+  lock_guard<mutex> guard(lock_);
+  return memory_limit_;
+}
+
+int64_t BPPageAllocator::used_memory()
+{
+  lock_guard<mutex> guard(lock_);
+  return used_memory_;
+}
+
+int64_t BPPageAllocator::free_memory()
+{
+  lock_guard<mutex> guard(lock_);
+  return memory_limit_ - used_memory_;
+}
+
+int64_t BPPageAllocator::exceeded_memory()
+{
+  lock_guard<mutex> guard(lock_);
+  return max(used_memory_ - memory_limit_, int64_t(0));
+}
+
+int64_t BPPageAllocator::allocated_memory()
+{
+  lock_guard<mutex> guard(lock_);
+  return allocated_memory_;
+}
+
+int64_t BPPageAllocator::hugetlb_memory()
+{
+  lock_guard<mutex> guard(lock_);
+  return hugetlb_memory_;
+}
+
+int64_t BPPageAllocator::thp_memory()
+{
+  lock_guard<mutex> guard(lock_);
+  return thp_memory_;
+}
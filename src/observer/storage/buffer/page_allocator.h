@@ -0,0 +1,158 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 页帧使用的页面内存
+ * @ingroup BufferPool
+ * @details 页面内存使用 mmap 按块(chunk)申请，每块 CHUNK_SIZE(2MB)，正好是一个大页的大小，
+ * 缓冲池很大时可以减少扫描和索引查找的 TLB miss。开启大页以后，先尝试 MAP_HUGETLB 使用预留的大页，
+ * 系统没有预留大页时退化成按照 2MB 对齐映射，再通过 madvise(MADV_HUGEPAGE) 建议内核使用透明大页。
+ * 剩余的内存不够一整块时，按照单个页面的大小映射。
+ *
+ * 每个文件的页面大小可能不同，页面内存按照大小分成几类(8KB、16KB、32KB、64KB)，一个块只切分成
+ * 同一类大小的页面。块里的页面全部释放以后，可以重新切分给其它大小的页面使用。
+ * 所有大小的页面共用一个内存上限，正在使用的页面达到上限以后分配失败，调用者需要淘汰一些页帧后再重试。
+ * 需要映射新的内存时，先释放其它大小的空闲块腾出空间。块中只要还有页面在使用就不能还给系统，
+ * 所以有多种大小的页面时，从系统申请的内存可能因为碎片稍微超出上限。
+ * 页面内存按照 PAGE_ALIGNMENT 对齐，可以直接用于 O_DIRECT 读写。
+ *
+ * 内存上限可以在运行时调整。调小以后，空闲的块立即还给系统，正在使用的块在里面的页面都释放以后
+ * 还给系统，直到占用的内存降到上限以下。
+ */
+class BPPageAllocator
+{
+public:
+  BPPageAllocator() = default;
+  ~BPPageAllocator();
+
+  /**
+   * @param memory_limit   所有页面最多占用多少内存
+   * @param use_huge_pages 是否使用大页
+   */
+  void init(int64_t memory_limit, bool use_huge_pages = false);
+
+  /**
+   * @brief 调整内存上限
+   * @details 不会等待正在使用的页面释放，可以通过 exceeded_memory 查看还有多少内存超出上限
+   */
+  void set_memory_limit(int64_t memory_limit);
+
+  /**
+   * @brief 分配一个页面
+   * @return 达到内存上限时返回 nullptr
+   */
+  Page *alloc(int page_size);
+  void  free(Page *page, int page_size);
+
+  int64_t memory_limit();
+
+  /**
+   * @brief 正在被页帧使用的内存
+   */
+  int64_t used_memory();
+
+  /**
+   * @brief 还可以分配多少内存，包括空闲的页面
+   */
+  int64_t free_memory();
+
+  /**
+   * @brief 正在使用的内存超出上限多少，调小上限以后需要淘汰这么多内存的页面
+   */
+  int64_t exceeded_memory();
+
+  /**
+   * @brief 从系统申请的内存，包括空闲的页面
+   */
+  int64_t allocated_memory();
+
+  /**
+   * @brief 使用 MAP_HUGETLB 映射的内存，这些内存一定在大页上
+   */
+  int64_t hugetlb_memory();
+
+  /**
+   * @brief 建议内核使用透明大页的内存，实际是否在大页上取决于内核的透明大页配置
+   */
+  int64_t thp_memory();
+
+  static constexpr int     SIZE_CLASS_NUM = 4;
+  static constexpr size_t  PAGE_ALIGNMENT = 4096;
+  static constexpr int64_t CHUNK_SIZE     = 2 * 1024 * 1024;
+
+private:
+  enum class ChunkType
+  {
+    NORMAL,   ///< 普通的内存
+    HUGETLB,  ///< MAP_HUGETLB 映射的大页
+    THP,      ///< 建议内核使用透明大页
+  };
+
+  /**
+   * @brief 一次 mmap 映射的内存，切分成同样大小的页面
+   */
+  struct Chunk
+  {
+    char               *base      = nullptr;
+    int64_t             size      = 0;
+    ChunkType           type      = ChunkType::NORMAL;
+    int                 page_size = 0;  ///< 切分的页面大小，0表示还没有切分
+    int                 used      = 0;  ///< 正在使用的页面个数
+    std::vector<Page *> free_pages;
+  };
+
+  static int size_class(int page_size);
+
+  Chunk *map_chunk(int64_t size);
+  void   unmap_chunk(Chunk *chunk);
+  Chunk *find_chunk(Page *page);
+  void   carve(Chunk *chunk, int page_size);
+
+  /**
+   * @brief 为 page_size 大小的页面准备一个有空闲页面的块
+   */
+  Chunk *prepare_chunk(int page_size);
+
+  /**
+   * @brief 释放空闲的块，直到可以再申请 size 大小的内存
+   */
+  bool release_free_chunks(int64_t size);
+
+private:
+  std::mutex lock_;
+
+  bool use_huge_pages_ = false;
+  bool hugetlb_failed_ = false;  ///< 系统没有预留大页时，后面就不再尝试 MAP_HUGETLB 了
+
+  int64_t memory_limit_     = 0;
+  int64_t allocated_memory_ = 0;  ///< 从系统申请的内存，包括空闲的页面
+  int64_t used_memory_      = 0;
+  int64_t hugetlb_memory_   = 0;
+  int64_t thp_memory_       = 0;
+
+  std::map<const char *, std::unique_ptr<Chunk>> chunks_;  ///< 所有的块，按照起始地址排序
+  std::set<Chunk *>    free_chunks_[SIZE_CLASS_NUM];  ///< 每类页面中有空闲页面的块
+  std::vector<Chunk *> empty_chunks_;                 ///< 没有切分的 CHUNK_SIZE 大小的块
+};
@@ -0,0 +1,267 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <pthread.h>
+#include <algorithm>
+#include <chrono>
+
+#include "storage/buffer/page_cleaner.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/page_io.h"
+#include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+
+using namespace std;
+using namespace common;
+
+static const char *FLUSH_RATE_METRIC_TAG = "buffer_pool.page_cleaner.flush_rate";
+static const char *BACKLOG_METRIC_TAG    = "buffer_pool.page_cleaner.backlog";
+
+/// 前台线程每次等待刷脏线程的最长时间
+static const int FOREGROUND_WAIT_MS = 10;
+
+/**
+ * @brief 刷脏的积压，即淘汰顺序最前面的页帧中还有多少个脏页
+ */
+class BPPageCleaner::BacklogGauge : public Gauge
+{
+public:
+  BacklogGauge(const BPPageCleaner &cleaner) : cleaner_(cleaner) {}
+  ~BacklogGauge() { delete snapshot_value_; }
+  void snapshot() override;
+
+private:
+  const BPPageCleaner &cleaner_;
+};
+
+void BPPageCleaner::BacklogGauge::snapshot()
+{
+  if (snapshot_value_ == nullptr) {
+    snapshot_value_ = new SnapshotBasic<long>();
+  }
+  long value = cleaner_.backlog();
+  static_cast<SnapshotBasic<long> *>(snapshot_value_)->setValue(value);
+}
+
+BPPageCleaner::BPPageCleaner(BPFrameManager &frame_manager, BPPageIO &page_io, BufferPoolStats &stats)
+    : frame_manager_(frame_manager),
+      page_io_(page_io),
+      stats_(stats),
+      flush_meter_(new Meter()),
+      backlog_gauge_(new BacklogGauge(*this))
+{}
+
+BPPageCleaner::~BPPageCleaner()
+{
+  stop();
+}
+
+RC BPPageCleaner::start(int clean_target, int batch_size, int interval_ms)
+{
+  lock_guard<mutex> lock(mutex_);
+  if (running_) {
+    LOG_WARN("page cleaner has been started");
+    return RC::INTERNAL;
+  }
+
+  clean_target_.store(max(clean_target, 1));
+  batch_size_   = max(batch_size, 1);
+  interval_ms_  = max(interval_ms, 1);
+  running_      = true;
+  thread_       = thread(&BPPageCleaner::run, this);
+
+  get_metrics_registry().register_metric(FLUSH_RATE_METRIC_TAG, flush_meter_.get());
+  get_metrics_registry().register_metric(BACKLOG_METRIC_TAG, backlog_gauge_.get());
+
+  LOG_INFO("page cleaner started. clean target=%d, batch size=%d, interval=%dms",
+           clean_target_.load(), batch_size_, interval_ms_);
+  return RC::SUCCESS;
+}
+
+void BPPageCleaner::stop()
+{
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  request_cv_.notify_all();
+  done_cv_.notify_all();
+  thread_.join();
+
+  get_metrics_registry().unregister(FLUSH_RATE_METRIC_TAG);
+  get_metrics_registry().unregister(BACKLOG_METRIC_TAG);
+  LOG_INFO("page cleaner stopped. flushed pages=%ld, foreground waits=%ld",
+           flushed_pages_.load(), foreground_waits_.load());
+}
+
+void BPPageCleaner::run()
+{
+  pthread_setname_np(pthread_self(), "PageCleaner");
+
+  unique_lock<mutex> lock(mutex_);
+  while (running_) {
+    request_cv_.wait_for(lock, chrono::milliseconds(interval_ms_), [this]() { return !running_ || requested_; });
+    if (!running_) {
+      break;
+    }
+    requested_ = false;
+
+    lock.unlock();
+    // 先把这一轮页帧上的访问标识收集到淘汰策略中，再按照淘汰顺序找脏页
+    frame_manager_.sync_references();
+
+    // 写满了一批说明积压比较多，不需要等待，接着刷下一批。内存超出上限时也接着淘汰
+    int flushed  = 0;
+    int released = 0;
+    do {
+      flushed  = clean_batch();
+      released = release_batch();
+    } while ((flushed >= batch_size_ || released > 0) && running_);
+    lock.lock();
+
+    batch_seq_++;
+    done_cv_.notify_all();
+  }
+}
+
+void BPPageCleaner::wait_for_clean_frames()
+{
+  foreground_waits_.fetch_add(1);
+
+  unique_lock<mutex> lock(mutex_);
+  if (!running_) {
+    lock.unlock();
+    (void)clean_batch();
+    return;
+  }
+
+  const uint64_t seq = batch_seq_;
+  requested_         = true;
+  request_cv_.notify_one();
+  done_cv_.wait_for(lock, chrono::milliseconds(FOREGROUND_WAIT_MS), [this, seq]() {
+    return !running_ || batch_seq_ != seq;
+  });
+}
+
+int BPPageCleaner::clean_batch()
+{
+  lock_guard<mutex> batch_guard(batch_lock_);
+
+  const int batch_size = max(batch_size_, 1);
+  vector<Frame *> frames;
+  frames.reserve(batch_size);
+  const int backlog = frame_manager_.find_dirty_victims(max(clean_target_.load(), 1), batch_size, frames);
+  backlog_.store(backlog);
+  if (frames.empty()) {
+    return 0;
+  }
+
+  sort(frames.begin(), frames.end(), [](const Frame *left, const Frame *right) {
+    if (left->file_desc() != right->file_desc()) {
+      return left->file_desc() < right->file_desc();
+    }
+    return left->page_num() < right->page_num();
+  });
+
+  const int flushed = flush_frames(frames);
+  for (Frame *frame : frames) {
+    frame->unpin();
+  }
+
+  flushed_pages_.fetch_add(flushed);
+  backlog_.store(max(backlog - flushed, 0));
+  flush_meter_->inc(flushed);
+  LOG_DEBUG("page cleaner flushed a batch. candidates=%d, flushed=%d, backlog=%d",
+            (int)frames.size(), flushed, backlog);
+  return flushed;
+}
+
+int BPPageCleaner::release_batch()
+{
+  lock_guard<mutex> batch_guard(batch_lock_);
+  return frame_manager_.release_frames(max(batch_size_, 1));
+}
+
+void BPPageCleaner::wake_up()
+{
+  lock_guard<mutex> lock(mutex_);
+  requested_ = true;
+  request_cv_.notify_one();
+}
+
+int BPPageCleaner::flush_frames(vector<Frame *> &frames)
+{
+  // 先清除脏标识再写。写完以后页面又被修改了，脏标识会被重新设置上
+  vector<Frame *> flushing;
+  flushing.reserve(frames.size());
+  for (Frame *frame : frames) {
+    // 别人正在使用这个页面，等下一批再刷
+    if (!frame_manager_.begin_flush(frame)) {
+      continue;
+    }
+
+    if (frame->clear_dirty()) {
+      flushing.push_back(frame);
+    } else {
+      frame_manager_.end_flush(frame);
+    }
+  }
+
+  // 所有文件的脏页一次提交给读写引擎，可以同时执行
+  vector<PageIORequest> requests;
+  vector<const Page *>  pages;
+  for (size_t start = 0; start < flushing.size(); ) {
+    const int file_desc = flushing[start]->file_desc();
+    const int page_size = flushing[start]->page_size();
+    pages.clear();
+    while (start < flushing.size() && flushing[start]->file_desc() == file_desc) {
+      pages.push_back(&flushing[start]->page());
+      start++;
+    }
+    BPPageIO::make_write_requests(file_desc, pages.data(), static_cast<int>(pages.size()), requests, page_size);
+  }
+
+  BPStopwatch stopwatch;
+  (void)page_io_.execute(requests);
+  const int64_t latency_us = stopwatch.elapsed_us();
+
+  // 请求是按照页帧的顺序拆分的
+  int    flushed     = 0;
+  size_t frame_index = 0;
+  for (const PageIORequest &request : requests) {
+    if (request.rc == RC::SUCCESS) {
+      flushed += static_cast<int>(request.pages.size());
+    } else {
+      LOG_WARN("page cleaner failed to flush pages. file desc=%d, start page=%d, count=%d, rc=%s",
+               request.file_desc, request.start_page, (int)request.pages.size(), strrc(request.rc));
+    }
+
+    for (size_t i = 0; i < request.pages.size(); i++, frame_index++) {
+      Frame *frame = flushing[frame_index];
+      if (request.rc != RC::SUCCESS) {
+        frame->mark_dirty();
+      }
+      frame_manager_.end_flush(frame);
+    }
+  }
+
+  if (!requests.empty()) {
+    stats_.record_write(flushed, latency_us);
+  }
+  return flushed;
+}
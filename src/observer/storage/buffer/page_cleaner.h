@@ -0,0 +1,141 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/rc.h"
+
+class BPFrameManager;
+class BPPageIO;
+class BufferPoolStats;
+class Frame;
+
+namespace common {
+class Meter;
+}
+
+/**
+ * @brief 后台刷脏线程
+ * @ingroup BufferPool
+ * @details 页帧不够用时，前台线程只会淘汰干净的页帧，不会在淘汰时同步地把脏页写到磁盘。
+ * 刷脏线程周期性地检查淘汰顺序最前面的 clean_target 个页帧，把其中的脏页写到磁盘，
+ * 让它们变成可以直接淘汰的干净页帧。空闲页帧也算作干净的页帧，所以内存充足时什么都不用做。
+ * 一批脏页按照(文件, 页号)排序后再写，尽量让磁盘顺序写，页号连续的页面会合并成一次系统调用。
+ * 写页面之前通过 BPFrameManager::begin_flush 确认没有其它线程pin着页帧，写完之前其它线程也拿不到它，
+ * 所以写到磁盘上的不会是修改了一半的页面。
+ *
+ * 刷脏线程直接使用页帧上记录的文件描述符写磁盘，不加 DiskBufferPool 和 BufferPoolManager 的锁，
+ * 这样前台线程拿着这些锁等待干净页帧时也不会死锁。关闭文件和释放页面之前需要拿着 batch_lock，
+ * 保证刷脏线程没有在使用这个文件的页帧。
+ *
+ * 缓冲池的内存调小以后，刷脏线程每刷一批脏页，就淘汰一批干净的页帧，逐步把内存降到上限以下，
+ * 参考 BPFrameManager::release_frames。
+ *
+ * 刷脏线程同时也是淘汰策略的时钟：每一轮开始时收集页帧上的访问标识，参考 FrameReplacer。
+ */
+class BPPageCleaner
+{
+public:
+  /**
+   * @param stats 写页面的个数和延迟记录在这里，一般是全局的统计
+   */
+  BPPageCleaner(BPFrameManager &frame_manager, BPPageIO &page_io, BufferPoolStats &stats);
+  ~BPPageCleaner();
+
+  /**
+   * @brief 启动刷脏线程
+   *
+   * @param clean_target 淘汰顺序最前面需要保持干净的页帧个数
+   * @param batch_size   每批最多写多少个页面
+   * @param interval_ms  没有前台请求时，多久检查一次
+   */
+  RC start(int clean_target, int batch_size, int interval_ms);
+  void stop();
+
+  /**
+   * @brief 前台线程找不到干净的页帧时调用，唤醒刷脏线程，并等待它刷完一批脏页
+   * @details 最多等待一小段时间，调用者需要自己重试。如果刷脏线程没有启动，就直接在当前线程刷一批
+   */
+  void wait_for_clean_frames();
+
+  /**
+   * @brief 刷一批脏页
+   * @return 写到磁盘的页面个数
+   */
+  int clean_batch();
+
+  /**
+   * @brief 内存上限调小以后，淘汰一批干净的页帧
+   * @return 淘汰的页帧个数
+   */
+  int release_batch();
+
+  /**
+   * @brief 唤醒刷脏线程，不等待
+   */
+  void wake_up();
+
+  void set_clean_target(int clean_target) { clean_target_.store(std::max(clean_target, 1)); }
+  int  clean_target() const { return clean_target_.load(); }
+
+  /**
+   * @brief 刷脏线程处理一批页帧时会拿着这把锁
+   */
+  std::mutex &batch_lock() { return batch_lock_; }
+
+  int64_t flushed_pages() const { return flushed_pages_.load(); }
+  int64_t backlog() const { return backlog_.load(); }
+  int64_t foreground_waits() const { return foreground_waits_.load(); }
+
+private:
+  void run();
+  int  flush_frames(std::vector<Frame *> &frames);
+
+  class BacklogGauge;
+
+private:
+  BPFrameManager  &frame_manager_;
+  BPPageIO        &page_io_;
+  BufferPoolStats &stats_;
+
+  std::atomic<int> clean_target_{0};
+  int              batch_size_ = 0;
+  int              interval_ms_ = 0;
+
+  std::thread             thread_;
+  std::mutex              mutex_;
+  std::condition_variable request_cv_;  ///< 唤醒刷脏线程
+  std::condition_variable done_cv_;     ///< 刷完一批以后唤醒等待的前台线程
+  bool                    running_   = false;
+  bool                    requested_ = false;
+  uint64_t                batch_seq_ = 0;
+
+  std::mutex batch_lock_;
+
+  std::atomic<int64_t> flushed_pages_{0};
+  std::atomic<int64_t> backlog_{0};
+  std::atomic<int64_t> foreground_waits_{0};
+
+  std::unique_ptr<common::Meter> flush_meter_;    ///< 每秒写了多少个页面
+  std::unique_ptr<BacklogGauge>  backlog_gauge_;  ///< 刷脏的积压
+};
@@ -0,0 +1,240 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/uio.h>
+#include <algorithm>
+
+#include "storage/buffer/page_io.h"
+#include "storage/buffer/page_io_uring.h"
+#include "common/io/io.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+
+static_assert(BPPageIO::MAX_REQUEST_PAGES <= IOV_MAX, "too many pages in one request");
+
+/**
+ * @brief 使用 preadv/pwritev 读写，直到所有的数据都处理完
+ * @details 系统调用可能只处理了部分数据，需要跳过已经处理完的部分继续
+ * @return 0 表示成功，-1 表示读到了文件尾，其它表示errno
+ */
+static int vector_io(bool is_write, int fd, struct iovec *iov, int iovcnt, int64_t offset, int64_t &io_count)
+{
+  while (iovcnt > 0) {
+    const ssize_t ret = is_write ? ::pwritev(fd, iov, iovcnt, offset) : ::preadv(fd, iov, iovcnt, offset);
+    io_count++;
+    if (ret < 0) {
+      const int err = errno;
+      if (EAGAIN != err && EINTR != err) {
+        return err;
+      }
+      continue;
+    }
+
+    if (0 == ret) {
+      return -1;  // end of file
+    }
+
+    offset += ret;
+    size_t done = static_cast<size_t>(ret);
+    while (iovcnt > 0 && done >= iov->iov_len) {
+      done -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0 && done > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+      iov->iov_len -= done;
+    }
+  }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RC SyncPageIOEngine::execute_one(PageIORequest &request, int64_t &io_count)
+{
+  vector<struct iovec> iovs(request.pages.size());
+  for (size_t i = 0; i < request.pages.size(); i++) {
+    iovs[i].iov_base = request.pages[i];
+    iovs[i].iov_len  = request.page_size;
+  }
+
+  const int64_t offset = static_cast<int64_t>(request.start_page) * request.page_size;
+  const int ret = vector_io(request.is_write, request.file_desc, iovs.data(), static_cast<int>(iovs.size()),
+                            offset, io_count);
+  if (ret != 0) {
+    LOG_WARN("failed to %s pages. file desc=%d, start page=%d, count=%d, ret=%d, error=%s",
+             request.is_write ? "write" : "read", request.file_desc, request.start_page, (int)request.pages.size(),
+             ret, ret > 0 ? strerror(ret) : "end of file");
+    return request.is_write ? RC::IOERR_WRITE : RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+void SyncPageIOEngine::execute(PageIORequest requests[], int count, int64_t &io_count)
+{
+  for (int i = 0; i < count; i++) {
+    requests[i].rc = execute_one(requests[i], io_count);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BPPageIO::BPPageIO() : engine_(new SyncPageIOEngine())
+{}
+
+BPPageIO::~BPPageIO() = default;
+
+RC BPPageIO::init(const char *engine)
+{
+  if (common::is_blank(engine) || 0 == strcasecmp(engine, "sync")) {
+    engine_.reset(new SyncPageIOEngine());
+    return RC::SUCCESS;
+  }
+
+  if (0 == strcasecmp(engine, "io_uring")) {
+    unique_ptr<UringPageIOEngine> uring_engine(new UringPageIOEngine());
+    RC rc = uring_engine->init();
+    if (rc == RC::SUCCESS) {
+      engine_ = std::move(uring_engine);
+      return RC::SUCCESS;
+    }
+    LOG_WARN("failed to init io_uring, use sync page io instead. rc=%s", strrc(rc));
+  } else {
+    LOG_WARN("unknown page io engine, use sync instead. name=%s", engine);
+  }
+
+  engine_.reset(new SyncPageIOEngine());
+  return RC::SUCCESS;
+}
+
+const char *BPPageIO::engine_name() const
+{
+  return engine_->name();
+}
+
+RC BPPageIO::read_page(int file_desc, PageNum page_num, Page &page, int page_size /* = BP_PAGE_SIZE */)
+{
+  const int ret = preadn(file_desc, &page, page_size, static_cast<int64_t>(page_num) * page_size);
+  io_count_.fetch_add(1);
+  if (ret != 0) {
+    LOG_WARN("failed to read page. file desc=%d, page num=%d, ret=%d, error=%s",
+             file_desc, page_num, ret, ret > 0 ? strerror(ret) : "end of file");
+    return RC::IOERR_READ;
+  }
+
+  read_pages_.fetch_add(1);
+  return RC::SUCCESS;
+}
+
+RC BPPageIO::write_page(int file_desc, const Page &page, int page_size /* = BP_PAGE_SIZE */)
+{
+  const int ret = pwriten(file_desc, &page, page_size, static_cast<int64_t>(page.page_num) * page_size);
+  io_count_.fetch_add(1);
+  if (ret != 0) {
+    LOG_WARN("failed to write page. file desc=%d, page num=%d, error=%s", file_desc, page.page_num, strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+
+  write_pages_.fetch_add(1);
+  return RC::SUCCESS;
+}
+
+RC BPPageIO::read_pages(
+    int file_desc, PageNum start_page, Page *const pages[], int count, int page_size /* = BP_PAGE_SIZE */)
+{
+  vector<PageIORequest> requests;
+  for (int i = 0; i < count; i += MAX_REQUEST_PAGES) {
+    PageIORequest &request = requests.emplace_back();
+    request.file_desc      = file_desc;
+    request.start_page     = start_page + i;
+    request.is_write       = false;
+    request.page_size      = page_size;
+    request.pages.assign(pages + i, pages + std::min(count, i + MAX_REQUEST_PAGES));
+  }
+  return execute(requests);
+}
+
+void BPPageIO::make_write_requests(int file_desc, const Page *const pages[], int count,
+    vector<PageIORequest> &requests, int page_size /* = BP_PAGE_SIZE */)
+{
+  for (int start = 0; start < count; ) {
+    PageIORequest &request = requests.emplace_back();
+    request.file_desc      = file_desc;
+    request.start_page     = pages[start]->page_num;
+    request.is_write       = true;
+    request.page_size      = page_size;
+
+    // 找到一段页号连续的页面
+    int num = 0;
+    do {
+      request.pages.push_back(const_cast<Page *>(pages[start + num]));
+      num++;
+    } while (start + num < count && num < MAX_REQUEST_PAGES &&
+             pages[start + num]->page_num == pages[start + num - 1]->page_num + 1);
+    start += num;
+  }
+}
+
+RC BPPageIO::write_pages(
+    int file_desc, const Page *const pages[], int count, int page_size /* = BP_PAGE_SIZE */)
+{
+  vector<PageIORequest> requests;
+  make_write_requests(file_desc, pages, count, requests, page_size);
+  return execute(requests);
+}
+
+void BPPageIO::will_need(int file_desc, PageNum start_page, int count, int page_size /* = BP_PAGE_SIZE */)
+{
+  const int ret = ::posix_fadvise(file_desc,
+      static_cast<off_t>(start_page) * page_size,
+      static_cast<off_t>(count) * page_size,
+      POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    LOG_DEBUG("failed to advise will need. file desc=%d, start page=%d, count=%d, error=%s",
+              file_desc, start_page, count, strerror(ret));
+  }
+}
+
+RC BPPageIO::execute(vector<PageIORequest> &requests)
+{
+  if (requests.empty()) {
+    return RC::SUCCESS;
+  }
+
+  int64_t io_count = 0;
+  engine_->execute(requests.data(), static_cast<int>(requests.size()), io_count);
+  io_count_.fetch_add(io_count);
+
+  RC rc = RC::SUCCESS;
+  for (PageIORequest &request : requests) {
+    if (request.rc != RC::SUCCESS) {
+      rc = request.rc;
+      continue;
+    }
+
+    if (request.is_write) {
+      write_pages_.fetch_add(request.pages.size());
+    } else {
+      read_pages_.fetch_add(request.pages.size());
+    }
+  }
+  return rc;
+}
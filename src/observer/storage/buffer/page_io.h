@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 一个页面读写请求，读写页号连续的若干个页面
+ * @ingroup BufferPool
+ */
+struct PageIORequest
+{
+  int                 file_desc  = -1;
+  PageNum             start_page = BP_INVALID_PAGE_NUM;
+  bool                is_write   = false;
+  int                 page_size  = BP_PAGE_SIZE;  ///< 文件的页面大小
+  std::vector<Page *> pages;                      ///< pages[i] 对应 start_page + i
+  RC                  rc = RC::SUCCESS;  ///< 请求完成后的结果
+};
+
+/**
+ * @brief 执行页面读写请求的引擎
+ * @ingroup BufferPool
+ * @details 同一批的请求之间没有依赖关系，引擎可以同时执行它们，所有请求都完成后才返回，
+ * 每个请求的结果记录在 PageIORequest::rc 中
+ */
+class PageIOEngine
+{
+public:
+  virtual ~PageIOEngine() = default;
+
+  virtual const char *name() const = 0;
+
+  /**
+   * @brief 执行一批请求
+   * @param io_count 返回执行了多少次读写操作(系统调用或者提交到内核的请求)
+   */
+  virtual void execute(PageIORequest requests[], int count, int64_t &io_count) = 0;
+};
+
+/**
+ * @brief 使用 preadv/pwritev 一个一个地执行请求
+ * @ingroup BufferPool
+ */
+class SyncPageIOEngine : public PageIOEngine
+{
+public:
+  const char *name() const override { return "sync"; }
+  void        execute(PageIORequest requests[], int count, int64_t &io_count) override;
+
+  /**
+   * @brief 同步地执行一个请求
+   */
+  static RC execute_one(PageIORequest &request, int64_t &io_count);
+};
+
+/**
+ * @brief 页面的磁盘读写
+ * @ingroup BufferPool
+ * @details 使用 pread/pwrite 按照位置读写页面，不依赖也不修改文件的读写位置，
+ * 多个线程可以同时读写同一个文件，每个页面也只需要一次系统调用。
+ * 页号连续的多个页面使用 preadv/pwritev 合并成一次系统调用。
+ *
+ * 一次读写多段页面时(比如预读和刷脏)，使用 PageIOEngine 批量执行。默认是同步执行，
+ * 可以配置成 io_uring，一次系统调用提交所有的请求，由内核同时处理。内核不支持 io_uring 时使用同步引擎。
+ */
+class BPPageIO
+{
+public:
+  BPPageIO();
+  ~BPPageIO();
+
+  /**
+   * @brief 选择批量读写使用的引擎
+   * @param engine sync 或者 io_uring，为空时使用 sync。初始化 io_uring 失败时也使用 sync
+   */
+  RC init(const char *engine);
+
+  const char *engine_name() const;
+
+  /**
+   * @brief 读取一个页面
+   * @param page_size 文件的页面大小，page 指向的内存至少有这么大
+   */
+  RC read_page(int file_desc, PageNum page_num, Page &page, int page_size = BP_PAGE_SIZE);
+
+  /**
+   * @brief 写一个页面，写入的位置由 page.page_num 决定
+   */
+  RC write_page(int file_desc, const Page &page, int page_size = BP_PAGE_SIZE);
+
+  /**
+   * @brief 读取从 start_page 开始的连续 count 个页面
+   *
+   * @param pages 读到这些页面中，pages[i] 对应 start_page + i
+   */
+  RC read_pages(int file_desc, PageNum start_page, Page *const pages[], int count, int page_size = BP_PAGE_SIZE);
+
+  /**
+   * @brief 写多个页面
+   * @details 页面需要按照页号从小到大排好序，页号连续的页面会合并成一个请求
+   */
+  RC write_pages(int file_desc, const Page *const pages[], int count, int page_size = BP_PAGE_SIZE);
+
+  /**
+   * @brief 把页面按照页号连续的段拆分成写请求，追加到 requests 中
+   * @details 页面需要按照页号从小到大排好序
+   */
+  static void make_write_requests(int file_desc, const Page *const pages[], int count,
+      std::vector<PageIORequest> &requests, int page_size = BP_PAGE_SIZE);
+
+  /**
+   * @brief 通知操作系统马上会读取这些页面
+   * @details 操作系统在后台把这些页面读到页缓存中，不会等待读取完成。
+   * 后面真正读取时就只需要从页缓存中复制，顺序扫描时可以和数据处理重叠起来
+   */
+  void will_need(int file_desc, PageNum start_page, int count, int page_size = BP_PAGE_SIZE);
+
+  /**
+   * @brief 批量执行读写请求
+   * @return 有任何一个请求失败就返回失败，每个请求的结果参考 PageIORequest::rc
+   */
+  RC execute(std::vector<PageIORequest> &requests);
+
+  int64_t read_page_count() const { return read_pages_.load(); }
+  int64_t write_page_count() const { return write_pages_.load(); }
+  int64_t io_count() const { return io_count_.load(); }
+
+  /// 一个请求最多包含多少个页面，不能超过 IOV_MAX
+  static constexpr int MAX_REQUEST_PAGES = 256;
+
+private:
+  std::unique_ptr<PageIOEngine> engine_;
+
+  std::atomic<int64_t> read_pages_{0};   ///< 一共读取了多少个页面
+  std::atomic<int64_t> write_pages_{0};  ///< 一共写了多少个页面
+  std::atomic<int64_t> io_count_{0};     ///< 一共做了多少次读写操作
+};
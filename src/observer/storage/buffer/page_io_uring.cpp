@@ -0,0 +1,246 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <vector>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define HAVE_IO_URING 1
+#endif
+
+#include "storage/buffer/page_io_uring.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+UringPageIOEngine::~UringPageIOEngine()
+{
+  cleanup();
+}
+
+#ifdef HAVE_IO_URING
+
+RC UringPageIOEngine::init(int queue_depth /* = 64 */)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = static_cast<int>(syscall(__NR_io_uring_setup, std::max(queue_depth, 1), &params));
+  if (fd < 0) {
+    LOG_WARN("failed to setup io_uring. error=%s", strerror(errno));
+    return RC::UNIMPLENMENT;
+  }
+  ring_fd_ = fd;
+  entries_ = params.sq_entries;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    LOG_WARN("failed to mmap io_uring submission queue. error=%s", strerror(errno));
+    cleanup();
+    return RC::NOMEM;
+  }
+
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      LOG_WARN("failed to mmap io_uring completion queue. error=%s", strerror(errno));
+      cleanup();
+      return RC::NOMEM;
+    }
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_mem_  = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes_mem_ == MAP_FAILED) {
+    sqes_mem_ = nullptr;
+    LOG_WARN("failed to mmap io_uring submission queue entries. error=%s", strerror(errno));
+    cleanup();
+    return RC::NOMEM;
+  }
+
+  char *sq_ptr  = static_cast<char *>(sq_ring_);
+  sq_tail_      = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.tail);
+  sq_ring_mask_ = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.ring_mask);
+  sq_array_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.array);
+  sqes_         = static_cast<struct io_uring_sqe *>(sqes_mem_);
+
+  char *cq_ptr  = static_cast<char *>(cq_ring_);
+  cq_head_      = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.head);
+  cq_tail_      = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.tail);
+  cq_ring_mask_ = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.ring_mask);
+  cqes_         = reinterpret_cast<struct io_uring_cqe *>(cq_ptr + params.cq_off.cqes);
+
+  LOG_INFO("io_uring page io engine init done. entries=%u, features=%x", entries_, params.features);
+  return RC::SUCCESS;
+}
+
+void UringPageIOEngine::cleanup()
+{
+  if (sqes_mem_ != nullptr) {
+    munmap(sqes_mem_, sqes_size_);
+    sqes_mem_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+void UringPageIOEngine::prepare(PageIORequest &request, void *iovecs, uint64_t user_data)
+{
+  // 只有当前线程会修改提交队列的尾部，内核只会读取它
+  const unsigned tail  = *sq_tail_;
+  const unsigned index = tail & *sq_ring_mask_;
+
+  struct io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode    = request.is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+  sqe->fd        = request.file_desc;
+  sqe->addr      = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len       = static_cast<uint32_t>(request.pages.size());
+  sqe->off       = static_cast<uint64_t>(request.start_page) * request.page_size;
+  sqe->user_data = user_data;
+
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+}
+
+int UringPageIOEngine::reap(PageIORequest requests[], int64_t &io_count)
+{
+  unsigned       head = *cq_head_;
+  const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+  int completed = 0;
+  for (; head != tail; head++) {
+    const struct io_uring_cqe *cqe     = &cqes_[head & *cq_ring_mask_];
+    PageIORequest             &request = requests[cqe->user_data];
+
+    const int64_t expected = static_cast<int64_t>(request.pages.size()) * request.page_size;
+    if (cqe->res == expected) {
+      request.rc = RC::SUCCESS;
+    } else {
+      // 出错或者只处理了部分数据，同步地再做一次，得到准确的结果
+      LOG_DEBUG("io_uring request not fully done, retry synchronously. file desc=%d, start page=%d, res=%d",
+                request.file_desc, request.start_page, cqe->res);
+      request.rc = SyncPageIOEngine::execute_one(request, io_count);
+    }
+    completed++;
+  }
+
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  return completed;
+}
+
+void UringPageIOEngine::execute(PageIORequest requests[], int count, int64_t &io_count)
+{
+  vector<vector<struct iovec>> iovecs(count);
+  for (int i = 0; i < count; i++) {
+    iovecs[i].resize(requests[i].pages.size());
+    for (size_t j = 0; j < requests[i].pages.size(); j++) {
+      iovecs[i][j].iov_base = requests[i].pages[j];
+      iovecs[i][j].iov_len  = requests[i].page_size;
+    }
+  }
+
+  lock_guard<mutex> guard(lock_);
+
+  int next      = 0;  // 下一个要放到提交队列中的请求
+  int inflight  = 0;  // 已经放到提交队列中还没有完成的请求
+  int completed = 0;
+  while (completed < count) {
+    int to_submit = 0;
+    while (next < count && inflight < static_cast<int>(entries_)) {
+      prepare(requests[next], iovecs[next].data(), static_cast<uint64_t>(next));
+      next++;
+      inflight++;
+      to_submit++;
+    }
+
+    const int ret = static_cast<int>(
+        syscall(__NR_io_uring_enter, ring_fd_, to_submit, 1 /*min_complete*/, IORING_ENTER_GETEVENTS, nullptr, 0));
+    if (ret >= 0) {
+      io_count += ret;
+      to_submit -= ret;
+    } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      LOG_WARN("failed to submit io_uring requests. error=%s", strerror(errno));
+    }
+
+    if (to_submit > 0) {
+      // 内核没有取走的请求撤回来，同步执行。没有开启 SQPOLL，内核只会在 io_uring_enter 中读取提交队列
+      __atomic_store_n(sq_tail_, *sq_tail_ - to_submit, __ATOMIC_RELEASE);
+      for (int i = next - to_submit; i < next; i++) {
+        requests[i].rc = SyncPageIOEngine::execute_one(requests[i], io_count);
+      }
+      inflight -= to_submit;
+      completed += to_submit;
+    }
+
+    const int reaped = reap(requests, io_count);
+    inflight -= reaped;
+    completed += reaped;
+  }
+}
+
+#else  // HAVE_IO_URING
+
+RC UringPageIOEngine::init(int queue_depth /* = 64 */)
+{
+  LOG_WARN("io_uring is not supported by this build");
+  return RC::UNIMPLENMENT;
+}
+
+void UringPageIOEngine::cleanup()
+{}
+
+void UringPageIOEngine::prepare(PageIORequest &request, void *iovecs, uint64_t user_data)
+{}
+
+int UringPageIOEngine::reap(PageIORequest requests[], int64_t &io_count)
+{
+  return 0;
+}
+
+void UringPageIOEngine::execute(PageIORequest requests[], int count, int64_t &io_count)
+{
+  for (int i = 0; i < count; i++) {
+    requests[i].rc = SyncPageIOEngine::execute_one(requests[i], io_count);
+  }
+}
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <mutex>
+
+#include "storage/buffer/page_io.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * @brief 使用 io_uring 执行页面读写请求
+ * @ingroup BufferPool
+ * @details 一批请求全部放到提交队列中，一次 io_uring_enter 提交给内核，内核可以同时处理这些请求，
+ * 比一个一个地调用 preadv/pwritev 有更高的并发度，系统调用也更少。
+ * 没有依赖 liburing，直接使用系统调用和 linux/io_uring.h 中的定义。
+ * 编译环境没有 linux/io_uring.h 或者内核不支持时，init 会返回失败，调用者应该使用同步的引擎。
+ *
+ * 一个引擎只有一个 io_uring 实例，多个线程同时执行请求时会排队。
+ * 完成时读写的数据不足(比如读到了文件尾)的请求，会使用同步的方式重新执行一次，得到准确的错误。
+ */
+class UringPageIOEngine : public PageIOEngine
+{
+public:
+  UringPageIOEngine() = default;
+  ~UringPageIOEngine() override;
+
+  /**
+   * @brief 创建 io_uring 实例
+   * @param queue_depth 提交队列的长度，也是同时在执行的最大请求个数
+   */
+  RC init(int queue_depth = 64);
+
+  const char *name() const override { return "io_uring"; }
+  void        execute(PageIORequest requests[], int count, int64_t &io_count) override;
+
+private:
+  void cleanup();
+
+  /**
+   * @brief 把一个请求放到提交队列中
+   */
+  void prepare(PageIORequest &request, void *iovecs, uint64_t user_data);
+
+  /**
+   * @brief 收割所有已经完成的请求
+   * @return 完成的请求个数
+   */
+  int reap(PageIORequest requests[], int64_t &io_count);
+
+private:
+  std::mutex lock_;
+
+  int      ring_fd_ = -1;
+  unsigned entries_ = 0;
+
+  void  *sq_ring_      = nullptr;
+  size_t sq_ring_size_ = 0;
+  void  *cq_ring_      = nullptr;
+  size_t cq_ring_size_ = 0;
+  void  *sqes_mem_     = nullptr;
+  size_t sqes_size_    = 0;
+
+  unsigned     *sq_tail_      = nullptr;
+  unsigned     *sq_ring_mask_ = nullptr;
+  unsigned     *sq_array_     = nullptr;
+  io_uring_sqe *sqes_         = nullptr;
+
+  unsigned     *cq_head_      = nullptr;
+  unsigned     *cq_tail_      = nullptr;
+  unsigned     *cq_ring_mask_ = nullptr;
+  io_uring_cqe *cqes_         = nullptr;
+};
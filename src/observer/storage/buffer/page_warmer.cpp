@@ -0,0 +1,261 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include "storage/buffer/page_warmer.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/page_io.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+/// 预热时多久打印一次进度
+static const int PROGRESS_LOG_INTERVAL_MS = 1000;
+
+BPPageWarmer::BPPageWarmer(BufferPoolManager &bp_manager) : bp_manager_(bp_manager)
+{}
+
+BPPageWarmer::~BPPageWarmer()
+{
+  stop();
+}
+
+RC BPPageWarmer::start(const char *file_name, int thread_num, int dump_interval_s)
+{
+  if (common::is_blank(file_name)) {
+    LOG_INFO("buffer pool warm up is disabled");
+    return RC::SUCCESS;
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  if (running_) {
+    LOG_WARN("page warmer has been started");
+    return RC::INTERNAL;
+  }
+
+  file_name_       = file_name;
+  thread_num_      = max(thread_num, 1);
+  dump_interval_s_ = dump_interval_s;
+  running_         = true;
+  stopping_        = false;
+  thread_          = thread(&BPPageWarmer::run, this);
+  LOG_INFO("page warmer started. file=%s, thread num=%d, dump interval=%ds",
+           file_name_.c_str(), thread_num_, dump_interval_s_);
+  return RC::SUCCESS;
+}
+
+void BPPageWarmer::stop()
+{
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (!running_) {
+      return;
+    }
+    running_  = false;
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  LOG_INFO("page warmer stopped. warmed pages=%ld", warmed_pages_.load());
+}
+
+void BPPageWarmer::run()
+{
+  pthread_setname_np(pthread_self(), "PageWarmer");
+
+  RC rc = warm_up(file_name_.c_str(), thread_num_);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to warm up buffer pool. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+  }
+
+  unique_lock<mutex> lock(mutex_);
+  while (running_) {
+    if (dump_interval_s_ <= 0) {
+      cv_.wait(lock, [this]() { return !running_; });
+      break;
+    }
+
+    if (cv_.wait_for(lock, chrono::seconds(dump_interval_s_), [this]() { return !running_; })) {
+      break;
+    }
+
+    lock.unlock();
+    (void)dump(file_name_.c_str());
+    lock.lock();
+  }
+}
+
+RC BPPageWarmer::dump(const char *file_name)
+{
+  map<string, vector<PageNum>> pages;
+  bp_manager_.resident_pages(pages);
+
+  const string tmp_file_name = string(file_name) + ".tmp";
+  ofstream     ofs(tmp_file_name, ios::out | ios::trunc);
+  if (!ofs.is_open()) {
+    LOG_WARN("failed to open page list file. file=%s, error=%s", tmp_file_name.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  int64_t page_count = 0;
+  ofs << "# miniob buffer pool pages: page_num file_name" << endl;
+  for (const auto &[file, file_pages] : pages) {
+    for (PageNum page_num : file_pages) {
+      ofs << page_num << ' ' << file << '\n';
+    }
+    page_count += file_pages.size();
+  }
+  ofs.close();
+  if (!ofs) {
+    LOG_WARN("failed to write page list file. file=%s", tmp_file_name.c_str());
+    return RC::IOERR_WRITE;
+  }
+
+  if (::rename(tmp_file_name.c_str(), file_name) != 0) {
+    LOG_WARN("failed to rename page list file. from=%s, to=%s, error=%s",
+             tmp_file_name.c_str(), file_name, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+
+  LOG_INFO("dump buffer pool pages done. file=%s, files=%d, pages=%ld", file_name, (int)pages.size(), page_count);
+  return RC::SUCCESS;
+}
+
+RC BPPageWarmer::load(const char *file_name, map<string, vector<PageNum>> &pages)
+{
+  ifstream ifs(file_name);
+  if (!ifs.is_open()) {
+    LOG_INFO("no page list file to warm up buffer pool. file=%s", file_name);
+    return RC::NOTFOUND;
+  }
+
+  string line;
+  while (getline(ifs, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    char      *end      = nullptr;
+    const long page_num = strtol(line.c_str(), &end, 10);
+    if (end == line.c_str() || *end != ' ' || page_num < 0) {
+      LOG_WARN("invalid line in page list file. file=%s, line=%s", file_name, line.c_str());
+      continue;
+    }
+    pages[string(end + 1)].push_back(static_cast<PageNum>(page_num));
+  }
+
+  for (auto &[file, file_pages] : pages) {
+    sort(file_pages.begin(), file_pages.end());
+    file_pages.erase(unique(file_pages.begin(), file_pages.end()), file_pages.end());
+  }
+  return RC::SUCCESS;
+}
+
+RC BPPageWarmer::warm_up(const char *file_name, int thread_num)
+{
+  map<string, vector<PageNum>> pages;
+  RC rc = load(file_name, pages);
+  if (rc != RC::SUCCESS) {
+    return rc == RC::NOTFOUND ? RC::SUCCESS : rc;
+  }
+
+  // 每段页号连续的页面是一个任务，按照文件和页号的顺序排列
+  vector<Task> tasks;
+  int64_t      total_pages = 0;
+  for (const auto &[file, file_pages] : pages) {
+    for (size_t i = 0; i < file_pages.size(); ) {
+      size_t end = i + 1;
+      while (end < file_pages.size() && file_pages[end] == file_pages[end - 1] + 1 &&
+             static_cast<int>(end - i) < BPPageIO::MAX_REQUEST_PAGES) {
+        end++;
+      }
+      tasks.push_back(Task{&file, file_pages[i], static_cast<int>(end - i)});
+      i = end;
+    }
+    total_pages += file_pages.size();
+  }
+
+  LOG_INFO("begin to warm up buffer pool. file=%s, files=%d, pages=%ld, tasks=%d, threads=%d",
+           file_name, (int)pages.size(), total_pages, (int)tasks.size(), thread_num);
+
+  atomic<size_t>  next_task{0};
+  atomic<int64_t> done_pages{0};
+  atomic<int64_t> loaded_pages{0};
+  atomic<bool>    memory_full{false};
+  atomic<int>     running_workers{max(thread_num, 1)};
+  mutex              done_mutex;
+  condition_variable done_cv;
+
+  auto worker = [&]() {
+    while (!stopping_ && !memory_full) {
+      const size_t index = next_task.fetch_add(1);
+      if (index >= tasks.size()) {
+        break;
+      }
+
+      const Task &task   = tasks[index];
+      int         loaded = 0;
+      RC          rc     = bp_manager_.prefetch_pages(task.file_name->c_str(), task.start_page, task.count, loaded);
+      if (rc == RC::BUFFERPOOL_NOBUF) {
+        memory_full = true;
+        break;
+      }
+      if (rc != RC::SUCCESS) {
+        LOG_DEBUG("skip warm up pages. file=%s, start page=%d, count=%d, rc=%s",
+                  task.file_name->c_str(), task.start_page, task.count, strrc(rc));
+      }
+      done_pages.fetch_add(task.count);
+      loaded_pages.fetch_add(loaded);
+      warmed_pages_.fetch_add(loaded);
+    }
+
+    lock_guard<mutex> lock(done_mutex);
+    running_workers--;
+    done_cv.notify_all();
+  };
+
+  vector<thread> workers;
+  for (int i = 0; i < max(thread_num, 1); i++) {
+    workers.emplace_back(worker);
+  }
+
+  {
+    unique_lock<mutex> lock(done_mutex);
+    while (!done_cv.wait_for(lock, chrono::milliseconds(PROGRESS_LOG_INTERVAL_MS),
+                             [&running_workers]() { return running_workers.load() == 0; })) {
+      LOG_INFO("warming up buffer pool. progress=%ld/%ld, loaded=%ld",
+               done_pages.load(), total_pages, loaded_pages.load());
+    }
+  }
+
+  for (thread &worker_thread : workers) {
+    worker_thread.join();
+  }
+
+  if (memory_full) {
+    LOG_INFO("stop warming up because there is no free frame");
+  }
+  LOG_INFO("warm up buffer pool done. progress=%ld/%ld, loaded=%ld",
+           done_pages.load(), total_pages, loaded_pages.load());
+  return RC::SUCCESS;
+}
@@ -0,0 +1,104 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+
+class BufferPoolManager;
+
+/**
+ * @brief 缓冲池预热
+ * @ingroup BufferPool
+ * @details 进程重启以后内存中没有任何页面，每次访问都要读磁盘，需要很长时间才能恢复到正常的性能。
+ * 正常退出时把内存中的页面列表(文件名和页号)保存到文件中，也可以定期保存，防止异常退出时丢失。
+ * 下次启动打开所有文件以后，在后台使用多个线程按照文件中的顺序把这些页面读到内存中，同时可以接受请求。
+ *
+ * 每个文件的页面按照页号排序，页号连续的页面一次批量读取，不同的文件和同一个文件的不同段由多个线程同时读取。
+ * 预热不会淘汰已经在内存中的页面，空闲页帧用完以后就停止。
+ *
+ * 文件格式是文本，每行一个页面：`页号 文件名`，以 # 开头的行是注释。
+ */
+class BPPageWarmer
+{
+public:
+  BPPageWarmer(BufferPoolManager &bp_manager);
+  ~BPPageWarmer();
+
+  /**
+   * @brief 在后台预热，预热完成以后定期保存页面列表
+   *
+   * @param file_name        页面列表文件
+   * @param thread_num       预热使用的线程个数
+   * @param dump_interval_s  定期保存页面列表的间隔，<=0 表示只在退出时保存
+   */
+  RC   start(const char *file_name, int thread_num, int dump_interval_s);
+  void stop();
+
+  /**
+   * @brief 把当前内存中的页面列表保存到文件中
+   * @details 先写到临时文件中再重命名，保存过程中异常退出也不会破坏以前的文件
+   */
+  RC dump(const char *file_name);
+
+  /**
+   * @brief 按照页面列表文件把页面读到内存中，全部读完或者调用了 stop 以后才返回
+   */
+  RC warm_up(const char *file_name, int thread_num);
+
+  /**
+   * @brief 已经预热了多少个页面
+   */
+  int64_t warmed_pages() const { return warmed_pages_.load(); }
+
+private:
+  /**
+   * @brief 一次预热的一段页号连续的页面
+   */
+  struct Task
+  {
+    const std::string *file_name;
+    PageNum            start_page;
+    int                count;
+  };
+
+  void run();
+
+  static RC load(const char *file_name, std::map<std::string, std::vector<PageNum>> &pages);
+
+private:
+  BufferPoolManager &bp_manager_;
+
+  std::string file_name_;
+  int         thread_num_      = 1;
+  int         dump_interval_s_ = 0;
+
+  std::thread             thread_;
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+  bool                    running_ = false;
+  std::atomic<bool>       stopping_{false};  ///< 让正在预热的线程尽快结束
+
+  std::atomic<int64_t> warmed_pages_{0};
+};
@@ -48,6 +48,9 @@ class Db;
  * @details 除了事务操作相关的类型，比如MTR_BEGIN/MTR_COMMIT等，都是需要事务自己去处理的。
  * 也就是说，像INSERT、DELETE等是事务自己处理的，其实这种类型的日志不需要在这里定义，而是在各个
  * 事务模型中定义，由各个事务模型自行处理。
+ *
+ * INSERT_BATCH 是批量插入时同一个页面上的一批记录，rid_ 中的 page_num 是页面号，slot_num 是记录的条数，
+ * 数据部分是每条记录依次存放的 [int32_t slot_num][记录数据]，记录都是定长的，长度是 data_len_ / 条数 - 4。
  */
 #define DEFINE_CLOG_TYPE_ENUM         \
   DEFINE_CLOG_TYPE(ERROR)             \
@@ -55,7 +58,8 @@ class Db;
   DEFINE_CLOG_TYPE(MTR_COMMIT)        \
   DEFINE_CLOG_TYPE(MTR_ROLLBACK)      \
   DEFINE_CLOG_TYPE(INSERT)            \
-  DEFINE_CLOG_TYPE(DELETE)
+  DEFINE_CLOG_TYPE(DELETE)            \
+  DEFINE_CLOG_TYPE(INSERT_BATCH)
 
 enum class CLogType 
 { 
@@ -0,0 +1,402 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "storage/column/column_segment.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+const char *column_encoding_name(ColumnEncoding encoding)
+{
+  switch (encoding) {
+    case ColumnEncoding::PLAIN: return "plain";
+    case ColumnEncoding::RLE: return "rle";
+    case ColumnEncoding::FOR: return "for";
+    case ColumnEncoding::DICT: return "dict";
+    default: return "unknown";
+  }
+}
+
+/**
+ * @brief 按照比较的结果判断是否满足比较运算，与 ComparisonExpr::compare_value 一致
+ */
+static bool comp_matches(CompOp comp, int cmp)
+{
+  switch (comp) {
+    case EQUAL_TO: return cmp == 0;
+    case LESS_EQUAL: return cmp <= 0;
+    case NOT_EQUAL: return cmp != 0;
+    case LESS_THAN: return cmp < 0;
+    case GREAT_EQUAL: return cmp >= 0;
+    case GREAT_THAN: return cmp > 0;
+    default: return true;
+  }
+}
+
+/**
+ * @brief 与 RowTuple::cell_at 取出来的值一样
+ */
+static Value field_value(AttrType type, const char *data, int len)
+{
+  Value value;
+  value.set_type(type);
+  value.set_data(const_cast<char *>(data), len);
+  return value;
+}
+
+static uint32_t load_unsigned(const char *data, int width)
+{
+  switch (width) {
+    case 1: return *reinterpret_cast<const uint8_t *>(data);
+    case 2: {
+      uint16_t v;
+      memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    default: {
+      uint32_t v;
+      memcpy(&v, data, sizeof(v));
+      return v;
+    }
+  }
+}
+
+static void store_unsigned(char *data, int width, uint32_t value)
+{
+  switch (width) {
+    case 1: *reinterpret_cast<uint8_t *>(data) = static_cast<uint8_t>(value); break;
+    case 2: {
+      const uint16_t v = static_cast<uint16_t>(value);
+      memcpy(data, &v, sizeof(v));
+    } break;
+    default: memcpy(data, &value, sizeof(value)); break;
+  }
+}
+
+static int unsigned_width(uint64_t max_value)
+{
+  if (max_value <= UINT8_MAX) {
+    return 1;
+  }
+  if (max_value <= UINT16_MAX) {
+    return 2;
+  }
+  return 4;
+}
+
+int ColumnSegment::plain_capacity(int page_data_size, int value_len)
+{
+  return (page_data_size - static_cast<int>(sizeof(ColumnSegmentHeader))) / value_len;
+}
+
+void ColumnSegment::init(int value_len)
+{
+  memset(header_, 0, sizeof(ColumnSegmentHeader));
+  header_->encoding  = static_cast<int32_t>(ColumnEncoding::PLAIN);
+  header_->value_len = value_len;
+}
+
+int ColumnSegment::used_size() const
+{
+  const int64_t len = header_->value_len;
+  int64_t       size = 0;
+  switch (encoding()) {
+    case ColumnEncoding::PLAIN: size = header_->row_num * len; break;
+    case ColumnEncoding::RLE: size = header_->entry_num * (sizeof(int32_t) + len); break;
+    case ColumnEncoding::FOR: size = static_cast<int64_t>(header_->row_num) * header_->width; break;
+    case ColumnEncoding::DICT:
+      size = header_->entry_num * len + static_cast<int64_t>(header_->row_num) * header_->width;
+      break;
+  }
+  return static_cast<int>(sizeof(ColumnSegmentHeader) + size);
+}
+
+void ColumnSegment::set(int row, const char *value)
+{
+  ASSERT(encoding() == ColumnEncoding::PLAIN, "cannot set value of an encoded segment. encoding=%s",
+         column_encoding_name(encoding()));
+  memcpy(body() + static_cast<int64_t>(row) * header_->value_len, value, header_->value_len);
+  if (row >= header_->row_num) {
+    header_->row_num = row + 1;
+  }
+}
+
+RC ColumnSegment::update(int row, const char *value)
+{
+  if (encoding() == ColumnEncoding::PLAIN) {
+    set(row, value);
+    return RC::SUCCESS;
+  }
+
+  vector<char> old_value(header_->value_len);
+  get(row, old_value.data());
+  return memcmp(old_value.data(), value, header_->value_len) == 0 ? RC::SUCCESS : RC::UNIMPLENMENT;
+}
+
+int ColumnSegment::run_of(int row) const
+{
+  const int32_t *ends = run_ends();
+  return static_cast<int>(upper_bound(ends, ends + header_->entry_num, row) - ends);
+}
+
+uint32_t ColumnSegment::delta(int row) const
+{
+  return load_unsigned(body() + static_cast<int64_t>(row) * header_->width, header_->width);
+}
+
+uint32_t ColumnSegment::code(int row) const
+{
+  return load_unsigned(dict_codes() + static_cast<int64_t>(row) * header_->width, header_->width);
+}
+
+void ColumnSegment::get(int row, char *value) const
+{
+  const int len = header_->value_len;
+  switch (encoding()) {
+    case ColumnEncoding::PLAIN: memcpy(value, plain_value(row), len); break;
+    case ColumnEncoding::RLE: memcpy(value, run_values() + static_cast<int64_t>(run_of(row)) * len, len); break;
+    case ColumnEncoding::FOR: {
+      const int32_t v = static_cast<int32_t>(static_cast<uint32_t>(header_->base) + delta(row));
+      memcpy(value, &v, sizeof(v));
+    } break;
+    case ColumnEncoding::DICT: memcpy(value, dict_entries() + static_cast<int64_t>(code(row)) * len, len); break;
+  }
+}
+
+void ColumnSegment::decode(char *values) const
+{
+  const int len = header_->value_len;
+  const int row_num = header_->row_num;
+  switch (encoding()) {
+    case ColumnEncoding::PLAIN: memcpy(values, body(), static_cast<int64_t>(row_num) * len); break;
+    case ColumnEncoding::RLE: {
+      int row = 0;
+      for (int i = 0; i < header_->entry_num; i++) {
+        const char *value = run_values() + static_cast<int64_t>(i) * len;
+        for (; row < run_ends()[i]; row++) {
+          memcpy(values + static_cast<int64_t>(row) * len, value, len);
+        }
+      }
+    } break;
+    case ColumnEncoding::FOR: {
+      for (int row = 0; row < row_num; row++) {
+        const int32_t v = static_cast<int32_t>(static_cast<uint32_t>(header_->base) + delta(row));
+        memcpy(values + static_cast<int64_t>(row) * sizeof(v), &v, sizeof(v));
+      }
+    } break;
+    case ColumnEncoding::DICT: {
+      for (int row = 0; row < row_num; row++) {
+        memcpy(values + static_cast<int64_t>(row) * len, dict_entries() + static_cast<int64_t>(code(row)) * len, len);
+      }
+    } break;
+  }
+}
+
+void ColumnSegment::filter(AttrType type, CompOp comp, const Value &value, uint8_t *selection) const
+{
+  const int  len     = header_->value_len;
+  const int  row_num = header_->row_num;
+  const bool int_cmp = type == INTS && value.attr_type() == INTS;
+
+  switch (encoding()) {
+    case ColumnEncoding::PLAIN: {
+      if (int_cmp) {
+        const int target = value.get_int();
+        for (int row = 0; row < row_num; row++) {
+          int32_t v;
+          memcpy(&v, plain_value(row), sizeof(v));
+          selection[row] &= comp_matches(comp, v < target ? -1 : (v > target ? 1 : 0));
+        }
+      } else {
+        for (int row = 0; row < row_num; row++) {
+          if (selection[row]) {
+            selection[row] = comp_matches(comp, field_value(type, plain_value(row), len).compare(value));
+          }
+        }
+      }
+    } break;
+
+    case ColumnEncoding::RLE: {
+      // 每个游程只比较一次
+      int start = 0;
+      for (int i = 0; i < header_->entry_num; i++) {
+        const int end = run_ends()[i];
+        if (!comp_matches(comp, field_value(type, run_values() + static_cast<int64_t>(i) * len, len).compare(value))) {
+          memset(selection + start, 0, end - start);
+        }
+        start = end;
+      }
+    } break;
+
+    case ColumnEncoding::FOR: {
+      if (int_cmp) {
+        // 把常量换算成差值，直接与每一行的差值比较，不需要还原出原来的值
+        const int64_t target = static_cast<int64_t>(value.get_int()) - header_->base;
+        for (int row = 0; row < row_num; row++) {
+          const int64_t d = delta(row);
+          selection[row] &= comp_matches(comp, d < target ? -1 : (d > target ? 1 : 0));
+        }
+      } else {
+        for (int row = 0; row < row_num; row++) {
+          if (selection[row]) {
+            const int32_t v = static_cast<int32_t>(static_cast<uint32_t>(header_->base) + delta(row));
+            Value         cell;
+            cell.set_int(v);
+            selection[row] = comp_matches(comp, cell.compare(value));
+          }
+        }
+      }
+    } break;
+
+    case ColumnEncoding::DICT: {
+      // 每个字典项只比较一次，每一行只需要查表
+      vector<uint8_t> entry_matches(header_->entry_num);
+      for (int i = 0; i < header_->entry_num; i++) {
+        entry_matches[i] =
+            comp_matches(comp, field_value(type, dict_entries() + static_cast<int64_t>(i) * len, len).compare(value));
+      }
+      for (int row = 0; row < row_num; row++) {
+        selection[row] &= entry_matches[code(row)];
+      }
+    } break;
+  }
+}
+
+void ColumnSegment::seal(AttrType type)
+{
+  if (encoding() != ColumnEncoding::PLAIN || header_->row_num == 0) {
+    return;
+  }
+
+  const int     len     = header_->value_len;
+  const int     row_num = header_->row_num;
+  vector<char>  plain(body(), body() + static_cast<int64_t>(row_num) * len);
+  const bool    is_string = type == CHARS || type == VARCHARS;
+  if (is_string) {
+    // 字符串结尾'\0'后面的内容没有意义，清零以后相同的字符串才能按照字节比较
+    for (int row = 0; row < row_num; row++) {
+      char *value = plain.data() + static_cast<int64_t>(row) * len;
+      char *end   = static_cast<char *>(memchr(value, 0, len));
+      if (end != nullptr) {
+        memset(end, 0, value + len - end);
+      }
+    }
+  }
+  auto value_at = [&](int row) { return plain.data() + static_cast<int64_t>(row) * len; };
+
+  ColumnEncoding best      = ColumnEncoding::PLAIN;
+  int64_t        best_size = static_cast<int64_t>(row_num) * len;
+
+  int run_num = 1;
+  for (int row = 1; row < row_num; row++) {
+    if (memcmp(value_at(row), value_at(row - 1), len) != 0) {
+      run_num++;
+    }
+  }
+  if (static_cast<int64_t>(run_num) * (sizeof(int32_t) + len) < best_size) {
+    best      = ColumnEncoding::RLE;
+    best_size = static_cast<int64_t>(run_num) * (sizeof(int32_t) + len);
+  }
+
+  int32_t min_value = 0;
+  int     for_width = 0;
+  if (type == INTS && len == sizeof(int32_t)) {
+    int32_t max_value = 0;
+    memcpy(&min_value, value_at(0), sizeof(min_value));
+    memcpy(&max_value, value_at(0), sizeof(max_value));
+    for (int row = 1; row < row_num; row++) {
+      int32_t v;
+      memcpy(&v, value_at(row), sizeof(v));
+      min_value = std::min(min_value, v);
+      max_value = std::max(max_value, v);
+    }
+    for_width = unsigned_width(static_cast<uint64_t>(static_cast<int64_t>(max_value) - min_value));
+    if (static_cast<int64_t>(row_num) * for_width < best_size) {
+      best      = ColumnEncoding::FOR;
+      best_size = static_cast<int64_t>(row_num) * for_width;
+    }
+  }
+
+  map<string, uint32_t> dict;
+  int                   dict_width = 0;
+  if (is_string) {
+    for (int row = 0; row < row_num && dict.size() <= UINT16_MAX + 1; row++) {
+      dict.emplace(string(value_at(row), len), 0);
+    }
+    if (dict.size() <= UINT16_MAX + 1) {
+      dict_width = unsigned_width(dict.size() - 1);
+      const int64_t size = static_cast<int64_t>(dict.size()) * len + static_cast<int64_t>(row_num) * dict_width;
+      if (size < best_size) {
+        best      = ColumnEncoding::DICT;
+        best_size = size;
+      }
+    }
+  }
+
+  char *out = body();
+  switch (best) {
+    case ColumnEncoding::PLAIN: {
+      memcpy(out, plain.data(), plain.size());
+    } break;
+
+    case ColumnEncoding::RLE: {
+      header_->entry_num = run_num;
+      int run = 0;
+      for (int row = 1; row <= row_num; row++) {
+        if (row == row_num || memcmp(value_at(row), value_at(row - 1), len) != 0) {
+          run_ends()[run] = row;
+          memcpy(run_values() + static_cast<int64_t>(run) * len, value_at(row - 1), len);
+          run++;
+        }
+      }
+    } break;
+
+    case ColumnEncoding::FOR: {
+      header_->width = for_width;
+      header_->base  = min_value;
+      for (int row = 0; row < row_num; row++) {
+        int32_t v;
+        memcpy(&v, value_at(row), sizeof(v));
+        store_unsigned(out + static_cast<int64_t>(row) * for_width,
+                       for_width,
+                       static_cast<uint32_t>(static_cast<int64_t>(v) - min_value));
+      }
+    } break;
+
+    case ColumnEncoding::DICT: {
+      // 字典项按照字节的顺序排列
+      header_->width     = dict_width;
+      header_->entry_num = static_cast<int32_t>(dict.size());
+      uint32_t next_code = 0;
+      for (auto &[entry, entry_code] : dict) {
+        entry_code = next_code++;
+        memcpy(dict_entries() + static_cast<int64_t>(entry_code) * len, entry.data(), len);
+      }
+      for (int row = 0; row < row_num; row++) {
+        const uint32_t c = dict[string(value_at(row), len)];
+        store_unsigned(dict_codes() + static_cast<int64_t>(row) * dict_width, dict_width, c);
+      }
+    } break;
+  }
+  header_->encoding = static_cast<int32_t>(best);
+
+  LOG_TRACE("sealed column segment. encoding=%s, rows=%d, size=%d/%d",
+            column_encoding_name(best), row_num, used_size(), size_);
+}
@@ -0,0 +1,152 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/rc.h"
+#include "sql/parser/parse_defs.h"
+
+/**
+ * @defgroup ColumnStore
+ * @brief 列存储引擎
+ */
+
+/**
+ * @brief 列段的编码方式
+ * @ingroup ColumnStore
+ */
+enum class ColumnEncoding : int32_t
+{
+  PLAIN = 0,  ///< 不编码，每个值按照字段的长度依次存放
+  RLE   = 1,  ///< 游程编码，连续相同的值只存放一次
+  FOR   = 2,  ///< 整数的基准值(frame of reference)编码，存放与最小值的差，差值占用1、2或4个字节
+  DICT  = 3,  ///< 字典编码，存放不同的值组成的字典和每一行在字典中的编号，编号占用1或2个字节
+};
+
+const char *column_encoding_name(ColumnEncoding encoding);
+
+/**
+ * @brief 列段的头部
+ * @ingroup ColumnStore
+ */
+struct ColumnSegmentHeader
+{
+  int32_t encoding;   ///< ColumnEncoding
+  int32_t row_num;    ///< 行数
+  int32_t value_len;  ///< 每个值的长度，就是字段的长度
+  int32_t width;      ///< FOR 的差值和 DICT 的编号占用的字节数
+  int32_t entry_num;  ///< RLE 的游程个数，DICT 的字典项个数
+  int32_t base;       ///< FOR 的基准值，即最小值
+};
+
+/**
+ * @brief 列段，一个行组中一个字段的所有值，存放在列文件的一个页面上
+ * @ingroup ColumnStore
+ * @details 各种编码的数据都紧跟在头部后面：
+ * - PLAIN: value[row_num]
+ * - RLE:   run_end[entry_num] value[entry_num]，run_end 是每个游程结束(不包括)的行号，是递增的
+ * - FOR:   delta[row_num]，每个差值 width 个字节
+ * - DICT:  entry[entry_num] code[row_num]，每个编号 width 个字节
+ *
+ * 行组还没有写满时段是 PLAIN 格式，可以追加和修改。写满以后调用 seal 选择占用空间最小的编码重新写一遍，
+ * 以后只能读取。过滤数据时不需要解码每一个值：FOR 把比较的常量换算成差值直接比较，RLE 和 DICT
+ * 对每个游程或者字典项只比较一次。
+ * 这个类只是页面内存上的一个视图，不负责 pin 页面和标记脏页。
+ */
+class ColumnSegment
+{
+public:
+  ColumnSegment(char *data, int size)
+      : data_(data), size_(size), header_(reinterpret_cast<ColumnSegmentHeader *>(data))
+  {}
+
+  /**
+   * @brief 一个页面上的 PLAIN 段最多能放多少个值
+   */
+  static int plain_capacity(int page_data_size, int value_len);
+
+  /**
+   * @brief 初始化成空的 PLAIN 段
+   */
+  void init(int value_len);
+
+  /**
+   * @brief 页面是否已经初始化过。数据库恢复时新扩展的页面内容都是0
+   */
+  bool inited() const { return header_->value_len > 0; }
+
+  ColumnEncoding encoding() const { return static_cast<ColumnEncoding>(header_->encoding); }
+  int            row_num() const { return header_->row_num; }
+  int            value_len() const { return header_->value_len; }
+
+  /**
+   * @brief 占用的字节数，包括头部
+   */
+  int used_size() const;
+
+  /**
+   * @brief 设置一行的值，超过当前的行数时扩大行数。只能用于 PLAIN 段
+   */
+  void set(int row, const char *value);
+
+  /**
+   * @brief 修改一行的值。编码以后的段不能修改，值不同时返回 UNIMPLENMENT
+   */
+  RC update(int row, const char *value);
+
+  /**
+   * @brief 取出一行的值
+   */
+  void get(int row, char *value) const;
+
+  /**
+   * @brief 解码所有的行，values 中依次存放 row_num 个值
+   */
+  void decode(char *values) const;
+
+  /**
+   * @brief 按照编码以后的数据过滤
+   * @details 与 ComparisonExpr 一样使用 Value::compare 比较，不满足 "值 comp value" 的行把 selection 设置成0
+   *
+   * @param type      字段的类型
+   * @param selection 每一行一个字节，至少有 row_num 个
+   */
+  void filter(AttrType type, CompOp comp, const Value &value, uint8_t *selection) const;
+
+  /**
+   * @brief 选择占用空间最小的编码，重新写一遍数据
+   * @param type 字段的类型，FOR 只用于 INTS，DICT 只用于字符串
+   */
+  void seal(AttrType type);
+
+private:
+  char       *body() const { return data_ + sizeof(ColumnSegmentHeader); }
+  const char *plain_value(int row) const { return body() + static_cast<int64_t>(row) * header_->value_len; }
+
+  int32_t *run_ends() const { return reinterpret_cast<int32_t *>(body()); }
+  char    *run_values() const { return body() + sizeof(int32_t) * header_->entry_num; }
+  int      run_of(int row) const;
+
+  uint32_t delta(int row) const;
+  uint32_t code(int row) const;
+  char    *dict_entries() const { return body(); }
+  char    *dict_codes() const { return body() + header_->entry_num * header_->value_len; }
+
+private:
+  char                *data_   = nullptr;
+  int                  size_   = 0;
+  ColumnSegmentHeader *header_ = nullptr;
+};
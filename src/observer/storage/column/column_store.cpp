@@ -0,0 +1,805 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <algorithm>
+#include <map>
+
+#include "storage/column/column_store.h"
+#include "common/lang/bitmap.h"
+#include "common/log/log.h"
+#include "storage/column/column_segment.h"
+#include "storage/common/meta_util.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+namespace {
+
+/**
+ * @brief 一个行组在目录和列文件中 pin 住的页面，析构时 unpin
+ */
+class PinnedPages
+{
+public:
+  ~PinnedPages()
+  {
+    for (auto &[buffer_pool, frame] : frames_) {
+      buffer_pool->unpin_page(frame);
+    }
+  }
+
+  void add(DiskBufferPool *buffer_pool, Frame *frame) { frames_.emplace_back(buffer_pool, frame); }
+
+private:
+  vector<pair<DiskBufferPool *, Frame *>> frames_;
+};
+
+const char *comp_op_to_string(CompOp comp)
+{
+  switch (comp) {
+    case EQUAL_TO: return "=";
+    case LESS_THAN: return "<";
+    case LESS_EQUAL: return "<=";
+    case GREAT_THAN: return ">";
+    case GREAT_EQUAL: return ">=";
+    case NOT_EQUAL: return "<>";
+    default: return "?";
+  }
+}
+
+}  // namespace
+
+ColumnStore::~ColumnStore() { close(); }
+
+RC ColumnStore::create_files(const char *base_dir, const char *table_name, const vector<FieldMeta> &fields)
+{
+  BufferPoolManager &bpm = BufferPoolManager::instance();
+  for (const FieldMeta &field : fields) {
+    string column_file = table_column_file(base_dir, table_name, field.name());
+    RC     rc          = bpm.create_file(column_file.c_str(), bpm.options().table_page_size);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to create column file. file name=%s, rc=%s", column_file.c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::open(const char *base_dir, const char *table_name, DiskBufferPool *directory,
+                     const vector<FieldMeta> &fields, int sys_field_num, int record_size)
+{
+  table_name_    = table_name;
+  directory_     = directory;
+  fields_        = fields;
+  sys_field_num_ = sys_field_num;
+  record_size_   = record_size;
+
+  // 目录页面上的位图也要放得下一个行组的所有行
+  capacity_ = static_cast<int>((directory->page_data_size() - sizeof(ColumnRowGroupHeader)) * 8);
+  for (const FieldMeta &field : fields_) {
+    string          column_file = table_column_file(base_dir, table_name, field.name());
+    DiskBufferPool *buffer_pool = nullptr;
+    RC              rc          = BufferPoolManager::instance().open_file(column_file.c_str(), buffer_pool);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to open column file. file name=%s, rc=%s", column_file.c_str(), strrc(rc));
+      return rc;
+    }
+    column_files_.push_back(buffer_pool);
+    capacity_ = min(capacity_, ColumnSegment::plain_capacity(buffer_pool->page_data_size(), field.len()));
+  }
+
+  // 新的记录追加到最后一个行组。这里不编码写满的行组，数据库恢复时还可能往里面补写没有落盘的行
+  BufferPoolIterator iterator;
+  RC                 rc = iterator.init(*directory_);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to init row group iterator. table=%s, rc=%s", table_name, strrc(rc));
+    return rc;
+  }
+  while (iterator.has_next()) {
+    current_group_ = iterator.next();
+  }
+
+  LOG_INFO("open column store. table=%s, columns=%d, row group capacity=%d, last row group=%d",
+           table_name, static_cast<int>(fields_.size()), capacity_, current_group_);
+  return RC::SUCCESS;
+}
+
+void ColumnStore::close()
+{
+  for (DiskBufferPool *buffer_pool : column_files_) {
+    buffer_pool->close_file();
+  }
+  column_files_.clear();
+  directory_     = nullptr;
+  current_group_ = BP_INVALID_PAGE_NUM;
+}
+
+RC ColumnStore::get_page(DiskBufferPool &buffer_pool, PageNum page_num, Frame *&frame)
+{
+  RC rc = buffer_pool.get_this_page(page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get page of column store. table=%s, page num=%d, rc=%s",
+             table_name_.c_str(), page_num, strrc(rc));
+  }
+  return rc;
+}
+
+RC ColumnStore::new_row_group(PageNum &page_num)
+{
+  Frame *frame = nullptr;
+  RC     rc    = directory_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate row group. table=%s, rc=%s", table_name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  page_num = frame->page_num();
+  auto *header = reinterpret_cast<ColumnRowGroupHeader *>(frame->data());
+  memset(header, 0, sizeof(ColumnRowGroupHeader));
+  header->capacity = capacity_;
+  memset(deleted_bitmap(*frame), 0, (capacity_ + 7) / 8);
+  frame->mark_dirty();
+  directory_->unpin_page(frame);
+
+  // 每个列文件中使用同样的页面号。列文件与目录一起增长，只有数据库异常退出时才可能落后于目录，
+  // 这时多分配的页面不会被使用
+  for (size_t i = 0; i < column_files_.size(); i++) {
+    DiskBufferPool *buffer_pool = column_files_[i];
+    rc = buffer_pool->allocate_page(&frame);
+    while (OB_SUCC(rc) && frame->page_num() < page_num) {
+      buffer_pool->unpin_page(frame);
+      rc = buffer_pool->allocate_page(&frame);
+    }
+    if (OB_SUCC(rc) && frame->page_num() != page_num) {
+      buffer_pool->unpin_page(frame);
+      rc = buffer_pool->recover_page(page_num);
+      if (OB_SUCC(rc)) {
+        rc = get_page(*buffer_pool, page_num, frame);
+      }
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate column segment. table=%s, field=%s, page num=%d, rc=%s",
+               table_name_.c_str(), fields_[i].name(), page_num, strrc(rc));
+      return rc;
+    }
+
+    ColumnSegment(frame->data(), buffer_pool->page_data_size()).init(fields_[i].len());
+    frame->mark_dirty();
+    buffer_pool->unpin_page(frame);
+  }
+
+  LOG_TRACE("new row group. table=%s, page num=%d", table_name_.c_str(), page_num);
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::recover_row_group(PageNum page_num)
+{
+  Frame *frame = nullptr;
+  RC     rc    = directory_->recover_page(page_num);
+  if (OB_SUCC(rc)) {
+    rc = get_page(*directory_, page_num, frame);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to recover row group. table=%s, page num=%d, rc=%s", table_name_.c_str(), page_num, strrc(rc));
+    return rc;
+  }
+
+  // 新扩展的页面内容都是0
+  auto *header = reinterpret_cast<ColumnRowGroupHeader *>(frame->data());
+  if (header->capacity == 0) {
+    header->capacity = capacity_;
+    memset(deleted_bitmap(*frame), 0, (capacity_ + 7) / 8);
+    frame->mark_dirty();
+  }
+  directory_->unpin_page(frame);
+
+  for (size_t i = 0; i < column_files_.size(); i++) {
+    DiskBufferPool *buffer_pool = column_files_[i];
+    rc = buffer_pool->recover_page(page_num);
+    if (OB_SUCC(rc)) {
+      rc = get_page(*buffer_pool, page_num, frame);
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    ColumnSegment segment(frame->data(), buffer_pool->page_data_size());
+    if (!segment.inited()) {
+      segment.init(fields_[i].len());
+      frame->mark_dirty();
+    }
+    buffer_pool->unpin_page(frame);
+  }
+
+  if (current_group_ == BP_INVALID_PAGE_NUM || page_num > current_group_) {
+    current_group_ = page_num;
+  }
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::seal_row_group(PageNum page_num)
+{
+  PinnedPages pinned;
+  Frame      *directory_frame = nullptr;
+  RC          rc              = get_page(*directory_, page_num, directory_frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  pinned.add(directory_, directory_frame);
+
+  auto *header = reinterpret_cast<ColumnRowGroupHeader *>(directory_frame->data());
+  if (header->sealed) {
+    return RC::SUCCESS;
+  }
+
+  // 事务在提交和回滚时还要修改系统字段，系统字段不编码
+  for (size_t i = sys_field_num_; i < column_files_.size(); i++) {
+    Frame *frame = nullptr;
+    rc           = get_page(*column_files_[i], page_num, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    pinned.add(column_files_[i], frame);
+
+    ColumnSegment segment(frame->data(), column_files_[i]->page_data_size());
+    if (segment.encoding() == ColumnEncoding::PLAIN) {
+      segment.seal(fields_[i].type());
+      frame->mark_dirty();
+    }
+    LOG_TRACE("seal column segment. table=%s, field=%s, page num=%d, encoding=%s, size=%d",
+              table_name_.c_str(), fields_[i].name(), page_num,
+              column_encoding_name(segment.encoding()), segment.used_size());
+  }
+
+  header->sealed = 1;
+  directory_frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::seal_full_row_groups()
+{
+  BufferPoolIterator iterator;
+  RC                 rc = iterator.init(*directory_);
+  while (OB_SUCC(rc) && iterator.has_next()) {
+    const PageNum page_num = iterator.next();
+    Frame        *frame    = nullptr;
+    rc = get_page(*directory_, page_num, frame);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+    auto      *header = reinterpret_cast<ColumnRowGroupHeader *>(frame->data());
+    const bool full   = header->row_num >= header->capacity && !header->sealed;
+    directory_->unpin_page(frame);
+    if (full) {
+      rc = seal_row_group(page_num);
+    }
+  }
+  return rc;
+}
+
+RC ColumnStore::writable_row_group(PageNum &page_num, int &row_num)
+{
+  // 第一次插入时数据库的恢复已经结束了
+  if (!unsealed_checked_) {
+    RC rc = seal_full_row_groups();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to seal full row groups. table=%s, rc=%s", table_name_.c_str(), strrc(rc));
+      return rc;
+    }
+    unsealed_checked_ = true;
+  }
+
+  if (current_group_ != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC     rc    = get_page(*directory_, current_group_, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    row_num = reinterpret_cast<ColumnRowGroupHeader *>(frame->data())->row_num;
+    directory_->unpin_page(frame);
+
+    if (row_num < capacity_) {
+      page_num = current_group_;
+      return RC::SUCCESS;
+    }
+
+    // 写满的行组在开始写下一个行组时编码
+    rc = seal_row_group(current_group_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to seal row group. table=%s, page num=%d, rc=%s",
+               table_name_.c_str(), current_group_, strrc(rc));
+      return rc;
+    }
+  }
+
+  RC rc = new_row_group(page_num);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  current_group_ = page_num;
+  row_num        = 0;
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::write_rows(PageNum page_num, int start, const char *const *datas, int count)
+{
+  PinnedPages pinned;
+  Frame      *directory_frame = nullptr;
+  RC          rc              = get_page(*directory_, page_num, directory_frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  pinned.add(directory_, directory_frame);
+
+  for (size_t i = 0; i < column_files_.size(); i++) {
+    Frame *frame = nullptr;
+    rc           = get_page(*column_files_[i], page_num, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    pinned.add(column_files_[i], frame);
+
+    // 只有数据库恢复时才会写到已经编码的列段，编码过的列段包含了行组的所有值
+    ColumnSegment segment(frame->data(), column_files_[i]->page_data_size());
+    if (segment.encoding() != ColumnEncoding::PLAIN) {
+      continue;
+    }
+    const int offset = fields_[i].offset();
+    for (int row = 0; row < count; row++) {
+      segment.set(start + row, datas[row] + offset);
+    }
+    frame->mark_dirty();
+  }
+
+  auto  *header = reinterpret_cast<ColumnRowGroupHeader *>(directory_frame->data());
+  Bitmap deleted(deleted_bitmap(*directory_frame), capacity_);
+  for (int row = start; row < start + count; row++) {
+    if (row < header->row_num && deleted.get_bit(row)) {
+      deleted.clear_bit(row);
+      header->deleted_num--;
+    }
+  }
+  header->row_num = max(header->row_num, start + count);
+  directory_frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::insert_record(const char *data, RID &rid)
+{
+  vector<RID> rids;
+  RC          rc = insert_records({data}, rids);
+  if (OB_SUCC(rc)) {
+    rid = rids.front();
+  }
+  return rc;
+}
+
+RC ColumnStore::insert_records(const vector<const char *> &datas, vector<RID> &rids)
+{
+  lock_guard<Mutex> guard(lock_);
+
+  rids.clear();
+  rids.reserve(datas.size());
+  size_t done = 0;
+  while (done < datas.size()) {
+    PageNum page_num = BP_INVALID_PAGE_NUM;
+    int     row_num  = 0;
+    RC      rc       = writable_row_group(page_num, row_num);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    const int count = static_cast<int>(min<size_t>(capacity_ - row_num, datas.size() - done));
+    rc              = write_rows(page_num, row_num, datas.data() + done, count);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to write rows. table=%s, page num=%d, rc=%s", table_name_.c_str(), page_num, strrc(rc));
+      return rc;
+    }
+    for (int i = 0; i < count; i++) {
+      rids.emplace_back(page_num, row_num + i);
+    }
+    done += count;
+  }
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::recover_insert_record(const char *data, const RID &rid)
+{
+  lock_guard<Mutex> guard(lock_);
+  if (rid.slot_num < 0 || rid.slot_num >= capacity_) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  RC rc = recover_row_group(rid.page_num);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  return write_rows(rid.page_num, rid.slot_num, &data, 1);
+}
+
+RC ColumnStore::delete_record(const RID &rid)
+{
+  lock_guard<Mutex> guard(lock_);
+
+  Frame *frame = nullptr;
+  RC     rc    = get_page(*directory_, rid.page_num, frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  auto  *header = reinterpret_cast<ColumnRowGroupHeader *>(frame->data());
+  Bitmap deleted(deleted_bitmap(*frame), capacity_);
+  if (rid.slot_num < 0 || rid.slot_num >= header->row_num || deleted.get_bit(rid.slot_num)) {
+    rc = RC::RECORD_NOT_EXIST;
+  } else {
+    deleted.set_bit(rid.slot_num);
+    header->deleted_num++;
+    frame->mark_dirty();
+  }
+  directory_->unpin_page(frame);
+  return rc;
+}
+
+RC ColumnStore::copy_row(PageNum page_num, int row, char *data)
+{
+  PinnedPages pinned;
+  Frame      *frame = nullptr;
+  RC          rc    = get_page(*directory_, page_num, frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  pinned.add(directory_, frame);
+
+  auto *header = reinterpret_cast<ColumnRowGroupHeader *>(frame->data());
+  if (row < 0 || row >= header->row_num || Bitmap(deleted_bitmap(*frame), capacity_).get_bit(row)) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  memset(data, 0, record_size_);
+  for (size_t i = 0; i < column_files_.size(); i++) {
+    rc = get_page(*column_files_[i], page_num, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    pinned.add(column_files_[i], frame);
+    ColumnSegment(frame->data(), column_files_[i]->page_data_size()).get(row, data + fields_[i].offset());
+  }
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::copy_record(const RID &rid, char *data)
+{
+  lock_guard<Mutex> guard(lock_);
+  return copy_row(rid.page_num, rid.slot_num, data);
+}
+
+RC ColumnStore::visit_record(const RID &rid, bool readonly, function<void(Record &)> visitor)
+{
+  lock_guard<Mutex> guard(lock_);
+
+  vector<char> data(record_size_);
+  RC           rc = copy_row(rid.page_num, rid.slot_num, data.data());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const vector<char> old_data = data;
+  Record             record;
+  record.set_rid(rid);
+  record.set_data(data.data(), record_size_);
+  visitor(record);
+  if (readonly) {
+    return RC::SUCCESS;
+  }
+
+  // 只写回修改过的字段，通常只有事务的系统字段
+  for (size_t i = 0; i < column_files_.size(); i++) {
+    const int offset = fields_[i].offset();
+    if (memcmp(old_data.data() + offset, data.data() + offset, fields_[i].len()) == 0) {
+      continue;
+    }
+
+    Frame *frame = nullptr;
+    rc           = get_page(*column_files_[i], rid.page_num, frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    rc = ColumnSegment(frame->data(), column_files_[i]->page_data_size()).update(rid.slot_num, data.data() + offset);
+    if (OB_SUCC(rc)) {
+      frame->mark_dirty();
+    }
+    column_files_[i]->unpin_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("cannot update an encoded column. table=%s, field=%s, rid=%s",
+               table_name_.c_str(), fields_[i].name(), rid.to_string().c_str());
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC ColumnStore::scan_row_group(PageNum page_num, const vector<ColumnCondition> &conditions,
+                               const vector<int> &columns, vector<char> &buffer, vector<Record> &records, int &row_num)
+{
+  lock_guard<Mutex> guard(lock_);
+
+  records.clear();
+  row_num = 0;
+
+  PinnedPages pinned;
+  Frame      *frame = nullptr;
+  RC          rc    = get_page(*directory_, page_num, frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  pinned.add(directory_, frame);
+
+  auto *header = reinterpret_cast<ColumnRowGroupHeader *>(frame->data());
+  const int total = header->row_num;
+  vector<uint8_t> selection(total, 1);
+  Bitmap          deleted(deleted_bitmap(*frame), capacity_);
+  if (header->deleted_num > 0) {
+    for (int row = deleted.next_setted_bit(0); row >= 0 && row < total; row = deleted.next_setted_bit(row + 1)) {
+      selection[row] = 0;
+    }
+  }
+  row_num = total - header->deleted_num;
+
+  // 每个列段最多 pin 一次
+  vector<Frame *> segment_frames(column_files_.size(), nullptr);
+  auto pin_segment = [&](int column) -> RC {
+    if (segment_frames[column] != nullptr) {
+      return RC::SUCCESS;
+    }
+    RC rc = get_page(*column_files_[column], page_num, segment_frames[column]);
+    if (OB_SUCC(rc)) {
+      pinned.add(column_files_[column], segment_frames[column]);
+    } else {
+      segment_frames[column] = nullptr;
+    }
+    return rc;
+  };
+
+  // 在编码以后的数据上计算条件
+  for (const ColumnCondition &condition : conditions) {
+    rc = pin_segment(condition.column);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    ColumnSegment segment(segment_frames[condition.column]->data(), column_files_[condition.column]->page_data_size());
+    segment.filter(fields_[condition.column].type(), condition.comp, condition.value, selection.data());
+  }
+
+  vector<int> rows;
+  for (int row = 0; row < total; row++) {
+    if (selection[row]) {
+      rows.push_back(row);
+    }
+  }
+  if (rows.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 只取出需要的字段
+  buffer.assign(rows.size() * record_size_, 0);
+  vector<char> values;
+  auto gather = [&](int column) -> RC {
+    RC rc = pin_segment(column);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    ColumnSegment segment(segment_frames[column]->data(), column_files_[column]->page_data_size());
+    const int     offset = fields_[column].offset();
+    const int     len    = fields_[column].len();
+    char         *dst    = buffer.data() + offset;
+    if (segment.encoding() == ColumnEncoding::RLE) {
+      // 按行号找游程要二分查找，不如一次解码所有的行
+      values.resize(static_cast<size_t>(segment.row_num()) * len);
+      segment.decode(values.data());
+      for (int row : rows) {
+        memcpy(dst, values.data() + static_cast<int64_t>(row) * len, len);
+        dst += record_size_;
+      }
+    } else {
+      for (int row : rows) {
+        segment.get(row, dst);
+        dst += record_size_;
+      }
+    }
+    return RC::SUCCESS;
+  };
+
+  if (columns.empty()) {
+    for (int i = 0; i < static_cast<int>(column_files_.size()); i++) {
+      rc = gather(i);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  } else {
+    for (int column : columns) {
+      rc = gather(column);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+
+  records.resize(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    records[i].set_rid(page_num, rows[i]);
+    records[i].set_data(buffer.data() + i * record_size_, record_size_);
+  }
+  return RC::SUCCESS;
+}
+
+string ColumnStore::encoding_summary(int column)
+{
+  lock_guard<Mutex> guard(lock_);
+
+  map<ColumnEncoding, int> counts;
+  BufferPoolIterator       iterator;
+  if (OB_FAIL(iterator.init(*directory_))) {
+    return "";
+  }
+  while (iterator.has_next()) {
+    PageNum page_num = iterator.next();
+    Frame  *frame    = nullptr;
+    if (OB_FAIL(get_page(*column_files_[column], page_num, frame))) {
+      continue;
+    }
+    counts[ColumnSegment(frame->data(), column_files_[column]->page_data_size()).encoding()]++;
+    column_files_[column]->unpin_page(frame);
+  }
+
+  string summary;
+  for (const auto &[encoding, count] : counts) {
+    if (!summary.empty()) {
+      summary += " ";
+    }
+    summary += string(column_encoding_name(encoding)) + ":" + to_string(count);
+  }
+  return summary;
+}
+
+string ColumnStore::condition_to_string(const ColumnCondition &condition) const
+{
+  return string(fields_[condition.column].name()) + comp_op_to_string(condition.comp) + condition.value.to_string();
+}
+
+RC ColumnStore::sync()
+{
+  lock_guard<Mutex> guard(lock_);
+  RC rc = directory_->flush_all_pages();
+  for (size_t i = 0; OB_SUCC(rc) && i < column_files_.size(); i++) {
+    rc = column_files_[i]->flush_all_pages();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to flush column store. table=%s, rc=%s", table_name_.c_str(), strrc(rc));
+  }
+  return rc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ColumnScanner::~ColumnScanner() { close_scan(); }
+
+RC ColumnScanner::open_scan(Table *table, ColumnStore &store, Trx *trx, bool readonly,
+                            vector<ColumnCondition> conditions, vector<int> columns)
+{
+  table_      = table;
+  store_      = &store;
+  trx_        = trx;
+  readonly_   = readonly;
+  conditions_ = std::move(conditions);
+  columns_    = std::move(columns);
+
+  RC rc = iterator_.init(store.directory());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init row group iterator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  records_.clear();
+  record_index_  = 0;
+  fetch_rc_      = RC::SUCCESS;
+  rows_scanned_  = 0;
+  rows_selected_ = 0;
+  return RC::SUCCESS;
+}
+
+RC ColumnScanner::close_scan()
+{
+  store_ = nullptr;
+  records_.clear();
+  buffer_.clear();
+  record_index_ = 0;
+  return RC::SUCCESS;
+}
+
+RC ColumnScanner::fetch_next_row_group()
+{
+  records_.clear();
+  record_index_ = 0;
+  while (iterator_.has_next()) {
+    PageNum page_num = iterator_.next();
+    int     row_num  = 0;
+    RC      rc       = store_->scan_row_group(page_num, conditions_, columns_, buffer_, records_, row_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to scan row group. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    rows_scanned_ += row_num;
+    rows_selected_ += records_.size();
+
+    // 与 RecordFileScanner 一样，由事务决定记录是否可见
+    size_t visible_num = 0;
+    for (size_t i = 0; i < records_.size(); i++) {
+      Record &record = records_[i];
+      if (trx_ != nullptr) {
+        rc = trx_->visit_record(table_, record, readonly_);
+        if (rc == RC::RECORD_INVISIBLE) {
+          continue;
+        }
+        if (OB_FAIL(rc)) {
+          LOG_TRACE("failed to visit record. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+          records_.clear();
+          return rc;
+        }
+      }
+
+      if (visible_num != i) {
+        records_[visible_num] = record;
+      }
+      visible_num++;
+    }
+    records_.resize(visible_num);
+    if (!records_.empty()) {
+      return RC::SUCCESS;
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
+bool ColumnScanner::has_next()
+{
+  if (record_index_ < records_.size()) {
+    return true;
+  }
+  if (store_ == nullptr || fetch_rc_ == RC::RECORD_EOF) {
+    return false;
+  }
+
+  // 出错时也返回true，由 next 返回错误
+  fetch_rc_ = fetch_next_row_group();
+  return fetch_rc_ != RC::RECORD_EOF;
+}
+
+RC ColumnScanner::next(Record &record)
+{
+  if (record_index_ >= records_.size()) {
+    if (!has_next()) {
+      return RC::RECORD_EOF;
+    }
+    if (OB_FAIL(fetch_rc_)) {
+      return fetch_rc_;
+    }
+  }
+
+  record = records_[record_index_++];
+  return RC::SUCCESS;
+}
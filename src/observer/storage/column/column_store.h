@@ -0,0 +1,242 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "common/lang/mutex.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record.h"
+
+class Table;
+class Trx;
+
+/**
+ * @brief 行组目录页面的页头，后面是删除标记的位图
+ * @ingroup ColumnStore
+ */
+struct ColumnRowGroupHeader
+{
+  int32_t row_num;      ///< 已经插入的行数，包括删除的行
+  int32_t capacity;     ///< 最多能放多少行
+  int32_t deleted_num;  ///< 删除的行数
+  int32_t sealed;       ///< 是否已经写满并且编码过了
+};
+
+/**
+ * @brief 在编码以后的列数据上过滤的条件：字段 comp 值
+ * @ingroup ColumnStore
+ */
+struct ColumnCondition
+{
+  int    column = -1;     ///< 字段的编号
+  CompOp comp   = NO_OP;  ///< 比较运算，字段在左边
+  Value  value;           ///< 比较的常量
+};
+
+/**
+ * @brief 列存储引擎，管理一个表的所有列文件
+ * @ingroup ColumnStore
+ * @details 表的每个字段(包括系统字段)有一个列文件，都由 DiskBufferPool 管理。数据按照行组划分，
+ * 一个行组在每个列文件中占用一个页面(列段，参考 ColumnSegment)，在所有列文件中的页面号相同。
+ * 表的数据文件用作行组目录，同一个页面号的页面记录这个行组的行数和删除标记。
+ * RID 的 page_num 是行组的页面号，slot_num 是行在行组中的编号，事务和日志都不需要感知列存储。
+ *
+ * 新插入的行追加到最后一个行组中，行组写满以后对普通字段的列段做编码。事务使用的系统字段要在提交时修改，
+ * 一直是 PLAIN 格式；编码以后的普通字段不能再修改。删除只在目录中设置删除标记，不回收空间。
+ *
+ * 一个行组的容量由最长的字段决定，PLAIN 格式的列段要能放在一个页面中。
+ * 所有的操作都持有 lock_，扫描时一次复制出一个行组需要的数据，返回记录时不再持有锁。
+ */
+class ColumnStore
+{
+public:
+  ColumnStore() = default;
+  ~ColumnStore();
+
+  /**
+   * @brief 创建所有的列文件
+   */
+  static RC create_files(const char *base_dir, const char *table_name, const std::vector<FieldMeta> &fields);
+
+  /**
+   * @brief 打开所有的列文件
+   *
+   * @param directory     行组目录使用的文件，就是表的数据文件
+   * @param fields        表的所有字段
+   * @param sys_field_num 系统字段的个数，系统字段在最前面
+   * @param record_size   记录的长度
+   */
+  RC open(const char *base_dir, const char *table_name, DiskBufferPool *directory,
+          const std::vector<FieldMeta> &fields, int sys_field_num, int record_size);
+  void close();
+
+  /**
+   * @brief 每个行组的行数
+   */
+  int row_group_capacity() const { return capacity_; }
+
+  RC insert_record(const char *data, RID &rid);
+
+  /**
+   * @brief 插入一批记录，一个行组中的记录每个列段只访问一次
+   */
+  RC insert_records(const std::vector<const char *> &datas, std::vector<RID> &rids);
+
+  /**
+   * @brief 数据库恢复时在指定的位置插入记录。已经编码的列段中的值与日志中的一样，不需要再写
+   */
+  RC recover_insert_record(const char *data, const RID &rid);
+
+  RC delete_record(const RID &rid);
+
+  /**
+   * @brief 访问一条记录，非只读时把修改过的字段写回列段
+   */
+  RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
+
+  RC copy_record(const RID &rid, char *data);
+
+  /**
+   * @brief 读取一个行组中满足条件的行
+   * @details 先在编码以后的数据上计算条件，再只解码需要的字段，复制到 buffer 中。没有读取的字段都是0
+   *
+   * @param page_num   行组的页面号
+   * @param conditions 过滤条件，所有的条件都要满足
+   * @param columns    需要读取的字段，为空时读取所有的字段
+   * @param buffer     存放记录的数据
+   * @param records    返回的记录，指向 buffer 中的数据
+   * @param row_num    返回行组中没有删除的行数
+   */
+  RC scan_row_group(PageNum page_num, const std::vector<ColumnCondition> &conditions, const std::vector<int> &columns,
+                    std::vector<char> &buffer, std::vector<Record> &records, int &row_num);
+
+  /**
+   * @brief 行组目录所在的文件，遍历这个文件的页面就是遍历所有的行组
+   */
+  DiskBufferPool &directory() { return *directory_; }
+
+  /**
+   * @brief 统计每种编码的列段个数，EXPLAIN 使用
+   */
+  std::string encoding_summary(int column);
+
+  /**
+   * @brief 用于 EXPLAIN 展示的过滤条件
+   */
+  std::string condition_to_string(const ColumnCondition &condition) const;
+
+  RC sync();
+
+private:
+  RC new_row_group(PageNum &page_num);
+  RC recover_row_group(PageNum page_num);
+
+  /**
+   * @brief 找到可以追加记录的行组，最后一个行组写满时编码它，再创建一个新的
+   * @param row_num 返回行组中已有的行数
+   */
+  RC writable_row_group(PageNum &page_num, int &row_num);
+
+  /**
+   * @brief 把一个行组的普通字段编码
+   */
+  RC seal_row_group(PageNum page_num);
+
+  /**
+   * @brief 编码所有写满了但是还没有编码的行组
+   * @details 数据库异常退出时编码的结果可能没有落盘，恢复以后这些行组又是 PLAIN 格式的
+   */
+  RC seal_full_row_groups();
+
+  /**
+   * @brief 在行组的 [start, start + count) 行写入记录
+   */
+  RC write_rows(PageNum page_num, int start, const char *const *datas, int count);
+
+  RC copy_row(PageNum page_num, int row, char *data);
+
+  RC get_page(DiskBufferPool &buffer_pool, PageNum page_num, Frame *&frame);
+  char *deleted_bitmap(Frame &frame) const { return frame.data() + sizeof(ColumnRowGroupHeader); }
+
+private:
+  common::Mutex                 lock_;
+  std::string                   table_name_;
+  DiskBufferPool               *directory_ = nullptr;
+  std::vector<DiskBufferPool *> column_files_;
+  std::vector<FieldMeta>        fields_;
+  int                           record_size_      = 0;
+  int                           sys_field_num_    = 0;
+  int                           capacity_         = 0;
+  PageNum                       current_group_    = BP_INVALID_PAGE_NUM;  ///< 正在插入的行组
+  bool                          unsealed_checked_ = false;  ///< 打开以后是否检查过没有编码的行组
+};
+
+/**
+ * @brief 列存储表的扫描器
+ * @ingroup ColumnStore
+ * @details 一次读取一个行组，在编码以后的数据上过滤以后，再检查事务的可见性
+ */
+class ColumnScanner
+{
+public:
+  ColumnScanner() = default;
+  ~ColumnScanner();
+
+  /**
+   * @brief 打开扫描
+   *
+   * @param table      扫描的表
+   * @param store      表的列存储
+   * @param trx        当前的事务
+   * @param readonly   是否只读
+   * @param conditions 在编码以后的数据上计算的条件
+   * @param columns    需要读取的字段，为空时读取所有的字段
+   */
+  RC open_scan(Table *table, ColumnStore &store, Trx *trx, bool readonly, std::vector<ColumnCondition> conditions,
+               std::vector<int> columns);
+  RC close_scan();
+
+  bool has_next();
+  RC   next(Record &record);
+
+  int64_t rows_scanned() const { return rows_scanned_; }
+  int64_t rows_selected() const { return rows_selected_; }
+
+private:
+  RC fetch_next_row_group();
+
+private:
+  Table                       *table_    = nullptr;
+  ColumnStore                 *store_    = nullptr;
+  Trx                         *trx_      = nullptr;
+  bool                         readonly_ = false;
+  std::vector<ColumnCondition> conditions_;
+  std::vector<int>             columns_;
+  BufferPoolIterator           iterator_;
+  std::vector<char>            buffer_;
+  std::vector<Record>          records_;
+  size_t                       record_index_  = 0;
+  RC                           fetch_rc_      = RC::SUCCESS;
+  int64_t                      rows_scanned_  = 0;  ///< 读取过的行组中没有删除的行数
+  int64_t                      rows_selected_ = 0;  ///< 满足过滤条件的行数
+};
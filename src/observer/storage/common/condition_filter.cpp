@@ -76,7 +76,7 @@ RC DefaultConditionFilter::init(Table &table, const ConditionSqlNode &condition)
     left.attr_length = field_left->len();
     left.attr_offset = field_left->offset();
 
-    type_left = field_left->type();
+    type_left = attr_value_type(field_left->type());
   } else {
     left.is_attr = false;
     left.value = condition.left_value;  // 校验type 或者转换类型
@@ -95,7 +95,7 @@ RC DefaultConditionFilter::init(Table &table, const ConditionSqlNode &condition)
     }
     right.attr_length = field_right->len();
     right.attr_offset = field_right->offset();
-    type_right = field_right->type();
+    type_right = attr_value_type(field_right->type());
   } else {
     right.is_attr = false;
     right.value = condition.right_value;
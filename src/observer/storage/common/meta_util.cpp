@@ -27,3 +27,13 @@ std::string table_index_file(const char *base_dir, const char *table_name, const
 {
   return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + "-" + index_name + TABLE_INDEX_SUFFIX;
 }
+
+std::string table_overflow_file(const char *base_dir, const char *table_name)
+{
+  return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + TABLE_OVERFLOW_SUFFIX;
+}
+
+std::string table_column_file(const char *base_dir, const char *table_name, const char *field_name)
+{
+  return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + "-" + field_name + TABLE_COLUMN_SUFFIX;
+}
@@ -19,7 +19,11 @@ static constexpr const char *TABLE_META_SUFFIX = ".table";
 static constexpr const char *TABLE_META_FILE_PATTERN = ".*\\.table$";
 static constexpr const char *TABLE_DATA_SUFFIX = ".data";
 static constexpr const char *TABLE_INDEX_SUFFIX = ".index";
+static constexpr const char *TABLE_OVERFLOW_SUFFIX = ".overflow";
+static constexpr const char *TABLE_COLUMN_SUFFIX = ".column";
 
 std::string table_meta_file(const char *base_dir, const char *table_name);
 std::string table_data_file(const char *base_dir, const char *table_name);
 std::string table_index_file(const char *base_dir, const char *table_name, const char *index_name);
+std::string table_overflow_file(const char *base_dir, const char *table_name);
+std::string table_column_file(const char *base_dir, const char *table_name, const char *field_name);
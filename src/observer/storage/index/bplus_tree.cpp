@@ -23,18 +23,21 @@ using namespace common;
 
 #define FIRST_INDEX_PAGE 1
 
-int calc_internal_page_capacity(int attr_length)
+/// 只读操作乐观地查找叶子节点时最多重试几次，之后改成加读锁
+static constexpr int OPTIMISTIC_FIND_LEAF_RETRY = 4;
+
+int calc_internal_page_capacity(int attr_length, int page_data_size)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
 
-  int capacity = ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / item_size;
+  int capacity = (page_data_size - InternalIndexNode::HEADER_SIZE) / item_size;
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, int page_data_size)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(RID);
-  int capacity = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
+  int capacity = (page_data_size - LeafIndexNode::HEADER_SIZE) / item_size;
   return capacity;
 }
 
@@ -496,6 +499,14 @@ PageNum InternalIndexNodeHandler::value_at(int index)
   return *(PageNum *)__value_at(index);
 }
 
+PageNum InternalIndexNodeHandler::optimistic_value_at(int index) const
+{
+  if (index < 0 || index >= max_size()) {
+    return BP_INVALID_PAGE_NUM;
+  }
+  return *(PageNum *)__value_at(index);
+}
+
 int InternalIndexNodeHandler::value_index(PageNum page_num)
 {
   for (int i = 0; i < size(); i++) {
@@ -749,7 +760,7 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
     int leaf_max_size /* = -1 */)
 {
   BufferPoolManager &bpm = BufferPoolManager::instance();
-  RC rc = bpm.create_file(file_name);
+  RC rc = bpm.create_file(file_name, bpm.options().index_page_size);
   if (rc != RC::SUCCESS) {
     LOG_WARN("Failed to create file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
     return rc;
@@ -780,10 +791,10 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
   }
 
   if (internal_max_size < 0) {
-    internal_max_size = calc_internal_page_capacity(attr_length);
+    internal_max_size = calc_internal_page_capacity(attr_length, bp->page_data_size());
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(attr_length);
+    leaf_max_size = calc_leaf_page_capacity(attr_length, bp->page_data_size());
   }
 
   char *pdata = header_frame->data();
@@ -1079,23 +1090,35 @@ bool BplusTreeHandler::is_empty() const
 
 RC BplusTreeHandler::find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame)
 {
-  auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
-        return internal_node.value_at(internal_node.lookup(key_comparator_, key));
+  auto child_index_getter = [this, key](InternalIndexNodeHandler &internal_node) {
+        return internal_node.lookup(key_comparator_, key);
       };
-  return find_leaf_internal(latch_memo, op, child_page_getter, frame);
+  return find_leaf_internal(latch_memo, op, child_index_getter, frame);
 }
 
 RC BplusTreeHandler::left_most_page(LatchMemo &latch_memo, Frame *&frame)
 {
-  auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
-  return find_leaf_internal(latch_memo, BplusTreeOperationType::READ, child_page_getter, frame);
+  auto child_index_getter = [](InternalIndexNodeHandler &) { return 0; };
+  return find_leaf_internal(latch_memo, BplusTreeOperationType::READ, child_index_getter, frame);
 }
 
 RC BplusTreeHandler::find_leaf_internal(
     LatchMemo &latch_memo, BplusTreeOperationType op, 
-    const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, 
+    const std::function<int(InternalIndexNodeHandler &)> &child_index_getter, 
     Frame *&frame)
 {
+  if (op == BplusTreeOperationType::READ) {
+    for (int i = 0; i < OPTIMISTIC_FIND_LEAF_RETRY; i++) {
+      RC rc = optimistic_find_leaf(latch_memo, child_index_getter, frame);
+      if (rc != RC::LOCKED_CONCURRENCY_CONFLICT) {
+        return rc;
+      }
+      latch_memo.release();
+    }
+    // 路径上的节点一直在被修改，改成加读锁的蟹行协议
+    LOG_DEBUG("too many conflicts while finding leaf optimistically, use latch crabbing instead");
+  }
+
   // root locked
   if (op != BplusTreeOperationType::READ) {
     latch_memo.xlatch(&root_lock_);
@@ -1117,7 +1140,7 @@ RC BplusTreeHandler::find_leaf_internal(
   PageNum next_page_id;
   for (; !node->is_leaf; ) {
     InternalIndexNodeHandler internal_node(file_header_, frame);
-    next_page_id = child_page_getter(internal_node);
+    next_page_id = internal_node.value_at(child_index_getter(internal_node));
     rc = crabing_protocal_fetch_page(latch_memo, op, next_page_id, false /* is_root_node */, frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("Failed to load page page_num:%d. rc=%s", next_page_id, strrc(rc));
@@ -1129,6 +1152,90 @@ RC BplusTreeHandler::find_leaf_internal(
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::optimistic_find_leaf(LatchMemo &latch_memo, 
+                                          const std::function<int(InternalIndexNodeHandler &)> &child_index_getter, 
+                                          Frame *&frame)
+{
+  latch_memo.slatch(&root_lock_);
+  if (is_empty()) {
+    return RC::EMPTY;
+  }
+
+  RC       rc             = RC::SUCCESS;
+  PageNum  page_num       = file_header_.root_page;
+  Frame   *parent         = nullptr;
+  uint64_t parent_version = 0;
+  while (true) {
+    Frame *current = nullptr;
+    rc = disk_buffer_pool_->get_this_page(page_num, &current);
+    if (rc != RC::SUCCESS) {
+      // 父节点可能已经被修改，读到的页号是无效的
+      if (parent != nullptr && !parent->optimistic_read_validate(parent_version)) {
+        rc = RC::LOCKED_CONCURRENCY_CONFLICT;
+      } else {
+        LOG_WARN("failed to fetch page. page num=%d, rc=%s", page_num, strrc(rc));
+      }
+      break;
+    }
+
+    uint64_t version    = 0;
+    bool     consistent = current->optimistic_read_latch(version);
+
+    // 父节点没有变化，才能确定当前页面就是要找的子节点
+    if (parent != nullptr) {
+      consistent = parent->optimistic_read_validate(parent_version) && consistent;
+      disk_buffer_pool_->unpin_page(parent);
+      parent = nullptr;
+    }
+
+    IndexNodeHandler node(file_header_, current);
+    const bool is_leaf = consistent && node.is_leaf();
+    if (!consistent || !current->optimistic_read_validate(version)) {
+      disk_buffer_pool_->unpin_page(current);
+      rc = RC::LOCKED_CONCURRENCY_CONFLICT;
+      break;
+    }
+
+    if (is_leaf) {
+      // 叶子节点会被调用者长时间访问，需要加读锁。加锁之前可能已经被修改了，加锁以后再校验一次
+      rc = latch_memo.get_page(page_num, frame);
+      disk_buffer_pool_->unpin_page(current);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to fetch leaf page. page num=%d, rc=%s", page_num, strrc(rc));
+        break;
+      }
+
+      latch_memo.slatch(frame);
+      if (!frame->optimistic_read_validate(version)) {
+        rc = RC::LOCKED_CONCURRENCY_CONFLICT;
+      }
+      break;
+    }
+
+    InternalIndexNodeHandler internal_node(file_header_, current);
+    const int size       = internal_node.size();
+    PageNum   child_page = BP_INVALID_PAGE_NUM;
+    if (size > 0 && size <= internal_node.max_size()) {
+      child_page = internal_node.optimistic_value_at(child_index_getter(internal_node));
+    }
+
+    if (!current->optimistic_read_validate(version) || child_page == BP_INVALID_PAGE_NUM) {
+      disk_buffer_pool_->unpin_page(current);
+      rc = RC::LOCKED_CONCURRENCY_CONFLICT;
+      break;
+    }
+
+    parent         = current;
+    parent_version = version;
+    page_num       = child_page;
+  }
+
+  if (parent != nullptr) {
+    disk_buffer_pool_->unpin_page(parent);
+  }
+  return rc;
+}
+
 RC BplusTreeHandler::crabing_protocal_fetch_page(LatchMemo &latch_memo, 
                                                  BplusTreeOperationType op, 
                                                  PageNum page_num, 
@@ -405,6 +405,13 @@ public:
   char *key_at(int index);
   PageNum value_at(int index);
 
+  /**
+   * @brief 乐观读时获取子节点的页号
+   * @details 乐观读的时候节点可能正在被修改，这里不做断言检查，下标超出范围时返回 BP_INVALID_PAGE_NUM。
+   * 返回的页号需要校验页帧版本以后才能使用
+   */
+  PageNum optimistic_value_at(int index) const;
+
   /**
    * 返回指定子节点在当前节点中的索引
    */
@@ -534,8 +541,17 @@ protected:
   RC find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame);
   RC left_most_page(LatchMemo &latch_memo, Frame *&frame);
   RC find_leaf_internal(LatchMemo &latch_memo, BplusTreeOperationType op, 
-                        const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, 
+                        const std::function<int(InternalIndexNodeHandler &)> &child_index_getter, 
                         Frame *&frame);
+
+  /**
+   * @brief 只读操作使用乐观读查找叶子节点
+   * @details 内部节点不加锁，读到子节点页号以后校验版本号，只有叶子节点加读锁。
+   * 路径上的节点被修改时返回 LOCKED_CONCURRENCY_CONFLICT，调用者释放 latch_memo 以后重试
+   */
+  RC optimistic_find_leaf(LatchMemo &latch_memo, 
+                          const std::function<int(InternalIndexNodeHandler &)> &child_index_getter, 
+                          Frame *&frame);
   RC crabing_protocal_fetch_page(LatchMemo &latch_memo, BplusTreeOperationType op, PageNum page_num, bool is_root_page,
                                  Frame *&frame);
 
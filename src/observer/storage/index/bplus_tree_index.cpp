@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021/5/19.
 //
 
+#include <algorithm>
+#include <numeric>
+
 #include "storage/index/bplus_tree_index.h"
 #include "common/log/log.h"
 
@@ -32,7 +35,8 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, co
 
   Index::init(index_meta, field_meta);
 
-  RC rc = index_handler_.create(file_name, field_meta.type(), field_meta.len());
+  // 索引的键值取自内存中的记录，VARCHARS 字段在内存中与 CHARS 的格式一样
+  RC rc = index_handler_.create(file_name, attr_value_type(field_meta.type()), field_meta.len());
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name,
@@ -92,6 +96,33 @@ RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
   return index_handler_.insert_entry(record + field_meta_.offset(), rid);
 }
 
+RC BplusTreeIndex::insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids)
+{
+  AttrComparator comparator;
+  comparator.init(attr_value_type(field_meta_.type()), field_meta_.len());
+
+  const int offset = field_meta_.offset();
+  std::vector<size_t> order(records.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t left, size_t right) {
+    int result = comparator(records[left] + offset, records[right] + offset);
+    if (result != 0) {
+      return result < 0;
+    }
+    return RID::compare(&rids[left], &rids[right]) < 0;
+  });
+
+  for (size_t index : order) {
+    RC rc = index_handler_.insert_entry(records[index] + offset, &rids[index]);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to insert entry. index=%s, rid=%s, rc=%s",
+          index_meta_.name(), rids[index].to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
 {
   return index_handler_.delete_entry(record + field_meta_.offset(), rid);
@@ -34,6 +34,12 @@ public:
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 按照键值排序以后再插入
+   * @details 相邻的键值大多落在同一个叶子节点上，访问的页面比按照记录的顺序插入少很多
+   */
+  RC insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids) override;
+
   /**
    * 扫描指定范围的数据
    */
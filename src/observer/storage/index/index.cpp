@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/index.h"
+#include "common/log/log.h"
 
 RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta)
 {
@@ -20,3 +21,15 @@ RC Index::init(const IndexMeta &index_meta, const FieldMeta &field_meta)
   field_meta_ = field_meta;
   return RC::SUCCESS;
 }
+
+RC Index::insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids)
+{
+  for (size_t i = 0; i < records.size(); i++) {
+    RC rc = insert_entry(records[i], &rids[i]);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to insert entry. index=%s, rid=%s, rc=%s", index_meta_.name(), rids[i].to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -53,6 +53,15 @@ public:
    */
   virtual RC insert_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 插入一批数据
+   * @details 批量导入数据时使用。默认实现逐条调用 insert_entry，失败时已经插入的数据不会删除
+   *
+   * @param records 插入的记录
+   * @param rids    每条记录的位置，与 records 一一对应
+   */
+  virtual RC insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids);
+
   /**
    * @brief 删除一条数据
    * 
@@ -0,0 +1,186 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+
+#include "storage/record/free_space_map.h"
+#include "common/lang/bitmap.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace common;
+
+static constexpr int FSM_PAGE_HEADER_SIZE = static_cast<int>(sizeof(FreeSpaceMapPageHeader));
+
+RC FreeSpaceMap::init(DiskBufferPool &buffer_pool)
+{
+  buffer_pool_     = &buffer_pool;
+  pages_per_group_ = buffer_pool.pages_per_group();
+  enabled_         = false;
+
+  // 位图的长度与组内页面个数一样，页头不比 buffer pool 位图页的页头长，一定放得下
+  static_assert(FSM_PAGE_HEADER_SIZE <= static_cast<int>(sizeof(int32_t) * 2), "header of fsm page is too large");
+
+  const PageNum first_map_page = 1;
+  if (buffer_pool.page_count() <= first_map_page) {
+    // 还没有任何记录页面，使用新的格式。第一个分配出来的页面就是第0组的空闲空间表页面
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool.allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to create free space map page. file=%s, rc=%s", buffer_pool.file_name().c_str(), strrc(rc));
+      return rc;
+    }
+    if (frame->page_num() != first_map_page) {
+      LOG_WARN("unexpected page allocated. file=%s, page num=%d", buffer_pool.file_name().c_str(), frame->page_num());
+      buffer_pool.unpin_page(frame);
+      return RC::INTERNAL;
+    }
+    enabled_ = true;
+    frame->write_latch();
+    init_map_page(*frame);
+    frame->write_unlatch();
+    buffer_pool.unpin_page(frame);
+    LOG_INFO("create free space map. file=%s", buffer_pool.file_name().c_str());
+    return RC::SUCCESS;
+  }
+
+  if (buffer_pool.next_allocated_page(first_map_page, first_map_page + 1) != first_map_page) {
+    LOG_INFO("data file has no free space map. file=%s", buffer_pool.file_name().c_str());
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool.get_this_page(first_map_page, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get page. file=%s, page num=%d, rc=%s",
+             buffer_pool.file_name().c_str(), first_map_page, strrc(rc));
+    return rc;
+  }
+  enabled_ = is_map_page(buffer_pool, first_map_page, frame->data());
+  buffer_pool.unpin_page(frame);
+
+  LOG_INFO("open data file. file=%s, free space map enabled=%d", buffer_pool.file_name().c_str(), enabled_);
+  return RC::SUCCESS;
+}
+
+void FreeSpaceMap::close()
+{
+  buffer_pool_ = nullptr;
+  enabled_     = false;
+}
+
+int FreeSpaceMap::group_num() const
+{
+  return (buffer_pool_->page_count() + pages_per_group_ - 1) / pages_per_group_;
+}
+
+RC FreeSpaceMap::load_group(int group, bool &found, const std::function<void(PageNum)> &visitor)
+{
+  found = false;
+
+  Frame *frame = nullptr;
+  RC     rc    = get_map_page(group, frame);
+  if (rc == RC::NOTFOUND) {
+    return RC::SUCCESS;
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  found = true;
+  frame->read_latch();
+  Bitmap        bitmap(map_bitmap(*frame), pages_per_group_);
+  const PageNum group_start = group * pages_per_group_;
+  for (int index = bitmap.next_setted_bit(0); index >= 0; index = bitmap.next_setted_bit(index + 1)) {
+    visitor(group_start + index);
+  }
+  frame->read_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC FreeSpaceMap::set_free(PageNum page_num, bool free)
+{
+  if (!enabled_) {
+    return RC::SUCCESS;
+  }
+
+  const int group = page_num / pages_per_group_;
+  const int index = page_num % pages_per_group_;
+
+  Frame *frame = nullptr;
+  RC     rc    = get_map_page(group, frame);
+  if (rc == RC::NOTFOUND) {
+    // 这一组没有空闲空间表页面，打开文件时会遍历这一组的页面
+    return RC::SUCCESS;
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get free space map page. group=%d, rc=%s", group, strrc(rc));
+    return rc;
+  }
+
+  frame->write_latch();
+  Bitmap bitmap(map_bitmap(*frame), pages_per_group_);
+  if (bitmap.get_bit(index) != free) {
+    if (free) {
+      bitmap.set_bit(index);
+    } else {
+      bitmap.clear_bit(index);
+    }
+    frame->mark_dirty();
+  }
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+void FreeSpaceMap::init_map_page(Frame &frame)
+{
+  memset(frame.data(), 0, buffer_pool_->page_data_size());
+  FreeSpaceMapPageHeader *header = reinterpret_cast<FreeSpaceMapPageHeader *>(frame.data());
+  header->magic                  = PAGE_MAGIC;
+  header->group                  = frame.page_num() / pages_per_group_;
+  frame.mark_dirty();
+}
+
+bool FreeSpaceMap::is_map_page(const DiskBufferPool &buffer_pool, PageNum page_num, const char *data)
+{
+  const FreeSpaceMapPageHeader *header = reinterpret_cast<const FreeSpaceMapPageHeader *>(data);
+  return page_num % buffer_pool.pages_per_group() == 1 && header->magic == PAGE_MAGIC &&
+         header->group == page_num / buffer_pool.pages_per_group();
+}
+
+RC FreeSpaceMap::get_map_page(int group, Frame *&frame)
+{
+  const PageNum page_num = group * pages_per_group_ + 1;
+  if (page_num >= buffer_pool_->page_count() || buffer_pool_->next_allocated_page(page_num, page_num + 1) != page_num) {
+    return RC::NOTFOUND;
+  }
+
+  RC rc = buffer_pool_->get_this_page(page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get free space map page. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  if (!is_map_page(*buffer_pool_, page_num, frame->data())) {
+    // 数据库恢复时这个位置可能分配成了记录页面
+    buffer_pool_->unpin_page(frame);
+    frame = nullptr;
+    return RC::NOTFOUND;
+  }
+  return RC::SUCCESS;
+}
+
+char *FreeSpaceMap::map_bitmap(Frame &frame) const { return frame.data() + FSM_PAGE_HEADER_SIZE; }
@@ -0,0 +1,126 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+#include "common/rc.h"
+#include "common/types.h"
+
+class DiskBufferPool;
+class Frame;
+
+/**
+ * @brief 空闲空间表页面的页头
+ * @ingroup RecordManager
+ */
+struct FreeSpaceMapPageHeader
+{
+  int32_t magic;  ///< 固定是 FreeSpaceMap::PAGE_MAGIC
+  int32_t group;  ///< 对应的页面组
+};
+
+/**
+ * @brief 数据文件的空闲空间表
+ * @ingroup RecordManager
+ * @details 按照 buffer pool 的页面组划分，每组的第二个页面(位图页之后的第一个页面)是这一组的空闲空间表页面，
+ * 页头之后是一个位图，记录组内每个页面是否可能还有空闲空间，与 RecordFileHandler 中的 free_pages_ 一致。
+ * 打开表的时候只需要读取这些页面，不需要遍历所有的记录页面。
+ *
+ * 空闲空间表只是一个提示，修改不记录日志。插入记录时会检查页面实际的空间，标记有空闲空间的页面其实已经满了也没有关系；
+ * 异常退出以后有些有空间的页面可能没有标记，下次删除这个页面上的记录时会再标记上。
+ *
+ * 空闲空间表页面也是数据文件中分配出来的页面，遍历数据文件时需要使用 is_map_page 跳过。
+ * 以前创建的数据文件第1个页面就是记录页面，这种文件不使用空闲空间表，打开时仍然遍历所有的页面。
+ */
+class FreeSpaceMap
+{
+public:
+  /// 页头中的标识，是个负数。记录页面在这个位置存放的是记录个数，不会与它相同
+  static constexpr int32_t PAGE_MAGIC = static_cast<int32_t>(0xF5A0F5A0);
+
+  FreeSpaceMap() = default;
+  ~FreeSpaceMap() = default;
+
+  /**
+   * @brief 打开数据文件的空闲空间表
+   * @details 还没有任何记录页面的文件会分配第0组的空闲空间表页面，以后就按照新的格式使用。
+   * 其它组的空闲空间表页面在分配记录页面时创建，参考 is_map_page_num
+   */
+  RC init(DiskBufferPool &buffer_pool);
+  void close();
+
+  /**
+   * @brief 这个数据文件是否使用空闲空间表
+   */
+  bool enabled() const { return enabled_; }
+
+  /**
+   * @brief 文件中一共有多少个页面组
+   */
+  int group_num() const;
+
+  /**
+   * @brief 读取一组的空闲空间表，找到所有可能有空闲空间的页面
+   *
+   * @param group   页面组
+   * @param found   返回这一组是否有空闲空间表页面。数据库恢复时可能按照页面号创建了新的组，这种组没有空闲空间表页面
+   * @param visitor 每个有空闲空间的页面调用一次
+   */
+  RC load_group(int group, bool &found, const std::function<void(PageNum)> &visitor);
+
+  /**
+   * @brief 标记页面是否有空闲空间
+   * @details 页面所在组没有空闲空间表页面时什么都不做
+   */
+  RC set_free(PageNum page_num, bool free);
+
+  /**
+   * @brief 这个页面号是不是空闲空间表页面的位置
+   * @details 分配新的记录页面时，分配到这个位置的页面要用作空闲空间表页面
+   */
+  bool is_map_page_num(PageNum page_num) const { return enabled_ && page_num % pages_per_group_ == 1; }
+
+  /**
+   * @brief 把刚分配出来的页面初始化成空闲空间表页面
+   */
+  void init_map_page(Frame &frame);
+
+  /**
+   * @brief 页面是否是空闲空间表页面
+   *
+   * @param buffer_pool 页面所在的文件
+   * @param page_num    页面号
+   * @param data        页面的数据
+   */
+  static bool is_map_page(const DiskBufferPool &buffer_pool, PageNum page_num, const char *data);
+
+private:
+  /**
+   * @brief 获取某一组的空闲空间表页面，返回时已经pin住。没有时返回 RC::NOTFOUND
+   *
+   * @param group  页面组
+   * @param frame  返回的页帧
+   */
+  RC get_map_page(int group, Frame *&frame);
+
+  char *map_bitmap(Frame &frame) const;
+
+private:
+  DiskBufferPool *buffer_pool_     = nullptr;
+  int             pages_per_group_ = 0;
+  bool            enabled_         = false;
+};
@@ -0,0 +1,208 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <algorithm>
+
+#include "storage/record/overflow_page.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+
+static constexpr int OVERFLOW_PAGE_HEADER_SIZE = static_cast<int>(sizeof(OverflowPageHeader));
+
+RC OverflowReader::open(DiskBufferPool &buffer_pool, const OverflowRef &ref)
+{
+  if (ref.length < 0 || (ref.length > 0 && ref.first_page == BP_INVALID_PAGE_NUM)) {
+    LOG_WARN("invalid overflow reference. first page=%d, length=%d", ref.first_page, ref.length);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  buffer_pool_ = &buffer_pool;
+  page_num_    = ref.first_page;
+  page_offset_ = 0;
+  length_      = ref.length;
+  remain_      = ref.length;
+  return RC::SUCCESS;
+}
+
+RC OverflowReader::read(char *buf, int size, int &read_len)
+{
+  read_len = 0;
+  while (remain_ > 0 && read_len < size) {
+    if (page_num_ == BP_INVALID_PAGE_NUM) {
+      LOG_WARN("overflow page list is shorter than the value. length=%d, remain=%d", length_, remain_);
+      return RC::RECORD_INVALID_KEY;
+    }
+
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool_->get_this_page(page_num_, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page num=%d, rc=%s", page_num_, strrc(rc));
+      return rc;
+    }
+
+    frame->read_latch();
+    const OverflowPageHeader *header   = reinterpret_cast<const OverflowPageHeader *>(frame->data());
+    const int                 data_len = header->data_len;
+    const PageNum             next     = header->next_page;
+    if (data_len < 0 || data_len > buffer_pool_->page_data_size() - OVERFLOW_PAGE_HEADER_SIZE ||
+        page_offset_ > data_len) {
+      frame->read_unlatch();
+      buffer_pool_->unpin_page(frame);
+      LOG_WARN("invalid overflow page. page num=%d, data len=%d", page_num_, data_len);
+      return RC::RECORD_INVALID_KEY;
+    }
+
+    const int copy_len = min({data_len - page_offset_, size - read_len, remain_});
+    memcpy(buf + read_len, frame->data() + OVERFLOW_PAGE_HEADER_SIZE + page_offset_, copy_len);
+    frame->read_unlatch();
+    buffer_pool_->unpin_page(frame);
+
+    read_len += copy_len;
+    remain_ -= copy_len;
+    page_offset_ += copy_len;
+    if (page_offset_ >= data_len) {
+      page_num_    = next;
+      page_offset_ = 0;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC OverflowFileHandler::init(DiskBufferPool *buffer_pool)
+{
+  if (buffer_pool == nullptr) {
+    return RC::INVALID_ARGUMENT;
+  }
+  buffer_pool_ = buffer_pool;
+  return RC::SUCCESS;
+}
+
+void OverflowFileHandler::close() { buffer_pool_ = nullptr; }
+
+int OverflowFileHandler::page_capacity() const { return buffer_pool_->page_data_size() - OVERFLOW_PAGE_HEADER_SIZE; }
+
+RC OverflowFileHandler::insert(const char *data, int len, OverflowRef &ref)
+{
+  ref.first_page = BP_INVALID_PAGE_NUM;
+  ref.length     = 0;
+  if (len < 0) {
+    return RC::INVALID_ARGUMENT;
+  }
+  if (len == 0) {
+    return RC::SUCCESS;
+  }
+
+  RC         rc       = RC::SUCCESS;
+  const int  capacity = page_capacity();
+  Frame     *prev     = nullptr;
+  int        written  = 0;
+  while (written < len) {
+    Frame *frame = nullptr;
+    if (OB_FAIL(rc = buffer_pool_->allocate_page(&frame))) {
+      LOG_WARN("failed to allocate overflow page. rc=%s", strrc(rc));
+      break;
+    }
+
+    const int           data_len = min(capacity, len - written);
+    OverflowPageHeader *header   = reinterpret_cast<OverflowPageHeader *>(frame->data());
+    header->next_page            = BP_INVALID_PAGE_NUM;
+    header->data_len             = data_len;
+    memcpy(frame->data() + OVERFLOW_PAGE_HEADER_SIZE, data + written, data_len);
+    frame->mark_dirty();
+    written += data_len;
+
+    if (prev == nullptr) {
+      ref.first_page = frame->page_num();
+    } else {
+      reinterpret_cast<OverflowPageHeader *>(prev->data())->next_page = frame->page_num();
+      buffer_pool_->unpin_page(prev);
+    }
+    prev = frame;
+  }
+
+  if (prev != nullptr) {
+    buffer_pool_->unpin_page(prev);
+  }
+
+  if (OB_SUCC(rc)) {
+    rc = buffer_pool_->flush_all_pages();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to flush overflow pages. rc=%s", strrc(rc));
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    ref.length = written;
+    (void)remove(ref);
+    ref.first_page = BP_INVALID_PAGE_NUM;
+    ref.length     = 0;
+    return rc;
+  }
+
+  ref.length = len;
+  return RC::SUCCESS;
+}
+
+RC OverflowFileHandler::remove(const OverflowRef &ref)
+{
+  RC      rc       = RC::SUCCESS;
+  PageNum page_num = ref.first_page;
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    if (OB_FAIL(rc = buffer_pool_->get_this_page(page_num, &frame))) {
+      LOG_WARN("failed to get overflow page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    const PageNum next = reinterpret_cast<const OverflowPageHeader *>(frame->data())->next_page;
+    buffer_pool_->unpin_page(frame);
+
+    // 释放失败时页面留在文件中，不影响其它的数据
+    RC rc2 = buffer_pool_->dispose_page(page_num);
+    if (OB_FAIL(rc2)) {
+      LOG_WARN("failed to dispose overflow page. page num=%d, rc=%s", page_num, strrc(rc2));
+    }
+    page_num = next;
+  }
+  return rc;
+}
+
+RC OverflowFileHandler::read(const OverflowRef &ref, string &data) const
+{
+  OverflowReader reader;
+  RC             rc = reader.open(*buffer_pool_, ref);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  data.resize(ref.length);
+  int read_len = 0;
+  if (OB_FAIL(rc = reader.read(data.data(), ref.length, read_len))) {
+    return rc;
+  }
+  if (read_len != ref.length) {
+    LOG_WARN("overflow value is truncated. length=%d, read=%d", ref.length, read_len);
+    return RC::RECORD_INVALID_KEY;
+  }
+  return RC::SUCCESS;
+}
+
+RC OverflowFileHandler::open_reader(const OverflowRef &ref, OverflowReader &reader) const
+{
+  return reader.open(*buffer_pool_, ref);
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "common/rc.h"
+#include "common/types.h"
+
+class DiskBufferPool;
+
+/**
+ * @brief 大字段在记录中保存的引用
+ * @ingroup RecordManager
+ * @details TEXTS 字段的值不放在记录中，而是放在溢出页面组成的链表中，记录里只保存第一个页面和值的长度。
+ * 扫描表的时候不会访问溢出页面，只有真正读取这个字段的时候才去读取。
+ */
+struct OverflowRef
+{
+  PageNum first_page;  ///< 第一个溢出页面，空字符串没有溢出页面，是 BP_INVALID_PAGE_NUM
+  int32_t length;      ///< 值的长度
+};
+
+/**
+ * @brief 溢出页面的页头
+ * @ingroup RecordManager
+ */
+struct OverflowPageHeader
+{
+  PageNum next_page;  ///< 链表中的下一个页面，最后一个页面是 BP_INVALID_PAGE_NUM
+  int32_t data_len;   ///< 当前页面中数据的长度
+};
+
+/**
+ * @brief 顺序读取一个大字段的值
+ * @ingroup RecordManager
+ * @details 每次只访问一个溢出页面，把数据拷贝到调用者的缓存中。返回客户端时可以一段一段地发送，
+ * 不需要把整个值都放到内存中。
+ */
+class OverflowReader
+{
+public:
+  OverflowReader() = default;
+  ~OverflowReader() = default;
+
+  RC open(DiskBufferPool &buffer_pool, const OverflowRef &ref);
+
+  /**
+   * @brief 读取接下来的一段数据
+   *
+   * @param buf      数据拷贝到这里
+   * @param size     最多读取多少字节
+   * @param read_len 实际读取的字节数，读取完以后是0
+   */
+  RC read(char *buf, int size, int &read_len);
+
+  int length() const { return length_; }
+  int remain() const { return remain_; }
+
+private:
+  DiskBufferPool *buffer_pool_ = nullptr;
+  PageNum         page_num_    = -1;  ///< 当前读取的页面
+  int             page_offset_ = 0;   ///< 当前页面中已经读取的数据长度
+  int             length_      = 0;
+  int             remain_      = 0;
+};
+
+/**
+ * @brief 管理表的溢出页面文件
+ * @ingroup RecordManager
+ * @details 每个有大字段的表都有一个单独的溢出页面文件，一个值占用一个或多个页面，页面之间使用 next_page 串联起来。
+ * 溢出页面不记录日志，重做日志中只有记录中的引用，所以写入以后马上刷盘，保证引用它的记录恢复以后也能读到数据。
+ */
+class OverflowFileHandler
+{
+public:
+  OverflowFileHandler() = default;
+  ~OverflowFileHandler() = default;
+
+  RC init(DiskBufferPool *buffer_pool);
+  void close();
+
+  bool inited() const { return buffer_pool_ != nullptr; }
+
+  /**
+   * @brief 把一个值写到新分配的溢出页面中
+   *
+   * @param data 值的数据
+   * @param len  值的长度
+   * @param ref  返回值的引用，保存到记录中
+   */
+  RC insert(const char *data, int len, OverflowRef &ref);
+
+  /**
+   * @brief 释放一个值占用的所有溢出页面
+   */
+  RC remove(const OverflowRef &ref);
+
+  /**
+   * @brief 读取完整的值
+   */
+  RC read(const OverflowRef &ref, std::string &data) const;
+
+  /**
+   * @brief 打开一个流式读取器
+   */
+  RC open_reader(const OverflowRef &ref, OverflowReader &reader) const;
+
+  /**
+   * @brief 每个溢出页面可以存放多少字节的数据
+   */
+  int page_capacity() const;
+
+private:
+  DiskBufferPool *buffer_pool_ = nullptr;
+};
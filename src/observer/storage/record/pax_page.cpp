@@ -0,0 +1,236 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+
+#include "storage/record/pax_page.h"
+#include "common/lang/bitmap.h"
+
+using namespace std;
+using namespace common;
+
+static int pax_align8(int size) { return (size + 7) / 8 * 8; }
+
+/**
+ * @brief 把一列的值从小页复制到每条记录中
+ * @details 按照值的长度特化，常见的4字节和8字节的列每个值只是一次定长的读写，循环里没有 memcpy 调用
+ */
+template <int LEN>
+static void gather_column(
+    const char *minipage, const vector<SlotNum> &slots, char *records, int record_size, int offset)
+{
+  char *dst = records + offset;
+  for (SlotNum slot : slots) {
+    memcpy(dst, minipage + static_cast<int64_t>(slot) * LEN, LEN);
+    dst += record_size;
+  }
+}
+
+static void gather_column(
+    const char *minipage, int len, const vector<SlotNum> &slots, char *records, int record_size, int offset)
+{
+  switch (len) {
+    case 4: gather_column<4>(minipage, slots, records, record_size, offset); break;
+    case 8: gather_column<8>(minipage, slots, records, record_size, offset); break;
+    default: {
+      char *dst = records + offset;
+      for (SlotNum slot : slots) {
+        memcpy(dst, minipage + static_cast<int64_t>(slot) * len, len);
+        dst += record_size;
+      }
+    } break;
+  }
+}
+
+int PaxPage::layout_columns(int capacity, PaxPageColumn *columns) const
+{
+  const vector<RecordLayout::Column> &layout_columns = layout_.columns();
+  const int column_num    = static_cast<int>(layout_columns.size());
+  const int bitmap_offset = static_cast<int>(sizeof(PaxPageHeader) + sizeof(PaxPageColumn) * column_num);
+
+  int offset = pax_align8(bitmap_offset + (capacity + 7) / 8);
+  for (int i = 0; i < column_num; i++) {
+    columns[i].offset = offset;
+    columns[i].len    = layout_columns[i].len;
+    offset            = pax_align8(offset + capacity * layout_columns[i].len);
+  }
+  return offset;
+}
+
+void PaxPage::init()
+{
+  const vector<RecordLayout::Column> &columns = layout_.columns();
+  const int column_num = static_cast<int>(columns.size());
+
+  int row_len = 0;
+  for (const RecordLayout::Column &column : columns) {
+    row_len += column.len;
+  }
+
+  // 先不考虑对齐估算一个容量，再逐个减少直到放得下
+  const int fixed_size = static_cast<int>(sizeof(PaxPageHeader) + sizeof(PaxPageColumn) * column_num);
+  int       capacity   = static_cast<int>((page_data_size_ - fixed_size - 1) / (row_len + 0.125));
+  while (capacity > 0 && layout_columns(capacity, page_columns()) > page_data_size_) {
+    capacity--;
+  }
+
+  header_->record_num      = 0;
+  header_->record_capacity = capacity;
+  header_->column_num      = column_num;
+  header_->bitmap_offset   = fixed_size;
+  layout_columns(capacity, page_columns());
+  memset(bitmap(), 0, (capacity + 7) / 8);
+}
+
+void PaxPage::put(SlotNum slot, const char *record)
+{
+  const vector<RecordLayout::Column> &columns      = layout_.columns();
+  const PaxPageColumn                *page_columns = this->page_columns();
+  for (size_t i = 0; i < columns.size(); i++) {
+    memcpy(data_ + page_columns[i].offset + static_cast<int64_t>(slot) * columns[i].len,
+           record + columns[i].offset,
+           columns[i].len);
+  }
+}
+
+RC PaxPage::insert(const char *record, SlotNum &slot)
+{
+  if (is_full()) {
+    return RC::RECORD_NOMEM;
+  }
+
+  Bitmap bitmap(this->bitmap(), header_->record_capacity);
+  slot = bitmap.next_unsetted_bit(0);
+  bitmap.set_bit(slot);
+  header_->record_num++;
+  put(slot, record);
+  return RC::SUCCESS;
+}
+
+RC PaxPage::insert_at(SlotNum slot, const char *record)
+{
+  if (slot < 0 || slot >= header_->record_capacity) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  Bitmap bitmap(this->bitmap(), header_->record_capacity);
+  if (!bitmap.get_bit(slot)) {
+    bitmap.set_bit(slot);
+    header_->record_num++;
+  }
+  put(slot, record);
+  return RC::SUCCESS;
+}
+
+RC PaxPage::update(SlotNum slot, const char *record)
+{
+  if (slot < 0 || slot >= header_->record_capacity) {
+    return RC::RECORD_INVALID_RID;
+  }
+  if (!Bitmap(bitmap(), header_->record_capacity).get_bit(slot)) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  put(slot, record);
+  return RC::SUCCESS;
+}
+
+RC PaxPage::erase(SlotNum slot)
+{
+  if (slot < 0 || slot >= header_->record_capacity) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  Bitmap bitmap(this->bitmap(), header_->record_capacity);
+  if (!bitmap.get_bit(slot)) {
+    return RC::RECORD_NOT_EXIST;
+  }
+  bitmap.clear_bit(slot);
+  header_->record_num--;
+  return RC::SUCCESS;
+}
+
+RC PaxPage::get(SlotNum slot, char *record) const
+{
+  if (slot < 0 || slot >= header_->record_capacity) {
+    return RC::RECORD_INVALID_RID;
+  }
+  if (!Bitmap(bitmap(), header_->record_capacity).get_bit(slot)) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  const vector<RecordLayout::Column> &columns      = layout_.columns();
+  const PaxPageColumn                *page_columns = this->page_columns();
+  memset(record, 0, layout_.record_size());
+  for (size_t i = 0; i < columns.size(); i++) {
+    memcpy(record + columns[i].offset,
+           data_ + page_columns[i].offset + static_cast<int64_t>(slot) * columns[i].len,
+           columns[i].len);
+  }
+  return RC::SUCCESS;
+}
+
+void PaxPage::get_records(const vector<SlotNum> &slots, char *records, const vector<int> &columns) const
+{
+  const vector<RecordLayout::Column> &layout_columns = layout_.columns();
+  const PaxPageColumn                *page_columns   = this->page_columns();
+  const int                           record_size    = layout_.record_size();
+
+  memset(records, 0, slots.size() * record_size);
+  auto gather = [&](int column) {
+    gather_column(data_ + page_columns[column].offset,
+                  layout_columns[column].len,
+                  slots,
+                  records,
+                  record_size,
+                  layout_columns[column].offset);
+  };
+
+  if (columns.empty()) {
+    for (int i = 0; i < static_cast<int>(layout_columns.size()); i++) {
+      gather(i);
+    }
+  } else {
+    for (int column : columns) {
+      gather(column);
+    }
+  }
+}
+
+SlotNum PaxPage::next_slot(SlotNum start) const
+{
+  return Bitmap(bitmap(), header_->record_capacity).next_setted_bit(start);
+}
+
+RC PaxPage::checked_get(SlotNum slot, char *record) const
+{
+  const vector<RecordLayout::Column> &columns    = layout_.columns();
+  const int                           column_num = static_cast<int>(columns.size());
+  const int                           capacity   = header_->record_capacity;
+  const int64_t fixed_size = static_cast<int64_t>(sizeof(PaxPageHeader) + sizeof(PaxPageColumn) * column_num);
+  if (capacity < 0 || header_->column_num != column_num || header_->bitmap_offset != fixed_size ||
+      fixed_size + (capacity + 7) / 8 > page_data_size_) {
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  const PaxPageColumn *page_columns = this->page_columns();
+  for (int i = 0; i < column_num; i++) {
+    if (page_columns[i].len != columns[i].len || page_columns[i].offset < 0 ||
+        page_columns[i].offset + static_cast<int64_t>(capacity) * columns[i].len > page_data_size_) {
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+  }
+
+  return get(slot, record);
+}
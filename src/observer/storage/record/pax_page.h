@@ -0,0 +1,136 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "storage/record/record_layout.h"
+
+/**
+ * @brief 列分组页面的页头
+ * @ingroup RecordManager
+ */
+struct PaxPageHeader
+{
+  int32_t record_num;       ///< 当前页面记录的个数
+  int32_t record_capacity;  ///< 最大记录个数，也是每个小页能放的值的个数
+  int32_t column_num;       ///< 列的个数
+  int32_t bitmap_offset;    ///< 记录分配位图的起始位置
+};
+
+/**
+ * @brief 列分组页面上一列的小页
+ */
+struct PaxPageColumn
+{
+  int32_t offset;  ///< 小页的起始位置，8字节对齐
+  int32_t len;     ///< 每个值的长度
+};
+
+/**
+ * @brief 列分组(PAX, Partition Attributes Across)页面
+ * @ingroup RecordManager
+ * @details 页面的布局如下：
+ * | PaxPageHeader | PaxPageColumn 0 | ... | PaxPageColumn N | bitmap |
+ * | column 0 的小页: value 0 | value 1 | ... | value capacity-1 |
+ * | ...                                                        |
+ * | column N 的小页: value 0 | value 1 | ... | value capacity-1 |
+ * 与定长记录页面一样用位图管理槽位，slot num 就是记录在每个小页中的下标，所以 RID 仍然可以定位一条记录，
+ * 索引和 MVCC 不需要感知页面的格式。一条记录的各个字段分散在不同的小页中，读取时拼成内存中的格式，
+ * 修改以后要调用 update 写回。
+ * 扫描时按列复制(get_records)，每次只访问一个小页里连续的内存，而且可以只复制查询用到的列。
+ * 这个类只是页面内存上的一个视图，不负责加锁、pin 页面和标记脏页。
+ */
+class PaxPage
+{
+public:
+  PaxPage(char *data, int page_data_size, const RecordLayout &layout)
+      : data_(data),
+        page_data_size_(page_data_size),
+        header_(reinterpret_cast<PaxPageHeader *>(data)),
+        layout_(layout)
+  {}
+
+  /**
+   * @brief 按照记录的格式初始化一个空页面，计算每个小页的位置
+   */
+  void init();
+
+  int  record_num() const { return header_->record_num; }
+  int  capacity() const { return header_->record_capacity; }
+  bool is_full() const { return header_->record_num >= header_->record_capacity; }
+
+  /**
+   * @brief 插入一条记录，页面满了返回 RECORD_NOMEM
+   * @param record 内存中格式的记录
+   * @param slot   返回记录所在的槽位
+   */
+  RC insert(const char *record, SlotNum &slot);
+
+  /**
+   * @brief 在指定的槽位上放一条记录，数据库恢复时使用。槽位上已经有记录时覆盖
+   */
+  RC insert_at(SlotNum slot, const char *record);
+
+  RC update(SlotNum slot, const char *record);
+  RC erase(SlotNum slot);
+
+  /**
+   * @brief 把一条记录的所有字段复制到 record 中
+   */
+  RC get(SlotNum slot, char *record) const;
+
+  /**
+   * @brief 按列复制多条记录
+   * @details 每一列依次复制所有记录的值，没有复制的列在 records 中填0
+   *
+   * @param slots   要复制的槽位，调用者保证上面都有记录
+   * @param records 复制到这里，每条记录 record_size 个字节，依次存放
+   * @param columns 要复制的列，为空时复制所有的列
+   */
+  void get_records(const std::vector<SlotNum> &slots, char *records, const std::vector<int> &columns) const;
+
+  /**
+   * @brief 从 start 开始(包括start)，下一个有记录的槽位。没有时返回-1
+   */
+  SlotNum next_slot(SlotNum start) const;
+
+  /**
+   * @brief 乐观读的时候使用，检查页头和小页是否在页面范围内
+   * @details 页面内容可能正在被修改，不一致时返回 LOCKED_CONCURRENCY_CONFLICT。
+   * 检查通过时与 get 一样复制记录
+   */
+  RC checked_get(SlotNum slot, char *record) const;
+
+private:
+  PaxPageColumn *page_columns() const { return reinterpret_cast<PaxPageColumn *>(data_ + sizeof(PaxPageHeader)); }
+  char          *bitmap() const { return data_ + header_->bitmap_offset; }
+
+  /**
+   * @brief 计算有 capacity 个槽位时每个小页的位置，返回页面上使用到的末尾位置
+   */
+  int layout_columns(int capacity, PaxPageColumn *columns) const;
+
+  void put(SlotNum slot, const char *record);
+
+private:
+  char               *data_           = nullptr;
+  int                 page_data_size_ = 0;
+  PaxPageHeader      *header_         = nullptr;
+  const RecordLayout &layout_;
+};
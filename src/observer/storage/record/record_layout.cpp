@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <algorithm>
+
+#include "storage/record/record_layout.h"
+
+using namespace std;
+
+/// 变长字段的长度占用的字节数
+static constexpr int VAR_LEN_SIZE = sizeof(uint16_t);
+
+void RecordLayout::init(StorageFormat format, int record_size, const vector<FieldMeta> &fields)
+{
+  format_      = format;
+  record_size_ = record_size;
+  var_fields_.clear();
+  columns_.clear();
+
+  if (format == StorageFormat::PAX_FORMAT) {
+    for (const FieldMeta &field : fields) {
+      columns_.push_back(Column{field.offset(), field.len()});
+    }
+  }
+
+  if (format == StorageFormat::SLOTTED_FORMAT) {
+    for (const FieldMeta &field : fields) {
+      if (field.type() == VARCHARS) {
+        var_fields_.push_back(VarField{field.offset(), field.len()});
+      }
+    }
+    sort(var_fields_.begin(), var_fields_.end(), [](const VarField &f1, const VarField &f2) {
+      return f1.offset < f2.offset;
+    });
+  }
+
+  min_encoded_size_ = record_size;
+  max_encoded_size_ = record_size;
+  for (const VarField &field : var_fields_) {
+    min_encoded_size_ += VAR_LEN_SIZE - field.len;
+    max_encoded_size_ += VAR_LEN_SIZE;
+  }
+}
+
+int RecordLayout::encoded_size(const char *data) const
+{
+  int size = min_encoded_size_;
+  for (const VarField &field : var_fields_) {
+    size += strnlen(data + field.offset, field.len);
+  }
+  return size;
+}
+
+int RecordLayout::encode(const char *data, char *buf) const
+{
+  int data_pos = 0;
+  int buf_pos  = 0;
+  for (const VarField &field : var_fields_) {
+    const int fixed_len = field.offset - data_pos;
+    memcpy(buf + buf_pos, data + data_pos, fixed_len);
+    buf_pos += fixed_len;
+
+    const uint16_t len = static_cast<uint16_t>(strnlen(data + field.offset, field.len));
+    memcpy(buf + buf_pos, &len, VAR_LEN_SIZE);
+    buf_pos += VAR_LEN_SIZE;
+    memcpy(buf + buf_pos, data + field.offset, len);
+    buf_pos += len;
+
+    data_pos = field.offset + field.len;
+  }
+
+  memcpy(buf + buf_pos, data + data_pos, record_size_ - data_pos);
+  return buf_pos + record_size_ - data_pos;
+}
+
+RC RecordLayout::decode(const char *buf, int len, char *data) const
+{
+  int data_pos = 0;
+  int buf_pos  = 0;
+  for (const VarField &field : var_fields_) {
+    const int fixed_len = field.offset - data_pos;
+    if (buf_pos + fixed_len + VAR_LEN_SIZE > len) {
+      return RC::RECORD_INVALID_KEY;
+    }
+    memcpy(data + data_pos, buf + buf_pos, fixed_len);
+    buf_pos += fixed_len;
+
+    uint16_t var_len = 0;
+    memcpy(&var_len, buf + buf_pos, VAR_LEN_SIZE);
+    buf_pos += VAR_LEN_SIZE;
+    if (var_len > field.len || buf_pos + var_len > len) {
+      return RC::RECORD_INVALID_KEY;
+    }
+    memcpy(data + field.offset, buf + buf_pos, var_len);
+    memset(data + field.offset + var_len, 0, field.len - var_len);
+    buf_pos += var_len;
+
+    data_pos = field.offset + field.len;
+  }
+
+  if (buf_pos + record_size_ - data_pos != len) {
+    return RC::RECORD_INVALID_KEY;
+  }
+  memcpy(data + data_pos, buf + buf_pos, record_size_ - data_pos);
+  return RC::SUCCESS;
+}
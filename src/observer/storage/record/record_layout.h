@@ -0,0 +1,114 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "storage/field/field_meta.h"
+
+/**
+ * @brief 记录在内存中和页面上的格式
+ * @ingroup RecordManager
+ * @details 内存中的记录总是定长的，每个字段按照 FieldMeta 中的偏移量存放，上层直接按照偏移量访问字段。
+ * FIXED_FORMAT 的表在页面上也按照这个格式存放。
+ * SLOTTED_FORMAT 的表在页面上存放紧凑的编码：变长字段(VARCHARS)只保存实际的字符串，前面加上2个字节的长度，
+ * 不包含结尾的'\0'；其它字段原样保存。写入页面时编码，从页面上读取时再解码成内存中的格式。
+ * PAX_FORMAT 的表把每个字段当作一列，页面上同一列的值连续存放，参考 PaxPage。列的编号就是字段的编号。
+ */
+class RecordLayout
+{
+public:
+  RecordLayout() = default;
+  ~RecordLayout() = default;
+
+  /**
+   * @brief 初始化
+   *
+   * @param format      页面上的存放格式
+   * @param record_size 内存中记录的大小
+   * @param fields      所有的字段，包括系统字段
+   */
+  void init(StorageFormat format, int record_size, const std::vector<FieldMeta> &fields);
+
+  StorageFormat format() const { return format_; }
+  bool          slotted() const { return format_ == StorageFormat::SLOTTED_FORMAT; }
+  bool          pax() const { return format_ == StorageFormat::PAX_FORMAT; }
+  int           record_size() const { return record_size_; }
+
+  /**
+   * @brief PAX 页面上的一列，对应内存记录中的一个字段
+   */
+  struct Column
+  {
+    int offset;  ///< 在内存记录中的偏移量
+    int len;     ///< 长度
+  };
+
+  /**
+   * @brief PAX 页面上的列，按照字段的顺序。其它格式时为空
+   */
+  const std::vector<Column> &columns() const { return columns_; }
+
+  /**
+   * @brief 编码以后最少占用多少字节，即所有变长字段都是空字符串的时候
+   */
+  int min_encoded_size() const { return min_encoded_size_; }
+
+  /**
+   * @brief 编码以后最多占用多少字节，即所有变长字段都写满的时候
+   */
+  int max_encoded_size() const { return max_encoded_size_; }
+
+  /**
+   * @brief 内存中的一条记录编码以后的大小
+   */
+  int encoded_size(const char *data) const;
+
+  /**
+   * @brief 把内存中的一条记录编码到 buf 中
+   * @details buf 至少要有 encoded_size 这么大
+   * @return 编码以后的长度
+   */
+  int encode(const char *data, char *buf) const;
+
+  /**
+   * @brief 把页面上的记录解码成内存中的格式
+   * @details 会检查所有的长度，乐观读的时候页面内容可能被修改，编码不合法时返回 RECORD_INVALID_KEY，不会越界访问
+   *
+   * @param buf  页面上的记录
+   * @param len  页面上记录的长度
+   * @param data 解码到这里，至少要有 record_size 这么大
+   */
+  RC decode(const char *buf, int len, char *data) const;
+
+private:
+  /**
+   * @brief 变长字段在内存记录中的位置
+   */
+  struct VarField
+  {
+    int offset;
+    int len;
+  };
+
+  StorageFormat         format_           = StorageFormat::FIXED_FORMAT;
+  int                   record_size_      = 0;
+  int                   min_encoded_size_ = 0;
+  int                   max_encoded_size_ = 0;
+  std::vector<VarField> var_fields_;  ///< 按照偏移量排序
+  std::vector<Column>   columns_;
+};
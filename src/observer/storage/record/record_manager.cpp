@@ -21,6 +21,9 @@ using namespace common;
 
 static constexpr int PAGE_HEADER_SIZE = (sizeof(PageHeader));
 
+/// 乐观读复制记录时，最多重试几次，之后改成加读锁
+static constexpr int OPTIMISTIC_READ_RETRY = 4;
+
 /**
  * @brief 8字节对齐
  * 注: ceiling(a / b) = floor((a + b - 1) / b)
@@ -58,28 +61,137 @@ void RecordPageIterator::init(RecordPageHandler &record_page_handler, SlotNum st
 {
   record_page_handler_ = &record_page_handler;
   page_num_            = record_page_handler.get_page_num();
-  bitmap_.init(record_page_handler.bitmap_, record_page_handler.page_header_->record_capacity);
-  next_slot_num_ = bitmap_.next_setted_bit(start_slot_num);
+  if (!record_page_handler.slotted() && !record_page_handler.pax()) {
+    bitmap_.init(record_page_handler.bitmap_, record_page_handler.page_header_->record_capacity);
+  }
+  next_slot_num_ = next_slot(start_slot_num);
 }
 
 bool RecordPageIterator::has_next() { return -1 != next_slot_num_; }
 
+SlotNum RecordPageIterator::next_slot(SlotNum start)
+{
+  if (record_page_handler_->slotted()) {
+    return record_page_handler_->slotted_page().next_slot(start);
+  }
+  if (record_page_handler_->pax()) {
+    return record_page_handler_->pax_page().next_slot(start);
+  }
+  return bitmap_.next_setted_bit(start);
+}
+
 RC RecordPageIterator::next(Record &record)
 {
   record.set_rid(page_num_, next_slot_num_);
-  record.set_data(record_page_handler_->get_record_data(record.rid().slot_num));
+  if (next_slot_num_ < 0) {
+    return RC::RECORD_EOF;
+  }
 
-  if (next_slot_num_ >= 0) {
-    next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
+  if (record_page_handler_->slotted()) {
+    const RecordLayout *layout = record_page_handler_->layout_;
+    const char         *data   = nullptr;
+    int                 len    = 0;
+    RC                  rc     = record_page_handler_->slotted_page().get(next_slot_num_, data, len);
+    if (OB_SUCC(rc)) {
+      buffer_.resize(layout->record_size());
+      rc = layout->decode(data, len, buffer_.data());
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to decode record. page_num=%d, slot_num=%d, rc=%s", page_num_, next_slot_num_, strrc(rc));
+      return rc;
+    }
+    record.set_data(buffer_.data(), layout->record_size());
+  } else if (record_page_handler_->pax()) {
+    const RecordLayout *layout = record_page_handler_->layout_;
+    buffer_.resize(layout->record_size());
+    RC rc = record_page_handler_->pax_page().get(next_slot_num_, buffer_.data());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record. page_num=%d, slot_num=%d, rc=%s", page_num_, next_slot_num_, strrc(rc));
+      return rc;
+    }
+    record.set_data(buffer_.data(), layout->record_size());
+  } else {
+    record.set_data(record_page_handler_->get_record_data(record.rid().slot_num));
   }
-  return record.rid().slot_num != -1 ? RC::SUCCESS : RC::RECORD_EOF;
+
+  next_slot_num_ = next_slot(next_slot_num_ + 1);
+  return RC::SUCCESS;
+}
+
+RC RecordPageIterator::next_batch(std::vector<Record> &records, const std::vector<int> &columns /* = {} */)
+{
+  records.clear();
+  if (next_slot_num_ < 0) {
+    return RC::SUCCESS;
+  }
+
+  if (!record_page_handler_->slotted() && !record_page_handler_->pax()) {
+    const int record_len = record_page_handler_->page_header_->record_real_size;
+    records.reserve(record_page_handler_->page_header_->record_num);
+    for (SlotNum slot_num = next_slot_num_; slot_num >= 0; slot_num = bitmap_.next_setted_bit(slot_num + 1)) {
+      Record &record = records.emplace_back();
+      record.set_rid(page_num_, slot_num);
+      record.set_data(record_page_handler_->get_record_data(slot_num), record_len);
+    }
+    next_slot_num_ = -1;
+    return RC::SUCCESS;
+  }
+
+  if (record_page_handler_->pax()) {
+    // 先找出所有的槽位，再一列一列地复制到 buffer_ 中
+    std::vector<SlotNum> slots;
+    for (SlotNum slot_num = next_slot_num_; slot_num >= 0; slot_num = next_slot(slot_num + 1)) {
+      slots.push_back(slot_num);
+    }
+    next_slot_num_ = -1;
+
+    const int record_size = record_page_handler_->layout_->record_size();
+    buffer_.resize(slots.size() * record_size);
+    record_page_handler_->pax_page().get_records(slots, buffer_.data(), columns);
+
+    records.reserve(slots.size());
+    for (size_t i = 0; i < slots.size(); i++) {
+      Record &record = records.emplace_back();
+      record.set_rid(page_num_, slots[i]);
+      record.set_data(buffer_.data() + i * record_size, record_size);
+    }
+    return RC::SUCCESS;
+  }
+
+  // 变长记录先找出所有的槽位，再一起解码到 buffer_ 中，记录指向 buffer_ 中不同的位置
+  for (SlotNum slot_num = next_slot_num_; slot_num >= 0; slot_num = next_slot(slot_num + 1)) {
+    records.emplace_back().set_rid(page_num_, slot_num);
+  }
+  next_slot_num_ = -1;
+
+  const RecordLayout *layout      = record_page_handler_->layout_;
+  const int           record_size = layout->record_size();
+  buffer_.resize(records.size() * record_size);
+  for (size_t i = 0; i < records.size(); i++) {
+    Record     &record = records[i];
+    const char *data   = nullptr;
+    int         len    = 0;
+    char       *buffer = buffer_.data() + i * record_size;
+    RC          rc     = record_page_handler_->slotted_page().get(record.rid().slot_num, data, len);
+    if (OB_SUCC(rc)) {
+      rc = layout->decode(data, len, buffer);
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to decode record. page_num=%d, slot_num=%d, rc=%s", page_num_, record.rid().slot_num, strrc(rc));
+      records.clear();
+      return rc;
+    }
+    record.set_data(buffer, record_size);
+  }
+  return RC::SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordPageHandler::~RecordPageHandler() { cleanup(); }
 
-RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly)
+RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly,
+    BPScanRing *scan_ring /* = nullptr */, const RecordLayout *layout /* = nullptr */)
 {
   if (disk_buffer_pool_ != nullptr) {
     LOG_WARN("Disk buffer pool has been opened for page_num %d.", page_num);
@@ -87,7 +199,7 @@ RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool r
   }
 
   RC ret = RC::SUCCESS;
-  if ((ret = buffer_pool.get_this_page(page_num, &frame_)) != RC::SUCCESS) {
+  if ((ret = buffer_pool.get_this_page(page_num, &frame_, scan_ring)) != RC::SUCCESS) {
     LOG_ERROR("Failed to get page handle from disk buffer pool. ret=%d:%s", ret, strrc(ret));
     return ret;
   }
@@ -103,12 +215,42 @@ RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool r
   readonly_         = readonly;
   page_header_      = (PageHeader *)(data);
   bitmap_           = data + PAGE_HEADER_SIZE;
-  
+  layout_           = layout;
+
   LOG_TRACE("Successfully init page_num %d.", page_num);
   return ret;
 }
 
-RC RecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num)
+RC RecordPageHandler::try_init(DiskBufferPool &buffer_pool, PageNum page_num, const RecordLayout *layout /* = nullptr */)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("Disk buffer pool has been opened for page_num %d.", page_num);
+    return RC::RECORD_OPENNED;
+  }
+
+  RC ret = RC::SUCCESS;
+  if ((ret = buffer_pool.get_this_page(page_num, &frame_)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to get page handle from disk buffer pool. ret=%d:%s", ret, strrc(ret));
+    return ret;
+  }
+
+  if (!frame_->try_write_latch()) {
+    buffer_pool.unpin_page(frame_);
+    frame_ = nullptr;
+    return RC::LOCKED_NEED_WAIT;
+  }
+
+  char *data        = frame_->data();
+  disk_buffer_pool_ = &buffer_pool;
+  readonly_         = false;
+  page_header_      = (PageHeader *)(data);
+  bitmap_           = data + PAGE_HEADER_SIZE;
+  layout_           = layout;
+  return ret;
+}
+
+RC RecordPageHandler::recover_init(
+    DiskBufferPool &buffer_pool, PageNum page_num, const RecordLayout *layout /* = nullptr */)
 {
   if (disk_buffer_pool_ != nullptr) {
     LOG_WARN("Disk buffer pool has been opened for page_num %d.", page_num);
@@ -128,6 +270,7 @@ RC RecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num
   readonly_         = false;
   page_header_      = (PageHeader *)(data);
   bitmap_           = data + PAGE_HEADER_SIZE;
+  layout_           = layout;
 
   buffer_pool.recover_page(page_num);
 
@@ -135,22 +278,35 @@ RC RecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num
   return ret;
 }
 
-RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num, int record_size)
+RC RecordPageHandler::init_empty_page(
+    DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const RecordLayout *layout /* = nullptr */)
 {
-  RC ret = init(buffer_pool, page_num, false /*readonly*/);
+  RC ret = init(buffer_pool, page_num, false /*readonly*/, nullptr /*scan_ring*/, layout);
   if (ret != RC::SUCCESS) {
     LOG_ERROR("Failed to init empty page page_num:record_size %d:%d.", page_num, record_size);
     return ret;
   }
 
+  if (slotted() || pax()) {
+    if (slotted()) {
+      slotted_page().init();
+    } else {
+      pax_page().init();
+    }
+    if ((ret = buffer_pool.flush_page(*frame_)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    }
+    return ret;
+  }
+
   page_header_->record_num          = 0;
   page_header_->record_real_size    = record_size;
   page_header_->record_size         = align8(record_size);
-  page_header_->record_capacity     = page_record_capacity(BP_PAGE_DATA_SIZE, page_header_->record_size);
+  page_header_->record_capacity     = page_record_capacity(buffer_pool.page_data_size(), page_header_->record_size);
   page_header_->first_record_offset = align8(PAGE_HEADER_SIZE + page_bitmap_size(page_header_->record_capacity));
   this->fix_record_capacity();
   ASSERT(page_header_->first_record_offset + 
-         page_header_->record_capacity * page_header_->record_size <= BP_PAGE_DATA_SIZE, "Record overflow the page size");
+         page_header_->record_capacity * page_header_->record_size <= buffer_pool.page_data_size(), "Record overflow the page size");
 
   bitmap_ = frame_->data() + PAGE_HEADER_SIZE;
   memset(bitmap_, 0, page_bitmap_size(page_header_->record_capacity));
@@ -178,10 +334,49 @@ RC RecordPageHandler::cleanup()
   return RC::SUCCESS;
 }
 
+int RecordPageHandler::encode_record(const char *data)
+{
+  encode_buffer_.resize(layout_->max_encoded_size());
+  return layout_->encode(data, encode_buffer_.data());
+}
+
 RC RecordPageHandler::insert_record(const char *data, RID *rid)
 {
   ASSERT(readonly_ == false, "cannot insert record into page while the page is readonly");
 
+  if (slotted()) {
+    const int len  = encode_record(data);
+    SlotNum   slot = -1;
+    RC        rc   = slotted_page().insert(encode_buffer_.data(), len, slot);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("Page has no space for record, page_num %d, len %d. rc=%s", frame_->page_num(), len, strrc(rc));
+      return rc;
+    }
+
+    frame_->mark_dirty();
+    if (rid) {
+      rid->page_num = get_page_num();
+      rid->slot_num = slot;
+    }
+    return RC::SUCCESS;
+  }
+
+  if (pax()) {
+    SlotNum slot = -1;
+    RC      rc   = pax_page().insert(data, slot);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("Page is full, page_num %d. rc=%s", frame_->page_num(), strrc(rc));
+      return rc;
+    }
+
+    frame_->mark_dirty();
+    if (rid) {
+      rid->page_num = get_page_num();
+      rid->slot_num = slot;
+    }
+    return RC::SUCCESS;
+  }
+
   if (page_header_->record_num == page_header_->record_capacity) {
     LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
     return RC::RECORD_NOMEM;
@@ -210,6 +405,27 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid)
 
 RC RecordPageHandler::recover_insert_record(const char *data, const RID &rid)
 {
+  if (slotted()) {
+    const int len = encode_record(data);
+    RC        rc  = slotted_page().insert_at(rid.slot_num, encode_buffer_.data(), len);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to recover record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
+  if (pax()) {
+    RC rc = pax_page().insert_at(rid.slot_num, data);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to recover record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
   if (rid.slot_num >= page_header_->record_capacity) {
     LOG_WARN("slot_num illegal, slot_num(%d) > record_capacity(%d).", rid.slot_num, page_header_->record_capacity);
     return RC::RECORD_INVALID_RID;
@@ -235,6 +451,36 @@ RC RecordPageHandler::delete_record(const RID *rid)
 {
   ASSERT(readonly_ == false, "cannot delete record from page while the page is readonly");
 
+  if (slotted()) {
+    SlottedPage page = slotted_page();
+    RC          rc   = page.erase(rid->slot_num);
+    if (OB_FAIL(rc)) {
+      LOG_DEBUG("Failed to delete record. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    frame_->mark_dirty();
+    if (page.record_num() == 0) {
+      cleanup();
+    }
+    return RC::SUCCESS;
+  }
+
+  if (pax()) {
+    PaxPage page = pax_page();
+    RC      rc   = page.erase(rid->slot_num);
+    if (OB_FAIL(rc)) {
+      LOG_DEBUG("Failed to delete record. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    frame_->mark_dirty();
+    if (page.record_num() == 0) {
+      cleanup();
+    }
+    return RC::SUCCESS;
+  }
+
   if (rid->slot_num >= page_header_->record_capacity) {
     LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, page_num %d.", rid->slot_num, frame_->page_num());
     return RC::INVALID_ARGUMENT;
@@ -257,8 +503,72 @@ RC RecordPageHandler::delete_record(const RID *rid)
   }
 }
 
+RC RecordPageHandler::update_record(const RID &rid, const char *data)
+{
+  ASSERT(readonly_ == false, "cannot update record in page while the page is readonly");
+
+  RC rc = RC::SUCCESS;
+  if (slotted()) {
+    const int len = encode_record(data);
+    rc            = slotted_page().update(rid.slot_num, encode_buffer_.data(), len);
+  } else if (pax()) {
+    rc = pax_page().update(rid.slot_num, data);
+  } else if (rid.slot_num < 0 || rid.slot_num >= page_header_->record_capacity) {
+    rc = RC::RECORD_INVALID_RID;
+  } else if (!Bitmap(bitmap_, page_header_->record_capacity).get_bit(rid.slot_num)) {
+    rc = RC::RECORD_NOT_EXIST;
+  } else {
+    char *record_data = get_record_data(rid.slot_num);
+    if (record_data != data) {
+      memcpy(record_data, data, page_header_->record_real_size);
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to update record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  frame_->mark_dirty();
+  return rc;
+}
+
 RC RecordPageHandler::get_record(const RID *rid, Record *rec)
 {
+  if (slotted()) {
+    const char *data = nullptr;
+    int         len  = 0;
+    RC          rc   = slotted_page().get(rid->slot_num, data, len);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Invalid rid:%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    record_buffer_.resize(layout_->record_size());
+    rc = layout_->decode(data, len, record_buffer_.data());
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to decode record. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    rec->set_rid(*rid);
+    rec->set_data(record_buffer_.data(), layout_->record_size());
+    return RC::SUCCESS;
+  }
+
+  if (pax()) {
+    record_buffer_.resize(layout_->record_size());
+    RC rc = pax_page().get(rid->slot_num, record_buffer_.data());
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Invalid rid:%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    rec->set_rid(*rid);
+    rec->set_data(record_buffer_.data(), layout_->record_size());
+    return RC::SUCCESS;
+  }
+
   if (rid->slot_num >= page_header_->record_capacity) {
     LOG_ERROR("Invalid slot_num:%d, exceed page's record capacity, page_num %d.", rid->slot_num, frame_->page_num());
     return RC::RECORD_INVALID_RID;
@@ -275,6 +585,104 @@ RC RecordPageHandler::get_record(const RID *rid, Record *rec)
   return RC::SUCCESS;
 }
 
+RC RecordPageHandler::copy_record(
+    Frame &frame, const RID &rid, char *data, int len, const RecordLayout *layout /* = nullptr */)
+{
+  RC rc = RC::LOCKED_CONCURRENCY_CONFLICT;
+  for (int i = 0; i < OPTIMISTIC_READ_RETRY && rc == RC::LOCKED_CONCURRENCY_CONFLICT; i++) {
+    uint64_t version = 0;
+    if (!frame.optimistic_read_latch(version)) {
+      continue;
+    }
+
+    rc = copy_record_data(frame, rid, data, len, layout);
+    if (!frame.optimistic_read_validate(version)) {
+      rc = RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+  }
+
+  if (rc == RC::LOCKED_CONCURRENCY_CONFLICT) {
+    // 页面一直在被修改，加读锁再复制
+    frame.read_latch();
+    rc = copy_record_data(frame, rid, data, len, layout);
+    frame.read_unlatch();
+  }
+  return rc;
+}
+
+RC RecordPageHandler::copy_record_data(Frame &frame, const RID &rid, char *data, int len, const RecordLayout *layout)
+{
+  if (layout != nullptr && layout->slotted()) {
+    if (len > layout->record_size()) {
+      return RC::INVALID_ARGUMENT;
+    }
+
+    const SlottedPage page(frame.data(), bp_page_data_size(frame.page_size()));
+    const char       *record_data = nullptr;
+    int               record_len  = 0;
+    RC                rc          = page.checked_get(rid.slot_num, record_data, record_len);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 只复制一部分时先解码到临时内存中
+    std::vector<char> buffer;
+    char             *decode_data = data;
+    if (len < layout->record_size()) {
+      buffer.resize(layout->record_size());
+      decode_data = buffer.data();
+    }
+    if (OB_FAIL(layout->decode(record_data, record_len, decode_data))) {
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+    if (decode_data != data) {
+      memcpy(data, decode_data, len);
+    }
+    return RC::SUCCESS;
+  }
+
+  if (layout != nullptr && layout->pax()) {
+    if (len > layout->record_size()) {
+      return RC::INVALID_ARGUMENT;
+    }
+
+    std::vector<char> buffer;
+    char             *record_data = data;
+    if (len < layout->record_size()) {
+      buffer.resize(layout->record_size());
+      record_data = buffer.data();
+    }
+    const PaxPage page(frame.data(), bp_page_data_size(frame.page_size()), *layout);
+    RC            rc = page.checked_get(rid.slot_num, record_data);
+    if (OB_SUCC(rc) && record_data != data) {
+      memcpy(data, record_data, len);
+    }
+    return rc;
+  }
+
+  const char       *page_data   = frame.data();
+  const PageHeader *page_header = reinterpret_cast<const PageHeader *>(page_data);
+  const int         capacity    = page_header->record_capacity;
+  const int64_t     offset      = page_header->first_record_offset + int64_t(page_header->record_size) * rid.slot_num;
+  if (capacity < 0 || page_header->record_real_size < len || offset < 0 ||
+      offset + len > bp_page_data_size(frame.page_size()) ||
+      PAGE_HEADER_SIZE + (capacity + 7) / 8 > bp_page_data_size(frame.page_size())) {
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  if (rid.slot_num < 0 || rid.slot_num >= capacity) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  Bitmap bitmap(const_cast<char *>(page_data) + PAGE_HEADER_SIZE, capacity);
+  if (!bitmap.get_bit(rid.slot_num)) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  memcpy(data, page_data + offset, len);
+  return RC::SUCCESS;
+}
+
 PageNum RecordPageHandler::get_page_num() const
 {
   if (nullptr == page_header_) {
@@ -283,13 +691,35 @@ PageNum RecordPageHandler::get_page_num() const
   return frame_->page_num();
 }
 
-bool RecordPageHandler::is_full() const { return page_header_->record_num >= page_header_->record_capacity; }
+bool RecordPageHandler::is_full() const
+{
+  if (slotted()) {
+    return !slotted_page().can_insert(layout_->min_encoded_size());
+  }
+  if (pax()) {
+    return pax_page().is_full();
+  }
+  return page_header_->record_num >= page_header_->record_capacity;
+}
+
+bool RecordPageHandler::can_insert(const char *data) const
+{
+  if (slotted()) {
+    return slotted_page().can_insert(layout_->encoded_size(data));
+  }
+  return !is_full();
+}
+
+bool RecordPageHandler::is_free_space_map_page() const
+{
+  return FreeSpaceMap::is_map_page(*disk_buffer_pool_, frame_->page_num(), frame_->data());
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileHandler::~RecordFileHandler() { this->close(); }
 
-RC RecordFileHandler::init(DiskBufferPool *buffer_pool)
+RC RecordFileHandler::init(DiskBufferPool *buffer_pool, const RecordLayout *layout /* = nullptr */)
 {
   if (disk_buffer_pool_ != nullptr) {
     LOG_ERROR("record file handler has been openned.");
@@ -297,6 +727,7 @@ RC RecordFileHandler::init(DiskBufferPool *buffer_pool)
   }
 
   disk_buffer_pool_ = buffer_pool;
+  layout_           = layout;
 
   RC rc = init_free_pages();
 
@@ -308,83 +739,231 @@ void RecordFileHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
     free_pages_.clear();
+    for (InsertTarget &target : insert_targets_) {
+      target.page_num.store(BP_INVALID_PAGE_NUM);
+    }
+    free_space_map_.close();
+    zone_map_.close();
     disk_buffer_pool_ = nullptr;
   }
 }
 
 RC RecordFileHandler::init_free_pages()
 {
-  // 遍历当前文件上所有页面，找到没有满的页面
-  // 这个效率很低，会降低启动速度
   // NOTE: 由于是初始化时的动作，所以不需要加锁控制并发
+  RC rc = free_space_map_.init(*disk_buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init free space map. rc=%s", strrc(rc));
+    return rc;
+  }
 
+  if (!free_space_map_.enabled()) {
+    // 以前的文件没有空闲空间表，只能遍历当前文件上所有页面，找到没有满的页面
+    // 这个效率很低，会降低启动速度
+    rc = scan_free_pages(0, disk_buffer_pool_->page_count());
+    LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_pages_.size(), strrc(rc));
+    return rc;
+  }
+
+  const int pages_per_group = disk_buffer_pool_->pages_per_group();
+  const int group_num       = free_space_map_.group_num();
+  for (int group = 0; group < group_num && OB_SUCC(rc); group++) {
+    bool found = false;
+    rc         = free_space_map_.load_group(group, found, [this](PageNum page_num) { free_pages_.insert(page_num); });
+    if (OB_SUCC(rc) && !found) {
+      // 数据库恢复时创建的组可能没有空闲空间表页面，只能遍历这一组的页面
+      rc = scan_free_pages(group * pages_per_group, (group + 1) * pages_per_group);
+    }
+  }
+  LOG_INFO("record file handler load free space map done. group num=%d, free page num=%d, rc=%s",
+           group_num, free_pages_.size(), strrc(rc));
+  return rc;
+}
+
+RC RecordFileHandler::scan_free_pages(PageNum start_page, PageNum end_page)
+{
   RC rc = RC::SUCCESS;
 
   BufferPoolIterator bp_iterator;
-  bp_iterator.init(*disk_buffer_pool_);
+  bp_iterator.init(*disk_buffer_pool_, start_page);
+  bp_iterator.enable_read_ahead(disk_buffer_pool_->read_ahead_max_pages());
   RecordPageHandler record_page_handler;
   PageNum           current_page_num = 0;
 
   while (bp_iterator.has_next()) {
     current_page_num = bp_iterator.next();
+    if (current_page_num >= end_page) {
+      break;
+    }
 
-    rc = record_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/);
+    rc = record_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/, nullptr /*scan_ring*/, layout_);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, rc, strrc(rc));
       return rc;
     }
 
-    if (!record_page_handler.is_full()) {
-      free_pages_.insert(current_page_num);
-    }
+    const bool free = !record_page_handler.is_free_space_map_page() && !record_page_handler.is_full();
     record_page_handler.cleanup();
+    if (free) {
+      add_free_page(current_page_num);
+    }
+  }
+  return rc;
+}
+
+RC RecordFileHandler::allocate_record_page(Frame *&frame)
+{
+  RC rc = disk_buffer_pool_->allocate_page(&frame);
+  if (OB_SUCC(rc) && free_space_map_.is_map_page_num(frame->page_num())) {
+    // 新的页面组的第一个页面，用作这一组的空闲空间表页面
+    frame->write_latch();
+    free_space_map_.init_map_page(*frame);
+    frame->write_unlatch();
+    frame->unpin();
+    rc = disk_buffer_pool_->allocate_page(&frame);
   }
-  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_pages_.size(), strrc(rc));
   return rc;
 }
 
+void RecordFileHandler::remove_free_page(PageNum page_num)
+{
+  if (free_pages_.erase(page_num) > 0) {
+    RC rc = free_space_map_.set_free(page_num, false);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to clear free page in free space map. page num=%d, rc=%s", page_num, strrc(rc));
+    }
+  }
+}
+
+std::atomic<PageNum> &RecordFileHandler::insert_target()
+{
+  static std::atomic<int> thread_count{0};
+  static thread_local int target_index = thread_count.fetch_add(1) % INSERT_TARGET_NUM;
+  return insert_targets_[target_index].page_num;
+}
+
+bool RecordFileHandler::is_insert_target(PageNum page_num) const
+{
+  for (const InsertTarget &target : insert_targets_) {
+    if (target.page_num.load(std::memory_order_relaxed) == page_num) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RecordFileHandler::add_free_page(PageNum page_num)
+{
+  if (free_pages_.insert(page_num).second) {
+    RC rc = free_space_map_.set_free(page_num, true);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to mark free page in free space map. page num=%d, rc=%s", page_num, strrc(rc));
+    }
+  }
+}
+
 RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
 {
-  RC ret = RC::SUCCESS;
+  RecordPageHandler record_page_handler;
+  RC                ret = prepare_insert_page(data, record_size, record_page_handler);
+  if (ret != RC::SUCCESS) {
+    return ret;
+  }
+
+  // 找到空闲位置
+  ret = record_page_handler.insert_record(data, rid);
+  if (ret == RC::SUCCESS) {
+    zone_map_.insert(rid->page_num, data);
+  }
+  return ret;
+}
+
+RC RecordFileHandler::insert_records(const std::vector<const char *> &datas, int record_size, std::vector<RID> &rids)
+{
+  rids.clear();
+  rids.reserve(datas.size());
 
+  // 每次拿到一个页面以后，一直插入到这个页面放不下为止，不需要每条记录都查找一次页面
   RecordPageHandler record_page_handler;
-  bool              page_found       = false;
-  PageNum           current_page_num = 0;
+  size_t            index = 0;
+  while (index < datas.size()) {
+    RC ret = prepare_insert_page(datas[index], record_size, record_page_handler);
+    if (ret != RC::SUCCESS) {
+      return ret;
+    }
 
-  // 当前要访问free_pages对象，所以需要加锁。在非并发编译模式下，不需要考虑这个锁
-  lock_.lock();
+    do {
+      RID rid;
+      ret = record_page_handler.insert_record(datas[index], &rid);
+      if (ret != RC::SUCCESS) {
+        LOG_WARN("failed to insert record. page num=%d, inserted=%d, rc=%s",
+                 record_page_handler.get_page_num(), static_cast<int>(index), strrc(ret));
+        return ret;
+      }
+      zone_map_.insert(rid.page_num, datas[index]);
+      rids.push_back(rid);
+      index++;
+    } while (index < datas.size() && record_page_handler.can_insert(datas[index]));
+    record_page_handler.cleanup();
+  }
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::prepare_insert_page(const char *data, int record_size, RecordPageHandler &record_page_handler)
+{
+  RC ret = RC::SUCCESS;
+
+  if (layout_ != nullptr && layout_->slotted() &&
+      layout_->encoded_size(data) > SlottedPage::max_record_size(disk_buffer_pool_->page_data_size())) {
+    LOG_WARN("record is too large to fit in a page. encoded size=%d, page data size=%d",
+             layout_->encoded_size(data), disk_buffer_pool_->page_data_size());
+    return RC::RECORD_NOMEM;
+  }
 
-  // 找到没有填满的页面
-  while (!free_pages_.empty()) {
-    current_page_num = *free_pages_.begin();
+  std::atomic<PageNum> &target = insert_target();
 
-    ret = record_page_handler.init(*disk_buffer_pool_, current_page_num, false /*readonly*/);
+  // 先尝试当前线程的目标页面，不需要访问 free_pages_
+  PageNum target_page = target.load(std::memory_order_acquire);
+  if (target_page != BP_INVALID_PAGE_NUM) {
+    ret = record_page_handler.init(*disk_buffer_pool_, target_page, false /*readonly*/, nullptr /*scan_ring*/, layout_);
     if (ret != RC::SUCCESS) {
-      lock_.unlock();
-      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", target_page, ret, strrc(ret));
       return ret;
     }
 
-    if (!record_page_handler.is_full()) {
-      page_found = true;
-      break;
+    if (record_page_handler.can_insert(data)) {
+      return RC::SUCCESS;
     }
+
+    // 放不下了，把这个页面交出去。其它线程可能已经换了目标，所以使用CAS
+    const bool full = record_page_handler.is_full();
     record_page_handler.cleanup();
-    free_pages_.erase(free_pages_.begin());
+    target.compare_exchange_strong(target_page, BP_INVALID_PAGE_NUM, std::memory_order_acq_rel);
+    if (full) {
+      lock_.lock();
+      remove_free_page(target_page);
+      lock_.unlock();
+    }
+  }
+
+  // 从 free_pages_ 中找一个新的目标页面
+  bool page_found = false;
+  ret             = find_insert_page(data, record_page_handler, page_found);
+  if (ret != RC::SUCCESS) {
+    return ret;
   }
-  lock_.unlock();  // 如果找到了一个有效的页面，那么此时已经拿到了页面的写锁
 
   // 找不到就分配一个新的页面
   if (!page_found) {
     Frame *frame = nullptr;
-    if ((ret = disk_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
+    if ((ret = allocate_record_page(frame)) != RC::SUCCESS) {
       LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
       return ret;
     }
 
-    current_page_num = frame->page_num();
+    const PageNum page_num = frame->page_num();
 
-    ret = record_page_handler.init_empty_page(*disk_buffer_pool_, current_page_num, record_size);
+    ret = record_page_handler.init_empty_page(*disk_buffer_pool_, page_num, record_size, layout_);
     if (ret != RC::SUCCESS) {
       frame->unpin();
       LOG_ERROR("Failed to init empty page. ret:%d", ret);
@@ -394,18 +973,70 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
 
     // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
     frame->unpin();
+    zone_map_.init_page(page_num);
 
     // 这里的加锁顺序看起来与上面是相反的，但是不会出现死锁
     // 上面的逻辑是先加lock锁，然后加页面写锁，这里是先加上
     // 了页面写锁，然后加lock的锁，但是不会引起死锁。
     // 为什么？
     lock_.lock();
-    free_pages_.insert(current_page_num);
+    add_free_page(page_num);
     lock_.unlock();
   }
 
-  // 找到空闲位置
-  return record_page_handler.insert_record(data, rid);
+  target.store(record_page_handler.get_page_num(), std::memory_order_release);
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::find_insert_page(const char *data, RecordPageHandler &record_page_handler, bool &found)
+{
+  found = false;
+
+  // 当前要访问free_pages对象，所以需要加锁。在非并发编译模式下，不需要考虑这个锁
+  lock_.lock();
+
+  // 找到能放下这条记录的页面。变长记录页面可能还有空间，只是放不下这条比较长的记录，这种页面继续留在 free_pages_ 中。
+  // 其它线程正在插入的页面也跳过，都找不到时宁可分配一个新的页面
+  auto iter = free_pages_.begin();
+  while (iter != free_pages_.end()) {
+    const PageNum current_page_num = *iter;
+
+    RC ret = RC::SUCCESS;
+    if (is_insert_target(current_page_num)) {
+      ret = record_page_handler.try_init(*disk_buffer_pool_, current_page_num, layout_);
+      if (ret == RC::LOCKED_NEED_WAIT) {
+        ++iter;
+        continue;
+      }
+    } else {
+      ret = record_page_handler.init(
+          *disk_buffer_pool_, current_page_num, false /*readonly*/, nullptr /*scan_ring*/, layout_);
+    }
+    if (ret != RC::SUCCESS) {
+      lock_.unlock();
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
+      return ret;
+    }
+
+    if (record_page_handler.can_insert(data)) {
+      found = true;
+      break;
+    }
+
+    const bool full = record_page_handler.is_full();
+    record_page_handler.cleanup();
+    if (full) {
+      iter = free_pages_.erase(iter);
+      RC rc = free_space_map_.set_free(current_page_num, false);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to clear free page in free space map. page num=%d, rc=%s", current_page_num, strrc(rc));
+      }
+    } else {
+      ++iter;
+    }
+  }
+  lock_.unlock();  // 如果找到了一个有效的页面，那么此时已经拿到了页面的写锁
+  return RC::SUCCESS;
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
@@ -414,13 +1045,23 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
 
   RecordPageHandler record_page_handler;
 
-  ret = record_page_handler.recover_init(*disk_buffer_pool_, rid.page_num);
+  ret = record_page_handler.recover_init(*disk_buffer_pool_, rid.page_num, layout_);
   if (ret != RC::SUCCESS) {
     LOG_WARN("failed to init record page handler. page num=%d, rc=%s", rid.page_num, strrc(ret));
     return ret;
   }
 
-  return record_page_handler.recover_insert_record(data, rid);
+  ret = record_page_handler.recover_insert_record(data, rid);
+  if (OB_SUCC(ret)) {
+    zone_map_.insert(rid.page_num, data);
+  }
+  if (OB_SUCC(ret) && !record_page_handler.is_full()) {
+    // 恢复时可能重新创建了页面，这种页面不在 free_pages_ 中
+    lock_.lock();
+    add_free_page(rid.page_num);
+    lock_.unlock();
+  }
+  return ret;
 }
 
 RC RecordFileHandler::delete_record(const RID *rid)
@@ -428,11 +1069,21 @@ RC RecordFileHandler::delete_record(const RID *rid)
   RC rc = RC::SUCCESS;
 
   RecordPageHandler page_handler;
-  if ((rc = page_handler.init(*disk_buffer_pool_, rid->page_num, false /*readonly*/)) != RC::SUCCESS) {
+  if ((rc = page_handler.init(*disk_buffer_pool_, rid->page_num, false /*readonly*/, nullptr /*scan_ring*/, layout_)) !=
+      RC::SUCCESS) {
     LOG_ERROR("Failed to init record page handler.page number=%d. rc=%s", rid->page_num, strrc(rc));
     return rc;
   }
 
+  if (zone_map_.enabled()) {
+    Record record;
+    if (OB_SUCC(rc = page_handler.get_record(rid, &record))) {
+      zone_map_.remove(rid->page_num, record.data());
+    } else {
+      return rc;
+    }
+  }
+
   rc = page_handler.delete_record(rid);
   // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
   // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放record manager锁
@@ -442,7 +1093,7 @@ RC RecordFileHandler::delete_record(const RID *rid)
     // 因为这里已经释放了页面锁，并发时，其它线程可能又把该页面填满了，那就不应该再放入 free_pages_
     // 中。但是这里可以不关心，因为在查找空闲页面时，会自动过滤掉已经满的页面
     lock_.lock();
-    free_pages_.insert(rid->page_num);
+    add_free_page(rid->page_num);
     LOG_TRACE("add free page %d to free page list", rid->page_num);
     lock_.unlock();
   }
@@ -456,7 +1107,7 @@ RC RecordFileHandler::get_record(RecordPageHandler &page_handler, const RID *rid
     return RC::INVALID_ARGUMENT;
   }
 
-  RC ret = page_handler.init(*disk_buffer_pool_, rid->page_num, readonly);
+  RC ret = page_handler.init(*disk_buffer_pool_, rid->page_num, readonly, nullptr /*scan_ring*/, layout_);
   if (OB_FAIL(ret)) {
     LOG_ERROR("Failed to init record page handler.page number=%d", rid->page_num);
     return ret;
@@ -469,7 +1120,7 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
 {
   RecordPageHandler page_handler;
 
-  RC rc = page_handler.init(*disk_buffer_pool_, rid.page_num, readonly);
+  RC rc = page_handler.init(*disk_buffer_pool_, rid.page_num, readonly, nullptr /*scan_ring*/, layout_);
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to init record page handler.page number=%d", rid.page_num);
     return rc;
@@ -483,6 +1134,31 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
   }
 
   visitor(record);
+
+  // 变长记录和列分组页面上访问的是复制出来的记录，修改以后要写回页面
+  if (!readonly && (page_handler.slotted() || page_handler.pax())) {
+    rc = page_handler.update_record(rid, record.data());
+  }
+  if (!readonly && OB_SUCC(rc)) {
+    zone_map_.insert(rid.page_num, record.data());
+  }
+  return rc;
+}
+
+RC RecordFileHandler::copy_record(const RID &rid, char *data, int len)
+{
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->get_this_page(rid.page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to get page. page number=%d, rc=%s", rid.page_num, strrc(rc));
+    return rc;
+  }
+
+  rc = RecordPageHandler::copy_record(*frame, rid, data, len, layout_);
+  disk_buffer_pool_->unpin_page(frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+  }
   return rc;
 }
 
@@ -490,8 +1166,9 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
 
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
-RC RecordFileScanner::open_scan(
-    Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter)
+RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly,
+    ConditionFilter *condition_filter, const RecordLayout *layout /* = nullptr */, ZoneMap *zone_map /* = nullptr */,
+    std::vector<ZoneMapCondition> zone_map_conditions /* = {} */, std::vector<int> columns /* = {} */)
 {
   close_scan();
 
@@ -499,6 +1176,10 @@ RC RecordFileScanner::open_scan(
   disk_buffer_pool_ = &buffer_pool;
   trx_              = trx;
   readonly_         = readonly;
+  layout_           = layout;
+  zone_map_         = (zone_map != nullptr && zone_map->enabled()) ? zone_map : nullptr;
+  zone_map_conditions_.swap(zone_map_conditions);
+  columns_.swap(columns);
 
   RC rc = bp_iterator_.init(buffer_pool);
   if (rc != RC::SUCCESS) {
@@ -507,7 +1188,16 @@ RC RecordFileScanner::open_scan(
   }
   condition_filter_ = condition_filter;
 
-  rc = fetch_next_record();
+  int read_ahead_max_pages = buffer_pool.read_ahead_max_pages();
+  if (buffer_pool.scan_ring_size() > 0) {
+    scan_ring_ = std::make_unique<BPScanRing>(buffer_pool.scan_ring_size());
+    // 预读的页面也放在扫描环中，窗口不能超过环的大小，否则还没有访问到就被回收了
+    read_ahead_max_pages = std::min(read_ahead_max_pages, buffer_pool.scan_ring_size());
+  }
+  bp_iterator_.enable_read_ahead(read_ahead_max_pages, scan_ring_.get());
+
+  fetch_rc_ = fetch_next_page();
+  rc        = fetch_rc_;
   if (rc == RC::RECORD_EOF) {
     rc = RC::SUCCESS;
   }
@@ -515,87 +1205,95 @@ RC RecordFileScanner::open_scan(
 }
 
 /**
- * @brief 从当前位置开始找到下一条有效的记录
+ * @brief 从下一个页面开始，找到有可见记录的页面
  *
- * 如果当前页面还有记录没有访问，就遍历当前的页面。
- * 当前页面遍历完了，就遍历下一个页面，然后找到有效的记录
+ * 每个页面一次取出所有的记录，然后在一个循环中过滤，不需要每条记录都遍历一次位图和页面。
+ * 页面一直持有到这个页面的记录都返回了，再去读下一个页面
  */
-RC RecordFileScanner::fetch_next_record()
+RC RecordFileScanner::fetch_next_page()
 {
   RC rc = RC::SUCCESS;
-  if (record_page_iterator_.is_valid()) {
-    // 当前页面还是有效的，尝试看一下是否有有效记录
-    rc = fetch_next_record_in_page();
-    if (rc == RC::SUCCESS || rc != RC::RECORD_EOF) {
-      // 有有效记录：RC::SUCCESS
-      // 或者出现了错误，rc != (RC::SUCCESS or RC::RECORD_EOF)
-      // RECORD_EOF 表示当前页面已经遍历完了
-      return rc;
-    }
-  }
+  page_records_.clear();
+  page_record_index_ = 0;
 
-  // 上个页面遍历完了，或者还没有开始遍历某个页面，那么就从一个新的页面开始遍历查找
   while (bp_iterator_.has_next()) {
+    record_page_handler_.cleanup();  // 先释放上一个页面，预读时扫描环可以回收它
     PageNum page_num = bp_iterator_.next();
-    record_page_handler_.cleanup();
-    rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_);
+    if (zone_map_ != nullptr && !zone_map_->may_match(page_num, zone_map_conditions_)) {
+      pages_skipped_++;
+      continue;
+    }
+
+    rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_, scan_ring_.get(), layout_);
     if (OB_FAIL(rc)) {
       LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
       return rc;
     }
+    if (record_page_handler_.is_free_space_map_page()) {
+      continue;
+    }
 
+    // 生成区域映射的摘要需要所有的字段
+    const bool summarize = zone_map_ != nullptr && !zone_map_->summarized(page_num);
     record_page_iterator_.init(record_page_handler_);
-    rc = fetch_next_record_in_page();
-    if (rc == RC::SUCCESS || rc != RC::RECORD_EOF) {
-      // 有有效记录：RC::SUCCESS
-      // 或者出现了错误，rc != (RC::SUCCESS or RC::RECORD_EOF)
-      // RECORD_EOF 表示当前页面已经遍历完了
+    rc = record_page_iterator_.next_batch(page_records_, summarize ? std::vector<int>() : columns_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get records from page. page_num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    // 还持有页面的读锁，其它线程不会同时修改这个页面
+    if (summarize) {
+      zone_map_->summarize(page_num, page_records_);
+    }
+
+    rc = filter_page_records();
+    if (OB_FAIL(rc)) {
       return rc;
     }
+    if (!page_records_.empty()) {
+      return RC::SUCCESS;
+    }
   }
 
   // 所有的页面都遍历完了，没有数据了
-  next_record_.rid().slot_num = -1;
   record_page_handler_.cleanup();
   return RC::RECORD_EOF;
 }
 
-/**
- * @brief 遍历当前页面，尝试找到一条有效的记录
- */
-RC RecordFileScanner::fetch_next_record_in_page()
+RC RecordFileScanner::filter_page_records()
 {
-  RC rc = RC::SUCCESS;
-  while (record_page_iterator_.has_next()) {
-    rc = record_page_iterator_.next(next_record_);
-    if (rc != RC::SUCCESS) {
-      const auto page_num = record_page_handler_.get_page_num();
-      LOG_TRACE("failed to get next record from page. page_num=%d, rc=%s", page_num, strrc(rc));
-      return rc;
-    }
+  size_t visible_num = 0;
+  for (size_t i = 0; i < page_records_.size(); i++) {
+    Record &record = page_records_[i];
 
     // 如果有过滤条件，就用过滤条件过滤一下
-    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
+    if (condition_filter_ != nullptr && !condition_filter_->filter(record)) {
       continue;
     }
 
-    // 如果是某个事务上遍历数据，还要看看事务访问是否有冲突
-    if (trx_ == nullptr) {
-      return rc;
+    // 如果是某个事务上遍历数据，还要看看事务访问是否有冲突，或者需要加锁、等锁等操作，由事务自己决定
+    if (trx_ != nullptr) {
+      RC rc = trx_->visit_record(table_, record, readonly_);
+      if (rc == RC::RECORD_INVISIBLE) {
+        // 可以参考MvccTrx，表示当前记录不可见
+        // 这种模式仅在 readonly 事务下是有效的
+        continue;
+      }
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("failed to visit record. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+        page_records_.clear();
+        return rc;
+      }
     }
 
-    // 让当前事务探测一下是否访问冲突，或者需要加锁、等锁等操作，由事务自己决定
-    rc = trx_->visit_record(table_, next_record_, readonly_);
-    if (rc == RC::RECORD_INVISIBLE) {
-      // 可以参考MvccTrx，表示当前记录不可见
-      // 这种模式仅在 readonly 事务下是有效的
-      continue;
+    if (visible_num != i) {
+      page_records_[visible_num] = record;
     }
-    return rc;
+    visible_num++;
   }
-
-  next_record_.rid().slot_num = -1;
-  return RC::RECORD_EOF;
+  page_records_.resize(visible_num);
+  return RC::SUCCESS;
 }
 
 RC RecordFileScanner::close_scan()
@@ -608,20 +1306,44 @@ RC RecordFileScanner::close_scan()
     condition_filter_ = nullptr;
   }
 
+  page_records_.clear();
+  page_record_index_ = 0;
+  fetch_rc_          = RC::SUCCESS;
   record_page_handler_.cleanup();
+  scan_ring_.reset();
+  zone_map_      = nullptr;
+  pages_skipped_ = 0;
+  zone_map_conditions_.clear();
+  columns_.clear();
 
   return RC::SUCCESS;
 }
 
-bool RecordFileScanner::has_next() { return next_record_.rid().slot_num != -1; }
+bool RecordFileScanner::has_next()
+{
+  if (page_record_index_ < page_records_.size()) {
+    return true;
+  }
+  if (disk_buffer_pool_ == nullptr || fetch_rc_ == RC::RECORD_EOF) {
+    return false;
+  }
+
+  // 出错时也返回true，由 next 返回错误
+  fetch_rc_ = fetch_next_page();
+  return fetch_rc_ != RC::RECORD_EOF;
+}
 
 RC RecordFileScanner::next(Record &record)
 {
-  record = next_record_;
-
-  RC rc = fetch_next_record();
-  if (rc == RC::RECORD_EOF) {
-    rc = RC::SUCCESS;
+  if (page_record_index_ >= page_records_.size()) {
+    if (!has_next()) {
+      return RC::RECORD_EOF;
+    }
+    if (OB_FAIL(fetch_rc_)) {
+      return fetch_rc_;
+    }
   }
-  return rc;
+
+  record = page_records_[page_record_index_++];
+  return RC::SUCCESS;
 }
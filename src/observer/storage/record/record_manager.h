@@ -14,11 +14,20 @@ See the Mulan PSL v2 for more details. */
 //
 #pragma once
 
+#include <atomic>
 #include <sstream>
 #include <limits>
+#include <memory>
+#include <unordered_set>
+#include <vector>
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/trx/latch_memo.h"
 #include "storage/record/record.h"
+#include "storage/record/record_layout.h"
+#include "storage/record/slotted_page.h"
+#include "storage/record/pax_page.h"
+#include "storage/record/free_space_map.h"
+#include "storage/record/zone_map.h"
 #include "common/lang/bitmap.h"
 
 class ConditionFilter;
@@ -45,12 +54,18 @@ class Table;
  * 问题2：如何更有效地存放不定长数据呢？
  * 问题3：如果一个页面不能存放一个记录，那么怎么组织记录存放效果更好呢？
  *
+ * 有变长字段的表使用另一种页面格式(StorageFormat::SLOTTED_FORMAT)，参考 SlottedPage 和 RecordLayout。
+ * 页面上有一个槽位目录，slot num 是槽位的编号，槽位中记录了记录在页面中的偏移量和长度。
+ * 表使用哪种格式记录在表的元数据中，操作页面时通过 RecordLayout 告诉 RecordPageHandler。
+ * 建表时也可以指定列分组格式(StorageFormat::PAX_FORMAT)，页面内按列存放，参考 PaxPage。
+ *
  * 按照上面的描述，这里提供了几个类，分别是：
  * - RecordFileHandler：管理整个文件/表的记录增删改查
  * - RecordPageHandler：管理单个页面上记录的增删改查
  * - RecordFileScanner：可以用来遍历整个文件上的所有记录
  * - RecordPageIterator：可以用来遍历指定页面上的所有记录
  * - PageHeader：每个页面上都会记录的页面头信息
+ * - RecordLayout：记录在内存和页面上的格式
  */
 
 /**
@@ -99,16 +114,35 @@ public:
    */
   RC   next(Record &record);
 
+  /**
+   * @brief 读取当前位置以及之后页面上所有的记录
+   * @details 定长记录页面的位图每次查找64位，返回的记录直接指向页面中的数据，页面释放之前一直有效。
+   * 变长记录解码到迭代器的内存中，下一次调用 next 或 next_batch 之前有效。
+   * 列分组页面按列复制到迭代器的内存中，也是下一次调用之前有效。读取以后迭代器就到了页面的末尾。
+   *
+   * @param records 返回的记录，原来的内容会被清掉
+   * @param columns 列分组页面上只复制这些列(字段编号)，其它字段填0。为空时复制所有的列，其它格式的页面忽略这个参数
+   */
+  RC   next_batch(std::vector<Record> &records, const std::vector<int> &columns = {});
+
   /**
    * 该迭代器是否有效
    */
   bool is_valid() const { return record_page_handler_ != nullptr; }
 
+private:
+  /**
+   * @brief 找到 start 以及之后的下一个有记录的槽位
+   */
+  SlotNum next_slot(SlotNum start);
+
 private:
   RecordPageHandler *record_page_handler_ = nullptr;
   PageNum            page_num_            = BP_INVALID_PAGE_NUM;
   common::Bitmap     bitmap_;             ///< bitmap 的相关信息可以参考 RecordPageHandler 的说明
   SlotNum            next_slot_num_ = 0;  ///< 当前遍历到了哪一个slot
+
+  std::vector<char> buffer_;  ///< 变长记录和列分组页面上的记录复制到这里，下一次调用 next 或 next_batch 时会被覆盖
 };
 
 /**
@@ -120,6 +154,8 @@ private:
  * |------------|------------------------|
  * | record1 | record2 | ..... | recordN |
  * @endcode
+ * 变长记录页面的组织参考 SlottedPage。变长记录页面上存放的是编码以后的记录，读取的时候解码到
+ * RecordPageHandler 自己的内存中，返回的记录不再指向页面。列分组页面(参考 PaxPage)也是这样。
  */
 class RecordPageHandler
 {
@@ -133,16 +169,25 @@ public:
    * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
    * @param page_num    当前处理哪个页面
    * @param readonly    是否只读。在访问页面时，需要对页面加锁
+   * @param scan_ring   顺序扫描时使用的私有页帧环，参考 BPScanRing
+   * @param layout      记录的格式，为空时是定长记录页面
    */
-  RC init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly);
+  RC init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly, BPScanRing *scan_ring = nullptr,
+      const RecordLayout *layout = nullptr);
+
+  /**
+   * @brief 以写模式初始化，页面的写锁被其它线程拿着时不等待，返回 RC::LOCKED_NEED_WAIT
+   */
+  RC try_init(DiskBufferPool &buffer_pool, PageNum page_num, const RecordLayout *layout = nullptr);
 
   /**
    * @brief 数据库恢复时，与普通的运行场景有所不同，不做任何并发操作，也不需要加锁
    * 
    * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
    * @param page_num    操作的页面编号
+   * @param layout      记录的格式，为空时是定长记录页面
    */
-  RC recover_init(DiskBufferPool &buffer_pool, PageNum page_num);
+  RC recover_init(DiskBufferPool &buffer_pool, PageNum page_num, const RecordLayout *layout = nullptr);
 
   /**
    * @brief 对一个新的页面做初始化，初始化关于该页面记录信息的页头PageHeader
@@ -150,8 +195,10 @@ public:
    * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
    * @param page_num    当前处理哪个页面
    * @param record_size 每个记录的大小
+   * @param layout      记录的格式，为空时是定长记录页面。变长记录页面不使用 record_size
    */
-  RC init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num, int record_size);
+  RC init_empty_page(
+      DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const RecordLayout *layout = nullptr);
 
   /**
    * @brief 操作结束后做的清理工作，比如释放页面、解锁
@@ -163,6 +210,7 @@ public:
    *
    * @param data 要插入的记录
    * @param rid  如果插入成功，通过这个参数返回插入的位置
+   * @return 页面放不下这条记录时返回 RECORD_NOMEM
    */
   RC insert_record(const char *data, RID *rid);
 
@@ -181,14 +229,38 @@ public:
    */
   RC delete_record(const RID *rid);
 
+  /**
+   * @brief 用新的数据覆盖指定的记录
+   * @details 定长记录页面上 get_record 返回的就是页面内存，可以直接修改，变长记录页面需要调用这个接口
+   * 把修改以后的记录写回页面。记录的长度变长而页面放不下时返回 RECORD_NOMEM，RID 不会改变
+   *
+   * @param rid  要修改的记录
+   * @param data 新的记录，内存中的格式
+   */
+  RC update_record(const RID &rid, const char *data);
+
   /**
    * @brief 获取指定位置的记录数据
    *
    * @param rid 指定的位置
-   * @param rec 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护
+   * @param rec 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护。
+   *            变长记录页面上返回的是解码以后的数据，放在 RecordPageHandler 中，修改以后要调用 update_record
    */
   RC get_record(const RID *rid, Record *rec);
 
+  /**
+   * @brief 把指定位置的记录复制到调用者提供的内存中
+   * @details 使用乐观读，不给页面加锁。页面频繁修改导致多次校验失败时，再加读锁复制。
+   * 调用者需要已经pin住页面
+   *
+   * @param frame 记录所在的页帧
+   * @param rid   记录的位置
+   * @param data  复制到这里
+   * @param len   需要复制的长度，不能超过记录的实际大小
+   * @param layout 记录的格式，为空时是定长记录页面
+   */
+  static RC copy_record(Frame &frame, const RID &rid, char *data, int len, const RecordLayout *layout = nullptr);
+
   /**
    * @brief 返回该记录页的页号
    */
@@ -196,9 +268,30 @@ public:
 
   /**
    * @brief 当前页面是否已经没有空闲位置插入新的记录
+   * @details 变长记录页面上按照最短的记录计算
    */
   bool is_full() const;
 
+  /**
+   * @brief 当前页面能否放下这条记录
+   */
+  bool can_insert(const char *data) const;
+
+  /**
+   * @brief 是否是变长记录页面
+   */
+  bool slotted() const { return layout_ != nullptr && layout_->slotted(); }
+
+  /**
+   * @brief 是否是列分组页面
+   */
+  bool pax() const { return layout_ != nullptr && layout_->pax(); }
+
+  /**
+   * @brief 当前页面是不是数据文件的空闲空间表页面，遍历数据文件时要跳过这种页面
+   */
+  bool is_free_space_map_page() const;
+
 protected:
   /**
    * @details 
@@ -209,12 +302,34 @@ protected:
   void fix_record_capacity() {
     int32_t last_record_offset = page_header_->first_record_offset + 
                                  page_header_->record_capacity * page_header_->record_size;
-    while(last_record_offset > BP_PAGE_DATA_SIZE) {
+    while(last_record_offset > disk_buffer_pool_->page_data_size()) {
       page_header_->record_capacity -= 1;
       last_record_offset -= page_header_->record_size;
     }
   }
 
+  /**
+   * @brief copy_record 使用，复制一次记录
+   * @details 乐观读的时候页面内容可能被修改，访问之前要检查所有的边界。
+   * 页面内容不一致时返回 LOCKED_CONCURRENCY_CONFLICT
+   */
+  static RC copy_record_data(Frame &frame, const RID &rid, char *data, int len, const RecordLayout *layout);
+
+  /**
+   * @brief 变长记录页面
+   */
+  SlottedPage slotted_page() const { return SlottedPage(frame_->data(), disk_buffer_pool_->page_data_size()); }
+
+  /**
+   * @brief 列分组页面
+   */
+  PaxPage pax_page() const { return PaxPage(frame_->data(), disk_buffer_pool_->page_data_size(), *layout_); }
+
+  /**
+   * @brief 把内存中的记录编码到 encode_buffer_ 中，返回编码以后的长度
+   */
+  int encode_record(const char *data);
+
   /**
    * @brief 获取指定槽位的记录数据
    * 
@@ -226,11 +341,15 @@ protected:
   }
 
 protected:
-  DiskBufferPool *disk_buffer_pool_ = nullptr;  ///< 当前操作的buffer pool(文件)
-  Frame          *frame_            = nullptr;  ///< 当前操作页面关联的frame(frame的更多概念可以参考buffer pool和frame)
-  bool            readonly_         = false;    ///< 当前的操作是否都是只读的
-  PageHeader     *page_header_      = nullptr;  ///< 当前页面上页面头
-  char           *bitmap_           = nullptr;  ///< 当前页面上record分配状态信息bitmap内存起始位置
+  DiskBufferPool     *disk_buffer_pool_ = nullptr;  ///< 当前操作的buffer pool(文件)
+  Frame              *frame_            = nullptr;  ///< 当前操作页面关联的frame(frame的更多概念可以参考buffer pool和frame)
+  bool                readonly_         = false;    ///< 当前的操作是否都是只读的
+  PageHeader         *page_header_      = nullptr;  ///< 当前页面上页面头
+  char               *bitmap_           = nullptr;  ///< 当前页面上record分配状态信息bitmap内存起始位置
+  const RecordLayout *layout_           = nullptr;  ///< 记录的格式，为空时是定长记录页面
+
+  std::vector<char> encode_buffer_;  ///< 变长记录页面上，写入之前编码记录
+  std::vector<char> record_buffer_;  ///< 变长记录页面上，get_record 解码出来的记录
 
 private:
   friend class RecordPageIterator;
@@ -251,8 +370,9 @@ public:
    * @brief 初始化
    *
    * @param buffer_pool 当前操作的是哪个文件
+   * @param layout      记录的格式，为空时使用定长记录页面。需要在 RecordFileHandler 关闭之前一直有效
    */
-  RC init(DiskBufferPool *buffer_pool);
+  RC init(DiskBufferPool *buffer_pool, const RecordLayout *layout = nullptr);
 
   /**
    * @brief 关闭，做一些资源清理的工作
@@ -268,6 +388,8 @@ public:
 
   /**
    * @brief 插入一个新的记录到指定文件中，并返回该记录的标识符
+   * @details 每个线程优先插入到自己的目标页面中，这个页面满了才从 free_pages_ 中取一个其它线程没有正在插入的页面，
+   * 多个线程同时插入时不会都去竞争同一个页面的写锁。
    * 
    * @param data        纪录内容
    * @param record_size 记录大小
@@ -275,6 +397,17 @@ public:
    */
   RC insert_record(const char *data, int record_size, RID *rid);
 
+  /**
+   * @brief 批量插入记录
+   * @details 拿到一个页面以后一直插入到放不下为止，再去找下一个页面，不需要每条记录都查找一次空闲页面。
+   * 失败时已经插入的记录不会删除，它们的位置在 rids 中返回
+   *
+   * @param datas       每条记录的内容
+   * @param record_size 记录大小
+   * @param rids        返回插入的记录的标识符，与 datas 一一对应
+   */
+  RC insert_records(const std::vector<const char *> &datas, int record_size, std::vector<RID> &rids);
+
    /**
    * @brief 数据库恢复时，在指定文件指定位置插入数据
    * 
@@ -305,15 +438,93 @@ public:
    */
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
 
+  /**
+   * @brief 把记录复制出来，参考 RecordPageHandler::copy_record
+   *
+   * @param rid  想要获取的记录ID
+   * @param data 复制到这里
+   * @param len  需要复制的长度
+   */
+  RC copy_record(const RID &rid, char *data, int len);
+
+  const RecordLayout *layout() const { return layout_; }
+
+  /**
+   * @brief 数据文件的区域映射，初始化以后默认不维护任何字段
+   */
+  ZoneMap &zone_map() { return zone_map_; }
+
 private:
   /**
    * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
+   * @details 有空闲空间表的文件只读取空闲空间表页面，以前的文件遍历所有的页面
    */
   RC init_free_pages();
 
+  /**
+   * @brief 遍历 [start_page, end_page) 范围内的记录页面，找到没有满的页面
+   */
+  RC scan_free_pages(PageNum start_page, PageNum end_page);
+
+  /**
+   * @brief 分配一个新的记录页面
+   * @details 分配到空闲空间表页面的位置时，把它初始化成空闲空间表页面，再分配一个
+   */
+  RC allocate_record_page(Frame *&frame);
+
+  /**
+   * @brief 页面加入 free_pages_，同时记录到空闲空间表中。调用者需要持有 lock_
+   */
+  void add_free_page(PageNum page_num);
+
+  /**
+   * @brief 页面满了，从 free_pages_ 和空闲空间表中去掉。调用者需要持有 lock_
+   */
+  void remove_free_page(PageNum page_num);
+
+  /**
+   * @brief 找到一个能放下这条记录的页面，返回时已经加上了页面写锁
+   * @details 优先使用当前线程的目标页面，然后从 free_pages_ 中查找，最后分配一个新的页面
+   */
+  RC prepare_insert_page(const char *data, int record_size, RecordPageHandler &record_page_handler);
+
+  /**
+   * @brief 从 free_pages_ 中找一个能放下这条记录、并且没有被其它线程插入的页面，找到时已经加上了页面写锁
+   */
+  RC find_insert_page(const char *data, RecordPageHandler &record_page_handler, bool &found);
+
+  /**
+   * @brief 页面是不是某个线程的插入目标页面
+   * @details 其它线程的目标页面只在拿得到写锁的时候使用，正在被其它线程插入的页面就跳过。
+   * 不支持并发的编译模式下只在其它线程正在写页面时拿不到锁，多个线程基本上还是插入到同一个页面中
+   */
+  bool is_insert_target(PageNum page_num) const;
+
+  /**
+   * @brief 当前线程的插入目标页面
+   */
+  std::atomic<PageNum> &insert_target();
+
+private:
+  /// 插入目标页面的个数，线程按照创建顺序分配到这些目标上
+  static constexpr int INSERT_TARGET_NUM = 16;
+
+  /**
+   * @brief 线程的插入目标页面
+   * @details 对齐到缓存行，不同线程修改自己的目标页面时互不影响
+   */
+  struct alignas(64) InsertTarget
+  {
+    std::atomic<PageNum> page_num{BP_INVALID_PAGE_NUM};
+  };
+
 private:
   DiskBufferPool             *disk_buffer_pool_ = nullptr;
+  const RecordLayout         *layout_           = nullptr;  ///< 记录的格式
   std::unordered_set<PageNum> free_pages_;  ///< 没有填充满的页面集合
+  FreeSpaceMap                free_space_map_;  ///< 持久化的 free_pages_
+  ZoneMap                     zone_map_;        ///< 每个页面上部分字段的取值范围
+  InsertTarget                insert_targets_[INSERT_TARGET_NUM];  ///< 各个线程正在插入的页面，也都在 free_pages_ 中
   common::Mutex               lock_;        ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
 };
 
@@ -336,8 +547,15 @@ public:
    * @param readonly         当前是否只读操作。访问数据时，需要对页面加锁。比如
    *                         删除时也需要遍历找到数据，然后删除，这时就需要加写锁
    * @param condition_filter 做一些初步过滤操作
+   * @param layout           记录的格式，为空时是定长记录页面
+   * @param zone_map         数据文件的区域映射，可以为空
+   * @param zone_map_conditions 下推的比较条件，按照区域映射跳过不可能满足这些条件的页面
+   * @param columns          列分组页面上只读取这些列(字段编号)，其它字段填0，为空时读取所有的列。
+   *                         系统字段总是需要的，由调用者放进来
    */
-  RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter);
+  RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter,
+      const RecordLayout *layout = nullptr, ZoneMap *zone_map = nullptr,
+      std::vector<ZoneMapCondition> zone_map_conditions = {}, std::vector<int> columns = {});
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -346,7 +564,7 @@ public:
 
   /** 
    * @brief 判断是否还有数据
-   * @details 判断完成后调用next获取下一条数据
+   * @details 判断完成后调用next获取下一条数据。当前页面的记录都返回以后才会读取下一个页面
    */
   bool has_next();
 
@@ -355,20 +573,27 @@ public:
    * 
    * @param record 返回的下一条记录
    * 
-   * @details 获取下一条记录之前先调用has_next()判断是否还有数据
+   * @details 获取下一条记录之前先调用has_next()判断是否还有数据。
+   * 返回的记录指向页面或页面迭代器的内存，在读取下一个页面之前有效
    */
   RC   next(Record &record);
 
+  /**
+   * @brief 按照区域映射跳过了多少个页面
+   */
+  int pages_skipped() const { return pages_skipped_; }
+
 private:
   /**
-   * @brief 获取该文件中的下一条记录
+   * @brief 读取下一个有可见记录的页面
+   * @details 一次取出页面上所有的记录，过滤以后放到 page_records_ 中。没有更多数据时返回 RC::RECORD_EOF
    */
-  RC fetch_next_record();
+  RC fetch_next_page();
 
   /**
-   * @brief 获取一个页面内的下一条记录
+   * @brief 过滤 page_records_ 中的记录，只留下满足条件并且当前事务可见的记录
    */
-  RC fetch_next_record_in_page();
+  RC filter_page_records();
 
 private:
   // TODO 对于一个纯粹的record遍历器来说，不应该关心表和事务
@@ -378,8 +603,16 @@ private:
   bool               readonly_         = false;    ///< 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                 ///< 遍历buffer pool的所有页面
+  std::unique_ptr<BPScanRing> scan_ring_;          ///< 扫描时使用的私有页帧环，避免把热点页面挤出内存
   ConditionFilter   *condition_filter_ = nullptr;  ///< 过滤record
+  const RecordLayout *layout_          = nullptr;  ///< 记录的格式
   RecordPageHandler  record_page_handler_;         ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;        ///< 遍历某个页面上的所有record
-  Record             next_record_;                 ///< 获取的记录放在这里缓存起来
+  std::vector<Record> page_records_;               ///< 当前页面上可以返回的记录
+  size_t             page_record_index_ = 0;       ///< 下一条要返回的记录在 page_records_ 中的位置
+  RC                 fetch_rc_          = RC::SUCCESS;  ///< 读取页面时的错误，在 next 中返回
+  ZoneMap           *zone_map_          = nullptr;      ///< 用来跳过页面的区域映射
+  std::vector<ZoneMapCondition> zone_map_conditions_;   ///< 区域映射使用的比较条件
+  int                pages_skipped_     = 0;            ///< 按照区域映射跳过的页面数
+  std::vector<int>   columns_;                          ///< 列分组页面上需要读取的列
 };
\ No newline at end of file
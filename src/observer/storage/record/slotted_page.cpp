@@ -0,0 +1,258 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "storage/record/slotted_page.h"
+
+using namespace std;
+
+static constexpr int SLOT_SIZE = static_cast<int>(sizeof(SlottedPageSlot));
+
+void SlottedPage::init()
+{
+  header_->record_num   = 0;
+  header_->slot_num     = 0;
+  header_->data_offset  = page_data_size_;
+  header_->garbage_size = 0;
+}
+
+bool SlottedPage::can_insert(int len) const
+{
+  const int slot_size = header_->record_num < header_->slot_num ? 0 : SLOT_SIZE;
+  return len > 0 && len + slot_size <= free_space();
+}
+
+RC SlottedPage::insert(const char *data, int len, SlotNum &slot)
+{
+  if (!can_insert(len)) {
+    return RC::RECORD_NOMEM;
+  }
+
+  SlotNum index = -1;
+  if (header_->record_num < header_->slot_num) {
+    SlottedPageSlot *page_slots = slots();
+    for (SlotNum i = 0; i < header_->slot_num; i++) {
+      if (page_slots[i].offset == 0) {
+        index = i;
+        break;
+      }
+    }
+  }
+
+  if (index == -1) {
+    // 新的槽位也要占用连续的空闲空间
+    if (contiguous_free_space() < SLOT_SIZE) {
+      compact();
+    }
+    index = header_->slot_num++;
+    slots()[index] = SlottedPageSlot{0, 0};
+  }
+
+  const int offset = allocate(len);
+  memcpy(data_ + offset, data, len);
+  slots()[index] = SlottedPageSlot{static_cast<uint16_t>(offset), static_cast<uint16_t>(len)};
+  header_->record_num++;
+
+  slot = index;
+  return RC::SUCCESS;
+}
+
+RC SlottedPage::insert_at(SlotNum slot, const char *data, int len)
+{
+  if (slot < 0 || len <= 0) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  if (slot < header_->slot_num && slots()[slot].offset != 0) {
+    return update(slot, data, len);
+  }
+
+  const int new_slots = max(slot + 1 - header_->slot_num, 0);
+  if (len + new_slots * SLOT_SIZE > free_space()) {
+    return RC::RECORD_NOMEM;
+  }
+
+  if (new_slots > 0) {
+    if (contiguous_free_space() < new_slots * SLOT_SIZE) {
+      compact();
+    }
+    SlottedPageSlot *page_slots = slots();
+    for (SlotNum i = header_->slot_num; i <= slot; i++) {
+      page_slots[i] = SlottedPageSlot{0, 0};
+    }
+    header_->slot_num = slot + 1;
+  }
+
+  const int offset = allocate(len);
+  memcpy(data_ + offset, data, len);
+  slots()[slot] = SlottedPageSlot{static_cast<uint16_t>(offset), static_cast<uint16_t>(len)};
+  header_->record_num++;
+  return RC::SUCCESS;
+}
+
+RC SlottedPage::update(SlotNum slot, const char *data, int len)
+{
+  const char *old_data = nullptr;
+  int         old_len  = 0;
+  RC          rc       = get(slot, old_data, old_len);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  if (len <= 0) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  SlottedPageSlot &page_slot = slots()[slot];
+  if (len <= old_len) {
+    memcpy(data_ + page_slot.offset, data, len);
+    page_slot.length = static_cast<uint16_t>(len);
+    header_->garbage_size += old_len - len;
+    return RC::SUCCESS;
+  }
+
+  // 原来的位置放不下，释放以后重新分配，整理页面时不再保留原来的数据
+  if (len > free_space() + old_len) {
+    return RC::RECORD_NOMEM;
+  }
+
+  header_->garbage_size += old_len;
+  page_slot = SlottedPageSlot{0, 0};
+
+  const int offset = allocate(len);
+  memcpy(data_ + offset, data, len);
+  slots()[slot] = SlottedPageSlot{static_cast<uint16_t>(offset), static_cast<uint16_t>(len)};
+  return RC::SUCCESS;
+}
+
+RC SlottedPage::erase(SlotNum slot)
+{
+  const char *old_data = nullptr;
+  int         old_len  = 0;
+  RC          rc       = get(slot, old_data, old_len);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  SlottedPageSlot *page_slots = slots();
+  page_slots[slot]            = SlottedPageSlot{0, 0};
+  header_->garbage_size += old_len;
+  header_->record_num--;
+
+  if (header_->record_num == 0) {
+    init();
+    return RC::SUCCESS;
+  }
+
+  // 末尾的空槽位不会被任何 RID 引用，直接还给空闲空间
+  while (header_->slot_num > 0 && page_slots[header_->slot_num - 1].offset == 0) {
+    header_->slot_num--;
+  }
+  return RC::SUCCESS;
+}
+
+RC SlottedPage::get(SlotNum slot, const char *&data, int &len) const
+{
+  if (slot < 0 || slot >= header_->slot_num) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  const SlottedPageSlot &page_slot = slots()[slot];
+  if (page_slot.offset == 0) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  data = data_ + page_slot.offset;
+  len  = page_slot.length;
+  return RC::SUCCESS;
+}
+
+RC SlottedPage::checked_get(SlotNum slot, const char *&data, int &len) const
+{
+  const int slot_num    = header_->slot_num;
+  const int data_offset = header_->data_offset;
+  if (slot_num < 0 || data_offset > page_data_size_ ||
+      static_cast<int64_t>(sizeof(SlottedPageHeader)) + int64_t(SLOT_SIZE) * slot_num > data_offset) {
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  if (slot < 0 || slot >= slot_num) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  const SlottedPageSlot page_slot = slots()[slot];
+  if (page_slot.offset == 0) {
+    return RC::RECORD_NOT_EXIST;
+  }
+  if (page_slot.offset < data_offset || page_slot.offset + page_slot.length > page_data_size_) {
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  data = data_ + page_slot.offset;
+  len  = page_slot.length;
+  return RC::SUCCESS;
+}
+
+SlotNum SlottedPage::next_slot(SlotNum start) const
+{
+  const SlottedPageSlot *page_slots = slots();
+  for (SlotNum i = max(start, 0); i < header_->slot_num; i++) {
+    if (page_slots[i].offset != 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void SlottedPage::compact()
+{
+  SlottedPageSlot *page_slots = slots();
+
+  vector<SlotNum> used_slots;
+  used_slots.reserve(header_->record_num);
+  for (SlotNum i = 0; i < header_->slot_num; i++) {
+    if (page_slots[i].offset != 0) {
+      used_slots.push_back(i);
+    }
+  }
+
+  // 从最靠近页面末尾的记录开始往后挪，目标位置总是不小于原来的位置，不会覆盖还没有挪动的记录
+  sort(used_slots.begin(), used_slots.end(), [page_slots](SlotNum s1, SlotNum s2) {
+    return page_slots[s1].offset > page_slots[s2].offset;
+  });
+
+  int offset = page_data_size_;
+  for (SlotNum slot : used_slots) {
+    SlottedPageSlot &page_slot = page_slots[slot];
+    offset -= page_slot.length;
+    if (offset != page_slot.offset) {
+      memmove(data_ + offset, data_ + page_slot.offset, page_slot.length);
+      page_slot.offset = static_cast<uint16_t>(offset);
+    }
+  }
+
+  header_->data_offset  = offset;
+  header_->garbage_size = 0;
+}
+
+int SlottedPage::allocate(int len)
+{
+  if (contiguous_free_space() < len) {
+    compact();
+  }
+  header_->data_offset -= len;
+  return header_->data_offset;
+}
@@ -0,0 +1,149 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/rc.h"
+#include "common/types.h"
+
+/**
+ * @brief 变长记录页面的页头
+ * @ingroup RecordManager
+ */
+struct SlottedPageHeader
+{
+  int32_t record_num;    ///< 当前页面记录的个数
+  int32_t slot_num;      ///< 槽位目录的长度，包括已经删除的空槽位
+  int32_t data_offset;   ///< 记录数据区的起始位置，记录从页面末尾向前存放
+  int32_t garbage_size;  ///< 删除或者缩短记录留下的空洞，整理页面时回收
+};
+
+/**
+ * @brief 变长记录页面的一个槽位
+ * @details 页面最大 64KB，偏移量和长度用2个字节就可以表示。偏移量为0表示空槽位
+ */
+struct SlottedPageSlot
+{
+  uint16_t offset;
+  uint16_t length;
+};
+
+/**
+ * @brief 变长记录页面
+ * @ingroup RecordManager
+ * @details 页面的布局如下：
+ * | SlottedPageHeader | slot 0 | slot 1 | ... | 空闲空间 | ... | record 1 | record 0 |
+ * 槽位目录从页头之后向后增长，记录从页面末尾向前增长，中间是连续的空闲空间。
+ * 槽位号就是记录ID(RID)中的 slot_num，记录在页面内移动时只修改槽位中的偏移量，RID 保持不变。
+ * 删除记录时只清空槽位，记录占用的空间记在 garbage_size 中；连续的空闲空间不够时整理页面(compact)，
+ * 把所有的记录挪到页面末尾，回收这些空洞。
+ * 这个类只是页面内存上的一个视图，不负责加锁、pin 页面和标记脏页。
+ */
+class SlottedPage
+{
+public:
+  SlottedPage(char *data, int page_data_size)
+      : data_(data), page_data_size_(page_data_size), header_(reinterpret_cast<SlottedPageHeader *>(data))
+  {}
+
+  /**
+   * @brief 初始化一个空页面
+   */
+  void init();
+
+  int record_num() const { return header_->record_num; }
+  int slot_num() const { return header_->slot_num; }
+
+  /**
+   * @brief 整理页面以后一共可以使用的空闲空间
+   */
+  int free_space() const { return contiguous_free_space() + header_->garbage_size; }
+
+  /**
+   * @brief 是否能够插入一条指定长度的记录，包括可能需要新增的槽位
+   */
+  bool can_insert(int len) const;
+
+  /**
+   * @brief 插入一条记录，优先复用空槽位
+   * @details 连续的空闲空间不够时会整理页面。空间不够时返回 RECORD_NOMEM
+   *
+   * @param data 记录的数据
+   * @param len  记录的长度
+   * @param slot 返回记录所在的槽位
+   */
+  RC insert(const char *data, int len, SlotNum &slot);
+
+  /**
+   * @brief 在指定的槽位上放一条记录，数据库恢复时使用
+   * @details 槽位目录不够长时扩展目录，槽位上已经有记录时覆盖
+   */
+  RC insert_at(SlotNum slot, const char *data, int len);
+
+  /**
+   * @brief 修改一条记录，记录长度可以变化，但是不会离开这个页面
+   */
+  RC update(SlotNum slot, const char *data, int len);
+
+  RC erase(SlotNum slot);
+
+  /**
+   * @brief 获取一条记录，返回的指针指向页面内存
+   */
+  RC get(SlotNum slot, const char *&data, int &len) const;
+
+  /**
+   * @brief 从 start 开始(包括start)，下一个有记录的槽位。没有时返回-1
+   */
+  SlotNum next_slot(SlotNum start) const;
+
+  /**
+   * @brief 整理页面，把所有的记录挪到页面末尾，回收删除记录留下的空洞
+   */
+  void compact();
+
+  /**
+   * @brief 一个空页面最多可以放多长的记录
+   */
+  static int max_record_size(int page_data_size)
+  {
+    return page_data_size - static_cast<int>(sizeof(SlottedPageHeader) + sizeof(SlottedPageSlot));
+  }
+
+  /**
+   * @brief 乐观读的时候使用，检查页头和槽位是否在页面范围内
+   * @details 页面内容可能正在被修改，不一致时返回 LOCKED_CONCURRENCY_CONFLICT。
+   * 检查通过时与 get 一样返回记录
+   */
+  RC checked_get(SlotNum slot, const char *&data, int &len) const;
+
+private:
+  SlottedPageSlot *slots() const { return reinterpret_cast<SlottedPageSlot *>(data_ + sizeof(SlottedPageHeader)); }
+
+  int slots_end() const { return static_cast<int>(sizeof(SlottedPageHeader) + sizeof(SlottedPageSlot) * header_->slot_num); }
+
+  int contiguous_free_space() const { return header_->data_offset - slots_end(); }
+
+  /**
+   * @brief 在连续的空闲空间中为记录分配位置，空间不够时先整理页面。调用者需要确认空间是足够的
+   */
+  int allocate(int len);
+
+private:
+  char              *data_           = nullptr;
+  int                page_data_size_ = 0;
+  SlottedPageHeader *header_         = nullptr;
+};
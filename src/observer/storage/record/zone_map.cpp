@@ -0,0 +1,262 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <mutex>
+
+#include "storage/record/zone_map.h"
+#include "common/log/log.h"
+#include "storage/buffer/buffer_pool_stats.h"
+#include "storage/record/record.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 维护最小值和最大值时使用的比较
+ * @details Value::compare 比较浮点数时有误差范围，用它维护的最小值可能比实际的最小值大一点，
+ * 所以浮点数按照精确的大小比较
+ */
+static int exact_compare(const Value &left, const Value &right)
+{
+  if (left.attr_type() == FLOATS && right.attr_type() == FLOATS) {
+    const float l = left.get_float();
+    const float r = right.get_float();
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  return left.compare(right);
+}
+
+/**
+ * @brief 取值范围是 [min, max] 的字段是否可能满足 "字段 comp value"
+ */
+static bool range_may_match(const Value &min, const Value &max, CompOp comp, const Value &value)
+{
+  switch (comp) {
+    case EQUAL_TO: return min.compare(value) <= 0 && max.compare(value) >= 0;
+    case LESS_THAN: return min.compare(value) < 0;
+    case LESS_EQUAL: return min.compare(value) <= 0;
+    case GREAT_THAN: return max.compare(value) > 0;
+    case GREAT_EQUAL: return max.compare(value) >= 0;
+    case NOT_EQUAL: return min.compare(value) != 0 || max.compare(value) != 0;
+    default: return true;
+  }
+}
+
+static const char *comp_op_to_string(CompOp comp)
+{
+  switch (comp) {
+    case EQUAL_TO: return "=";
+    case LESS_THAN: return "<";
+    case LESS_EQUAL: return "<=";
+    case GREAT_THAN: return ">";
+    case GREAT_EQUAL: return ">=";
+    case NOT_EQUAL: return "<>";
+    default: return "?";
+  }
+}
+
+ZoneMap::ZoneMap() = default;
+
+ZoneMap::~ZoneMap() { close(); }
+
+void ZoneMap::init(const vector<FieldMeta> &fields, const string &name)
+{
+  close();
+  fields_ = fields;
+  if (fields_.empty()) {
+    return;
+  }
+
+  metrics_.reset(new BPMetricGroup(name, "zone_map.table." + name + "."));
+  metrics_->add("pages_checked", [this]() { return std::to_string(pages_checked()); });
+  metrics_->add("pages_skipped", [this]() { return std::to_string(pages_skipped()); });
+  metrics_->add("summarized_pages", [this]() {
+    lock_guard<Mutex> guard(lock_);
+    return std::to_string(zones_.size());
+  });
+}
+
+void ZoneMap::close()
+{
+  metrics_.reset();
+  lock_guard<Mutex> guard(lock_);
+  fields_.clear();
+  zones_.clear();
+}
+
+int ZoneMap::field_index(const char *field_name) const
+{
+  for (size_t i = 0; i < fields_.size(); i++) {
+    if (0 == strcmp(fields_[i].name(), field_name)) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void ZoneMap::init_page(PageNum page_num)
+{
+  if (!enabled()) {
+    return;
+  }
+
+  lock_guard<Mutex> guard(lock_);
+  zones_[page_num] = Zone();
+}
+
+void ZoneMap::insert(PageNum page_num, const char *record)
+{
+  if (!enabled()) {
+    return;
+  }
+
+  lock_guard<Mutex> guard(lock_);
+  auto iter = zones_.find(page_num);
+  if (iter != zones_.end()) {
+    extend(iter->second, record);
+  }
+}
+
+void ZoneMap::remove(PageNum page_num, const char *record)
+{
+  if (!enabled()) {
+    return;
+  }
+
+  lock_guard<Mutex> guard(lock_);
+  auto iter = zones_.find(page_num);
+  if (iter == zones_.end()) {
+    return;
+  }
+
+  const Zone &zone = iter->second;
+  for (size_t i = 0; i < fields_.size(); i++) {
+    const Value value = field_value(static_cast<int>(i), record);
+    if (zone.empty || exact_compare(value, zone.min_values[i]) <= 0 || exact_compare(value, zone.max_values[i]) >= 0) {
+      zones_.erase(iter);
+      return;
+    }
+  }
+}
+
+bool ZoneMap::summarized(PageNum page_num) const
+{
+  lock_guard<Mutex> guard(lock_);
+  return zones_.count(page_num) != 0;
+}
+
+void ZoneMap::summarize(PageNum page_num, const vector<Record> &records)
+{
+  if (!enabled()) {
+    return;
+  }
+
+  Zone zone;
+  for (const Record &record : records) {
+    extend(zone, record.data());
+  }
+
+  lock_guard<Mutex> guard(lock_);
+  zones_.emplace(page_num, std::move(zone));
+}
+
+bool ZoneMap::may_match(PageNum page_num, const vector<ZoneMapCondition> &conditions)
+{
+  if (!enabled() || conditions.empty()) {
+    return true;
+  }
+
+  pages_checked_.fetch_add(1, memory_order_relaxed);
+
+  lock_guard<Mutex> guard(lock_);
+  auto iter = zones_.find(page_num);
+  if (iter == zones_.end() || zone_may_match(iter->second, conditions)) {
+    return true;
+  }
+
+  pages_skipped_.fetch_add(1, memory_order_relaxed);
+  return false;
+}
+
+void ZoneMap::count_skippable(const vector<ZoneMapCondition> &conditions, int &skippable, int &summarized) const
+{
+  lock_guard<Mutex> guard(lock_);
+  skippable  = 0;
+  summarized = static_cast<int>(zones_.size());
+  if (conditions.empty()) {
+    return;
+  }
+
+  for (const auto &[page_num, zone] : zones_) {
+    if (!zone_may_match(zone, conditions)) {
+      skippable++;
+    }
+  }
+}
+
+string ZoneMap::condition_to_string(const ZoneMapCondition &condition) const
+{
+  return string(fields_[condition.field_index].name()) + comp_op_to_string(condition.comp) + condition.value.to_string();
+}
+
+Value ZoneMap::field_value(int index, const char *record) const
+{
+  // 与 RowTuple::cell_at 取出来的值一样
+  const FieldMeta &field = fields_[index];
+  Value            value;
+  value.set_type(field.type());
+  value.set_data(record + field.offset(), field.len());
+  return value;
+}
+
+void ZoneMap::extend(Zone &zone, const char *record) const
+{
+  if (zone.empty) {
+    zone.empty = false;
+    zone.min_values.clear();
+    zone.max_values.clear();
+    for (size_t i = 0; i < fields_.size(); i++) {
+      const Value value = field_value(static_cast<int>(i), record);
+      zone.min_values.push_back(value);
+      zone.max_values.push_back(value);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < fields_.size(); i++) {
+    const Value value = field_value(static_cast<int>(i), record);
+    if (exact_compare(value, zone.min_values[i]) < 0) {
+      zone.min_values[i] = value;
+    }
+    if (exact_compare(value, zone.max_values[i]) > 0) {
+      zone.max_values[i] = value;
+    }
+  }
+}
+
+bool ZoneMap::zone_may_match(const Zone &zone, const vector<ZoneMapCondition> &conditions) const
+{
+  if (zone.empty) {
+    return false;
+  }
+
+  for (const ZoneMapCondition &condition : conditions) {
+    const int index = condition.field_index;
+    if (!range_may_match(zone.min_values[index], zone.max_values[index], condition.comp, condition.value)) {
+      return false;
+    }
+  }
+  return true;
+}
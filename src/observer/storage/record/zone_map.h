@@ -0,0 +1,150 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "common/lang/mutex.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/field/field_meta.h"
+
+class BPMetricGroup;
+class Record;
+
+/**
+ * @brief 使用区域映射过滤页面的条件：字段 comp 值
+ * @ingroup RecordManager
+ */
+struct ZoneMapCondition
+{
+  int    field_index = -1;     ///< 字段在 ZoneMap::fields() 中的位置
+  CompOp comp        = NO_OP;  ///< 比较运算，字段在左边
+  Value  value;                ///< 比较的常量
+};
+
+/**
+ * @brief 数据文件的区域映射，记录每个页面上若干字段的最小值和最大值
+ * @ingroup RecordManager
+ * @details 建表时指定需要维护的字段。扫描表的时候，如果一个页面上字段的取值范围不可能满足下推下来的比较条件，
+ * 就不用读取和过滤这个页面的记录。对时间戳、自增编号这类按照插入顺序增长的字段，范围查询可以跳过大部分的页面。
+ *
+ * 区域映射只保存在内存中，不记录日志，也不写到文件里。打开表以后页面还没有摘要，第一次完整地扫描这个页面时生成，
+ * 新分配的页面从空的摘要开始。插入记录时扩大范围；删除的记录正好是最小值或者最大值时丢弃这个页面的摘要，
+ * 下次扫描时再重新生成，不会因为删除而留下过宽的范围。
+ *
+ * 修改页面的时候都持有页面的写锁，生成摘要时持有页面的读锁，所以摘要不会漏掉并发插入的记录。
+ * 最小值和最大值使用精确的比较维护，判断是否可以跳过时与过滤记录一样使用 Value::compare，
+ * 保证跳过的页面上一定没有满足条件的记录。
+ */
+class ZoneMap
+{
+public:
+  ZoneMap();
+  ~ZoneMap();
+
+  /**
+   * @brief 初始化
+   *
+   * @param fields 需要维护取值范围的字段
+   * @param name   统计项的名字，一般是表名
+   */
+  void init(const std::vector<FieldMeta> &fields, const std::string &name);
+  void close();
+
+  bool enabled() const { return !fields_.empty(); }
+
+  const std::vector<FieldMeta> &fields() const { return fields_; }
+
+  /**
+   * @brief 字段在 fields() 中的位置，不维护这个字段时返回-1
+   */
+  int field_index(const char *field_name) const;
+
+  /**
+   * @brief 新分配了一个空的记录页面
+   */
+  void init_page(PageNum page_num);
+
+  /**
+   * @brief 页面上插入或修改了一条记录，扩大这个页面的范围
+   * @param record 内存中格式的记录
+   */
+  void insert(PageNum page_num, const char *record);
+
+  /**
+   * @brief 页面上要删除一条记录
+   */
+  void remove(PageNum page_num, const char *record);
+
+  /**
+   * @brief 页面是否已经有摘要
+   */
+  bool summarized(PageNum page_num) const;
+
+  /**
+   * @brief 根据页面上所有的记录生成摘要，页面已经有摘要时什么都不做
+   * @param records 页面上所有的记录，包括当前事务不可见的
+   */
+  void summarize(PageNum page_num, const std::vector<Record> &records);
+
+  /**
+   * @brief 页面上是否可能有满足所有条件的记录，没有摘要的页面总是返回 true
+   * @details 同时统计检查和跳过的页面数
+   */
+  bool may_match(PageNum page_num, const std::vector<ZoneMapCondition> &conditions);
+
+  /**
+   * @brief 按照当前的摘要，有多少页面可以跳过
+   *
+   * @param conditions  比较条件
+   * @param skippable   可以跳过的页面数
+   * @param summarized  有摘要的页面数
+   */
+  void count_skippable(const std::vector<ZoneMapCondition> &conditions, int &skippable, int &summarized) const;
+
+  std::string condition_to_string(const ZoneMapCondition &condition) const;
+
+  int64_t pages_checked() const { return pages_checked_.load(std::memory_order_relaxed); }
+  int64_t pages_skipped() const { return pages_skipped_.load(std::memory_order_relaxed); }
+
+private:
+  /**
+   * @brief 一个页面的摘要
+   */
+  struct Zone
+  {
+    bool               empty = true;  ///< 页面上没有记录，这时 min_values/max_values 没有意义
+    std::vector<Value> min_values;
+    std::vector<Value> max_values;
+  };
+
+  Value field_value(int index, const char *record) const;
+  void  extend(Zone &zone, const char *record) const;
+  bool  zone_may_match(const Zone &zone, const std::vector<ZoneMapCondition> &conditions) const;
+
+private:
+  mutable common::Mutex              lock_;
+  std::vector<FieldMeta>             fields_;
+  std::unordered_map<PageNum, Zone>  zones_;
+  std::atomic<int64_t>               pages_checked_{0};
+  std::atomic<int64_t>               pages_skipped_{0};
+  std::unique_ptr<BPMetricGroup>     metrics_;
+};
@@ -22,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "common/lang/string.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/column/column_store.h"
 #include "storage/record/record_manager.h"
 #include "storage/common/condition_filter.h"
 #include "storage/common/meta_util.h"
@@ -36,11 +37,22 @@ Table::~Table()
     record_handler_ = nullptr;
   }
 
+  if (column_store_ != nullptr) {
+    delete column_store_;
+    column_store_ = nullptr;
+  }
+
   if (data_buffer_pool_ != nullptr) {
     data_buffer_pool_->close_file();
     data_buffer_pool_ = nullptr;
   }
 
+  overflow_handler_.close();
+  if (overflow_buffer_pool_ != nullptr) {
+    overflow_buffer_pool_->close_file();
+    overflow_buffer_pool_ = nullptr;
+  }
+
   for (std::vector<Index *>::iterator it = indexes_.begin(); it != indexes_.end(); ++it) {
     Index *index = *it;
     delete index;
@@ -55,7 +67,8 @@ RC Table::create(int32_t table_id,
                  const char *name, 
                  const char *base_dir, 
                  int attribute_count, 
-                 const AttrInfoSqlNode attributes[])
+                 const AttrInfoSqlNode attributes[],
+                 const TableOptions &options)
 {
   if (table_id < 0) {
     LOG_WARN("invalid table id. table_id=%d, table_name=%s", table_id, name);
@@ -90,9 +103,10 @@ RC Table::create(int32_t table_id,
   close(fd);
 
   // 创建文件
-  if ((rc = table_meta_.init(table_id, name, attribute_count, attributes)) != RC::SUCCESS) {
+  if ((rc = table_meta_.init(table_id, name, attribute_count, attributes, options)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init table meta. name:%s, ret:%d", name, rc);
-    return rc;  // delete table file
+    ::unlink(path);  // 删除前面创建的空的元数据文件，否则下次启动时无法打开数据库
+    return rc;
   }
 
   std::fstream fs;
@@ -108,19 +122,42 @@ RC Table::create(int32_t table_id,
 
   std::string data_file = table_data_file(base_dir, name);
   BufferPoolManager &bpm = BufferPoolManager::instance();
-  rc = bpm.create_file(data_file.c_str());
+  rc = bpm.create_file(data_file.c_str(), bpm.options().table_page_size);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to create disk buffer pool of data file. file name=%s", data_file.c_str());
     return rc;
   }
 
-  rc = init_record_handler(base_dir);
+  if (table_meta_.column_store()) {
+    rc = ColumnStore::create_files(base_dir, name, *table_meta_.field_metas());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to create column files. table name=%s", name);
+      return rc;
+    }
+  }
+
+  if (has_overflow_fields()) {
+    std::string overflow_file = table_overflow_file(base_dir, name);
+    rc = bpm.create_file(overflow_file.c_str(), bpm.options().table_page_size);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to create disk buffer pool of overflow file. file name=%s", overflow_file.c_str());
+      return rc;
+    }
+  }
+
+  rc = table_meta_.column_store() ? init_column_store(base_dir) : init_record_handler(base_dir);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to create table %s due to init record handler failed.", data_file.c_str());
     // don't need to remove the data_file
     return rc;
   }
 
+  rc = init_overflow_handler(base_dir);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to create table %s due to init overflow handler failed.", name);
+    return rc;
+  }
+
   base_dir_ = base_dir;
   LOG_INFO("Successfully create table %s:%s", base_dir, name);
   return rc;
@@ -144,13 +181,19 @@ RC Table::open(const char *meta_file, const char *base_dir)
   fs.close();
 
   // 加载数据文件
-  RC rc = init_record_handler(base_dir);
+  RC rc = table_meta_.column_store() ? init_column_store(base_dir) : init_record_handler(base_dir);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to open table %s due to init record handler failed.", base_dir);
     // don't need to remove the data_file
     return rc;
   }
 
+  rc = init_overflow_handler(base_dir);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open table %s due to init overflow handler failed.", name());
+    return rc;
+  }
+
   base_dir_ = base_dir;
 
   const int index_num = table_meta_.index_num();
@@ -184,10 +227,20 @@ RC Table::open(const char *meta_file, const char *base_dir)
 
 RC Table::insert_record(Record &record)
 {
+  // 列存储的表没有索引
+  if (column_store_ != nullptr) {
+    RC rc = column_store_->insert_record(record.data(), record.rid());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+    }
+    return rc;
+  }
+
   RC rc = RC::SUCCESS;
   rc = record_handler_->insert_record(record.data(), table_meta_.record_size(), &record.rid());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+    free_overflow_values(record.data());
     return rc;
   }
 
@@ -203,12 +256,67 @@ RC Table::insert_record(Record &record)
       LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s",
                 name(), rc2, strrc(rc2));
     }
+    free_overflow_values(record.data());
+  }
+  return rc;
+}
+
+RC Table::insert_records(std::vector<Record> &records)
+{
+  std::vector<const char *> datas;
+  datas.reserve(records.size());
+  for (Record &record : records) {
+    datas.push_back(record.data());
+  }
+
+  std::vector<RID> rids;
+  RC rc = column_store_ != nullptr ? column_store_->insert_records(datas, rids)
+                                   : record_handler_->insert_records(datas, table_meta_.record_size(), rids);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Insert records failed. table name=%s, inserted=%d, rc=%s",
+              table_meta_.name(), static_cast<int>(rids.size()), strrc(rc));
+  }
+
+  // 一个索引插入失败时，前面的索引已经包含了所有的记录，后面的索引都还没有插入
+  size_t index_num = 0;
+  for (; rc == RC::SUCCESS && index_num < indexes_.size(); index_num++) {
+    rc = indexes_[index_num]->insert_entries(datas, rids);
+  }
+
+  if (rc != RC::SUCCESS) {
+    if (index_num > 0) {
+      for (size_t i = 0; i < rids.size(); i++) {
+        RC rc2 = delete_entry_of_indexes(datas[i], rids[i], false/*error_on_not_exists*/);
+        if (rc2 != RC::SUCCESS && rc2 != RC::RECORD_INVALID_KEY) {
+          LOG_ERROR("Failed to rollback index data when insert index entries failed. table name=%s, rc=%d:%s",
+                    name(), rc2, strrc(rc2));
+        }
+      }
+    }
+    for (const RID &rid : rids) {
+      RC rc2 = column_store_ != nullptr ? column_store_->delete_record(rid) : record_handler_->delete_record(&rid);
+      if (rc2 != RC::SUCCESS) {
+        LOG_PANIC("Failed to rollback record data when insert records failed. table name=%s, rc=%d:%s",
+                  name(), rc2, strrc(rc2));
+      }
+    }
+    for (Record &record : records) {
+      free_overflow_values(record.data());
+    }
+    return rc;
+  }
+
+  for (size_t i = 0; i < records.size(); i++) {
+    records[i].set_rid(rids[i]);
   }
   return rc;
 }
 
 RC Table::visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor)
 {
+  if (column_store_ != nullptr) {
+    return column_store_->visit_record(rid, readonly, visitor);
+  }
   return record_handler_->visit_record(rid, readonly, visitor);
 }
 
@@ -218,23 +326,29 @@ RC Table::get_record(const RID &rid, Record &record)
   char *record_data = (char *)malloc(record_size);
   ASSERT(nullptr != record_data, "failed to malloc memory. record data size=%d", record_size);
 
-  auto copier = [&record, record_data, record_size](Record &record_src) {
-    memcpy(record_data, record_src.data(), record_size);
-    record.set_rid(record_src.rid());
-  };
-  RC rc = record_handler_->visit_record(rid, true/*readonly*/, copier);
+  RC rc = column_store_ != nullptr ? column_store_->copy_record(rid, record_data)
+                                   : record_handler_->copy_record(rid, record_data, record_size);
   if (rc != RC::SUCCESS) {
     free(record_data);
-    LOG_WARN("failed to visit record. rid=%s, table=%s, rc=%s", rid.to_string().c_str(), name(), strrc(rc));
+    LOG_WARN("failed to copy record. rid=%s, table=%s, rc=%s", rid.to_string().c_str(), name(), strrc(rc));
     return rc;
   }
 
+  record.set_rid(rid);
   record.set_data_owner(record_data, record_size);
   return rc;
 }
 
 RC Table::recover_insert_record(Record &record)
 {
+  if (column_store_ != nullptr) {
+    RC rc = column_store_->recover_insert_record(record.data(), record.rid());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+    }
+    return rc;
+  }
+
   RC rc = RC::SUCCESS;
   rc = record_handler_->recover_insert_record(record.data(), table_meta_.record_size(), record.rid());
   if (rc != RC::SUCCESS) {
@@ -280,7 +394,7 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   for (int i = 0; i < value_num; i++) {
     const FieldMeta *field = table_meta_.field(i + normal_field_start_index);
     const Value &value = values[i];
-    if (field->type() != value.attr_type()) {
+    if (attr_value_type(field->type()) != value.attr_type()) {
       LOG_ERROR("Invalid value type. table name =%s, field name=%s, type=%d, but given=%d",
                 table_meta_.name(), field->name(), field->type(), value.attr_type());
       return RC::SCHEMA_FIELD_TYPE_MISMATCH;
@@ -294,8 +408,30 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   for (int i = 0; i < value_num; i++) {
     const FieldMeta *field = table_meta_.field(i + normal_field_start_index);
     const Value &value = values[i];
+    if (field->type() == TEXTS) {
+      // 大字段的值写到溢出页面中，记录中只保存引用
+      OverflowRef ref;
+      RC rc = overflow_handler_.insert(value.data(), value.length(), ref);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to write overflow value. table=%s, field=%s, length=%d, rc=%s",
+                 name(), field->name(), value.length(), strrc(rc));
+        // 释放前面的字段已经写入的溢出页面
+        for (int j = 0; j < i; j++) {
+          const FieldMeta *written_field = table_meta_.field(j + normal_field_start_index);
+          if (written_field->type() == TEXTS) {
+            memcpy(&ref, record_data + written_field->offset(), sizeof(ref));
+            (void)overflow_handler_.remove(ref);
+          }
+        }
+        free(record_data);
+        return rc;
+      }
+      memcpy(record_data + field->offset(), &ref, sizeof(ref));
+      continue;
+    }
+
     size_t copy_len = field->len();
-    if (field->type() == CHARS) {
+    if (field->type() == CHARS || field->type() == VARCHARS) {
       const size_t data_len = value.length();
       if (copy_len > data_len) {
         copy_len = data_len + 1;
@@ -308,6 +444,74 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   return RC::SUCCESS;
 }
 
+RC Table::init_overflow_handler(const char *base_dir)
+{
+  if (!has_overflow_fields()) {
+    return RC::SUCCESS;
+  }
+
+  std::string overflow_file = table_overflow_file(base_dir, table_meta_.name());
+
+  RC rc = BufferPoolManager::instance().open_file(overflow_file.c_str(), overflow_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open disk buffer pool for file:%s. rc=%d:%s", overflow_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
+  return overflow_handler_.init(overflow_buffer_pool_);
+}
+
+bool Table::has_overflow_fields() const
+{
+  const std::vector<FieldMeta> &fields = *table_meta_.field_metas();
+  return std::any_of(fields.begin(), fields.end(), [](const FieldMeta &field) { return field.type() == TEXTS; });
+}
+
+void Table::free_overflow_values(const char *record)
+{
+  if (!overflow_handler_.inited()) {
+    return;
+  }
+
+  for (const FieldMeta &field : *table_meta_.field_metas()) {
+    if (field.type() != TEXTS) {
+      continue;
+    }
+
+    OverflowRef ref;
+    memcpy(&ref, record + field.offset(), sizeof(ref));
+    RC rc = overflow_handler_.remove(ref);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to free overflow value. table=%s, field=%s, first page=%d, rc=%s",
+               name(), field.name(), ref.first_page, strrc(rc));
+    }
+  }
+}
+
+RC Table::read_overflow_value(const FieldMeta &field, const char *record, Value &value) const
+{
+  OverflowRef ref;
+  memcpy(&ref, record + field.offset(), sizeof(ref));
+
+  std::string data;
+  RC rc = overflow_handler_.read(ref, data);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to read overflow value. table=%s, field=%s, first page=%d, length=%d, rc=%s",
+             name(), field.name(), ref.first_page, ref.length, strrc(rc));
+    return rc;
+  }
+
+  value.set_string(data.data(), static_cast<int>(data.size()));
+  return rc;
+}
+
+RC Table::open_overflow_reader(const FieldMeta &field, const char *record, OverflowReader &reader) const
+{
+  OverflowRef ref;
+  memcpy(&ref, record + field.offset(), sizeof(ref));
+  return overflow_handler_.open_reader(ref, reader);
+}
+
 RC Table::init_record_handler(const char *base_dir)
 {
   std::string data_file = table_data_file(base_dir, table_meta_.name());
@@ -318,8 +522,10 @@ RC Table::init_record_handler(const char *base_dir)
     return rc;
   }
 
+  record_layout_.init(table_meta_.storage_format(), table_meta_.record_size(), *table_meta_.field_metas());
+
   record_handler_ = new RecordFileHandler();
-  rc = record_handler_->init(data_buffer_pool_);
+  rc = record_handler_->init(data_buffer_pool_, &record_layout_);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to init record handler. rc=%s", strrc(rc));
     data_buffer_pool_->close_file();
@@ -329,18 +535,79 @@ RC Table::init_record_handler(const char *base_dir)
     return rc;
   }
 
+  std::vector<FieldMeta> zone_map_fields;
+  for (const std::string &field_name : table_meta_.zone_map_fields()) {
+    zone_map_fields.push_back(*table_meta_.field(field_name.c_str()));
+  }
+  record_handler_->zone_map().init(zone_map_fields, table_meta_.name());
+
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly)
+RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly,
+    std::vector<ZoneMapCondition> zone_map_conditions, std::vector<int> columns)
 {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, nullptr);
+  if (!columns.empty()) {
+    // 事务要检查系统字段
+    for (int i = 0; i < table_meta_.sys_field_num(); i++) {
+      if (std::find(columns.begin(), columns.end(), i) == columns.end()) {
+        columns.push_back(i);
+      }
+    }
+  }
+
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, nullptr /*condition_filter*/, &record_layout_,
+                            &record_handler_->zone_map(), std::move(zone_map_conditions), std::move(columns));
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
   return rc;
 }
 
+RC Table::init_column_store(const char *base_dir)
+{
+  std::string data_file = table_data_file(base_dir, table_meta_.name());
+
+  RC rc = BufferPoolManager::instance().open_file(data_file.c_str(), data_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open disk buffer pool for file:%s. rc=%d:%s", data_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
+  column_store_ = new ColumnStore();
+  rc = column_store_->open(base_dir, table_meta_.name(), data_buffer_pool_, *table_meta_.field_metas(),
+                           table_meta_.sys_field_num(), table_meta_.record_size());
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open column store. table=%s, rc=%s", name(), strrc(rc));
+    delete column_store_;
+    column_store_ = nullptr;
+    data_buffer_pool_->close_file();
+    data_buffer_pool_ = nullptr;
+  }
+  return rc;
+}
+
+RC Table::get_column_scanner(ColumnScanner &scanner, Trx *trx, bool readonly,
+    std::vector<ColumnCondition> conditions, std::vector<int> columns)
+{
+  if (!columns.empty()) {
+    // 事务要检查系统字段
+    for (int i = 0; i < table_meta_.sys_field_num(); i++) {
+      if (std::find(columns.begin(), columns.end(), i) == columns.end()) {
+        columns.push_back(i);
+      }
+    }
+  }
+
+  RC rc = scanner.open_scan(this, *column_store_, trx, readonly, std::move(conditions), std::move(columns));
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("failed to open column scanner. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+ZoneMap &Table::zone_map() { return record_handler_->zone_map(); }
+
 RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name)
 {
   if (common::is_blank(index_name) || nullptr == field_meta) {
@@ -348,6 +615,16 @@ RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_
     return RC::INVALID_ARGUMENT;
   }
 
+  if (field_meta->type() == TEXTS) {
+    LOG_WARN("Cannot create index on a text field. table=%s, field=%s", name(), field_meta->name());
+    return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+  }
+
+  if (column_store_ != nullptr) {
+    LOG_WARN("Index is not supported on column store table. table=%s, index=%s", name(), index_name);
+    return RC::UNIMPLENMENT;
+  }
+
   IndexMeta new_index_meta;
   RC rc = new_index_meta.init(index_name, *field_meta);
   if (rc != RC::SUCCESS) {
@@ -435,7 +712,7 @@ RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_
   return rc;
 }
 
-RC Table::delete_record(const Record &record)
+RC Table::delete_record(const Record &record, bool free_overflow /*= true*/)
 {
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_) {
@@ -444,7 +721,11 @@ RC Table::delete_record(const Record &record)
            "failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s",
            name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
   }
-  rc = record_handler_->delete_record(&record.rid());
+  rc = column_store_ != nullptr ? column_store_->delete_record(record.rid())
+                                : record_handler_->delete_record(&record.rid());
+  if (rc == RC::SUCCESS && free_overflow) {
+    free_overflow_values(record.data());
+  }
   return rc;
 }
 
@@ -507,6 +788,20 @@ RC Table::sync()
       return rc;
     }
   }
+
+  if (overflow_buffer_pool_ != nullptr) {
+    rc = overflow_buffer_pool_->flush_all_pages();
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to flush overflow pages. table=%s, rc=%s", name(), strrc(rc));
+      return rc;
+    }
+  }
+  if (column_store_ != nullptr) {
+    rc = column_store_->sync();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
   LOG_INFO("Sync table over. table=%s", name());
   return rc;
 }
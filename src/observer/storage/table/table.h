@@ -16,12 +16,18 @@ See the Mulan PSL v2 for more details. */
 
 #include <functional>
 #include "storage/table/table_meta.h"
+#include "storage/record/record_layout.h"
+#include "storage/record/overflow_page.h"
+#include "storage/record/zone_map.h"
 
 struct RID;
 class Record;
 class DiskBufferPool;
 class RecordFileHandler;
 class RecordFileScanner;
+class ColumnStore;
+class ColumnScanner;
+struct ColumnCondition;
 class ConditionFilter;
 class DefaultConditionFilter;
 class Index;
@@ -46,13 +52,15 @@ public:
    * @param base_dir 表数据存放的路径
    * @param attribute_count 字段个数
    * @param attributes 字段
+   * @param options 建表时指定的选项
    */
   RC create(int32_t table_id, 
             const char *path, 
             const char *name, 
             const char *base_dir, 
             int attribute_count, 
-            const AttrInfoSqlNode attributes[]);
+            const AttrInfoSqlNode attributes[],
+            const TableOptions &options);
 
   /**
    * 打开一个表
@@ -76,7 +84,21 @@ public:
    * @param record[in/out] 传入的数据包含具体的数据，插入成功会通过此字段返回RID
    */
   RC insert_record(Record &record);
-  RC delete_record(const Record &record);
+
+  /**
+   * @brief 在当前的表中插入一批记录
+   * @details 记录连续地填充到页面中，每个索引的数据排好序以后再插入。要么全部插入成功，要么全部不插入，
+   * 失败时所有记录的大字段都会释放，与 insert_record 一样
+   * @param records[in/out] 插入成功会设置每条记录的RID
+   */
+  RC insert_records(std::vector<Record> &records);
+
+  /**
+   * @brief 删除一条记录
+   * @param free_overflow 是否释放大字段占用的溢出页面。数据库恢复时溢出页面的分配情况与日志不一定一致，
+   *                      为了不释放已经被其它记录使用的页面，恢复时不释放
+   */
+  RC delete_record(const Record &record, bool free_overflow = true);
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
   RC get_record(const RID &rid, Record &record);
 
@@ -85,7 +107,41 @@ public:
   // TODO refactor
   RC create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name);
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly);
+  /**
+   * @brief 打开表的记录扫描器
+   * @param zone_map_conditions 所有记录都要满足的比较条件，用来跳过页面，参考 ZoneMap
+   * @param columns 只读的扫描用到的字段编号，列分组格式的表只读取这些字段和系统字段。为空时读取所有的字段
+   */
+  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly,
+                        std::vector<ZoneMapCondition> zone_map_conditions = {}, std::vector<int> columns = {});
+
+  /**
+   * @brief 打开列存储表的扫描器
+   * @param conditions 在编码以后的列数据上计算的比较条件，参考 ColumnSegment::filter
+   * @param columns    只读的扫描用到的字段编号，只解码这些字段和系统字段。为空时读取所有的字段
+   */
+  RC get_column_scanner(ColumnScanner &scanner, Trx *trx, bool readonly,
+                        std::vector<ColumnCondition> conditions = {}, std::vector<int> columns = {});
+
+  /**
+   * @brief 表数据文件的区域映射
+   */
+  ZoneMap &zone_map();
+
+  /**
+   * @brief 列存储表的数据，行存储的表返回 nullptr
+   */
+  ColumnStore *column_store() const { return column_store_; }
+
+  /**
+   * @brief 读取记录中一个大字段(TEXTS)的完整值
+   */
+  RC read_overflow_value(const FieldMeta &field, const char *record, Value &value) const;
+
+  /**
+   * @brief 打开记录中一个大字段(TEXTS)的流式读取器
+   */
+  RC open_overflow_reader(const FieldMeta &field, const char *record, OverflowReader &reader) const;
 
   RecordFileHandler *record_handler() const
   {
@@ -107,7 +163,25 @@ private:
 private:
   RC init_record_handler(const char *base_dir);
 
+  /**
+   * @brief 打开列存储表的所有列文件，表的数据文件用作行组目录
+   */
+  RC init_column_store(const char *base_dir);
+  RC init_overflow_handler(const char *base_dir);
+
+  /**
+   * @brief 表是否有大字段，有大字段的表才有溢出页面文件
+   */
+  bool has_overflow_fields() const;
+
 public:
+  /**
+   * @brief 释放一条记录中所有大字段占用的溢出页面
+   * @details make_record 生成的记录没有插入到表中时，需要调用它释放溢出页面
+   */
+  void free_overflow_values(const char *record);
+
+
   Index *find_index(const char *index_name) const;
   Index *find_index_by_field(const char *field_name) const;
 
@@ -116,5 +190,9 @@ private:
   TableMeta   table_meta_;
   DiskBufferPool *data_buffer_pool_ = nullptr;   /// 数据文件关联的buffer pool
   RecordFileHandler *record_handler_ = nullptr;  /// 记录操作
+  RecordLayout       record_layout_;             /// 记录在内存和页面上的格式
+  ColumnStore       *column_store_ = nullptr;    /// 列存储表的数据，与 record_handler_ 只有一个
+  DiskBufferPool *overflow_buffer_pool_ = nullptr;  /// 溢出页面文件关联的buffer pool
+  OverflowFileHandler overflow_handler_;           /// 大字段的溢出页面
   std::vector<Index *> indexes_;
 };
@@ -13,12 +13,14 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <algorithm>
+#include <limits>
 #include <common/lang/string.h>
 
 #include "storage/table/table_meta.h"
 #include "json/json.h"
 #include "common/log/log.h"
 #include "storage/trx/trx.h"
+#include "storage/record/overflow_page.h"
 
 using namespace std;
 
@@ -26,13 +28,25 @@ static const Json::StaticString FIELD_TABLE_ID("table_id");
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_STORAGE_FORMAT("storage_format");
+static const Json::StaticString FIELD_ZONE_MAP_FIELDS("zone_map_fields");
+static const Json::StaticString FIELD_ENGINE("engine");
+
+static const char *STORAGE_FORMAT_FIXED   = "fixed";
+static const char *STORAGE_FORMAT_SLOTTED = "slotted";
+static const char *STORAGE_FORMAT_PAX     = "pax";
+
+static const char *ENGINE_COLUMN = "column";
 
 TableMeta::TableMeta(const TableMeta &other)
     : table_id_(other.table_id_),
     name_(other.name_),
     fields_(other.fields_),
     indexes_(other.indexes_),
-    record_size_(other.record_size_)
+    record_size_(other.record_size_),
+    storage_format_(other.storage_format_),
+    zone_map_fields_(other.zone_map_fields_),
+    column_store_(other.column_store_)
 {}
 
 void TableMeta::swap(TableMeta &other) noexcept
@@ -41,9 +55,13 @@ void TableMeta::swap(TableMeta &other) noexcept
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
   std::swap(record_size_, other.record_size_);
+  std::swap(storage_format_, other.storage_format_);
+  zone_map_fields_.swap(other.zone_map_fields_);
+  std::swap(column_store_, other.column_store_);
 }
 
-RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[])
+RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+                   const TableOptions &options)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Name cannot be empty");
@@ -74,19 +92,78 @@ RC TableMeta::init(int32_t table_id, const char *name, int field_num, const Attr
     fields_.resize(field_num);
   }
 
+  StorageFormat storage_format = StorageFormat::FIXED_FORMAT;
   for (int i = 0; i < field_num; i++) {
     const AttrInfoSqlNode &attr_info = attributes[i];
+    if (attr_info.type == VARCHARS) {
+      // 变长字段在页面上用2个字节记录长度
+      if (attr_info.length > std::numeric_limits<uint16_t>::max()) {
+        LOG_ERROR("Varchar field is too long. table name=%s, field name=%s, length=%d", 
+                  name, attr_info.name.c_str(), attr_info.length);
+        return RC::INVALID_ARGUMENT;
+      }
+      storage_format = StorageFormat::SLOTTED_FORMAT;
+    }
+
+    // 大字段的值放在溢出页面中，记录中只保存引用
+    const int attr_len = attr_info.type == TEXTS ? static_cast<int>(sizeof(OverflowRef)) : attr_info.length;
     rc = fields_[i + trx_field_num].init(attr_info.name.c_str(), 
-            attr_info.type, field_offset, attr_info.length, true/*visible*/);
+            attr_info.type, field_offset, attr_len, true/*visible*/);
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to init field meta. table name=%s, field name: %s", name, attr_info.name.c_str());
       return rc;
     }
 
-    field_offset += attr_info.length;
+    field_offset += attr_len;
+  }
+
+  if (options.pax) {
+    storage_format = StorageFormat::PAX_FORMAT;
   }
 
-  record_size_ = field_offset;
+  // 列存储表的数据都在列文件中，不使用记录页面，也就没有页面格式和区域映射
+  if (options.column_store) {
+    if (options.pax || !options.zone_map_fields.empty()) {
+      LOG_ERROR("Column store table cannot have pax format or zone map. table name=%s", name);
+      return RC::INVALID_ARGUMENT;
+    }
+    for (int i = 0; i < field_num; i++) {
+      if (attributes[i].type == TEXTS) {
+        LOG_ERROR("Text field is not supported in column store. table name=%s, field name=%s",
+                  name, attributes[i].name.c_str());
+        return RC::INVALID_ARGUMENT;
+      }
+    }
+  }
+
+  // 区域映射按照字段取出来的值比较，大字段的值不在记录中，不能使用
+  const std::vector<std::string> &zone_map_fields = options.zone_map_fields;
+  for (const std::string &field_name : zone_map_fields) {
+    const FieldMeta *field_meta = nullptr;
+    for (int i = trx_field_num; i < static_cast<int>(fields_.size()); i++) {
+      if (field_name == fields_[i].name()) {
+        field_meta = &fields_[i];
+        break;
+      }
+    }
+    if (nullptr == field_meta) {
+      LOG_ERROR("No such field for zone map. table name=%s, field name=%s", name, field_name.c_str());
+      return RC::SCHEMA_FIELD_NOT_EXIST;
+    }
+    if (field_meta->type() == TEXTS) {
+      LOG_ERROR("Zone map is not supported on text field. table name=%s, field name=%s", name, field_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    if (std::count(zone_map_fields.begin(), zone_map_fields.end(), field_name) > 1) {
+      LOG_ERROR("Duplicate zone map field. table name=%s, field name=%s", name, field_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  record_size_     = field_offset;
+  storage_format_  = storage_format;
+  zone_map_fields_ = zone_map_fields;
+  column_store_    = options.column_store;
 
   table_id_ = table_id;
   name_     = name;
@@ -214,6 +291,24 @@ int TableMeta::serialize(std::ostream &ss) const
   }
   table_value[FIELD_INDEXES] = std::move(indexes_value);
 
+  switch (storage_format_) {
+    case StorageFormat::FIXED_FORMAT: table_value[FIELD_STORAGE_FORMAT] = STORAGE_FORMAT_FIXED; break;
+    case StorageFormat::SLOTTED_FORMAT: table_value[FIELD_STORAGE_FORMAT] = STORAGE_FORMAT_SLOTTED; break;
+    case StorageFormat::PAX_FORMAT: table_value[FIELD_STORAGE_FORMAT] = STORAGE_FORMAT_PAX; break;
+  }
+
+  if (!zone_map_fields_.empty()) {
+    Json::Value zone_map_fields_value;
+    for (const std::string &field_name : zone_map_fields_) {
+      zone_map_fields_value.append(field_name);
+    }
+    table_value[FIELD_ZONE_MAP_FIELDS] = std::move(zone_map_fields_value);
+  }
+
+  if (column_store_) {
+    table_value[FIELD_ENGINE] = ENGINE_COLUMN;
+  }
+
   Json::StreamWriterBuilder builder;
   Json::StreamWriter *writer = builder.newStreamWriter();
 
@@ -253,6 +348,47 @@ int TableMeta::deserialize(std::istream &is)
 
   std::string table_name = table_name_value.asString();
 
+  // 没有记录存放格式的是以前创建的表，都是定长格式
+  StorageFormat storage_format = StorageFormat::FIXED_FORMAT;
+  const Json::Value &storage_format_value = table_value[FIELD_STORAGE_FORMAT];
+  if (!storage_format_value.isNull()) {
+    const std::string format_name = storage_format_value.isString() ? storage_format_value.asString() : "";
+    if (format_name == STORAGE_FORMAT_SLOTTED) {
+      storage_format = StorageFormat::SLOTTED_FORMAT;
+    } else if (format_name == STORAGE_FORMAT_PAX) {
+      storage_format = StorageFormat::PAX_FORMAT;
+    } else if (format_name != STORAGE_FORMAT_FIXED) {
+      LOG_ERROR("Invalid storage format. json value=%s", storage_format_value.toStyledString().c_str());
+      return -1;
+    }
+  }
+
+  std::vector<std::string> zone_map_fields;
+  const Json::Value &zone_map_fields_value = table_value[FIELD_ZONE_MAP_FIELDS];
+  if (!zone_map_fields_value.isNull()) {
+    if (!zone_map_fields_value.isArray()) {
+      LOG_ERROR("Invalid zone map fields. json value=%s", zone_map_fields_value.toStyledString().c_str());
+      return -1;
+    }
+    for (const Json::Value &field_name_value : zone_map_fields_value) {
+      if (!field_name_value.isString()) {
+        LOG_ERROR("Invalid zone map field. json value=%s", field_name_value.toStyledString().c_str());
+        return -1;
+      }
+      zone_map_fields.push_back(field_name_value.asString());
+    }
+  }
+
+  bool               column_store = false;
+  const Json::Value &engine_value = table_value[FIELD_ENGINE];
+  if (!engine_value.isNull()) {
+    if (!engine_value.isString() || engine_value.asString() != ENGINE_COLUMN) {
+      LOG_ERROR("Invalid engine. json value=%s", engine_value.toStyledString().c_str());
+      return -1;
+    }
+    column_store = true;
+  }
+
   const Json::Value &fields_value = table_value[FIELD_FIELDS];
   if (!fields_value.isArray() || fields_value.size() <= 0) {
     LOG_ERROR("Invalid table meta. fields is not array, json value=%s", fields_value.toStyledString().c_str());
@@ -280,6 +416,9 @@ int TableMeta::deserialize(std::istream &is)
   name_.swap(table_name);
   fields_.swap(fields);
   record_size_ = fields_.back().offset() + fields_.back().len() - fields_.begin()->offset();
+  storage_format_ = storage_format;
+  zone_map_fields_.swap(zone_map_fields);
+  column_store_ = column_store;
 
   const Json::Value &indexes_value = table_value[FIELD_INDEXES];
   if (!indexes_value.empty()) {
@@ -327,5 +466,18 @@ void TableMeta::desc(std::ostream &os) const
     index.desc(os);
     os << std::endl;
   }
+  if (!zone_map_fields_.empty()) {
+    os << "\tzone_map=(";
+    for (size_t i = 0; i < zone_map_fields_.size(); i++) {
+      os << (i == 0 ? "" : ",") << zone_map_fields_[i];
+    }
+    os << ')' << std::endl;
+  }
+  if (storage_format_ == StorageFormat::PAX_FORMAT) {
+    os << "\tformat=" << STORAGE_FORMAT_PAX << std::endl;
+  }
+  if (column_store_) {
+    os << "\tengine=" << ENGINE_COLUMN << std::endl;
+  }
   os << ')' << std::endl;
 }
@@ -18,10 +18,21 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 
 #include "common/rc.h"
+#include "common/types.h"
 #include "storage/field/field_meta.h"
 #include "storage/index/index_meta.h"
 #include "common/lang/serializable.h"
 
+/**
+ * @brief 建表时指定的选项
+ */
+struct TableOptions
+{
+  std::vector<std::string> zone_map_fields;        ///< 维护区域映射的字段，参考 ZoneMap
+  bool                     pax          = false;  ///< 使用列分组的页面格式，参考 PaxPage
+  bool                     column_store = false;  ///< 使用列存储引擎，参考 ColumnStore
+};
+
 /**
  * @brief 表元数据
  * 
@@ -36,7 +47,12 @@ public:
 
   void swap(TableMeta &other) noexcept;
 
-  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[]);
+  /**
+   * @brief 初始化
+   * @param options 建表时指定的选项
+   */
+  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+          const TableOptions &options);
 
   RC add_index(const IndexMeta &index);
 
@@ -63,6 +79,24 @@ public:
 
   int record_size() const;
 
+  /**
+   * @brief 数据文件中记录的存放格式
+   * @details 建表时指定了列分组格式的使用 PAX_FORMAT，变长字段在小页中按照最大长度存放。
+   * 否则有变长字段(VARCHARS)的表使用 SLOTTED_FORMAT，其它的表使用 FIXED_FORMAT。
+   * 以前创建的表在元数据中没有记录格式，都是 FIXED_FORMAT
+   */
+  StorageFormat storage_format() const { return storage_format_; }
+
+  /**
+   * @brief 维护了区域映射(每个页面的最小值和最大值)的字段
+   */
+  const std::vector<std::string> &zone_map_fields() const { return zone_map_fields_; }
+
+  /**
+   * @brief 是否使用列存储引擎。以前创建的表都是行存储
+   */
+  bool column_store() const { return column_store_; }
+
 public:
   int serialize(std::ostream &os) const override;
   int deserialize(std::istream &is) override;
@@ -77,4 +111,10 @@ protected:
   std::vector<IndexMeta> indexes_;
 
   int record_size_ = 0;
+
+  StorageFormat storage_format_ = StorageFormat::FIXED_FORMAT;
+
+  std::vector<std::string> zone_map_fields_;
+
+  bool column_store_ = false;
 };
@@ -160,6 +160,55 @@ RC MvccTrx::insert_record(Table *table, Record &record)
   return rc;
 }
 
+RC MvccTrx::insert_records(Table *table, vector<Record> &records)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  for (Record &record : records) {
+    begin_field.set_int(record, -trx_id_);
+    end_field.set_int(record, trx_kit_.max_trx_id());
+  }
+
+  RC rc = table->insert_records(records);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records into table. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 记录是一个页面一个页面填充的，同一个页面上的记录是连续的
+  vector<char> log_data;
+  size_t       begin = 0;
+  while (begin < records.size()) {
+    const PageNum page_num = records[begin].rid().page_num;
+    size_t        end      = begin;
+    log_data.clear();
+    for (; end < records.size() && records[end].rid().page_num == page_num; end++) {
+      const Record &record   = records[end];
+      const int32_t slot_num = record.rid().slot_num;
+      log_data.insert(log_data.end(), reinterpret_cast<const char *>(&slot_num),
+                      reinterpret_cast<const char *>(&slot_num) + sizeof(slot_num));
+      log_data.insert(log_data.end(), record.data(), record.data() + record.len());
+
+      pair<OperationSet::iterator, bool> ret = 
+            operations_.insert(Operation(Operation::Type::INSERT, table, record.rid()));
+      if (!ret.second) {
+        rc = RC::INTERNAL;
+        LOG_WARN("failed to insert operation(insertion) into operation set: duplicate");
+      }
+    }
+
+    const RID batch_rid(page_num, static_cast<SlotNum>(end - begin));
+    RC rc2 = log_manager_->append_log(CLogType::INSERT_BATCH, trx_id_, table->table_id(), batch_rid,
+                                      static_cast<int32_t>(log_data.size()), 0/*offset*/, log_data.data());
+    ASSERT(rc2 == RC::SUCCESS, "failed to append insert batch log. trx id=%d, table id=%d, page num=%d, count=%d, rc=%s",
+        trx_id_, table->table_id(), page_num, batch_rid.slot_num, strrc(rc2));
+    begin = end;
+  }
+  return rc;
+}
+
 RC MvccTrx::delete_record(Table * table, Record &record)
 {
   Field begin_field;
@@ -176,7 +225,18 @@ RC MvccTrx::delete_record(Table * table, Record &record)
   }
   
   end_field.set_int(record, -trx_id_);
-  RC rc = log_manager_->append_log(CLogType::DELETE, trx_id_, table->table_id(), record.rid(), 0, 0, nullptr);
+
+  // 变长记录和列分组页面扫描出来的是复制的记录，要写回页面。扫描时已经持有页面的写锁，这里可以重入
+  RC rc = table->visit_record(record.rid(), false /*readonly*/, [this, &end_field](Record &page_record) {
+    end_field.set_int(page_record, -trx_id_);
+  });
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to mark record deleted. trx id=%d, rid=%s, rc=%s",
+             trx_id_, record.rid().to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  rc = log_manager_->append_log(CLogType::DELETE, trx_id_, table->table_id(), record.rid(), 0, 0, nullptr);
   ASSERT(rc == RC::SUCCESS, "failed to append delete record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
       trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
 
@@ -340,7 +400,7 @@ RC MvccTrx::rollback()
         rc = table->get_record(rid, record); 
         ASSERT(rc == RC::SUCCESS, "failed to get record while rollback. rid=%s, rc=%s", 
                rid.to_string().c_str(), strrc(rc));
-        rc = table->delete_record(record);
+        rc = table->delete_record(record, !recovering_ /*free_overflow*/);
         ASSERT(rc == RC::SUCCESS, "failed to delete record while rollback. rid=%s, rc=%s",
               rid.to_string().c_str(), strrc(rc));
       } break;
@@ -386,6 +446,7 @@ RC find_table(Db *db, const CLogRecord &log_record, Table *&table)
 {
   switch (clog_type_from_integer(log_record.header().type_)) {
     case CLogType::INSERT:
+    case CLogType::INSERT_BATCH:
     case CLogType::DELETE: {
       const CLogRecordData &data_record = log_record.data_record();
       table = db->find_table(data_record.table_id_);
@@ -425,6 +486,10 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record)
       operations_.insert(Operation(Operation::Type::INSERT, table, record.rid()));
     } break;
 
+    case CLogType::INSERT_BATCH: {
+      return redo_insert_batch(table, log_record);
+    } break;
+
     case CLogType::DELETE: {
       const CLogRecordData &data_record = log_record.data_record();
       Field begin_field;
@@ -464,3 +529,34 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record)
 
   return RC::SUCCESS;
 }
+
+RC MvccTrx::redo_insert_batch(Table *table, const CLogRecord &log_record)
+{
+  const CLogRecordData &data_record = log_record.data_record();
+  const int             count       = data_record.rid_.slot_num;
+  if (count <= 0 || data_record.data_len_ % count != 0 ||
+      data_record.data_len_ / count <= static_cast<int>(sizeof(int32_t))) {
+    LOG_WARN("invalid insert batch log. log record=%s", log_record.to_string().c_str());
+    return RC::INTERNAL;
+  }
+
+  const int entry_len  = data_record.data_len_ / count;
+  const int record_len = entry_len - static_cast<int>(sizeof(int32_t));
+  for (int i = 0; i < count; i++) {
+    char   *entry = data_record.data_ + i * entry_len;
+    int32_t slot_num;
+    memcpy(&slot_num, entry, sizeof(slot_num));
+
+    Record record;
+    record.set_data(entry + sizeof(int32_t), record_len);
+    record.set_rid(RID(data_record.rid_.page_num, slot_num));
+    RC rc = table->recover_insert_record(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to recover insert. table=%s, rid=%s, log record=%s, rc=%s",
+               table->name(), record.rid().to_string().c_str(), log_record.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    operations_.insert(Operation(Operation::Type::INSERT, table, record.rid()));
+  }
+  return RC::SUCCESS;
+}
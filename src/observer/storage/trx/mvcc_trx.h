@@ -67,6 +67,12 @@ public:
   virtual ~MvccTrx();
 
   RC insert_record(Table *table, Record &record) override;
+
+  /**
+   * @brief 插入一批记录
+   * @details 同一个页面上的记录只写一条 INSERT_BATCH 日志
+   */
+  RC insert_records(Table *table, std::vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
 
   /**
@@ -91,6 +97,7 @@ public:
 
 private:
   RC commit_with_trx_id(int32_t commit_id);
+  RC redo_insert_batch(Table *table, const CLogRecord &log_record);
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
 private:
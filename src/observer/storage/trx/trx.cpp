@@ -61,6 +61,23 @@ TrxKit *TrxKit::instance()
   return global_trxkit;
 }
 
+RC Trx::insert_records(Table *table, std::vector<Record> &records)
+{
+  RC rc = RC::SUCCESS;
+  for (size_t i = 0; i < records.size(); i++) {
+    rc = insert_record(table, records[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to insert record. table=%s, rc=%s", table->name(), strrc(rc));
+      // 后面的记录没有插入，释放它们的大字段
+      for (size_t j = i + 1; j < records.size(); j++) {
+        table->free_overflow_values(records[j].data());
+      }
+      break;
+    }
+  }
+  return rc;
+}
+
 RC Trx::redo(Db *db, const CLogRecord &)
 {
   return RC::UNIMPLENMENT;
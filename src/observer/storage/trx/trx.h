@@ -145,6 +145,12 @@ public:
   virtual ~Trx() = default;
 
   virtual RC insert_record(Table *table, Record &record) = 0;
+
+  /**
+   * @brief 插入一批记录
+   * @details 批量导入和一次插入多行时使用。默认实现逐条调用 insert_record
+   */
+  virtual RC insert_records(Table *table, std::vector<Record> &records);
   virtual RC delete_record(Table *table, Record &record) = 0;
   virtual RC visit_record(Table *table, Record &record, bool readonly) = 0;
 
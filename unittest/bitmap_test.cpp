@@ -65,6 +65,52 @@ TEST(test_bitmap, test_bitmap)
   buf3[1] = 0;
   ASSERT_EQ(8, bitmap3.next_unsetted_bit(0));
   ASSERT_EQ(16, bitmap3.next_setted_bit(8));
+
+  // 跳过整个字节以后，下一个字节要从第0位开始找
+  ASSERT_EQ(8, bitmap3.next_unsetted_bit(3));
+  buf3[0] = 0;
+  buf3[1] = 1;
+  ASSERT_EQ(8, bitmap3.next_setted_bit(3));
+}
+
+TEST(test_bitmap, test_bitmap_words)
+{
+  // 超过一个64位字，并且长度不是8的倍数
+  char buf[26];
+  memset(buf, 0, sizeof(buf));
+  const int size = 197;
+  Bitmap bitmap(buf + 1, size);  // 不按照8字节对齐
+
+  ASSERT_EQ(-1, bitmap.next_setted_bit(0));
+  ASSERT_EQ(0, bitmap.count_setted_bits());
+
+  const int setted[] = {0, 63, 64, 127, 130, 196};
+  for (int index : setted) {
+    bitmap.set_bit(index);
+  }
+  ASSERT_EQ(6, bitmap.count_setted_bits());
+
+  int count = 0;
+  for (int index = bitmap.next_setted_bit(0); index >= 0; index = bitmap.next_setted_bit(index + 1)) {
+    ASSERT_EQ(setted[count], index);
+    count++;
+  }
+  ASSERT_EQ(6, count);
+
+  for (int i = 0; i < size; i++) {
+    bitmap.set_bit(i);
+  }
+  ASSERT_EQ(size, bitmap.count_setted_bits());
+  ASSERT_EQ(-1, bitmap.next_unsetted_bit(0));
+  bitmap.clear_bit(150);
+  ASSERT_EQ(150, bitmap.next_unsetted_bit(1));
+  ASSERT_EQ(-1, bitmap.next_unsetted_bit(151));
+
+  // 位图之外的位不影响结果
+  bitmap.clear_bit(196);
+  buf[sizeof(buf) - 1] |= 0xE0;
+  ASSERT_EQ(size - 2, bitmap.count_setted_bits());
+  ASSERT_EQ(-1, bitmap.next_setted_bit(196));
 }
 
 int main(int argc, char **argv)
@@ -12,6 +12,14 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021
 //
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
 #include "storage/buffer/disk_buffer_pool.h"
 #include "gtest/gtest.h"
 
@@ -125,6 +133,927 @@ TEST(test_frame_manager, test_frame_manager_simple_lru)
   frame_manager.cleanup();
 }
 
+TEST(test_frame_manager, test_frame_manager_sharded)
+{
+  BPFrameManager frame_manager("Test");
+  frame_manager.init(2, 4);
+  ASSERT_EQ(4, frame_manager.shard_num());
+
+  test_get(frame_manager);
+
+  test_alloc(frame_manager);
+
+  // 页面分散在各个分片上，淘汰时需要在所有分片上查找
+  std::list<Frame *> frames = frame_manager.find_list(0);
+  ASSERT_EQ(frames.size(), frame_manager.frame_num());
+  for (Frame *frame : frames) {
+    frame->unpin();  // find_list pin
+    frame->unpin();  // alloc pin
+  }
+
+  auto purger = [](Frame *frame) { return RC::SUCCESS; };
+  int purged = frame_manager.purge_frames(frames.size(), purger);
+  ASSERT_EQ(static_cast<size_t>(purged), frames.size());
+  ASSERT_EQ(0, frame_manager.frame_num());
+
+  frame_manager.cleanup();
+}
+
+TEST(test_frame_manager, test_frame_manager_flush_exclusion)
+{
+  BPFrameManager frame_manager("Test");
+  frame_manager.init(2);
+
+  const int file_desc = 0;
+  Frame *frame = frame_manager.alloc(file_desc, 1);
+  ASSERT_NE(frame, nullptr);
+  frame->set_file_desc(file_desc);
+
+  // 还有别人pin着页帧时不能开始写
+  ASSERT_EQ(frame, frame_manager.get(file_desc, 1));
+  ASSERT_FALSE(frame_manager.begin_flush(frame));
+  frame->unpin();
+
+  ASSERT_TRUE(frame_manager.begin_flush(frame));
+
+  // 写完之前，其它线程拿不到这个页帧
+  std::atomic<bool> got{false};
+  std::thread getter([&frame_manager, &got]() {
+    Frame *got_frame = frame_manager.get(file_desc, 1);
+    got              = true;
+    got_frame->unpin();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(got);
+
+  frame_manager.end_flush(frame);
+  getter.join();
+  ASSERT_TRUE(got);
+
+  frame_manager.free(file_desc, 1, frame);
+  frame_manager.cleanup();
+}
+
+TEST(test_page_allocator, test_page_allocator)
+{
+  const int64_t MEMORY_LIMIT = BPPageAllocator::CHUNK_SIZE * 2 + BP_PAGE_SIZE * 4;
+
+  BPPageAllocator allocator;
+  allocator.init(MEMORY_LIMIT, true/*use_huge_pages*/);
+
+  // 先按照整块映射，剩下不够一块的内存按照页面映射
+  std::vector<Page *> pages;
+  for (Page *page = allocator.alloc(BP_PAGE_SIZE); page != nullptr; page = allocator.alloc(BP_PAGE_SIZE)) {
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(page) % BPPageAllocator::PAGE_ALIGNMENT);
+    memset(page, 0xab, BP_PAGE_SIZE);
+    pages.push_back(page);
+  }
+  ASSERT_EQ(MEMORY_LIMIT / BP_PAGE_SIZE, static_cast<int64_t>(pages.size()));
+  ASSERT_EQ(MEMORY_LIMIT, allocator.allocated_memory());
+  ASSERT_EQ(MEMORY_LIMIT, allocator.used_memory());
+  ASSERT_LE(allocator.hugetlb_memory() + allocator.thp_memory(), BPPageAllocator::CHUNK_SIZE * 2);
+
+  // 整块释放以后可以切分给其它大小的页面
+  for (Page *page : pages) {
+    allocator.free(page, BP_PAGE_SIZE);
+  }
+  pages.clear();
+  ASSERT_EQ(0, allocator.used_memory());
+
+  const int BIG_PAGE_SIZE = BP_MAX_PAGE_SIZE;
+  for (Page *page = allocator.alloc(BIG_PAGE_SIZE); page != nullptr; page = allocator.alloc(BIG_PAGE_SIZE)) {
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(page) % BPPageAllocator::PAGE_ALIGNMENT);
+    memset(page, 0xcd, BIG_PAGE_SIZE);
+    pages.push_back(page);
+  }
+  ASSERT_EQ(BPPageAllocator::CHUNK_SIZE * 2 / BIG_PAGE_SIZE, static_cast<int64_t>(pages.size()));
+  ASSERT_LE(allocator.allocated_memory(), MEMORY_LIMIT);
+
+  // 调小上限以后，页面释放时把内存还给系统
+  allocator.set_memory_limit(BPPageAllocator::CHUNK_SIZE);
+  ASSERT_EQ(BPPageAllocator::CHUNK_SIZE, allocator.exceeded_memory());
+  ASSERT_EQ(nullptr, allocator.alloc(BP_PAGE_SIZE));
+  for (Page *page : pages) {
+    allocator.free(page, BIG_PAGE_SIZE);
+  }
+  ASSERT_EQ(0, allocator.exceeded_memory());
+  ASSERT_LE(allocator.allocated_memory(), BPPageAllocator::CHUNK_SIZE);
+}
+
+TEST(test_buffer_pool, test_page_cleaner)
+{
+  const char *file_name = "page_cleaner_test.bp";
+  ::remove(file_name);
+
+  // 只有一个内存池的页帧，页面写满以后，只有刷脏线程把脏页写到磁盘才能淘汰
+  BufferPoolOptions options;
+  options.memory_size              = DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
+  options.page_cleaner_interval_ms = 10;
+  BufferPoolManager bpm(options);
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  std::vector<PageNum> pages;
+  for (int i = 0; i < DEFAULT_ITEM_NUM_PER_POOL * 3; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    pages.push_back(frame->page_num());
+    bp->unpin_page(frame);
+  }
+  ASSERT_GT(bpm.page_cleaner().flushed_pages(), 0);
+
+  for (int i = 0; i < static_cast<int>(pages.size()); i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(pages[i], &frame));
+    ASSERT_EQ(i, *reinterpret_cast<int *>(frame->data()));
+    bp->unpin_page(frame);
+  }
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+/**
+ * @brief 读取磁盘上的页面。拿着 batch_lock 读，不会读到刷脏线程写了一半的页面
+ */
+static void read_disk_page(BufferPoolManager &bpm, int fd, PageNum page_num, Page &page)
+{
+  std::lock_guard<std::mutex> cleaner_guard(bpm.page_cleaner().batch_lock());
+  const off_t offset = static_cast<off_t>(page_num) * BP_PAGE_SIZE;
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(page)), ::pread(fd, &page, sizeof(page), offset));
+}
+
+/**
+ * @brief 页面数据是不是都等于 value，找到第一个不相等的位置
+ */
+static int first_mismatch(const Page &page, char value)
+{
+  for (int i = 0; i < BP_PAGE_DATA_SIZE; i++) {
+    if (page.data[i] != value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+TEST(test_buffer_pool, test_page_cleaner_with_writer)
+{
+  const char *file_name = "page_cleaner_writer_test.bp";
+  ::remove(file_name);
+
+  // 所有页帧都要保持干净，写者刚释放页面，刷脏线程就会去写
+  BufferPoolOptions options;
+  options.memory_size              = DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
+  options.clean_frame_target       = DEFAULT_ITEM_NUM_PER_POOL;
+  options.page_cleaner_interval_ms = 1;
+  BufferPoolManager bpm(options);
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int page_num = 4;
+  std::vector<PageNum> pages;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memset(frame->data(), 0, BP_PAGE_DATA_SIZE);
+    frame->mark_dirty();
+    pages.push_back(frame->page_num());
+    bp->unpin_page(frame);
+  }
+
+  int fd = ::open(file_name, O_RDONLY);
+  ASSERT_GE(fd, 0);
+  Page page;
+
+  // 页面只改了一半，还pin着，刷脏线程不能写
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(pages[0], &frame));
+  memset(frame->data(), 1, BP_PAGE_DATA_SIZE / 2);
+  frame->mark_dirty();
+  for (int i = 0; i < 10; i++) {
+    bpm.page_cleaner().wait_for_clean_frames();
+    read_disk_page(bpm, fd, pages[0], page);
+    ASSERT_NE(first_mismatch(page, 1), -1);
+  }
+  ASSERT_TRUE(frame->dirty());
+
+  memset(frame->data() + BP_PAGE_DATA_SIZE / 2, 1, BP_PAGE_DATA_SIZE - BP_PAGE_DATA_SIZE / 2);
+  bp->unpin_page(frame);
+  const auto flush_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  do {
+    bpm.page_cleaner().wait_for_clean_frames();
+    read_disk_page(bpm, fd, pages[0], page);
+  } while (first_mismatch(page, 1) != -1 && std::chrono::steady_clock::now() < flush_deadline);
+  ASSERT_EQ(first_mismatch(page, 1), -1);
+
+  // 写者每次把整个页面改成同一个字节，写到磁盘上的页面不能一半是旧的一半是新的
+  std::atomic<bool> stop{false};
+  std::thread writer([bp, &pages, &stop]() {
+    for (int round = 0; !stop; round++) {
+      Frame *writer_frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->get_this_page(pages[round % pages.size()], &writer_frame));
+      // 分两次修改页面，中间让出CPU，拉长页面不完整的时间
+      const int half = BP_PAGE_DATA_SIZE / 2;
+      memset(writer_frame->data(), round % 128, half);
+      std::this_thread::yield();
+      memset(writer_frame->data() + half, round % 128, BP_PAGE_DATA_SIZE - half);
+      writer_frame->mark_dirty();
+      bp->unpin_page(writer_frame);
+    }
+  });
+
+  const int64_t start_flushed = bpm.page_cleaner().flushed_pages();
+  const auto    deadline      = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (PageNum page_num : pages) {
+      read_disk_page(bpm, fd, page_num, page);
+      ASSERT_EQ(first_mismatch(page, page.data[0]), -1) << "page " << page_num << " is torn";
+    }
+  }
+  stop = true;
+  writer.join();
+  ::close(fd);
+  ASSERT_GT(bpm.page_cleaner().flushed_pages(), start_flushed);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_flush_and_read_ahead)
+{
+  const char *file_name = "read_ahead_test.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int page_count = 100;
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+
+  // 页号连续的脏页会合并在一起写
+  const int64_t write_pages = bpm.page_io().write_page_count();
+  const int64_t io_count    = bpm.page_io().io_count();
+  ASSERT_EQ(RC::SUCCESS, bp->flush_all_pages());
+  ASSERT_EQ(write_pages + page_count + 1, bpm.page_io().write_page_count());
+  ASSERT_LT(bpm.page_io().io_count() - io_count, 5);
+
+  // 换出所有的页面以后再预读
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(page_count / 2, bp->read_ahead(1, page_count / 2));
+  ASSERT_EQ(page_count / 2, bp->read_ahead(1, page_count));  // 前一半已经在内存中了
+  ASSERT_EQ(0, bp->read_ahead(page_count + 1, 10));
+
+  const int64_t read_pages = bpm.page_io().read_page_count();
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i + 1, &frame));
+    ASSERT_EQ(i, *reinterpret_cast<int *>(frame->data()));
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(read_pages, bpm.page_io().read_page_count());
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_close_file_after_write_failure)
+{
+  const char *file_name = "close_failure_test.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  // 把缓冲池的文件描述符换成只读的，写页面就会失败
+  const int fd       = bp->file_desc();
+  const int saved_fd = ::dup(fd);
+  ASSERT_GE(saved_fd, 0);
+  const int readonly_fd = ::open(file_name, O_RDONLY);
+  ASSERT_GE(readonly_fd, 0);
+  ASSERT_EQ(fd, ::dup2(readonly_fd, fd));
+  ::close(readonly_fd);
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  const PageNum page_num = frame->page_num();
+  const int     value    = 100;
+  memcpy(frame->data(), &value, sizeof(value));
+  frame->mark_dirty();
+  bp->unpin_page(frame);
+
+  // 关闭失败以后，文件头页面还pin着，脏页也还在内存中
+  ASSERT_NE(RC::SUCCESS, bp->close_file());
+  ASSERT_EQ(fd, bp->file_desc());
+
+  Frame *hdr_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(BP_HEADER_PAGE, &hdr_frame));
+  ASSERT_EQ(2, hdr_frame->pin_count());
+  bp->unpin_page(hdr_frame);
+
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+  ASSERT_TRUE(frame->dirty());
+  bp->unpin_page(frame);
+
+  // 恢复文件描述符以后再关闭一次
+  ASSERT_EQ(fd, ::dup2(saved_fd, fd));
+  ::close(saved_fd);
+  ASSERT_EQ(RC::SUCCESS, bp->close_file());
+
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+  ASSERT_EQ(value, *reinterpret_cast<int *>(frame->data()));
+  bp->unpin_page(frame);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_sequential_read_ahead)
+{
+  const char *file_name = "sequential_read_ahead_test.bp";
+  ::remove(file_name);
+
+  BufferPoolOptions options;
+  options.read_ahead_max_pages = 16;
+  BufferPoolManager bpm(options);
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  // 释放一部分页面，遍历时要跳过这些空洞
+  const int page_count = 200;
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  for (int i = 0; i < page_count; i += 7) {
+    ASSERT_EQ(RC::SUCCESS, bp->dispose_page(i + 1));
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int64_t read_pages = bpm.page_io().read_page_count();
+  const int64_t io_count   = bpm.page_io().io_count();
+
+  BufferPoolIterator iterator;
+  ASSERT_EQ(RC::SUCCESS, iterator.init(*bp));
+  iterator.enable_read_ahead(bp->read_ahead_max_pages());
+  int visited = 0;
+  while (iterator.has_next()) {
+    PageNum page_num = iterator.next();
+    if (page_num == BP_HEADER_PAGE) {
+      continue;
+    }
+    ASSERT_NE(0, (page_num - 1) % 7);
+
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+    ASSERT_EQ(page_num - 1, *reinterpret_cast<int *>(frame->data()));
+    bp->unpin_page(frame);
+    visited++;
+  }
+  ASSERT_EQ(page_count - (page_count + 6) / 7, visited);
+
+  // 每个页面只读了一次，并且大部分页面是批量读取的
+  ASSERT_EQ(read_pages + visited, bpm.page_io().read_page_count());
+  ASSERT_LT(bpm.page_io().io_count() - io_count, visited / 2);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_page_groups)
+{
+  const char *file_name = "page_groups_test.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  // 回放日志的方式填满第0组，不需要真的写这么多页面
+  const int pages_per_group = bp->pages_per_group();
+  for (PageNum page_num = 1; page_num < pages_per_group; page_num++) {
+    ASSERT_EQ(RC::SUCCESS, bp->recover_page(page_num));
+  }
+  ASSERT_EQ(pages_per_group, bp->page_count());
+
+  // 第0组满了，创建第1组，第1组的第一个页面是位图页
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(pages_per_group + 1, frame->page_num());
+  bp->unpin_page(frame);
+  ASSERT_EQ(RC::BUFFERPOOL_INVALID_PAGE_NUM, bp->dispose_page(pages_per_group));
+
+  // 释放的页面会被重新分配
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(5, &frame));
+  bp->unpin_page(frame);
+  ASSERT_EQ(RC::SUCCESS, bp->dispose_page(5));
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(5, frame->page_num());
+  bp->unpin_page(frame);
+
+  // 跨过几个组恢复一个页面，中间的组只有位图页
+  ASSERT_EQ(RC::SUCCESS, bp->recover_page(pages_per_group * 3 + 7));
+  ASSERT_EQ(pages_per_group * 3 + 8, bp->page_count());
+
+  // 遍历时跳过位图页
+  BufferPoolIterator iterator;
+  ASSERT_EQ(RC::SUCCESS, iterator.init(*bp, pages_per_group - 2));
+  std::vector<PageNum> pages;
+  while (iterator.has_next()) {
+    pages.push_back(iterator.next());
+  }
+  ASSERT_EQ(pages, (std::vector<PageNum>{pages_per_group - 1, pages_per_group + 1, pages_per_group * 3 + 7}));
+
+  // 重新打开文件以后，每个组的分配情况从位图中恢复
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(pages_per_group + 2, frame->page_num());
+  bp->unpin_page(frame);
+
+  int count = 0;
+  ASSERT_EQ(RC::SUCCESS, iterator.init(*bp));
+  while (iterator.has_next()) {
+    iterator.next();
+    count++;
+  }
+  ASSERT_EQ(pages_per_group - 1 + 3, count);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_page_size)
+{
+  const char *file_names[] = {"page_size_8k_test.bp", "page_size_32k_test.bp", "page_size_64k_test.bp"};
+  const int   page_sizes[] = {8 * 1024, 32 * 1024, 64 * 1024};
+  const int   FILE_NUM     = 3;
+  const int   PAGE_NUM     = 100;
+
+  // 内存放不下所有的页面，不同大小的页面互相淘汰
+  BufferPoolOptions options;
+  options.memory_size = DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE * 2;
+  BufferPoolManager bpm(options);
+
+  ASSERT_EQ(RC::INVALID_ARGUMENT, bpm.create_file("page_size_invalid_test.bp", 12 * 1024));
+
+  DiskBufferPool *bps[FILE_NUM];
+  for (int i = 0; i < FILE_NUM; i++) {
+    ::remove(file_names[i]);
+    ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_names[i], page_sizes[i]));
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_names[i], bps[i]));
+    ASSERT_EQ(page_sizes[i], bps[i]->page_size());
+    ASSERT_EQ(BPFileHeader::pages_per_group(page_sizes[i]), bps[i]->pages_per_group());
+  }
+
+  // 每个页面的最后几个字节也写上数据，检查整个页面都读写了
+  for (int n = 0; n < PAGE_NUM; n++) {
+    for (int i = 0; i < FILE_NUM; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bps[i]->allocate_page(&frame));
+      ASSERT_EQ(page_sizes[i], frame->page_size());
+      const int data_size = bps[i]->page_data_size();
+      *reinterpret_cast<int *>(frame->data())                 = frame->page_num() * 10 + i;
+      *reinterpret_cast<int *>(frame->data() + data_size - 4) = frame->page_num() * 10 + i;
+      frame->mark_dirty();
+      bps[i]->unpin_page(frame);
+    }
+  }
+
+  for (int i = 0; i < FILE_NUM; i++) {
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_names[i]));
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_names[i], bps[i]));
+    ASSERT_EQ(page_sizes[i], bps[i]->page_size());
+  }
+
+  for (int i = 0; i < FILE_NUM; i++) {
+    BufferPoolIterator iterator;
+    ASSERT_EQ(RC::SUCCESS, iterator.init(*bps[i]));
+    int count = 0;
+    while (iterator.has_next()) {
+      const PageNum page_num = iterator.next();
+      Frame        *frame    = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bps[i]->get_this_page(page_num, &frame));
+      const int data_size = bps[i]->page_data_size();
+      ASSERT_EQ(page_num * 10 + i, *reinterpret_cast<int *>(frame->data()));
+      ASSERT_EQ(page_num * 10 + i, *reinterpret_cast<int *>(frame->data() + data_size - 4));
+      bps[i]->unpin_page(frame);
+      count++;
+    }
+    ASSERT_EQ(PAGE_NUM, count);
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_names[i]));
+    ::remove(file_names[i]);
+  }
+}
+
+TEST(test_buffer_pool, test_legacy_file_header)
+{
+  // 以前的文件头没有页面大小，位图紧跟在已分配页面个数后面
+  const char *file_name = "legacy_header_test.bp";
+  ::remove(file_name);
+
+  Page page;
+  memset(&page, 0, sizeof(page));
+  int32_t *header = reinterpret_cast<int32_t *>(page.data);
+  header[0]       = 3;  // page count
+  header[1]       = 2;  // allocated pages
+  page.data[8]    = 0x01 | 0x04;
+  FILE *file      = fopen(file_name, "w");
+  ASSERT_NE(nullptr, file);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(1, fwrite(&page, sizeof(page), 1, file));
+  }
+  fclose(file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool   *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(BP_PAGE_SIZE, bp->page_size());
+  ASSERT_EQ(BPFileHeader::LEGACY_PAGES_PER_GROUP, bp->pages_per_group());
+
+  // 页面2已经分配，新分配的是页面1
+  BufferPoolIterator iterator;
+  ASSERT_EQ(RC::SUCCESS, iterator.init(*bp));
+  ASSERT_TRUE(iterator.has_next());
+  ASSERT_EQ(2, iterator.next());
+  ASSERT_FALSE(iterator.has_next());
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(1, frame->page_num());
+  bp->unpin_page(frame);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_concurrent_load)
+{
+  const char *file_name = "concurrent_load_test.bp";
+  ::remove(file_name);
+
+  const int PAGE_NUM   = 200;
+  const int THREAD_NUM = 8;
+
+  BufferPoolManager bpm;
+  DiskBufferPool   *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  for (int i = 0; i < PAGE_NUM; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    *reinterpret_cast<PageNum *>(frame->data()) = frame->page_num();
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  // 所有线程同时读取同样的页面，每个页面只会从磁盘读取一次
+  const int64_t    read_pages = bpm.page_io().read_page_count();
+  std::atomic<int> errors{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREAD_NUM; t++) {
+    threads.emplace_back([bp, t, &errors]() {
+      for (int i = 0; i < PAGE_NUM; i++) {
+        const PageNum page_num = (t % 2 == 0) ? i + 1 : PAGE_NUM - i;
+        Frame        *frame    = nullptr;
+        if (bp->get_this_page(page_num, &frame) != RC::SUCCESS) {
+          errors++;
+          continue;
+        }
+        if (*reinterpret_cast<PageNum *>(frame->data()) != page_num) {
+          errors++;
+        }
+        bp->unpin_page(frame);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, errors.load());
+  ASSERT_EQ(read_pages + PAGE_NUM, bpm.page_io().read_page_count());
+
+  // 读取文件尾之后的页面失败，不会留下不能使用的页帧
+  Frame *frame = nullptr;
+  ASSERT_NE(RC::SUCCESS, bp->get_this_page(PAGE_NUM + 10, &frame));
+  ASSERT_NE(RC::SUCCESS, bp->get_this_page(PAGE_NUM + 10, &frame));
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(PAGE_NUM + 1, frame->page_num());
+  bp->unpin_page(frame);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_warm_up)
+{
+  const char *file_name      = "warm_up_test.bp";
+  const char *page_list_file = "warm_up_test.pages";
+  ::remove(file_name);
+  ::remove(page_list_file);
+
+  const int PAGE_NUM = 300;
+
+  std::vector<PageNum> hot_pages;
+  {
+    BufferPoolManager bpm;
+    DiskBufferPool   *bp = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+    for (int i = 0; i < PAGE_NUM; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+      frame->mark_dirty();
+      bp->unpin_page(frame);
+    }
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+    // 重新打开以后只访问一部分页面，其中有连续的也有不连续的
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+    for (PageNum page_num = 1; page_num <= PAGE_NUM; page_num++) {
+      if (page_num < 100 || page_num % 7 == 0) {
+        Frame *frame = nullptr;
+        ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+        bp->unpin_page(frame);
+        hot_pages.push_back(page_num);
+      }
+    }
+    ASSERT_EQ(RC::SUCCESS, bpm.page_warmer().dump(page_list_file));
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  }
+
+  BufferPoolManager bpm;
+  DiskBufferPool   *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.page_warmer().warm_up(page_list_file, 4));
+  ASSERT_EQ(static_cast<int64_t>(hot_pages.size()), bpm.page_warmer().warmed_pages());
+
+  // 预热过的页面都在内存中，不需要再读磁盘
+  const int64_t read_pages = bpm.page_io().read_page_count();
+  for (PageNum page_num : hot_pages) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(read_pages, bpm.page_io().read_page_count());
+
+  // 没有页面列表文件时什么都不做
+  ASSERT_EQ(RC::SUCCESS, bpm.page_warmer().warm_up("no_such_warm_up_test.pages", 2));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+  ::remove(page_list_file);
+}
+
+TEST(test_buffer_pool, test_resize)
+{
+  const char *file_name = "resize_test.bp";
+  ::remove(file_name);
+
+  const int64_t POOL_MEMORY = static_cast<int64_t>(DEFAULT_ITEM_NUM_PER_POOL) * BP_PAGE_SIZE;
+  const int     PAGE_NUM    = DEFAULT_ITEM_NUM_PER_POOL * 3;
+
+  BufferPoolOptions options;
+  options.memory_size              = static_cast<int>(POOL_MEMORY * 4);
+  options.page_cleaner_interval_ms = 10;
+  BufferPoolManager bpm(options);
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  std::vector<PageNum> pages;
+  for (int i = 0; i < PAGE_NUM; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    pages.push_back(frame->page_num());
+    bp->unpin_page(frame);
+  }
+  ASSERT_GT(bpm.used_memory(), POOL_MEMORY * 2);
+
+  // 调小以后，刷脏线程在后台把脏页写到磁盘并淘汰多出来的页面
+  ASSERT_EQ(RC::INVALID_ARGUMENT, bpm.resize(POOL_MEMORY - 1));
+  ASSERT_EQ(RC::SUCCESS, bpm.resize(POOL_MEMORY));
+  ASSERT_EQ(POOL_MEMORY, bpm.memory_size());
+  for (int i = 0; i < 500 && bpm.used_memory() > POOL_MEMORY; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_LE(bpm.used_memory(), POOL_MEMORY);
+
+  for (int i = 0; i < PAGE_NUM; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(pages[i], &frame));
+    ASSERT_EQ(i, *reinterpret_cast<int *>(frame->data()));
+    bp->unpin_page(frame);
+  }
+  ASSERT_LE(bpm.used_memory(), POOL_MEMORY);
+
+  // 调大以后所有页面都可以留在内存中
+  ASSERT_EQ(RC::SUCCESS, bpm.resize(POOL_MEMORY * 8));
+  for (int i = 0; i < PAGE_NUM; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(pages[i], &frame));
+    bp->unpin_page(frame);
+  }
+  const int64_t read_pages = bpm.page_io().read_page_count();
+  for (int i = 0; i < PAGE_NUM; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(pages[i], &frame));
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(read_pages, bpm.page_io().read_page_count());
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_direct_io)
+{
+  const char *file_name = "direct_io_test.bp";
+  ::remove(file_name);
+
+  const int PAGE_NUM = DEFAULT_ITEM_NUM_PER_POOL * 2;
+
+  // 内存放不下所有的页面，写脏页和读页面都要经过磁盘。文件系统不支持 O_DIRECT 时跳过
+  BufferPoolOptions options;
+  options.memory_size              = DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
+  options.page_cleaner_interval_ms = 10;
+  options.read_ahead_max_pages     = 16;
+  options.direct_io                = true;
+  BufferPoolManager bpm(options);
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name, 16 * 1024));
+
+  const int fd = open(file_name, O_RDWR | O_DIRECT);
+  if (fd < 0) {
+    ASSERT_EQ(EINVAL, errno);
+    ::remove(file_name);
+    GTEST_SKIP() << "file system does not support O_DIRECT";
+  }
+  close(fd);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_TRUE(bp->direct_io());
+
+  for (int i = 0; i < PAGE_NUM; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_TRUE(bp->direct_io());
+  BufferPoolIterator iterator;
+  ASSERT_EQ(RC::SUCCESS, iterator.init(*bp));
+  int count = 0;
+  while (iterator.has_next()) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(iterator.next(), &frame));
+    ASSERT_EQ(count, *reinterpret_cast<int *>(frame->data()));
+    bp->unpin_page(frame);
+    count++;
+  }
+  ASSERT_EQ(PAGE_NUM, count);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_latency_histogram)
+{
+  BPLatencyHistogram histogram;
+  ASSERT_EQ(0, BPLatencyHistogram::bucket_of(0));
+  ASSERT_EQ(1, BPLatencyHistogram::bucket_of(1));
+  ASSERT_EQ(2, BPLatencyHistogram::bucket_of(3));
+  ASSERT_EQ(BPLatencyHistogram::BUCKET_NUM - 1, BPLatencyHistogram::bucket_of(INT64_MAX));
+
+  for (int i = 0; i < 99; i++) {
+    histogram.record(10);
+  }
+  histogram.record(1000);
+
+  BPLatencyHistogram::Summary summary;
+  histogram.summary(summary);
+  ASSERT_EQ(100, summary.count);
+  ASSERT_EQ(99 * 10 + 1000, summary.sum_us);
+  ASSERT_EQ(16, summary.percentile_us(50));
+  ASSERT_EQ(16, summary.percentile_us(99));
+  ASSERT_EQ(1024, summary.percentile_us(100));
+
+  // 不同线程记录在不同的分片上，读取时合在一起
+  BPShardedCounter counter;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&counter]() {
+      for (int i = 0; i < 1000; i++) {
+        counter.add();
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(4000, counter.value());
+}
+
+TEST(test_buffer_pool, test_stats)
+{
+  const char *file_name = "stats_test.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int page_count = 10;
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  const int64_t page_writes = bp->stats().page_writes();
+  ASSERT_EQ(RC::SUCCESS, bp->flush_all_pages());
+  ASSERT_EQ(page_writes + page_count + 1, bp->stats().page_writes());
+  ASSERT_EQ(bp->stats().page_writes(), bpm.stats().page_writes());
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  // 重新打开以后，第一次访问需要读磁盘，第二次命中
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  const BufferPoolStats &stats = bp->stats();
+  const int64_t hits          = stats.hits();
+  const int64_t misses        = stats.misses();
+  const int64_t global_hits   = bpm.stats().hits();
+  const int64_t global_misses = bpm.stats().misses();
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < page_count; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i + 1, &frame));
+      bp->unpin_page(frame);
+    }
+  }
+  ASSERT_EQ(misses + page_count, stats.misses());
+  ASSERT_GE(stats.hits() - hits, page_count);
+  ASSERT_GE(stats.page_reads(), page_count);
+  ASSERT_EQ(global_misses + page_count, bpm.stats().misses());
+  ASSERT_EQ(global_hits + stats.hits() - hits, bpm.stats().hits());
+
+  BPLatencyHistogram::Summary summary;
+  stats.read_latency().summary(summary);
+  ASSERT_GE(summary.count, page_count);
+
+  std::vector<BPStatusItem> items;
+  bpm.status(items);
+  bool found_global = false;
+  bool found_file   = false;
+  for (const BPStatusItem &item : items) {
+    if (item.scope == "global" && item.name == "hit_ratio") {
+      found_global = true;
+    }
+    if (item.scope == file_name && item.name == "misses") {
+      found_file = true;
+      ASSERT_EQ(std::to_string(stats.misses()), item.value);
+    }
+  }
+  ASSERT_TRUE(found_global);
+  ASSERT_TRUE(found_file);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
 int main(int argc, char **argv)
 {
 
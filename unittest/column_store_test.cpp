@@ -0,0 +1,298 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/column/column_segment.h"
+#include "storage/column/column_store.h"
+#include "storage/common/meta_util.h"
+#include "storage/trx/vacuous_trx.h"
+
+using namespace std;
+using namespace common;
+
+static const CompOp ALL_COMP_OPS[] = {EQUAL_TO, LESS_EQUAL, NOT_EQUAL, LESS_THAN, GREAT_EQUAL, GREAT_THAN};
+
+/**
+ * @brief 编码以后过滤的结果要与逐个值比较的结果一样
+ */
+static void check_filter(const ColumnSegment &segment, AttrType type, const vector<char> &values, const Value &value)
+{
+  const int row_num   = segment.row_num();
+  const int value_len = segment.value_len();
+  for (CompOp comp : ALL_COMP_OPS) {
+    vector<uint8_t> selection(row_num, 1);
+    segment.filter(type, comp, value, selection.data());
+    for (int row = 0; row < row_num; row++) {
+      Value field_value;
+      field_value.set_type(type);
+      field_value.set_data(const_cast<char *>(values.data()) + row * value_len, value_len);
+      const int  cmp      = field_value.compare(value);
+      const bool expected = (comp == EQUAL_TO && cmp == 0) || (comp == LESS_EQUAL && cmp <= 0) ||
+                            (comp == NOT_EQUAL && cmp != 0) || (comp == LESS_THAN && cmp < 0) ||
+                            (comp == GREAT_EQUAL && cmp >= 0) || (comp == GREAT_THAN && cmp > 0);
+      ASSERT_EQ(selection[row] != 0, expected) << "comp=" << comp << ", row=" << row;
+    }
+  }
+}
+
+/**
+ * @brief 写满一个段，编码以后检查编码方式、取值和过滤
+ */
+static void check_segment(AttrType type, int value_len, const vector<char> &values, ColumnEncoding expected,
+                          const vector<Value> &filter_values)
+{
+  const int    page_data_size = BP_PAGE_DATA_SIZE;
+  vector<char> page(page_data_size, 0);
+  const int    row_num = static_cast<int>(values.size()) / value_len;
+
+  ColumnSegment segment(page.data(), page_data_size);
+  segment.init(value_len);
+  ASSERT_TRUE(segment.inited());
+  for (int row = 0; row < row_num; row++) {
+    segment.set(row, values.data() + row * value_len);
+  }
+  ASSERT_EQ(segment.row_num(), row_num);
+
+  segment.seal(type);
+  ASSERT_EQ(segment.encoding(), expected);
+  ASSERT_EQ(segment.row_num(), row_num);
+  if (expected != ColumnEncoding::PLAIN) {
+    ASSERT_LT(segment.used_size(), static_cast<int>(sizeof(ColumnSegmentHeader)) + row_num * value_len);
+  }
+
+  vector<char> decoded(values.size());
+  segment.decode(decoded.data());
+  ASSERT_EQ(0, memcmp(decoded.data(), values.data(), values.size()));
+
+  vector<char> value(value_len);
+  for (int row = 0; row < row_num; row += 7) {
+    segment.get(row, value.data());
+    ASSERT_EQ(0, memcmp(value.data(), values.data() + row * value_len, value_len));
+  }
+
+  // 编码以后的段不能修改成别的值
+  ASSERT_EQ(segment.update(0, values.data()), RC::SUCCESS);
+  if (expected != ColumnEncoding::PLAIN) {
+    vector<char> other_value(value_len, 'z');
+    ASSERT_EQ(segment.update(0, other_value.data()), RC::UNIMPLENMENT);
+  }
+
+  for (const Value &filter_value : filter_values) {
+    check_filter(segment, type, values, filter_value);
+  }
+}
+
+TEST(test_column_store, test_column_segment)
+{
+  const int row_num = ColumnSegment::plain_capacity(BP_PAGE_DATA_SIZE, 8);
+
+  // 取值范围很小的整数用 FOR 编码
+  vector<char> ints(row_num * 4);
+  for (int i = 0; i < row_num; i++) {
+    const int value = 100000 + (i * 37) % 200;
+    memcpy(ints.data() + i * 4, &value, 4);
+  }
+  check_segment(INTS, 4, ints, ColumnEncoding::FOR,
+                {Value(100000), Value(100100), Value(100199), Value(99999), Value(200000), Value(100050.5f)});
+
+  // 连续相同的值用 RLE 编码
+  for (int i = 0; i < row_num; i++) {
+    const int value = i / 100 - 3;
+    memcpy(ints.data() + i * 4, &value, 4);
+  }
+  check_segment(INTS, 4, ints, ColumnEncoding::RLE, {Value(-3), Value(0), Value(2), Value(1000), Value(0.5f)});
+
+  // 不同的值很少的字符串用字典编码
+  const char  *names[] = {"alpha", "beta", "gamma", "delta", "epsilon"};
+  vector<char> chars(row_num * 8, 0);
+  for (int i = 0; i < row_num; i++) {
+    strcpy(chars.data() + i * 8, names[(i * 7) % 5]);
+  }
+  check_segment(CHARS, 8, chars, ColumnEncoding::DICT,
+                {Value("beta"), Value("gamma"), Value("a"), Value("zeta"), Value("delta1")});
+
+  // 不能压缩的数据保持原样
+  vector<char> floats(row_num * 4);
+  for (int i = 0; i < row_num; i++) {
+    const float value = i * 1.37f - 100.0f;
+    memcpy(floats.data() + i * 4, &value, 4);
+  }
+  check_segment(FLOATS, 4, floats, ColumnEncoding::PLAIN, {Value(0.0f), Value(-50.0f), Value(3)});
+}
+
+TEST(test_column_store, test_column_store)
+{
+  const char *table_name     = "column_store_test";
+  const char *directory_file = "column_store_test.data";
+
+  // | sys int | id int | g int | name char(8) | f float |
+  vector<FieldMeta> fields;
+  fields.emplace_back("__trx", INTS, 0, 4, false);
+  fields.emplace_back("id", INTS, 4, 4, true);
+  fields.emplace_back("g", INTS, 8, 4, true);
+  fields.emplace_back("name", CHARS, 12, 8, true);
+  fields.emplace_back("f", FLOATS, 20, 4, true);
+  const int record_size = 24;
+
+  ::remove(directory_file);
+  for (const FieldMeta &field : fields) {
+    ::remove(table_column_file(".", table_name, field.name()).c_str());
+  }
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  BufferPoolManager::set_instance(bpm);
+  ASSERT_EQ(bpm->create_file(directory_file), RC::SUCCESS);
+  ASSERT_EQ(ColumnStore::create_files(".", table_name, fields), RC::SUCCESS);
+
+  DiskBufferPool *directory = nullptr;
+  ASSERT_EQ(bpm->open_file(directory_file, directory), RC::SUCCESS);
+
+  ColumnStore *store = new ColumnStore();
+  ASSERT_EQ(store->open(".", table_name, directory, fields, 1 /*sys_field_num*/, record_size), RC::SUCCESS);
+  const int capacity = store->row_group_capacity();
+  ASSERT_GT(capacity, 0);
+
+  // 写满两个行组，第三个行组只有一部分，前两个行组会编码
+  const char  *names[]  = {"a", "b", "c"};
+  const int    row_num  = capacity * 2 + 100;
+  vector<char> data(static_cast<size_t>(row_num) * record_size, 0);
+  vector<const char *> datas;
+  for (int i = 0; i < row_num; i++) {
+    char *record = data.data() + static_cast<size_t>(i) * record_size;
+    const int   g = i / 300;
+    const float f = i * 0.37f;
+    memcpy(record + 4, &i, 4);
+    memcpy(record + 8, &g, 4);
+    strcpy(record + 12, names[i % 3]);
+    memcpy(record + 20, &f, 4);
+    datas.push_back(record);
+  }
+
+  vector<RID> rids;
+  ASSERT_EQ(store->insert_records(vector<const char *>(datas.begin(), datas.begin() + 10), rids), RC::SUCCESS);
+  vector<RID> more_rids;
+  ASSERT_EQ(store->insert_records(vector<const char *>(datas.begin() + 10, datas.end()), more_rids), RC::SUCCESS);
+  rids.insert(rids.end(), more_rids.begin(), more_rids.end());
+  ASSERT_EQ(static_cast<int>(rids.size()), row_num);
+  ASSERT_EQ(rids[capacity].page_num, rids[0].page_num + 1);
+  ASSERT_EQ(rids[capacity].slot_num, 0);
+
+  ASSERT_NE(store->encoding_summary(1).find("for:2"), string::npos) << store->encoding_summary(1);
+  ASSERT_NE(store->encoding_summary(2).find("rle:2"), string::npos) << store->encoding_summary(2);
+  ASSERT_NE(store->encoding_summary(3).find("dict:2"), string::npos) << store->encoding_summary(3);
+  ASSERT_EQ(store->encoding_summary(0), "plain:3");
+
+  for (int i = 0; i < row_num; i += 5) {
+    ASSERT_EQ(store->delete_record(rids[i]), RC::SUCCESS);
+  }
+  ASSERT_EQ(store->delete_record(rids[0]), RC::RECORD_NOT_EXIST);
+
+  char record[record_size];
+  ASSERT_EQ(store->copy_record(rids[0], record), RC::RECORD_NOT_EXIST);
+  ASSERT_EQ(store->copy_record(rids[1], record), RC::SUCCESS);
+  ASSERT_EQ(0, memcmp(record, datas[1], record_size));
+
+  // 系统字段一直可以修改，编码以后的字段不能修改
+  ASSERT_EQ(store->visit_record(rids[1], false /*readonly*/, [](Record &r) { *reinterpret_cast<int *>(r.data()) = 5; }),
+            RC::SUCCESS);
+  ASSERT_EQ(store->visit_record(rids[1], false /*readonly*/, [](Record &r) { *reinterpret_cast<int *>(r.data() + 4) = -1; }),
+            RC::UNIMPLENMENT);
+  ASSERT_EQ(store->copy_record(rids[1], record), RC::SUCCESS);
+  ASSERT_EQ(*reinterpret_cast<int *>(record), 5);
+
+  // 最后一个行组还没有编码，可以修改
+  const int last = (row_num - 1) % 5 == 0 ? row_num - 2 : row_num - 1;
+  ASSERT_EQ(store->visit_record(rids[last], false /*readonly*/, [](Record &r) { *reinterpret_cast<int *>(r.data() + 4) = -1; }),
+            RC::SUCCESS);
+  ASSERT_EQ(store->copy_record(rids[last], record), RC::SUCCESS);
+  ASSERT_EQ(*reinterpret_cast<int *>(record + 4), -1);
+  ASSERT_EQ(store->visit_record(rids[last], false /*readonly*/, [last](Record &r) { memcpy(r.data() + 4, &last, 4); }),
+            RC::SUCCESS);
+
+  auto scan = [&](ColumnStore &column_store, vector<ColumnCondition> conditions, vector<int> columns, int &count) {
+    VacuousTrx    trx;
+    ColumnScanner scanner;
+    ASSERT_EQ(scanner.open_scan(nullptr /*table*/, column_store, &trx, true /*readonly*/, conditions, columns),
+              RC::SUCCESS);
+
+    count = 0;
+    Record scan_record;
+    while (scanner.has_next()) {
+      ASSERT_EQ(scanner.next(scan_record), RC::SUCCESS);
+      const int i = *reinterpret_cast<const int *>(scan_record.data() + 4);
+      ASSERT_NE(i % 5, 0);
+      if (columns.empty()) {
+        ASSERT_EQ(0, memcmp(scan_record.data() + 8, datas[i] + 8, record_size - 8));
+      } else {
+        // 没有读取的字段都是0
+        ASSERT_EQ(*reinterpret_cast<const int *>(scan_record.data() + 8), 0);
+      }
+      count++;
+    }
+    ASSERT_EQ(scanner.rows_selected(), count);
+    ASSERT_EQ(scanner.close_scan(), RC::SUCCESS);
+  };
+
+  const int live_num = row_num - (row_num + 4) / 5;
+  int       count    = 0;
+  scan(*store, {}, {}, count);
+  ASSERT_EQ(count, live_num);
+
+  ColumnCondition g_condition;
+  g_condition.column = 2;
+  g_condition.comp   = EQUAL_TO;
+  g_condition.value  = Value(1);
+  ColumnCondition name_condition;
+  name_condition.column = 3;
+  name_condition.comp   = NOT_EQUAL;
+  name_condition.value  = Value("b");
+
+  int expected = 0;
+  for (int i = 0; i < row_num; i++) {
+    expected += (i % 5 != 0 && i / 300 == 1 && i % 3 != 1) ? 1 : 0;
+  }
+  scan(*store, {g_condition, name_condition}, {0, 1}, count);
+  ASSERT_EQ(count, expected);
+
+  // 重新打开以后数据不变
+  ASSERT_EQ(store->sync(), RC::SUCCESS);
+  delete store;
+  store = new ColumnStore();
+  ASSERT_EQ(store->open(".", table_name, directory, fields, 1 /*sys_field_num*/, record_size), RC::SUCCESS);
+  scan(*store, {}, {}, count);
+  ASSERT_EQ(count, live_num);
+
+  RID rid;
+  ASSERT_EQ(store->insert_record(datas[5], rid), RC::SUCCESS);
+  ASSERT_EQ(rid.page_num, rids.back().page_num);
+  ASSERT_EQ(rid.slot_num, rids.back().slot_num + 1);
+
+  delete store;
+  directory->close_file();
+  delete bpm;
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,172 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <memory>
+#include <vector>
+
+#include "storage/buffer/frame.h"
+#include "storage/buffer/frame_replacer.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+/**
+ * @brief 返回淘汰策略给出的前 count 个页帧
+ */
+vector<Frame *> victims(FrameReplacer &replacer, size_t count)
+{
+  vector<Frame *> result;
+  replacer.foreach_victim([&result, count](Frame *frame) {
+    result.push_back(frame);
+    return result.size() < count;
+  });
+  return result;
+}
+
+TEST(test_frame_replacer, test_create)
+{
+  unique_ptr<FrameReplacer> replacer(FrameReplacer::create(nullptr));
+  ASSERT_NE(nullptr, dynamic_cast<LruFrameReplacer *>(replacer.get()));
+
+  replacer.reset(FrameReplacer::create("CLOCK"));
+  ASSERT_NE(nullptr, dynamic_cast<ClockFrameReplacer *>(replacer.get()));
+
+  replacer.reset(FrameReplacer::create("lru-k"));
+  ASSERT_NE(nullptr, dynamic_cast<LruKFrameReplacer *>(replacer.get()));
+
+  replacer.reset(FrameReplacer::create("not-exists"));
+  ASSERT_EQ(nullptr, replacer.get());
+}
+
+TEST(test_frame_replacer, test_lru)
+{
+  Frame frames[4];
+  LruFrameReplacer replacer;
+  for (int i = 0; i < 3; i++) {
+    replacer.insert(&frames[i], false);
+  }
+  replacer.access(&frames[0]);
+  ASSERT_EQ(victims(replacer, 3), (vector<Frame *>{&frames[1], &frames[2], &frames[0]}));
+
+  // 冷页面最先被淘汰
+  replacer.insert(&frames[3], true);
+  ASSERT_EQ(&frames[3], victims(replacer, 1)[0]);
+
+  replacer.remove(&frames[3]);
+  replacer.remove(&frames[1]);
+  ASSERT_EQ(2, replacer.size());
+  ASSERT_EQ(victims(replacer, 3), (vector<Frame *>{&frames[2], &frames[0]}));
+}
+
+TEST(test_frame_replacer, test_clock)
+{
+  Frame frames[4];
+  ClockFrameReplacer replacer;
+  for (int i = 0; i < 3; i++) {
+    replacer.insert(&frames[i], true);
+  }
+
+  // 有访问标识的页帧会得到第二次机会
+  replacer.access(&frames[0]);
+  ASSERT_EQ(&frames[1], victims(replacer, 1)[0]);
+  ASSERT_EQ(&frames[2], victims(replacer, 1)[0]);
+  ASSERT_EQ(&frames[0], victims(replacer, 1)[0]);
+
+  replacer.remove(&frames[1]);
+  replacer.insert(&frames[3], false);
+  ASSERT_EQ(3, replacer.size());
+
+  // 转动一圈可以看到所有的页帧，每个页帧只出现一次
+  ASSERT_EQ(3, victims(replacer, 10).size());
+}
+
+TEST(test_frame_replacer, test_lru_k)
+{
+  Frame frames[5];
+  LruKFrameReplacer replacer(2);
+  for (int i = 0; i < 4; i++) {
+    replacer.insert(&frames[i], false);
+  }
+
+  // frames[0] 和 frames[1] 访问了两次，是热点页面。它们之间按照倒数第二次访问的时间排序
+  replacer.access(&frames[1]);
+  replacer.access(&frames[0]);
+  ASSERT_EQ(victims(replacer, 4), (vector<Frame *>{&frames[2], &frames[3], &frames[0], &frames[1]}));
+
+  // 扫描加载的冷页面排在最前面
+  replacer.insert(&frames[4], true);
+  ASSERT_EQ(&frames[4], victims(replacer, 1)[0]);
+
+  // frames[0] 的倒数第二次访问时间仍然是最早的
+  replacer.access(&frames[1]);
+  ASSERT_EQ(victims(replacer, 5), (vector<Frame *>{&frames[4], &frames[2], &frames[3], &frames[0], &frames[1]}));
+
+  replacer.remove(&frames[4]);
+  replacer.remove(&frames[0]);
+  ASSERT_EQ(3, replacer.size());
+  ASSERT_EQ(victims(replacer, 5), (vector<Frame *>{&frames[2], &frames[3], &frames[1]}));
+}
+
+TEST(test_frame_replacer, test_references)
+{
+  // 页帧上的访问标识在遍历淘汰候选时处理：先跳过，记录一次访问以后作为最后的候选
+  {
+    Frame frames[3];
+    LruFrameReplacer replacer;
+    for (int i = 0; i < 3; i++) {
+      replacer.insert(&frames[i], false);
+    }
+    frames[0].access();
+    ASSERT_EQ(&frames[1], victims(replacer, 1)[0]);
+    ASSERT_FALSE(frames[0].referenced());
+    ASSERT_EQ(victims(replacer, 3), (vector<Frame *>{&frames[1], &frames[2], &frames[0]}));
+
+    // 后台收集以后的顺序和直接调用 access 一样
+    frames[1].access();
+    frames[2].access();
+    replacer.sync_references();
+    ASSERT_FALSE(frames[1].referenced());
+    ASSERT_EQ(victims(replacer, 3), (vector<Frame *>{&frames[0], &frames[1], &frames[2]}));
+  }
+
+  {
+    Frame frames[3];
+    ClockFrameReplacer replacer;
+    for (int i = 0; i < 3; i++) {
+      replacer.insert(&frames[i], true);
+    }
+    frames[0].access();
+    ASSERT_EQ(victims(replacer, 3), (vector<Frame *>{&frames[1], &frames[2], &frames[0]}));
+  }
+
+  {
+    Frame frames[3];
+    LruKFrameReplacer replacer(2);
+    for (int i = 0; i < 3; i++) {
+      replacer.insert(&frames[i], false);
+    }
+    // 同一轮中的多次访问只算一次
+    frames[1].access();
+    frames[1].access();
+    replacer.sync_references();
+    frames[0].access();
+    ASSERT_EQ(victims(replacer, 3), (vector<Frame *>{&frames[2], &frames[1], &frames[0]}));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
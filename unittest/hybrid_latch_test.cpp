@@ -0,0 +1,171 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "common/lang/hybrid_latch.h"
+
+using namespace common;
+
+/**
+ * @brief 在另一个线程上尝试加读锁，当前线程持有的读锁会重入，不能用来检查别的线程能不能加锁
+ */
+static bool try_lock_shared_in_other_thread(HybridLatch &latch)
+{
+  bool locked = false;
+  std::thread thread([&latch, &locked]() {
+    locked = latch.try_lock_shared();
+    if (locked) {
+      latch.unlock_shared();
+    }
+  });
+  thread.join();
+  return locked;
+}
+
+/**
+ * @brief 等待写者设置写锁标记
+ */
+static void wait_writer_waiting(HybridLatch &latch)
+{
+  while (!latch.is_locked()) {
+    std::this_thread::yield();
+  }
+}
+
+TEST(hybrid_latch, test_version_increments_on_unlock)
+{
+  HybridLatch latch;
+  ASSERT_EQ(latch.version(), 0UL);
+
+  latch.lock();
+  ASSERT_TRUE(latch.is_locked());
+  ASSERT_EQ(latch.version(), 0UL);
+  latch.unlock();
+  ASSERT_FALSE(latch.is_locked());
+  ASSERT_EQ(latch.version(), 1UL);
+
+  ASSERT_TRUE(latch.try_lock());
+  latch.unlock();
+  ASSERT_EQ(latch.version(), 2UL);
+
+  // 读锁不改变版本号
+  latch.lock_shared();
+  latch.unlock_shared();
+  ASSERT_EQ(latch.version(), 2UL);
+}
+
+TEST(hybrid_latch, test_validate_fails_after_write)
+{
+  HybridLatch latch;
+
+  uint64_t version = 0;
+  ASSERT_TRUE(latch.try_optimistic_read(version));
+  ASSERT_TRUE(latch.validate(version));
+
+  // 读锁不影响乐观读
+  latch.lock_shared();
+  ASSERT_TRUE(latch.validate(version));
+  latch.unlock_shared();
+
+  latch.lock();
+  ASSERT_FALSE(latch.validate(version));
+  uint64_t locked_version = 0;
+  ASSERT_FALSE(latch.try_optimistic_read(locked_version));
+  latch.unlock();
+  ASSERT_FALSE(latch.validate(version));
+
+  ASSERT_TRUE(latch.try_optimistic_read(version));
+  ASSERT_TRUE(latch.validate(version));
+}
+
+TEST(hybrid_latch, test_try_lock_fails_with_shared)
+{
+  HybridLatch latch;
+
+  latch.lock_shared();
+  ASSERT_EQ(latch.shared_count(), 1);
+  ASSERT_FALSE(latch.try_lock());
+  ASSERT_FALSE(latch.is_locked());
+  ASSERT_TRUE(try_lock_shared_in_other_thread(latch));
+  latch.unlock_shared();
+
+  ASSERT_EQ(latch.shared_count(), 0);
+  ASSERT_TRUE(latch.try_lock());
+  ASSERT_FALSE(latch.try_lock());
+  ASSERT_FALSE(try_lock_shared_in_other_thread(latch));
+  latch.unlock();
+}
+
+TEST(hybrid_latch, test_waiting_writer_blocks_readers)
+{
+  HybridLatch latch;
+  latch.lock_shared();
+
+  std::atomic<bool> writer_locked{false};
+  std::thread       writer([&latch, &writer_locked]() {
+    latch.lock();
+    writer_locked = true;
+    latch.unlock();
+  });
+
+  // 写者设置了写锁标记，还在等已有的读锁释放，别的线程不能再加读锁
+  wait_writer_waiting(latch);
+  ASSERT_FALSE(writer_locked);
+  ASSERT_FALSE(try_lock_shared_in_other_thread(latch));
+
+  latch.unlock_shared();
+  writer.join();
+  ASSERT_TRUE(writer_locked);
+  ASSERT_EQ(latch.version(), 1UL);
+  ASSERT_TRUE(try_lock_shared_in_other_thread(latch));
+}
+
+TEST(hybrid_latch, test_shared_reentry_with_waiting_writer)
+{
+  HybridLatch latch;
+  latch.lock_shared();
+
+  std::atomic<bool> writer_locked{false};
+  std::thread       writer([&latch, &writer_locked]() {
+    latch.lock();
+    writer_locked = true;
+    latch.unlock();
+  });
+  wait_writer_waiting(latch);
+
+  // 已经持有读锁的线程可以重入，不会被等待中的写者挡住
+  latch.lock_shared();
+  ASSERT_TRUE(latch.try_lock_shared());
+  ASSERT_EQ(latch.shared_count(), 1);
+
+  latch.unlock_shared();
+  latch.unlock_shared();
+  ASSERT_EQ(latch.shared_count(), 1);
+  ASSERT_FALSE(writer_locked);
+
+  latch.unlock_shared();
+  writer.join();
+  ASSERT_TRUE(writer_locked);
+  ASSERT_EQ(latch.shared_count(), 0);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/common/meta_util.h"
+#include "storage/table/table.h"
+#include "storage/trx/vacuous_trx.h"
+
+using namespace std;
+
+TEST(test_index_scan, test_filter_rejects_record)
+{
+  const char  *table_name = "index_scan_test";
+  const char  *index_name = "index_scan_test_id";
+  const string meta_file  = table_meta_file(".", table_name);
+  const string data_file  = table_data_file(".", table_name);
+  const string index_file = table_index_file(".", table_name, index_name);
+  ::remove(meta_file.c_str());
+  ::remove(data_file.c_str());
+  ::remove(index_file.c_str());
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  BufferPoolManager::set_instance(bpm);
+  ASSERT_EQ(TrxKit::init_global("vacuous"), RC::SUCCESS);
+  Trx *trx = TrxKit::instance()->create_trx(nullptr /*log_manager*/);
+
+  vector<AttrInfoSqlNode> attrs = {{INTS, "id", 4}};
+  Table *table = new Table();
+  ASSERT_EQ(table->create(1, meta_file.c_str(), table_name, ".", static_cast<int>(attrs.size()), attrs.data(),
+                TableOptions()),
+            RC::SUCCESS);
+
+  const int record_num = 100;
+  for (int i = 0; i < record_num; i++) {
+    Value  value(i);
+    Record record;
+    ASSERT_EQ(table->make_record(1, &value, record), RC::SUCCESS);
+    ASSERT_EQ(table->insert_record(record), RC::SUCCESS);
+  }
+
+  ASSERT_EQ(table->create_index(trx, table->table_meta().field("id"), index_name), RC::SUCCESS);
+  Index *index = table->find_index(index_name);
+  ASSERT_NE(index, nullptr);
+
+  // 创建索引时替换了表的元数据，要重新取字段
+  const FieldMeta *id_field = table->table_meta().field("id");
+
+  // 过滤条件跳过的记录也占用了页面，要释放以后才能读取下一条
+  const Value left_value(10);
+  const Value right_value(50);
+  IndexScanPhysicalOperator scan(table, index, true /*readonly*/, &left_value, true, &right_value, true);
+
+  const int                      rejected_id = 20;
+  vector<unique_ptr<Expression>> predicates;
+  predicates.emplace_back(new ComparisonExpr(NOT_EQUAL,
+      unique_ptr<Expression>(new FieldExpr(table, id_field)),
+      unique_ptr<Expression>(new ValueExpr(Value(rejected_id)))));
+  scan.set_predicates(std::move(predicates));
+
+  ASSERT_EQ(scan.open(trx), RC::SUCCESS);
+  vector<int> ids;
+  RC          rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = scan.next())) {
+    Value value;
+    ASSERT_EQ(scan.current_tuple()->cell_at(0, value), RC::SUCCESS);
+    ids.push_back(value.get_int());
+  }
+  ASSERT_EQ(rc, RC::RECORD_EOF);
+  ASSERT_EQ(scan.close(), RC::SUCCESS);
+
+  vector<int> expected_ids;
+  for (int i = left_value.get_int(); i <= right_value.get_int(); i++) {
+    if (i != rejected_id) {
+      expected_ids.push_back(i);
+    }
+  }
+  ASSERT_EQ(ids, expected_ids);
+
+  TrxKit::instance()->destroy_trx(trx);
+  delete table;
+  ::remove(meta_file.c_str());
+  ::remove(data_file.c_str());
+  ::remove(index_file.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <string.h>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/common/meta_util.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+
+using namespace std;
+
+/**
+ * @brief 读取页面上记录的 end xid
+ */
+static int32_t page_end_xid(Table &table, const RID &rid)
+{
+  const FieldMeta *end_field = table.table_meta().trx_fields().first + 1;
+  int32_t          end_xid   = 0;
+  RC rc = table.visit_record(rid, true /*readonly*/, [end_field, &end_xid](Record &record) {
+    memcpy(&end_xid, record.data() + end_field->offset(), sizeof(end_xid));
+  });
+  EXPECT_EQ(rc, RC::SUCCESS);
+  return end_xid;
+}
+
+/**
+ * @brief 扫描表，删除 id 等于 delete_id 的记录
+ */
+static void delete_by_id(Table &table, Trx *trx, int delete_id, RID &rid)
+{
+  const FieldMeta *id_field = table.table_meta().field("id");
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(table.get_record_scanner(scanner, trx, false /*readonly*/), RC::SUCCESS);
+  bool deleted = false;
+  while (scanner.has_next()) {
+    Record record;
+    ASSERT_EQ(scanner.next(record), RC::SUCCESS);
+    if (*reinterpret_cast<const int *>(record.data() + id_field->offset()) == delete_id) {
+      ASSERT_EQ(trx->delete_record(&table, record), RC::SUCCESS);
+      rid     = record.rid();
+      deleted = true;
+    }
+  }
+  ASSERT_EQ(scanner.close_scan(), RC::SUCCESS);
+  ASSERT_TRUE(deleted);
+}
+
+TEST(test_mvcc_trx, test_delete_varchar_record)
+{
+  const char  *table_name = "mvcc_trx_test";
+  const string meta_file  = table_meta_file(".", table_name);
+  const string data_file  = table_data_file(".", table_name);
+  ::remove(meta_file.c_str());
+  ::remove(data_file.c_str());
+  ::remove("clog");
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  BufferPoolManager::set_instance(bpm);
+  ASSERT_EQ(TrxKit::init_global("mvcc"), RC::SUCCESS);
+  TrxKit *trx_kit = TrxKit::instance();
+
+  CLogManager *log_manager = new CLogManager();
+  ASSERT_EQ(log_manager->init("."), RC::SUCCESS);
+
+  // 有变长字段的表使用变长记录页面，扫描出来的是解码以后复制的记录
+  vector<AttrInfoSqlNode> attrs = {{INTS, "id", 4}, {VARCHARS, "name", 64}};
+  Table *table = new Table();
+  ASSERT_EQ(table->create(1, meta_file.c_str(), table_name, ".", static_cast<int>(attrs.size()), attrs.data(),
+                TableOptions()),
+            RC::SUCCESS);
+
+  const int record_num = 10;
+  Trx *writer = trx_kit->create_trx(log_manager);
+  ASSERT_EQ(writer->start_if_need(), RC::SUCCESS);
+  for (int i = 0; i < record_num; i++) {
+    const string name(i + 1, 'a' + i);
+    Value        values[] = {Value(i), Value(name.c_str())};
+    Record       record;
+    ASSERT_EQ(table->make_record(2, values, record), RC::SUCCESS);
+    ASSERT_EQ(writer->insert_record(table, record), RC::SUCCESS);
+  }
+  ASSERT_EQ(writer->commit(), RC::SUCCESS);
+
+  // 没有提交的删除要写到页面上，别的事务才能看到
+  Trx *deleter = trx_kit->create_trx(log_manager);
+  ASSERT_EQ(deleter->start_if_need(), RC::SUCCESS);
+  RID rid;
+  delete_by_id(*table, deleter, 3, rid);
+  ASSERT_EQ(page_end_xid(*table, rid), -deleter->id());
+
+  Trx *other = trx_kit->create_trx(log_manager);
+  ASSERT_EQ(other->start_if_need(), RC::SUCCESS);
+  Record record;
+  ASSERT_EQ(table->get_record(rid, record), RC::SUCCESS);
+  ASSERT_EQ(other->visit_record(table, record, false /*readonly*/), RC::LOCKED_CONCURRENCY_CONFLICT);
+  ASSERT_EQ(other->visit_record(table, record, true /*readonly*/), RC::SUCCESS);
+
+  ASSERT_EQ(deleter->rollback(), RC::SUCCESS);
+  ASSERT_EQ(page_end_xid(*table, rid), numeric_limits<int32_t>::max());
+
+  ASSERT_EQ(deleter->start_if_need(), RC::SUCCESS);
+  delete_by_id(*table, deleter, 3, rid);
+  ASSERT_EQ(deleter->commit(), RC::SUCCESS);
+  const int32_t end_xid = page_end_xid(*table, rid);
+  ASSERT_GT(end_xid, 0);
+  ASSERT_NE(end_xid, numeric_limits<int32_t>::max());
+  ASSERT_EQ(other->rollback(), RC::SUCCESS);
+
+  trx_kit->destroy_trx(writer);
+  trx_kit->destroy_trx(deleter);
+  trx_kit->destroy_trx(other);
+  delete table;
+  delete log_manager;
+  ::remove(meta_file.c_str());
+  ::remove(data_file.c_str());
+  ::remove("clog");
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
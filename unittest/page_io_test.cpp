@@ -0,0 +1,141 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <memory>
+#include <vector>
+
+#include "storage/buffer/page_io.h"
+#include "storage/buffer/page_io_uring.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+/**
+ * @brief 用两个文件，每个文件中不连续的几段页面，测试批量读写
+ */
+void test_batch_io(BPPageIO &page_io)
+{
+  const char *file_names[] = {"page_io_test_0.data", "page_io_test_1.data"};
+  const int   FILE_NUM     = 2;
+  const int   PAGE_NUM     = 64;
+
+  int fds[FILE_NUM];
+  for (int i = 0; i < FILE_NUM; i++) {
+    ::remove(file_names[i]);
+    fds[i] = ::open(file_names[i], O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fds[i], 0);
+  }
+
+  // 每个文件写 [0, 8), [10, 30), [40, 64) 三段
+  auto page_in_file = [](PageNum page_num) { return page_num < 8 || (page_num >= 10 && page_num < 30) || page_num >= 40; };
+
+  unique_ptr<Page[]>   pages(new Page[FILE_NUM * PAGE_NUM]);
+  vector<PageIORequest> requests;
+  for (int i = 0; i < FILE_NUM; i++) {
+    vector<const Page *> file_pages;
+    for (PageNum page_num = 0; page_num < PAGE_NUM; page_num++) {
+      if (!page_in_file(page_num)) {
+        continue;
+      }
+      Page &page    = pages[i * PAGE_NUM + page_num];
+      page.page_num = page_num;
+      memset(page.data, 'a' + i * PAGE_NUM + page_num % 26, sizeof(page.data));
+      file_pages.push_back(&page);
+    }
+    BPPageIO::make_write_requests(fds[i], file_pages.data(), static_cast<int>(file_pages.size()), requests);
+  }
+  ASSERT_EQ(6, requests.size());
+  ASSERT_EQ(RC::SUCCESS, page_io.execute(requests));
+  ASSERT_EQ(2 * (8 + 20 + 24), page_io.write_page_count());
+
+  // 按照另外的方式分段读回来
+  unique_ptr<Page[]> read_pages(new Page[FILE_NUM * PAGE_NUM]);
+  memset(read_pages.get(), 0, sizeof(Page) * FILE_NUM * PAGE_NUM);
+  requests.clear();
+  for (int i = 0; i < FILE_NUM; i++) {
+    for (PageNum start = 0; start < PAGE_NUM; start += 5) {
+      PageIORequest &request = requests.emplace_back();
+      request.file_desc      = fds[i];
+      request.start_page     = start;
+      for (PageNum page_num = start; page_num < std::min(start + 5, PAGE_NUM); page_num++) {
+        request.pages.push_back(&read_pages[i * PAGE_NUM + page_num]);
+      }
+    }
+  }
+  ASSERT_EQ(RC::SUCCESS, page_io.execute(requests));
+  for (int i = 0; i < FILE_NUM; i++) {
+    for (PageNum page_num = 0; page_num < PAGE_NUM; page_num++) {
+      if (page_in_file(page_num)) {
+        ASSERT_EQ(0, memcmp(&pages[i * PAGE_NUM + page_num], &read_pages[i * PAGE_NUM + page_num], sizeof(Page)));
+      }
+    }
+  }
+
+  // 超出文件尾的读请求失败，不影响同一批的其它请求
+  requests.clear();
+  PageIORequest &bad_request = requests.emplace_back();
+  bad_request.file_desc      = fds[0];
+  bad_request.start_page     = PAGE_NUM - 1;
+  bad_request.pages          = {&read_pages[0], &read_pages[1]};
+  PageIORequest &good_request = requests.emplace_back();
+  good_request.file_desc      = fds[1];
+  good_request.start_page     = 0;
+  good_request.pages          = {&read_pages[2]};
+  ASSERT_EQ(RC::IOERR_READ, page_io.execute(requests));
+  ASSERT_EQ(RC::IOERR_READ, requests[0].rc);
+  ASSERT_EQ(RC::SUCCESS, requests[1].rc);
+  ASSERT_EQ(0, memcmp(&pages[PAGE_NUM], &read_pages[2], sizeof(Page)));
+
+  for (int i = 0; i < FILE_NUM; i++) {
+    ::close(fds[i]);
+    ::remove(file_names[i]);
+  }
+}
+
+TEST(test_page_io, test_sync_engine)
+{
+  BPPageIO page_io;
+  ASSERT_EQ(RC::SUCCESS, page_io.init("sync"));
+  ASSERT_STREQ("sync", page_io.engine_name());
+  test_batch_io(page_io);
+}
+
+TEST(test_page_io, test_io_uring_engine)
+{
+  UringPageIOEngine engine;
+  if (engine.init() != RC::SUCCESS) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+
+  BPPageIO page_io;
+  ASSERT_EQ(RC::SUCCESS, page_io.init("io_uring"));
+  ASSERT_STREQ("io_uring", page_io.engine_name());
+  test_batch_io(page_io);
+}
+
+TEST(test_page_io, test_unknown_engine)
+{
+  BPPageIO page_io;
+  ASSERT_EQ(RC::SUCCESS, page_io.init("no_such_engine"));
+  ASSERT_STREQ("sync", page_io.engine_name());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -13,11 +13,14 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <string.h>
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 #include "gtest/gtest.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/record/record_manager.h"
+#include "storage/record/overflow_page.h"
 #include "storage/trx/vacuous_trx.h"
 
 using namespace common;
@@ -104,6 +107,19 @@ TEST(test_record_page_handler, test_record_page_handler)
   }
   ASSERT_EQ(count, 6);
 
+  // 一次取出页面上所有的记录
+  std::vector<Record> records;
+  iterator.init(record_page_handle);
+  ASSERT_EQ(iterator.next_batch(records), RC::SUCCESS);
+  ASSERT_EQ(records.size(), 6);
+  ASSERT_EQ(records[0].rid().slot_num, 1);
+  ASSERT_EQ(records[5].rid().slot_num, 10);
+  ASSERT_EQ(records[1].rid().slot_num, 3);
+  ASSERT_EQ(records[1].len(), record_size);
+  ASSERT_FALSE(iterator.has_next());
+  ASSERT_EQ(iterator.next_batch(records), RC::SUCCESS);
+  ASSERT_TRUE(records.empty());
+
   record_page_handle.cleanup();
   bpm->close_file(record_manager_file);
   delete bpm;
@@ -184,6 +200,368 @@ TEST(test_record_page_handler, test_record_file_iterator)
   delete bpm;
 }
 
+TEST(test_record_page_handler, test_slotted_page)
+{
+  const int page_data_size = BP_PAGE_DATA_SIZE;
+  char      page_data[page_data_size];
+  SlottedPage page(page_data, page_data_size);
+  page.init();
+
+  const int max_record_size = SlottedPage::max_record_size(page_data_size);
+  ASSERT_EQ(page.free_space(), max_record_size + static_cast<int>(sizeof(SlottedPageSlot)));
+
+  // 插入长短不一的记录，直到页面放满
+  std::vector<std::string> records;
+  SlotNum                  slot = -1;
+  for (int i = 0;; i++) {
+    std::string record(i % 50 + 1, 'a' + i % 26);
+    if (!page.can_insert(record.size())) {
+      ASSERT_EQ(page.insert(record.data(), record.size(), slot), RC::RECORD_NOMEM);
+      break;
+    }
+    ASSERT_EQ(page.insert(record.data(), record.size(), slot), RC::SUCCESS);
+    ASSERT_EQ(slot, i);
+    records.push_back(record);
+  }
+  ASSERT_EQ(page.record_num(), static_cast<int>(records.size()));
+
+  // 删除一半记录以后，可以插入更长的记录，页面会整理以回收空间
+  for (SlotNum i = 0; i < static_cast<SlotNum>(records.size()); i += 2) {
+    ASSERT_EQ(page.erase(i), RC::SUCCESS);
+    records[i].clear();
+  }
+  ASSERT_EQ(page.erase(0), RC::RECORD_NOT_EXIST);
+
+  std::string long_record(200, 'x');
+  ASSERT_EQ(page.insert(long_record.data(), long_record.size(), slot), RC::SUCCESS);
+  ASSERT_EQ(slot, 0);  // 复用第一个空槽位
+  records[0] = long_record;
+
+  // 修改记录：变短在原地修改，变长重新分配
+  std::string short_record("s");
+  ASSERT_EQ(page.update(1, short_record.data(), short_record.size()), RC::SUCCESS);
+  records[1] = short_record;
+  std::string longer_record(120, 'y');
+  ASSERT_EQ(page.update(3, longer_record.data(), longer_record.size()), RC::SUCCESS);
+  records[3] = longer_record;
+
+  page.compact();
+  for (SlotNum i = 0; i < static_cast<SlotNum>(records.size()); i++) {
+    const char *data = nullptr;
+    int         len  = 0;
+    if (records[i].empty()) {
+      ASSERT_NE(page.get(i, data, len), RC::SUCCESS);  // 末尾的空槽位已经收缩掉了
+      continue;
+    }
+    ASSERT_EQ(page.get(i, data, len), RC::SUCCESS);
+    ASSERT_EQ(std::string(data, len), records[i]);
+    ASSERT_EQ(page.checked_get(i, data, len), RC::SUCCESS);
+  }
+  ASSERT_EQ(page.next_slot(2), 3);
+
+  // 在指定的槽位上恢复记录
+  const SlotNum far_slot = page.slot_num() + 3;
+  ASSERT_EQ(page.insert_at(far_slot, long_record.data(), 10), RC::SUCCESS);
+  ASSERT_EQ(page.slot_num(), far_slot + 1);
+  ASSERT_EQ(page.next_slot(far_slot - 3), far_slot);
+
+  // 删除末尾的记录会收缩槽位目录，全部删除以后回到空页面
+  ASSERT_EQ(page.erase(far_slot), RC::SUCCESS);
+  ASSERT_LT(page.slot_num(), far_slot);
+  for (SlotNum i = page.next_slot(0); i != -1; i = page.next_slot(i + 1)) {
+    ASSERT_EQ(page.erase(i), RC::SUCCESS);
+  }
+  ASSERT_EQ(page.record_num(), 0);
+  ASSERT_EQ(page.slot_num(), 0);
+  ASSERT_EQ(page.free_space(), max_record_size + static_cast<int>(sizeof(SlottedPageSlot)));
+}
+
+TEST(test_record_page_handler, test_record_layout)
+{
+  // | int | varchar(20) | int | varchar(10) |
+  std::vector<FieldMeta> fields;
+  fields.emplace_back("id", INTS, 0, 4, true);
+  fields.emplace_back("name", VARCHARS, 4, 20, true);
+  fields.emplace_back("age", INTS, 24, 4, true);
+  fields.emplace_back("note", VARCHARS, 28, 10, true);
+  const int record_size = 38;
+
+  RecordLayout layout;
+  layout.init(StorageFormat::SLOTTED_FORMAT, record_size, fields);
+  ASSERT_EQ(layout.min_encoded_size(), 12);
+  ASSERT_EQ(layout.max_encoded_size(), record_size + 4);
+
+  char record[record_size];
+  memset(record, 'z', sizeof(record));  // 结尾'\0'后面的内容不会保存
+  *reinterpret_cast<int *>(record)      = 10;
+  strcpy(record + 4, "miniob");
+  *reinterpret_cast<int *>(record + 24) = 20;
+  memcpy(record + 28, "0123456789", 10);  // 写满的变长字段没有'\0'
+
+  char buf[64];
+  const int len = layout.encode(record, buf);
+  ASSERT_EQ(len, layout.encoded_size(record));
+  ASSERT_EQ(len, 8 + 2 + 6 + 2 + 10);
+
+  char decoded[record_size];
+  ASSERT_EQ(layout.decode(buf, len, decoded), RC::SUCCESS);
+  ASSERT_EQ(*reinterpret_cast<int *>(decoded), 10);
+  ASSERT_STREQ(decoded + 4, "miniob");
+  ASSERT_EQ(decoded[23], 0);
+  ASSERT_EQ(*reinterpret_cast<int *>(decoded + 24), 20);
+  ASSERT_EQ(memcmp(decoded + 28, "0123456789", 10), 0);
+
+  // 长度不对的编码不能越界
+  ASSERT_NE(layout.decode(buf, len - 1, decoded), RC::SUCCESS);
+  ASSERT_NE(layout.decode(buf, 9, decoded), RC::SUCCESS);
+
+  // 定长格式不做编码
+  RecordLayout fixed_layout;
+  fixed_layout.init(StorageFormat::FIXED_FORMAT, record_size, fields);
+  ASSERT_EQ(fixed_layout.encoded_size(record), record_size);
+}
+
+TEST(test_record_page_handler, test_slotted_record_file)
+{
+  const char *record_manager_file = "record_manager_slotted.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  ASSERT_EQ(bpm->create_file(record_manager_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+
+  // | int | varchar(200) |
+  std::vector<FieldMeta> fields;
+  fields.emplace_back("id", INTS, 0, 4, true);
+  fields.emplace_back("name", VARCHARS, 4, 200, true);
+  const int record_size = 204;
+
+  RecordLayout layout;
+  layout.init(StorageFormat::SLOTTED_FORMAT, record_size, fields);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp, &layout), RC::SUCCESS);
+
+  const int        record_insert_num = 1000;
+  std::vector<RID> rids;
+  char             record[record_size];
+  for (int i = 0; i < record_insert_num; i++) {
+    memset(record, 0, sizeof(record));
+    *reinterpret_cast<int *>(record) = i;
+    snprintf(record + 4, 200, "name-%d", i);
+    RID rid;
+    ASSERT_EQ(file_handler.insert_record(record, record_size, &rid), RC::SUCCESS);
+    rids.push_back(rid);
+  }
+
+  // 短的记录按照实际长度存放，使用的页面比定长格式少得多
+  const int fixed_capacity = bp->page_data_size() / record_size;
+  ASSERT_LT(bp->page_count(), record_insert_num / fixed_capacity / 2);
+
+  for (int i = 0; i < record_insert_num; i += 2) {
+    ASSERT_EQ(file_handler.delete_record(&rids[i]), RC::SUCCESS);
+  }
+
+  // 通过 visit_record 修改的记录会写回页面
+  ASSERT_EQ(file_handler.visit_record(rids[1], false /*readonly*/, [](Record &record) {
+    snprintf(record.data() + 4, 200, "%s", std::string(150, 'v').c_str());
+  }), RC::SUCCESS);
+
+  VacuousTrx        trx;
+  RecordFileScanner file_scanner;
+  ASSERT_EQ(file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, nullptr, &layout), RC::SUCCESS);
+
+  int    count = 0;
+  Record last_record;
+  Record scan_record;
+  while (file_scanner.has_next()) {
+    ASSERT_EQ(file_scanner.next(scan_record), RC::SUCCESS);
+    const int id = *reinterpret_cast<const int *>(scan_record.data());
+    ASSERT_EQ(id % 2, 1);
+    if (id == 1) {
+      ASSERT_EQ(std::string(scan_record.data() + 4), std::string(150, 'v'));
+    } else {
+      ASSERT_EQ(std::string(scan_record.data() + 4), "name-" + std::to_string(id));
+    }
+
+    // 上一条记录在取下一条以后仍然可以访问
+    if (last_record.data() != nullptr) {
+      ASSERT_EQ(*reinterpret_cast<const int *>(last_record.data()) % 2, 1);
+    }
+    last_record = scan_record;
+    count++;
+  }
+  file_scanner.close_scan();
+  ASSERT_EQ(count, record_insert_num / 2);
+
+  ASSERT_EQ(file_handler.copy_record(rids[3], record, record_size), RC::SUCCESS);
+  ASSERT_STREQ(record + 4, "name-3");
+  ASSERT_EQ(file_handler.copy_record(rids[2], record, record_size), RC::RECORD_NOT_EXIST);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_pax_record_file)
+{
+  const char *record_manager_file = "record_manager_pax.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  ASSERT_EQ(bpm->create_file(record_manager_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+
+  // | int | char(8) | float |
+  std::vector<FieldMeta> fields;
+  fields.emplace_back("id", INTS, 0, 4, true);
+  fields.emplace_back("name", CHARS, 4, 8, true);
+  fields.emplace_back("score", FLOATS, 12, 4, true);
+  const int record_size = 16;
+
+  RecordLayout layout;
+  layout.init(StorageFormat::PAX_FORMAT, record_size, fields);
+  ASSERT_TRUE(layout.pax());
+  ASSERT_EQ(layout.columns().size(), fields.size());
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp, &layout), RC::SUCCESS);
+
+  const int        record_insert_num = 2000;
+  std::vector<RID> rids;
+  char             record[record_size];
+  for (int i = 0; i < record_insert_num; i++) {
+    memset(record, 0, sizeof(record));
+    *reinterpret_cast<int *>(record)        = i;
+    snprintf(record + 4, 8, "n%d", i);
+    *reinterpret_cast<float *>(record + 12) = i * 0.5f;
+    RID rid;
+    ASSERT_EQ(file_handler.insert_record(record, record_size, &rid), RC::SUCCESS);
+    rids.push_back(rid);
+  }
+  ASSERT_GT(rids.back().page_num, rids.front().page_num);
+
+  for (int i = 0; i < record_insert_num; i += 2) {
+    ASSERT_EQ(file_handler.delete_record(&rids[i]), RC::SUCCESS);
+  }
+
+  // 修改以后写回各个小页
+  ASSERT_EQ(file_handler.visit_record(rids[1], false /*readonly*/, [](Record &record) {
+    *reinterpret_cast<float *>(record.data() + 12) = -1.0f;
+  }), RC::SUCCESS);
+
+  auto scan = [&](std::vector<int> columns, int &count) {
+    VacuousTrx        trx;
+    RecordFileScanner file_scanner;
+    ASSERT_EQ(file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, nullptr /*condition_filter*/,
+                  &layout, nullptr /*zone_map*/, {}, columns),
+        RC::SUCCESS);
+
+    count = 0;
+    Record scan_record;
+    while (file_scanner.has_next()) {
+      ASSERT_EQ(file_scanner.next(scan_record), RC::SUCCESS);
+      const int   id    = *reinterpret_cast<const int *>(scan_record.data());
+      const float score = *reinterpret_cast<const float *>(scan_record.data() + 12);
+      ASSERT_EQ(id % 2, 1);
+      if (columns.empty()) {
+        ASSERT_EQ(std::string(scan_record.data() + 4), "n" + std::to_string(id));
+        ASSERT_EQ(score, id == 1 ? -1.0f : id * 0.5f);
+      } else {
+        // 没有读取的列都是0
+        ASSERT_EQ(scan_record.data()[4], 0);
+        ASSERT_EQ(score, 0.0f);
+      }
+      count++;
+    }
+    file_scanner.close_scan();
+  };
+
+  int count = 0;
+  scan({}, count);
+  ASSERT_EQ(count, record_insert_num / 2);
+  scan({0}, count);
+  ASSERT_EQ(count, record_insert_num / 2);
+
+  ASSERT_EQ(file_handler.copy_record(rids[3], record, record_size), RC::SUCCESS);
+  ASSERT_STREQ(record + 4, "n3");
+  ASSERT_EQ(file_handler.copy_record(rids[2], record, record_size), RC::RECORD_NOT_EXIST);
+
+  // 恢复时在原来的位置插入
+  memset(record, 0, sizeof(record));
+  *reinterpret_cast<int *>(record) = 2;
+  ASSERT_EQ(file_handler.recover_insert_record(record, record_size, rids[2]), RC::SUCCESS);
+  ASSERT_EQ(file_handler.copy_record(rids[2], record, record_size), RC::SUCCESS);
+  ASSERT_EQ(*reinterpret_cast<int *>(record), 2);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_overflow_page)
+{
+  const char *overflow_file = "record_manager_overflow.bp";
+  ::remove(overflow_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  ASSERT_EQ(bpm->create_file(overflow_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(overflow_file, bp), RC::SUCCESS);
+
+  OverflowFileHandler handler;
+  ASSERT_EQ(handler.init(bp), RC::SUCCESS);
+
+  // 跨越多个页面的值
+  std::string value;
+  for (int i = 0; static_cast<int>(value.size()) < handler.page_capacity() * 3 + 100; i++) {
+    value += std::to_string(i) + ",";
+  }
+
+  OverflowRef ref;
+  ASSERT_EQ(handler.insert(value.data(), static_cast<int>(value.size()), ref), RC::SUCCESS);
+  ASSERT_NE(ref.first_page, BP_INVALID_PAGE_NUM);
+  ASSERT_EQ(ref.length, static_cast<int>(value.size()));
+
+  std::string data;
+  ASSERT_EQ(handler.read(ref, data), RC::SUCCESS);
+  ASSERT_EQ(data, value);
+
+  // 流式读取，每次读取的长度与页面大小无关
+  OverflowReader reader;
+  ASSERT_EQ(handler.open_reader(ref, reader), RC::SUCCESS);
+  std::string streamed;
+  char        buf[1000];
+  int         read_len = 0;
+  do {
+    ASSERT_EQ(reader.read(buf, sizeof(buf), read_len), RC::SUCCESS);
+    streamed.append(buf, read_len);
+  } while (read_len > 0);
+  ASSERT_EQ(streamed, value);
+  ASSERT_EQ(reader.remain(), 0);
+
+  // 空字符串不占用页面
+  OverflowRef empty_ref;
+  ASSERT_EQ(handler.insert("", 0, empty_ref), RC::SUCCESS);
+  ASSERT_EQ(empty_ref.first_page, BP_INVALID_PAGE_NUM);
+  ASSERT_EQ(handler.read(empty_ref, data), RC::SUCCESS);
+  ASSERT_TRUE(data.empty());
+
+  // 释放的页面可以再次使用
+  const PageNum page_count = bp->page_count();
+  ASSERT_EQ(handler.remove(ref), RC::SUCCESS);
+  ASSERT_EQ(handler.insert(value.data(), static_cast<int>(value.size()), ref), RC::SUCCESS);
+  ASSERT_EQ(bp->page_count(), page_count);
+  ASSERT_EQ(handler.read(ref, data), RC::SUCCESS);
+  ASSERT_EQ(data, value);
+
+  handler.close();
+  bpm->close_file(overflow_file);
+  delete bpm;
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
@@ -193,3 +571,273 @@ int main(int argc, char **argv)
   // main函数返回RUN_ALL_TESTS()的运行结果
   return RUN_ALL_TESTS();
 }
+
+TEST(test_record_page_handler, test_free_space_map)
+{
+  const char *record_manager_file = "record_manager_fsm.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(record_manager_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+
+  const int record_insert_num = 2000;
+  char record_data[20];
+  memset(record_data, 0, sizeof(record_data));
+  std::vector<RID> rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    RID rid;
+    ASSERT_EQ(file_handler.insert_record(record_data, sizeof(record_data), &rid), RC::SUCCESS);
+    ASSERT_NE(rid.page_num, 1);  // 第1个页面是空闲空间表
+    rids.push_back(rid);
+  }
+  for (int i = 0; i < record_insert_num; i += 2) {
+    ASSERT_EQ(file_handler.delete_record(&rids[i]), RC::SUCCESS);
+  }
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+
+  // 重新打开文件，删除记录空出来的空间从空闲空间表中找到
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+  const int page_count = bp->page_count();
+  for (int i = 0; i < record_insert_num / 2; i++) {
+    RID rid;
+    ASSERT_EQ(file_handler.insert_record(record_data, sizeof(record_data), &rid), RC::SUCCESS);
+  }
+  ASSERT_EQ(page_count, bp->page_count());
+
+  // 遍历时跳过空闲空间表页面
+  VacuousTrx trx;
+  RecordFileScanner file_scanner;
+  ASSERT_EQ(file_scanner.open_scan(nullptr/*table*/, *bp, &trx, true/*readonly*/, nullptr/*condition_filter*/),
+            RC::SUCCESS);
+  int count = 0;
+  Record record;
+  while (file_scanner.has_next()) {
+    ASSERT_EQ(file_scanner.next(record), RC::SUCCESS);
+    count++;
+  }
+  file_scanner.close_scan();
+  ASSERT_EQ(count, record_insert_num);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_insert_target_latched)
+{
+  const char *record_manager_file = "record_manager_target.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(record_manager_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+
+  char record_data[20];
+  memset(record_data, 0, sizeof(record_data));
+
+  // 在一个新的线程中插入一条记录，每个线程有自己的插入目标页面
+  auto insert_in_new_thread = [&file_handler, &record_data]() {
+    RID rid;
+    RC  rc = RC::SUCCESS;
+    std::thread thread([&]() { rc = file_handler.insert_record(record_data, sizeof(record_data), &rid); });
+    thread.join();
+    EXPECT_EQ(rc, RC::SUCCESS);
+    return rid.page_num;
+  };
+
+  RID rid;
+  ASSERT_EQ(file_handler.insert_record(record_data, sizeof(record_data), &rid), RC::SUCCESS);
+  const PageNum first_page = rid.page_num;
+
+  // 其它线程的目标页面没有人在写时可以共用
+  ASSERT_EQ(insert_in_new_thread(), first_page);
+
+  // 当前线程拿着目标页面的写锁，另一个线程 try_init 失败，插入时跳过这个页面
+  RecordPageHandler latched_page;
+  ASSERT_EQ(latched_page.init(*bp, first_page, false /*readonly*/), RC::SUCCESS);
+
+  RC try_rc = RC::SUCCESS;
+  std::thread try_thread([&]() {
+    RecordPageHandler page_handler;
+    try_rc = page_handler.try_init(*bp, first_page);
+  });
+  try_thread.join();
+  ASSERT_EQ(try_rc, RC::LOCKED_NEED_WAIT);
+
+  const PageNum second_page = insert_in_new_thread();
+  ASSERT_NE(second_page, first_page);
+
+  // 第二个页面也是其它线程的目标页面，但是没有人在写，可以使用，不需要再分配新的页面
+  const PageNum page_count = bp->page_count();
+  ASSERT_EQ(insert_in_new_thread(), second_page);
+  ASSERT_EQ(bp->page_count(), page_count);
+
+  latched_page.cleanup();
+  const PageNum page_num = insert_in_new_thread();
+  ASSERT_TRUE(page_num == first_page || page_num == second_page);
+  ASSERT_EQ(bp->page_count(), page_count);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_insert_records)
+{
+  const char *record_manager_file = "record_manager_batch.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(record_manager_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+
+  const int record_insert_num = 1000;
+  const int record_size = 20;
+  std::vector<char> record_datas(record_insert_num * record_size);
+  std::vector<const char *> datas;
+  for (int i = 0; i < record_insert_num; i++) {
+    char *data = record_datas.data() + i * record_size;
+    memset(data, 0, record_size);
+    memcpy(data, &i, sizeof(i));
+    datas.push_back(data);
+  }
+
+  std::vector<RID> rids;
+  ASSERT_EQ(file_handler.insert_records(datas, record_size, rids), RC::SUCCESS);
+  ASSERT_EQ(rids.size(), datas.size());
+
+  // 一个页面填满以后才使用下一个页面
+  int page_switches = 0;
+  for (int i = 1; i < record_insert_num; i++) {
+    ASSERT_LT(RID::compare(&rids[i - 1], &rids[i]), 0);
+    if (rids[i].page_num != rids[i - 1].page_num) {
+      page_switches++;
+    }
+  }
+  ASSERT_EQ(page_switches + 1, bp->page_count() - 2);  // 去掉文件头页面和空闲空间表页面
+
+  for (int i = 0; i < record_insert_num; i++) {
+    char buffer[record_size];
+    ASSERT_EQ(file_handler.copy_record(rids[i], buffer, record_size), RC::SUCCESS);
+    int value = -1;
+    memcpy(&value, buffer, sizeof(value));
+    ASSERT_EQ(value, i);
+  }
+
+  // 批量插入与逐条插入的记录可以混合在一起
+  RID rid;
+  ASSERT_EQ(file_handler.insert_record(datas[0], record_size, &rid), RC::SUCCESS);
+  ASSERT_EQ(rid.page_num, rids.back().page_num);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_zone_map)
+{
+  const char *record_manager_file = "record_manager_zone_map.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(record_manager_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(record_manager_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+
+  FieldMeta field_meta;
+  ASSERT_EQ(field_meta.init("id", INTS, 0, sizeof(int), true), RC::SUCCESS);
+  file_handler.zone_map().init({field_meta}, "zone_map_test");
+  ASSERT_TRUE(file_handler.zone_map().enabled());
+
+  const int record_insert_num = 1000;
+  const int record_size = 20;
+  std::vector<RID> rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    char record_data[record_size] = {0};
+    memcpy(record_data, &i, sizeof(i));
+    RID rid;
+    ASSERT_EQ(file_handler.insert_record(record_data, record_size, &rid), RC::SUCCESS);
+    rids.push_back(rid);
+  }
+  ASSERT_GT(rids.back().page_num, rids.front().page_num);
+
+  auto scan = [&](CompOp comp, int value, int &count, int &pages_skipped) {
+    ZoneMapCondition condition;
+    condition.field_index = 0;
+    condition.comp        = comp;
+    condition.value.set_int(value);
+
+    VacuousTrx trx;
+    RecordFileScanner file_scanner;
+    ASSERT_EQ(file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, nullptr /*condition_filter*/,
+                  nullptr /*layout*/, &file_handler.zone_map(), {condition}),
+        RC::SUCCESS);
+
+    // 区域映射只跳过页面，不过滤记录
+    count = 0;
+    Record record;
+    while (file_scanner.has_next()) {
+      ASSERT_EQ(file_scanner.next(record), RC::SUCCESS);
+      int id = -1;
+      memcpy(&id, record.data(), sizeof(id));
+      if (id >= value) {
+        count++;
+      }
+    }
+    pages_skipped = file_scanner.pages_skipped();
+    file_scanner.close_scan();
+  };
+
+  // 新页面插入记录时就维护了摘要，按照插入顺序增长的字段可以跳过前面所有的页面
+  const int last_page_records = std::count_if(
+      rids.begin(), rids.end(), [&](const RID &rid) { return rid.page_num == rids.back().page_num; });
+  const int first_in_last_page = record_insert_num - last_page_records;
+  int count = 0;
+  int pages_skipped = 0;
+  scan(GREAT_EQUAL, first_in_last_page, count, pages_skipped);
+  ASSERT_EQ(count, last_page_records);
+  ASSERT_EQ(pages_skipped, rids.back().page_num - rids.front().page_num);
+
+  // 删除页面上的最小值以后丢弃摘要，下次扫描时重新生成
+  ASSERT_EQ(file_handler.delete_record(&rids[first_in_last_page]), RC::SUCCESS);
+  ASSERT_FALSE(file_handler.zone_map().summarized(rids.back().page_num));
+  scan(GREAT_EQUAL, first_in_last_page, count, pages_skipped);
+  ASSERT_EQ(count, last_page_records - 1);
+  ASSERT_TRUE(file_handler.zone_map().summarized(rids.back().page_num));
+
+  // 没有任何页面满足条件
+  scan(GREAT_THAN, record_insert_num, count, pages_skipped);
+  ASSERT_EQ(count, 0);
+  ASSERT_EQ(pages_skipped, rids.back().page_num - rids.front().page_num + 1);
+
+  int skippable = 0;
+  int summarized = 0;
+  ZoneMapCondition condition;
+  condition.field_index = 0;
+  condition.comp        = LESS_THAN;
+  condition.value.set_int(0);
+  file_handler.zone_map().count_skippable({condition}, skippable, summarized);
+  ASSERT_EQ(skippable, summarized);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}